@@ -36,11 +36,16 @@
  *
  */
 
+#include <QStyleOptionGraphicsItem>
+
 #include "BitmapAnnotation.h"
+#include "BitmapImageCache.h"
 
-BitmapAnnotation::BitmapAnnotation(QString classFileName, QString annotation, Component *pParent)
+BitmapAnnotation::BitmapAnnotation(QString classFileName, const AnnotationNode &annotation, Component *pParent)
   : ShapeAnnotation(pParent), mpComponent(pParent)
 {
+  mImageRequestId = 0;
+  mLibraryImageLoaded = false;
   mClassFileName = classFileName;
   // set the default values
   GraphicItem::setDefaults();
@@ -50,10 +55,13 @@ BitmapAnnotation::BitmapAnnotation(QString classFileName, QString annotation, Co
   setRotation(mRotation);
 }
 
-BitmapAnnotation::BitmapAnnotation(QString classFileName, QString annotation, bool inheritedShape, GraphicsView *pGraphicsView)
+BitmapAnnotation::BitmapAnnotation(QString classFileName, const AnnotationNode &annotation, bool inheritedShape,
+                                   GraphicsView *pGraphicsView)
   : ShapeAnnotation(inheritedShape, pGraphicsView, 0)
 {
   mpComponent = 0;
+  mImageRequestId = 0;
+  mLibraryImageLoaded = false;
   mClassFileName = classFileName;
   // set the default values
   GraphicItem::setDefaults();
@@ -67,34 +75,25 @@ BitmapAnnotation::BitmapAnnotation(QString classFileName, QString annotation, bo
   connect(this, SIGNAL(updateClassAnnotation()), mpGraphicsView, SLOT(addClassAnnotation()));
 }
 
-void BitmapAnnotation::parseShapeAnnotation(QString annotation)
+void BitmapAnnotation::parseShapeAnnotation(const AnnotationNode &list)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  // parse the shape to get the list of attributes of Bitmap.
-  QStringList list = StringHandler::getStrings(annotation);
+  // list contains the arguments of the Bitmap shape.
+  GraphicItem::parseShapeAnnotation(list);
   if (list.size() < 5)
     return;
   // 4th item is the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(3)));
+  AnnotationNode extentsList = list.at(3);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++)
   {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2)
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    if (extentsList.at(i).size() >= 2)
+      mExtents.replace(i, extentsList.at(i).toPointF());
   }
   // 5th item is the fileName
-  setFileName(StringHandler::removeFirstLastQuotes(list.at(4)), mpComponent);
+  setFileName(list.at(4).toString(), mpComponent);
   // 6th item is the imageSource
   if (list.size() >= 6)
-    mImageSource = StringHandler::removeFirstLastQuotes(list.at(5));
-  if (!mImageSource.isEmpty())
-  {
-    mImage.loadFromData(QByteArray::fromBase64(mImageSource.toLatin1()));
-  }
-  else
-  {
-    mImage.load(mFileName);
-  }
+    mImageSource = list.at(5).toString();
+  loadImage();
 }
 
 QRectF BitmapAnnotation::boundingRect() const
@@ -113,13 +112,123 @@ void BitmapAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
-  if (mVisible)
+  if (mVisible && !isBelowLevelOfDetail(painter, qMax(boundingRect().width(), boundingRect().height()), 2))
     drawBitmapAnnotaion(painter);
 }
 
+/*!
+ * \brief BitmapAnnotation::drawBitmapAnnotaion
+ * Draws the image. A downscaled variant of the image is drawn when the image is drawn much smaller than its size.
+ * \param painter
+ */
 void BitmapAnnotation::drawBitmapAnnotaion(QPainter *painter)
 {
-  painter->drawImage(getBoundingRect(), mImage.mirrored());
+  QRectF rect = getBoundingRect();
+  qreal levelOfDetail = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+  QImage image = getBitmapImageCache()->getScaledImage(mImageKey, mImage, (rect.size() * levelOfDetail).toSize());
+  // mirror the image since our coordinate system is inverted.
+  painter->save();
+  painter->translate(0, rect.top() + rect.bottom());
+  painter->scale(1.0, -1.0);
+  painter->drawImage(rect, image);
+  painter->restore();
+}
+
+/*!
+ * \brief BitmapAnnotation::loadImage
+ * Sets the image right away if it is cached, otherwise requests it from the BitmapImageCache.\n
+ * The images of the library icons are not requested. They are loaded before the icon is recorded.
+ * \sa BitmapAnnotation::setLoadedImage
+ * \sa LibraryComponent::getUncachedImages
+ */
+void BitmapAnnotation::loadImage()
+{
+  BitmapImageCache *pBitmapImageCache = getBitmapImageCache();
+  pBitmapImageCache->cancelImageRequest(mImageRequestId);
+  mImageRequestId = 0;
+  mImageKey = "";
+  mImage = QImage();
+  mLibraryImageLoaded = false;
+  if ((mpComponent && mpComponent->isLibraryComponent()) || (mFileName.isEmpty() && mImageSource.isEmpty())) {
+    return;
+  }
+  if (!pBitmapImageCache->getCachedImage(mFileName, mImageSource, &mImageKey, &mImage)) {
+    mImageRequestId = pBitmapImageCache->requestImage(mFileName, mImageSource, this);
+  }
+}
+
+/*!
+ * \brief BitmapAnnotation::loadCachedLibraryImage
+ * Sets the image of the library icon if it is cached.
+ * \param pFileName - set to the file of the image to load.
+ * \param pImageSource - set to the imageSource of the image to load.
+ * \return false if the image has to be loaded.
+ */
+bool BitmapAnnotation::loadCachedLibraryImage(QString *pFileName, QString *pImageSource)
+{
+  if (mLibraryImageLoaded) {
+    return true;
+  }
+  if ((mFileName.isEmpty() && mImageSource.isEmpty()) || getBitmapImageCache()->getCachedImage(mFileName, mImageSource, &mImageKey, &mImage)) {
+    mLibraryImageLoaded = true;
+    return true;
+  }
+  *pFileName = mFileName;
+  *pImageSource = mImageSource;
+  return false;
+}
+
+/*!
+ * \brief BitmapAnnotation::loadLibraryImage
+ * Loads the image of the library icon in the calling thread.
+ */
+void BitmapAnnotation::loadLibraryImage()
+{
+  if (!mLibraryImageLoaded) {
+    mImage = getBitmapImageCache()->loadImage(mFileName, mImageSource, &mImageKey);
+    mLibraryImageLoaded = true;
+  }
+}
+
+/*!
+ * \brief BitmapAnnotation::setLoadedImage
+ * Called by the BitmapImageCache when the requested image is loaded.
+ * \param key
+ * \param image
+ */
+void BitmapAnnotation::setLoadedImage(QString key, QImage image)
+{
+  mImageRequestId = 0;
+  mImageKey = key;
+  mImage = image;
+  update();
+}
+
+/*!
+ * \brief BitmapAnnotation::setImage
+ * Reimplementation of ShapeAnnotation::setImage.\n
+ * Cancels the pending image request so that it doesn't replace the image.
+ * \param image
+ */
+void BitmapAnnotation::setImage(QImage image)
+{
+  getBitmapImageCache()->cancelImageRequest(mImageRequestId);
+  mImageRequestId = 0;
+  mImageKey = "";
+  ShapeAnnotation::setImage(image);
+}
+
+/*!
+ * \brief BitmapAnnotation::getBitmapImageCache
+ * \return the shared BitmapImageCache.
+ */
+BitmapImageCache* BitmapAnnotation::getBitmapImageCache()
+{
+  if (mpComponent) {
+    return mpComponent->getOMCProxy()->getBitmapImageCache();
+  } else {
+    return mpGraphicsView->getModelWidget()->getModelWidgetContainer()->getMainWindow()->getOMCProxy()->getBitmapImageCache();
+  }
 }
 
 QString BitmapAnnotation::getShapeAnnotation()
@@ -149,7 +258,7 @@ QString BitmapAnnotation::getShapeAnnotation()
 
 void BitmapAnnotation::duplicate()
 {
-  BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(mClassFileName, "", false, mpGraphicsView);
+  BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(mClassFileName, AnnotationNode(), false, mpGraphicsView);
   QPointF gridStep(mpGraphicsView->getCoOrdinateSystem()->getHorizontalGridStep(),
                    mpGraphicsView->getCoOrdinateSystem()->getVerticalGridStep());
   pBitmapAnnotation->setOrigin(mOrigin + gridStep);
@@ -158,7 +267,7 @@ void BitmapAnnotation::duplicate()
   pBitmapAnnotation->setExtents(getExtents());
   pBitmapAnnotation->setFileName(getFileName());
   pBitmapAnnotation->setImageSource(getImageSource());
-  pBitmapAnnotation->setImage(getImage());
+  pBitmapAnnotation->loadImage();
   pBitmapAnnotation->drawCornerItems();
   pBitmapAnnotation->setCornerItemsPassive();
   pBitmapAnnotation->update();
@@ -43,21 +43,32 @@
 #include "Component.h"
 
 class OMCProxy;
+class BitmapImageCache;
 
 class BitmapAnnotation : public ShapeAnnotation
 {
   Q_OBJECT
 public:
-  BitmapAnnotation(QString classFileName, QString annotation, Component *pParent);
-  BitmapAnnotation(QString classFileName, QString annotation, bool inheritedShape, GraphicsView *pGraphicsView);
-  void parseShapeAnnotation(QString annotation);
+  BitmapAnnotation(QString classFileName, const AnnotationNode &annotation, Component *pParent);
+  BitmapAnnotation(QString classFileName, const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
   void drawBitmapAnnotaion(QPainter *painter);
   QString getShapeAnnotation();
+  void loadImage();
+  bool loadCachedLibraryImage(QString *pFileName, QString *pImageSource);
+  void loadLibraryImage();
+  void setLoadedImage(QString key, QImage image);
+  void setImage(QImage image);
 private:
   Component *mpComponent;
+  int mImageRequestId;
+  QString mImageKey;
+  bool mLibraryImageLoaded;
+
+  BitmapImageCache* getBitmapImageCache();
 public slots:
   void duplicate();
 };
@@ -0,0 +1,278 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QCryptographicHash>
+
+#include "BitmapImageCache.h"
+#include "BitmapAnnotation.h"
+
+/*!
+ * \class BitmapImageCache
+ * \brief Shared cache of the decoded images of the Bitmap annotations.
+ * The images are keyed by the digest of their encoded data so an image used by many bitmaps is decoded only once,
+ * no matter if it comes from a file or from an imageSource. The downscaled variants used for the small icons are cached as well.\n
+ * The images of the views are decoded in a thread pool and handed to the requesting BitmapAnnotation in the GUI thread.
+ * The cache is also used from the library icon rendering threads so all the access to the cached images is serialized.
+ */
+/*!
+ * \brief BitmapImageCache::BitmapImageCache
+ * \param maximumCost - the size of the cache in kilobytes.
+ */
+BitmapImageCache::BitmapImageCache(int maximumCost)
+  : mImagesCache(maximumCost)
+{
+  mpImagesThreadPool = new QThreadPool(this);
+  mpImagesThreadPool->setMaxThreadCount(QThread::idealThreadCount());
+  mLastImageRequestId = 0;
+}
+
+/*!
+ * \brief BitmapImageCache::~BitmapImageCache
+ * Discards the queued image requests and waits for the running ones.
+ */
+BitmapImageCache::~BitmapImageCache()
+{
+  mpImagesThreadPool->clear();
+  mpImagesThreadPool->waitForDone();
+}
+
+/*!
+ * \brief BitmapImageCache::getCachedImage
+ * Looks up the image without reading the file or decoding the data.
+ * The image file is identified by the key it had when it was last loaded as long as the file is not modified.
+ * \param fileName
+ * \param imageSource - the base64 encoded image data.
+ * \param pKey - set to the key of the image.
+ * \param pImage - set to the cached image.
+ * \return true if the image is cached.
+ */
+bool BitmapImageCache::getCachedImage(QString fileName, QString imageSource, QString *pKey, QImage *pImage)
+{
+  QString key;
+  if (!imageSource.isEmpty()) {
+    key = imageKey(QByteArray::fromBase64(imageSource.toLatin1()));
+  } else if (!fileName.isEmpty()) {
+    QFileInfo fileInfo(fileName);
+    QMutexLocker cacheLocker(&mCacheMutex);
+    if (mFileKeysHash.contains(fileName) && mFileKeysHash.value(fileName).first == fileInfo.lastModified()) {
+      key = mFileKeysHash.value(fileName).second;
+    }
+  }
+  if (key.isEmpty()) {
+    return false;
+  }
+  QMutexLocker cacheLocker(&mCacheMutex);
+  QImage *pCachedImage = mImagesCache.object(key);
+  if (!pCachedImage) {
+    return false;
+  }
+  *pKey = key;
+  *pImage = *pCachedImage;
+  return true;
+}
+
+/*!
+ * \brief BitmapImageCache::loadImage
+ * Reads and decodes the image unless an image with the same data is already cached.
+ * The imageSource is used when it is not empty, otherwise the image is read from the file.
+ * \param fileName
+ * \param imageSource - the base64 encoded image data.
+ * \param pKey - set to the key of the image.
+ * \return the image or a null QImage if it can't be read.
+ */
+QImage BitmapImageCache::loadImage(QString fileName, QString imageSource, QString *pKey)
+{
+  // an unmodified image file that is already cached is not read again.
+  QImage image;
+  if (imageSource.isEmpty() && getCachedImage(fileName, imageSource, pKey, &image)) {
+    return image;
+  }
+  QByteArray data;
+  QDateTime lastModified;
+  if (!imageSource.isEmpty()) {
+    data = QByteArray::fromBase64(imageSource.toLatin1());
+  } else if (!fileName.isEmpty()) {
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly)) {
+      data = file.readAll();
+      file.close();
+    }
+    lastModified = QFileInfo(fileName).lastModified();
+  }
+  if (data.isEmpty()) {
+    return QImage();
+  }
+  QString key = imageKey(data);
+  *pKey = key;
+  QMutexLocker cacheLocker(&mCacheMutex);
+  if (imageSource.isEmpty()) {
+    mFileKeysHash.insert(fileName, qMakePair(lastModified, key));
+  }
+  QImage *pCachedImage = mImagesCache.object(key);
+  if (pCachedImage) {
+    return *pCachedImage;
+  }
+  // decode outside of the lock so the other threads can use the cache meanwhile.
+  cacheLocker.unlock();
+  image.loadFromData(data);
+  if (!image.isNull()) {
+    cacheLocker.relock();
+    mImagesCache.insert(key, new QImage(image), qMax(1, image.byteCount() / 1024));
+  }
+  return image;
+}
+
+/*!
+ * \brief BitmapImageCache::requestImage
+ * Queues the image for loading in the thread pool.
+ * BitmapAnnotation::setLoadedImage is called in the GUI thread once the image is loaded.
+ * \param fileName
+ * \param imageSource - the base64 encoded image data.
+ * \param pBitmapAnnotation
+ * \return the id of the request.
+ * \sa BitmapImageCache::imageLoaded
+ */
+int BitmapImageCache::requestImage(QString fileName, QString imageSource, BitmapAnnotation *pBitmapAnnotation)
+{
+  int requestId = ++mLastImageRequestId;
+  mImageRequestsHash.insert(requestId, QPointer<BitmapAnnotation>(pBitmapAnnotation));
+  mpImagesThreadPool->start(new BitmapImageLoadTask(requestId, fileName, imageSource, this));
+  return requestId;
+}
+
+/*!
+ * \brief BitmapImageCache::cancelImageRequest
+ * The image of the cancelled request is still loaded and cached but it is not handed to the BitmapAnnotation.
+ * \param requestId
+ */
+void BitmapImageCache::cancelImageRequest(int requestId)
+{
+  mImageRequestsHash.remove(requestId);
+}
+
+/*!
+ * \brief BitmapImageCache::getScaledImage
+ * Returns a downscaled variant of the image when it is drawn much smaller than its size.
+ * The variants are scaled to powers of two so only a few of them are cached per image.
+ * \param key - the key of the image. The variant is not cached if the key is empty.
+ * \param image
+ * \param size - the size in pixels the image is drawn at.
+ * \return the downscaled image or the image itself.
+ */
+QImage BitmapImageCache::getScaledImage(QString key, QImage image, QSize size)
+{
+  if (image.isNull() || size.isEmpty()) {
+    return image;
+  }
+  int side = 16;
+  while (side < qMax(size.width(), size.height())) {
+    side *= 2;
+  }
+  // only use a downscaled variant when it is at most half the size of the image.
+  if (side * 2 > qMax(image.width(), image.height())) {
+    return image;
+  }
+  QString scaledKey = QString("%1|%2").arg(key).arg(side);
+  QMutexLocker cacheLocker(&mCacheMutex);
+  if (!key.isEmpty()) {
+    QImage *pCachedImage = mImagesCache.object(scaledKey);
+    if (pCachedImage) {
+      return *pCachedImage;
+    }
+  }
+  cacheLocker.unlock();
+  QImage scaledImage = image.scaled(side, side, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  if (!key.isEmpty()) {
+    cacheLocker.relock();
+    mImagesCache.insert(scaledKey, new QImage(scaledImage), qMax(1, scaledImage.byteCount() / 1024));
+  }
+  return scaledImage;
+}
+
+/*!
+ * \brief BitmapImageCache::imageKey
+ * \param data - the encoded image data.
+ * \return the key of the image.
+ */
+QString BitmapImageCache::imageKey(const QByteArray &data)
+{
+  return QString(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+}
+
+/*!
+ * \brief BitmapImageCache::imageLoaded
+ * Slot activated when the image of the request is loaded by BitmapImageLoadTask.\n
+ * Hands the image to the BitmapAnnotation unless the request is cancelled or the BitmapAnnotation is deleted.
+ * \param requestId
+ * \param key
+ * \param image
+ */
+void BitmapImageCache::imageLoaded(int requestId, QString key, QImage image)
+{
+  QPointer<BitmapAnnotation> pBitmapAnnotation = mImageRequestsHash.take(requestId);
+  if (pBitmapAnnotation) {
+    pBitmapAnnotation->setLoadedImage(key, image);
+  }
+}
+
+/*!
+ * \class BitmapImageLoadTask
+ * \brief Loads the image of a BitmapImageCache request in the thread pool.
+ */
+/*!
+ * \brief BitmapImageLoadTask::BitmapImageLoadTask
+ * \param requestId
+ * \param fileName
+ * \param imageSource
+ * \param pBitmapImageCache
+ */
+BitmapImageLoadTask::BitmapImageLoadTask(int requestId, QString fileName, QString imageSource, BitmapImageCache *pBitmapImageCache)
+  : mRequestId(requestId), mFileName(fileName), mImageSource(imageSource), mpBitmapImageCache(pBitmapImageCache)
+{
+}
+
+void BitmapImageLoadTask::run()
+{
+  QString key;
+  QImage image = mpBitmapImageCache->loadImage(mFileName, mImageSource, &key);
+  QMetaObject::invokeMethod(mpBitmapImageCache, "imageLoaded", Qt::QueuedConnection, Q_ARG(int, mRequestId), Q_ARG(QString, key),
+                            Q_ARG(QImage, image));
+}
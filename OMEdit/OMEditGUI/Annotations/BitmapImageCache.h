@@ -0,0 +1,91 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef BITMAPIMAGECACHE_H
+#define BITMAPIMAGECACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QImage>
+#include <QCache>
+#include <QHash>
+#include <QPair>
+#include <QDateTime>
+#include <QMutex>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+
+class BitmapAnnotation;
+class BitmapImageCache : public QObject
+{
+  Q_OBJECT
+public:
+  BitmapImageCache(int maximumCost = 64 * 1024);
+  ~BitmapImageCache();
+  bool getCachedImage(QString fileName, QString imageSource, QString *pKey, QImage *pImage);
+  QImage loadImage(QString fileName, QString imageSource, QString *pKey);
+  int requestImage(QString fileName, QString imageSource, BitmapAnnotation *pBitmapAnnotation);
+  void cancelImageRequest(int requestId);
+  QImage getScaledImage(QString key, QImage image, QSize size);
+private:
+  QMutex mCacheMutex;
+  QCache<QString, QImage> mImagesCache;
+  QHash<QString, QPair<QDateTime, QString> > mFileKeysHash;
+  QThreadPool *mpImagesThreadPool;
+  int mLastImageRequestId;
+  QHash<int, QPointer<BitmapAnnotation> > mImageRequestsHash;
+
+  static QString imageKey(const QByteArray &data);
+public slots:
+  void imageLoaded(int requestId, QString key, QImage image);
+};
+
+class BitmapImageLoadTask : public QRunnable
+{
+public:
+  BitmapImageLoadTask(int requestId, QString fileName, QString imageSource, BitmapImageCache *pBitmapImageCache);
+  virtual void run();
+private:
+  int mRequestId;
+  QString mFileName;
+  QString mImageSource;
+  BitmapImageCache *mpBitmapImageCache;
+};
+
+#endif // BITMAPIMAGECACHE_H
@@ -38,7 +38,7 @@
 
 #include "EllipseAnnotation.h"
 
-EllipseAnnotation::EllipseAnnotation(QString annotation, Component *pParent)
+EllipseAnnotation::EllipseAnnotation(const AnnotationNode &annotation, Component *pParent)
   : ShapeAnnotation(pParent)
 {
   // set the default values
@@ -50,7 +50,15 @@ EllipseAnnotation::EllipseAnnotation(QString annotation, Component *pParent)
   setRotation(mRotation);
 }
 
-EllipseAnnotation::EllipseAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView)
+EllipseAnnotation::EllipseAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent)
+  : ShapeAnnotation(pParent)
+{
+  updateShape(pShapeAnnotation);
+  setPos(mOrigin);
+  setRotation(mRotation);
+}
+
+EllipseAnnotation::EllipseAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView)
   : ShapeAnnotation(inheritedShape, pGraphicsView, 0)
 {
   // set the default values
@@ -66,30 +74,28 @@ EllipseAnnotation::EllipseAnnotation(QString annotation, bool inheritedShape, Gr
   connect(this, SIGNAL(updateClassAnnotation()), mpGraphicsView, SLOT(addClassAnnotation()));
 }
 
-void EllipseAnnotation::parseShapeAnnotation(QString annotation)
+void EllipseAnnotation::parseShapeAnnotation(const AnnotationNode &list)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
-  // parse the shape to get the list of attributes of Ellipse.
-  QStringList list = StringHandler::getStrings(annotation);
+  // list contains the arguments of the Ellipse shape.
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 11)
   {
     return;
   }
   // 9th item is the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)));
+  AnnotationNode extentsList = list.at(8);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++)
   {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2)
+    if (extentsList.at(i).size() >= 2)
     {
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+      mExtents.replace(i, extentsList.at(i).toPointF());
     }
   }
   // 10th item of the list contains the start angle.
-  mStartAngle = list.at(9).toFloat();
+  mStartAngle = list.at(9).toDouble();
   // 11th item of the list contains the end angle.
-  mEndAngle = list.at(10).toFloat();
+  mEndAngle = list.at(10).toDouble();
 }
 
 QRectF EllipseAnnotation::boundingRect() const
@@ -122,7 +128,7 @@ void EllipseAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
-  if (mVisible)
+  if (mVisible && !isBelowLevelOfDetail(painter, qMax(boundingRect().width(), boundingRect().height()), 2))
   {
     drawEllipseAnnotaion(painter);
   }
@@ -179,7 +185,7 @@ QString EllipseAnnotation::getShapeAnnotation()
 
 void EllipseAnnotation::duplicate()
 {
-  EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation("", false, mpGraphicsView);
+  EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(AnnotationNode(), false, mpGraphicsView);
   QPointF gridStep(mpGraphicsView->getCoOrdinateSystem()->getHorizontalGridStep(),
                    mpGraphicsView->getCoOrdinateSystem()->getVerticalGridStep());
   pEllipseAnnotation->setOrigin(mOrigin + gridStep);
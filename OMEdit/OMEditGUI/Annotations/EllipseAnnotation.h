@@ -48,9 +48,10 @@ class EllipseAnnotation : public ShapeAnnotation
 {
   Q_OBJECT
 public:
-  EllipseAnnotation(QString annotation, Component *pParent);
-  EllipseAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView);
-  void parseShapeAnnotation(QString annotation);
+  EllipseAnnotation(const AnnotationNode &annotation, Component *pParent);
+  EllipseAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
+  EllipseAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
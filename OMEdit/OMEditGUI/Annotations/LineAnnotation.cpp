@@ -38,7 +38,7 @@
 
 #include "LineAnnotation.h"
 
-LineAnnotation::LineAnnotation(QString annotation, Component *pParent)
+LineAnnotation::LineAnnotation(const AnnotationNode &annotation, Component *pParent)
   : ShapeAnnotation(pParent)
 {
   mLineType = LineAnnotation::ComponentType;
@@ -52,7 +52,18 @@ LineAnnotation::LineAnnotation(QString annotation, Component *pParent)
   setRotation(mRotation);
 }
 
-LineAnnotation::LineAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView)
+LineAnnotation::LineAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent)
+  : ShapeAnnotation(pParent)
+{
+  mLineType = LineAnnotation::ComponentType;
+  setStartComponent(0);
+  setEndComponent(0);
+  updateShape(pShapeAnnotation);
+  setPos(mOrigin);
+  setRotation(mRotation);
+}
+
+LineAnnotation::LineAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView)
   : ShapeAnnotation(inheritedShape, pGraphicsView, 0)
 {
   mLineType = LineAnnotation::ShapeType;
@@ -105,7 +116,8 @@ LineAnnotation::LineAnnotation(QString annotation, bool inheritedShape, Componen
   setStartComponent(pStartComponent);
   // set the end component
   setEndComponent(pEndComponent);
-  parseShapeAnnotation(annotation);
+  AnnotationTree annotationTree(annotation);
+  parseShapeAnnotation(annotationTree.getRoot());
   /* make the points relative to origin */
   QList<QPointF> points;
   for (int i = 0 ; i < mPoints.size() ; i++) {
@@ -118,45 +130,38 @@ LineAnnotation::LineAnnotation(QString annotation, bool inheritedShape, Componen
   mpGraphicsView->scene()->addItem(this);
 }
 
-void LineAnnotation::parseShapeAnnotation(QString annotation)
+void LineAnnotation::parseShapeAnnotation(const AnnotationNode &list)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  // parse the shape to get the list of attributes of Line.
-  QStringList list = StringHandler::getStrings(annotation);
+  // list contains the arguments of the Line shape.
+  GraphicItem::parseShapeAnnotation(list);
   if (list.size() < 10) {
     return;
   }
   // 4th item of list contains the points.
-  QStringList pointsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(3)));
-  foreach (QString point, pointsList) {
-    QStringList linePoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(point));
-    if (linePoints.size() >= 2) {
-      addPoint(QPointF(linePoints.at(0).toFloat(), linePoints.at(1).toFloat()));
+  AnnotationNode pointsList = list.at(3);
+  for (int i = 0 ; i < pointsList.size() ; i++) {
+    if (pointsList.at(i).size() >= 2) {
+      addPoint(pointsList.at(i).toPointF());
     }
   }
   // 5th item of list contains the color.
-  QStringList colorList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(4)));
-  if (colorList.size() >= 3) {
-    int red, green, blue = 0;
-    red = colorList.at(0).toInt();
-    green = colorList.at(1).toInt();
-    blue = colorList.at(2).toInt();
-    mLineColor = QColor (red, green, blue);
+  if (list.at(4).size() >= 3) {
+    mLineColor = list.at(4).toColor();
   }
   // 6th item of list contains the Line Pattern.
-  mLinePattern = StringHandler::getLinePatternType(list.at(5));
+  mLinePattern = StringHandler::getLinePatternType(list.at(5).toRawString());
   // 7th item of list contains the Line thickness.
-  mLineThickness = list.at(6).toFloat();
+  mLineThickness = list.at(6).toDouble();
   // 8th item of list contains the Line Arrows.
-  QStringList arrowList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(7)));
+  AnnotationNode arrowList = list.at(7);
   if (arrowList.size() >= 2) {
-    mArrow.replace(0, StringHandler::getArrowType(arrowList.at(0)));
-    mArrow.replace(1, StringHandler::getArrowType(arrowList.at(1)));
+    mArrow.replace(0, StringHandler::getArrowType(arrowList.at(0).toRawString()));
+    mArrow.replace(1, StringHandler::getArrowType(arrowList.at(1).toRawString()));
   }
   // 9th item of list contains the Line Arrow Size.
-  mArrowSize = list.at(8).toFloat();
+  mArrowSize = list.at(8).toDouble();
   // 10th item of list contains the smooth.
-  mSmooth = StringHandler::getSmoothType(list.at(9));
+  mSmooth = StringHandler::getSmoothType(list.at(9).toRawString());
 }
 
 QPainterPath LineAnnotation::getShape() const
@@ -209,7 +214,7 @@ void LineAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *op
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
-  if (mVisible) {
+  if (mVisible && !isBelowLevelOfDetail(painter, qMax(boundingRect().width(), boundingRect().height()), 2)) {
     drawLineAnnotaion(painter);
   }
 }
@@ -569,6 +574,21 @@ QString LineAnnotation::getEndComponentName()
   return mEndComponentName;
 }
 
+/*!
+ * \brief LineAnnotation::setConnectionAnnotation
+ * Sets the connection annotation read from OMC. It is used to find the unchanged connections when the diagram is updated incrementally.
+ * \param annotation
+ */
+void LineAnnotation::setConnectionAnnotation(QString annotation)
+{
+  mConnectionAnnotation = annotation;
+}
+
+QString LineAnnotation::getConnectionAnnotation()
+{
+  return mConnectionAnnotation;
+}
+
 /*!
   Sets the shape flags.
   */
@@ -654,13 +674,15 @@ void LineAnnotation::updateConnectionAnnotation()
     pOMCProxy->updateConnection(getStartComponentName(), getEndComponentName(),
                                 mpGraphicsView->getModelWidget()->getLibraryTreeNode()->getNameStructure(), annotationString);
   }
+  // the connection annotation read from OMC is outdated now.
+  mConnectionAnnotation.clear();
   // make the model modified
   mpGraphicsView->getModelWidget()->setModelModified();
 }
 
 void LineAnnotation::duplicate()
 {
-  LineAnnotation *pLineAnnotation = new LineAnnotation("", false, mpGraphicsView);
+  LineAnnotation *pLineAnnotation = new LineAnnotation(AnnotationNode(), false, mpGraphicsView);
   QPointF gridStep(mpGraphicsView->getCoOrdinateSystem()->getHorizontalGridStep(),
                    mpGraphicsView->getCoOrdinateSystem()->getVerticalGridStep());
   pLineAnnotation->setOrigin(mOrigin + gridStep);
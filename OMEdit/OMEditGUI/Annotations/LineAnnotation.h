@@ -53,11 +53,12 @@ public:
     ConnectionType,  /* Line is a connection. */
     ShapeType  /* Line is a custom shape. */
   };
-  LineAnnotation(QString annotation, Component *pParent);
-  LineAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView);
+  LineAnnotation(const AnnotationNode &annotation, Component *pParent);
+  LineAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
+  LineAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView);
   LineAnnotation(Component *pStartComponent, GraphicsView *pGraphicsView);
   LineAnnotation(QString annotation, bool inheritedShape, Component *pStartComponent, Component *pEndComponent, GraphicsView *pGraphicsView);
-  void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QPainterPath getShape() const;
   QRectF boundingRect() const;
   QPainterPath shape() const;
@@ -81,6 +82,8 @@ public:
   QString getStartComponentName();
   void setEndComponentName(QString name);
   QString getEndComponentName();
+  void setConnectionAnnotation(QString annotation);
+  QString getConnectionAnnotation();
   void setShapeFlags(bool enable);
 private:
   LineType mLineType;
@@ -88,6 +91,7 @@ private:
   QString mStartComponentName;
   Component *mpEndComponent;
   QString mEndComponentName;
+  QString mConnectionAnnotation;
 public slots:
   void handleComponentMoved();
   void handleComponentRotation();
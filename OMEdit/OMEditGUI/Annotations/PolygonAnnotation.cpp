@@ -38,7 +38,7 @@
 
 #include "PolygonAnnotation.h"
 
-PolygonAnnotation::PolygonAnnotation(QString annotation, Component *pParent)
+PolygonAnnotation::PolygonAnnotation(const AnnotationNode &annotation, Component *pParent)
   : ShapeAnnotation(pParent)
 {
   // set the default values
@@ -50,7 +50,15 @@ PolygonAnnotation::PolygonAnnotation(QString annotation, Component *pParent)
   setRotation(mRotation);
 }
 
-PolygonAnnotation::PolygonAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView)
+PolygonAnnotation::PolygonAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent)
+  : ShapeAnnotation(pParent)
+{
+  updateShape(pShapeAnnotation);
+  setPos(mOrigin);
+  setRotation(mRotation);
+}
+
+PolygonAnnotation::PolygonAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView)
   : ShapeAnnotation(inheritedShape, pGraphicsView, 0)
 {
   // set the default values
@@ -66,21 +74,19 @@ PolygonAnnotation::PolygonAnnotation(QString annotation, bool inheritedShape, Gr
   connect(this, SIGNAL(updateClassAnnotation()), mpGraphicsView, SLOT(addClassAnnotation()));
 }
 
-void PolygonAnnotation::parseShapeAnnotation(QString annotation)
+void PolygonAnnotation::parseShapeAnnotation(const AnnotationNode &list)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
-  // parse the shape to get the list of attributes of Polygon.
-  QStringList list = StringHandler::getStrings(annotation);
+  // list contains the arguments of the Polygon shape.
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 10)
     return;
   // 9th item of list contains the points.
-  QStringList pointsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)));
-  foreach (QString point, pointsList)
+  AnnotationNode pointsList = list.at(8);
+  for (int i = 0 ; i < pointsList.size() ; i++)
   {
-    QStringList polygonPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(point));
-    if (polygonPoints.size() >= 2)
-      mPoints.append(QPointF(polygonPoints.at(0).toFloat(), polygonPoints.at(1).toFloat()));
+    if (pointsList.at(i).size() >= 2)
+      mPoints.append(pointsList.at(i).toPointF());
   }
   /* The polygon is automatically closed, if the first and the last points are not identical. */
   if (mPoints.size() == 1)
@@ -96,7 +102,7 @@ void PolygonAnnotation::parseShapeAnnotation(QString annotation)
     if (mPoints.first() != mPoints.last())
       mPoints.append(mPoints.first());
   // 10th item of the list is smooth.
-  mSmooth = StringHandler::getSmoothType(list.at(9));
+  mSmooth = StringHandler::getSmoothType(list.at(9).toRawString());
 }
 
 QPainterPath PolygonAnnotation::getShape() const
@@ -162,7 +168,7 @@ void PolygonAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
-  if (mVisible)
+  if (mVisible && !isBelowLevelOfDetail(painter, qMax(boundingRect().width(), boundingRect().height()), 2))
   {
     drawPolygonAnnotaion(painter);
   }
@@ -234,7 +240,7 @@ void PolygonAnnotation::updateEndPoint(QPointF point)
 
 void PolygonAnnotation::duplicate()
 {
-  PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation("", false, mpGraphicsView);
+  PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(AnnotationNode(), false, mpGraphicsView);
   QPointF gridStep(mpGraphicsView->getCoOrdinateSystem()->getHorizontalGridStep(),
                    mpGraphicsView->getCoOrdinateSystem()->getVerticalGridStep());
   pPolygonAnnotation->setOrigin(mOrigin + gridStep);
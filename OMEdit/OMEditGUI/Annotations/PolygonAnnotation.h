@@ -48,9 +48,10 @@ class PolygonAnnotation : public ShapeAnnotation
 {
   Q_OBJECT
 public:
-  PolygonAnnotation(QString annotation, Component *pParent);
-  PolygonAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView);
-  void parseShapeAnnotation(QString annotation);
+  PolygonAnnotation(const AnnotationNode &annotation, Component *pParent);
+  PolygonAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
+  PolygonAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QPainterPath getShape() const;
   QRectF boundingRect() const;
   QPainterPath shape() const;
@@ -38,7 +38,7 @@
 
 #include "RectangleAnnotation.h"
 
-RectangleAnnotation::RectangleAnnotation(QString annotation, Component *pParent)
+RectangleAnnotation::RectangleAnnotation(const AnnotationNode &annotation, Component *pParent)
   : ShapeAnnotation(pParent)
 {
   // set the default values
@@ -50,7 +50,15 @@ RectangleAnnotation::RectangleAnnotation(QString annotation, Component *pParent)
   setRotation(mRotation);
 }
 
-RectangleAnnotation::RectangleAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView)
+RectangleAnnotation::RectangleAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent)
+  : ShapeAnnotation(pParent)
+{
+  updateShape(pShapeAnnotation);
+  setPos(mOrigin);
+  setRotation(mRotation);
+}
+
+RectangleAnnotation::RectangleAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView)
   : ShapeAnnotation(inheritedShape, pGraphicsView, 0)
 {
   // set the default values
@@ -66,26 +74,24 @@ RectangleAnnotation::RectangleAnnotation(QString annotation, bool inheritedShape
   connect(this, SIGNAL(updateClassAnnotation()), mpGraphicsView, SLOT(addClassAnnotation()));
 }
 
-void RectangleAnnotation::parseShapeAnnotation(QString annotation)
+void RectangleAnnotation::parseShapeAnnotation(const AnnotationNode &list)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
-  // parse the shape to get the list of attributes of Rectangle.
-  QStringList list = StringHandler::getStrings(annotation);
+  // list contains the arguments of the Rectangle shape.
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 11)
     return;
   // 9th item of the list contains the border pattern.
-  mBorderPattern = StringHandler::getBorderPatternType(list.at(8));
+  mBorderPattern = StringHandler::getBorderPatternType(list.at(8).toRawString());
   // 10th item is the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(9)));
+  AnnotationNode extentsList = list.at(9);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++)
   {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2)
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    if (extentsList.at(i).size() >= 2)
+      mExtents.replace(i, extentsList.at(i).toPointF());
   }
   // 11th item of the list contains the corner radius.
-  mRadius = list.at(10).toFloat();
+  mRadius = list.at(10).toDouble();
 }
 
 QRectF RectangleAnnotation::boundingRect() const
@@ -107,7 +113,7 @@ void RectangleAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsIte
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
-  if (mVisible)
+  if (mVisible && !isBelowLevelOfDetail(painter, qMax(boundingRect().width(), boundingRect().height()), 2))
     drawRectangleAnnotaion(painter);
 }
 
@@ -146,7 +152,7 @@ QString RectangleAnnotation::getShapeAnnotation()
 
 void RectangleAnnotation::duplicate()
 {
-  RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation("", false, mpGraphicsView);
+  RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(AnnotationNode(), false, mpGraphicsView);
   QPointF gridStep(mpGraphicsView->getCoOrdinateSystem()->getHorizontalGridStep(),
                    mpGraphicsView->getCoOrdinateSystem()->getVerticalGridStep());
   pRectangleAnnotation->setOrigin(mOrigin + gridStep);
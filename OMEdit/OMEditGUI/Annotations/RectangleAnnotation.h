@@ -48,9 +48,10 @@ class RectangleAnnotation : public ShapeAnnotation
 {
   Q_OBJECT
 public:
-  RectangleAnnotation(QString annotation, Component *pParent);
-  RectangleAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView);
-  void parseShapeAnnotation(QString annotation);
+  RectangleAnnotation(const AnnotationNode &annotation, Component *pParent);
+  RectangleAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pParent);
+  RectangleAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
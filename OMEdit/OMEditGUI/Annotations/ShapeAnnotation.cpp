@@ -39,6 +39,7 @@
 #include "ShapeAnnotation.h"
 #include "ModelWidgetContainer.h"
 #include "ShapePropertiesDialog.h"
+#include <QStyleOptionGraphicsItem>
 
 /*!
   Sets the default value.
@@ -52,25 +53,21 @@ void GraphicItem::setDefaults()
 
 /*!
   Parses the GraphicItem annotation values.
-  \param annotation - the annotation string.
+  \param list - the parsed annotation values.
   */
-void GraphicItem::parseShapeAnnotation(QString annotation)
+void GraphicItem::parseShapeAnnotation(const AnnotationNode &list)
 {
-  // parse the shape to get the list of attributes
-  QStringList list = StringHandler::getStrings(annotation);
   if (list.size() < 3)
     return;
   // if first item of list is true then the shape should be visible.
-  mVisible = list.at(0).contains("true");
+  mVisible = list.at(0).toRawString().contains("true");
   // 2nd item is the origin
-  QStringList originList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(1)));
-  if (originList.size() >= 2)
+  if (list.at(1).size() >= 2)
   {
-    mOrigin.setX(originList.at(0).toFloat());
-    mOrigin.setY(originList.at(1).toFloat());
+    mOrigin = list.at(1).toPointF();
   }
   // 3rd item is the rotation
-  mRotation = list.at(2).toFloat();
+  mRotation = list.at(2).toDouble();
 }
 
 /*!
@@ -153,40 +150,28 @@ void FilledShape::setDefaults()
 
 /*!
   Parses the FilledShape annotation values.
-  \param annotation - the annotation string.
+  \param list - the parsed annotation values.
   */
-void FilledShape::parseShapeAnnotation(QString annotation)
+void FilledShape::parseShapeAnnotation(const AnnotationNode &list)
 {
-  // parse the shape to get the list of attributes
-  QStringList list = StringHandler::getStrings(annotation);
   if (list.size() < 8)
     return;
   // 4th item of the list is the line color
-  QStringList colorList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(3)));
-  if (colorList.size() >= 3)
+  if (list.at(3).size() >= 3)
   {
-    int red, green, blue = 0;
-    red = colorList.at(0).toInt();
-    green = colorList.at(1).toInt();
-    blue = colorList.at(2).toInt();
-    mLineColor = QColor (red, green, blue);
+    mLineColor = list.at(3).toColor();
   }
   // 5th item of list contains the fill color.
-  QStringList fillColorList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(4)));
-  if (fillColorList.size() >= 3)
+  if (list.at(4).size() >= 3)
   {
-    int red, green, blue = 0;
-    red = fillColorList.at(0).toInt();
-    green = fillColorList.at(1).toInt();
-    blue = fillColorList.at(2).toInt();
-    mFillColor = QColor (red, green, blue);
+    mFillColor = list.at(4).toColor();
   }
   // 6th item of list contains the Line Pattern.
-  mLinePattern = StringHandler::getLinePatternType(list.at(5));
+  mLinePattern = StringHandler::getLinePatternType(list.at(5).toRawString());
   // 7th item of list contains the Fill Pattern.
-  mFillPattern = StringHandler::getFillPatternType(list.at(6));
+  mFillPattern = StringHandler::getFillPatternType(list.at(6).toRawString());
   // 8th item of list contains the thickness.
-  mLineThickness = list.at(7).toFloat();
+  mLineThickness = list.at(7).toDouble();
 }
 
 /*!
@@ -337,6 +322,7 @@ ShapeAnnotation::ShapeAnnotation(QGraphicsItem *pParent)
   mIsInheritedShape = false;
   setOldPosition(QPointF(0, 0));
   mIsCornerItemClicked = false;
+  mLevelOfDetail = false;
 }
 
 /*!
@@ -353,6 +339,7 @@ ShapeAnnotation::ShapeAnnotation(bool inheritedShape, GraphicsView *pGraphicsVie
   mIsInheritedShape = inheritedShape;
   setOldPosition(QPointF(0, 0));
   mIsCornerItemClicked = false;
+  mLevelOfDetail = false;
   createActions();
 }
 
@@ -427,6 +414,48 @@ void ShapeAnnotation::setUserDefaults()
   mFillPattern = StringHandler::getFillPatternType(pOptionsDialog->getFillStylePage()->getFillPattern());
 }
 
+/*!
+ * \brief ShapeAnnotation::updateShape
+ * Copies the parsed annotation values of the shape. The shapes of the components are created from the shared parsed shapes
+ * of the ComponentClassCache so the annotation is not parsed for every component.
+ * \param pShapeAnnotation
+ */
+void ShapeAnnotation::updateShape(ShapeAnnotation *pShapeAnnotation)
+{
+  // GraphicItem
+  mVisible = pShapeAnnotation->mVisible;
+  mOrigin = pShapeAnnotation->mOrigin;
+  mRotation = pShapeAnnotation->mRotation;
+  // FilledShape
+  mLineColor = pShapeAnnotation->mLineColor;
+  mFillColor = pShapeAnnotation->mFillColor;
+  mLinePattern = pShapeAnnotation->mLinePattern;
+  mFillPattern = pShapeAnnotation->mFillPattern;
+  mLineThickness = pShapeAnnotation->mLineThickness;
+  // ShapeAnnotation
+  mPoints = pShapeAnnotation->mPoints;
+  mGeometries = pShapeAnnotation->mGeometries;
+  mArrow = pShapeAnnotation->mArrow;
+  mArrowSize = pShapeAnnotation->mArrowSize;
+  mSmooth = pShapeAnnotation->mSmooth;
+  mExtents = pShapeAnnotation->mExtents;
+  mBorderPattern = pShapeAnnotation->mBorderPattern;
+  mRadius = pShapeAnnotation->mRadius;
+  mStartAngle = pShapeAnnotation->mStartAngle;
+  mEndAngle = pShapeAnnotation->mEndAngle;
+  mOriginalTextString = pShapeAnnotation->mOriginalTextString;
+  mTextString = pShapeAnnotation->mTextString;
+  mFontSize = pShapeAnnotation->mFontSize;
+  mFontName = pShapeAnnotation->mFontName;
+  mTextStyles = pShapeAnnotation->mTextStyles;
+  mHorizontalAlignment = pShapeAnnotation->mHorizontalAlignment;
+  mOriginalFileName = pShapeAnnotation->mOriginalFileName;
+  mFileName = pShapeAnnotation->mFileName;
+  mClassFileName = pShapeAnnotation->mClassFileName;
+  mImageSource = pShapeAnnotation->mImageSource;
+  mImage = pShapeAnnotation->mImage;
+}
+
 bool ShapeAnnotation::isInheritedShape()
 {
   return mIsInheritedShape;
@@ -505,6 +534,23 @@ void ShapeAnnotation::applyLinePattern(QPainter *painter)
   painter->setPen(pen);
 }
 
+/*!
+ * \brief ShapeAnnotation::isBelowLevelOfDetail
+ * Returns true if the level of detail is enabled and the size is drawn smaller than minimumSize pixels.
+ * Selected shapes are always drawn.
+ * \param painter
+ * \param size - the size in item coordinates.
+ * \param minimumSize - the minimum size in pixels.
+ * \return
+ */
+bool ShapeAnnotation::isBelowLevelOfDetail(QPainter *painter, qreal size, qreal minimumSize) const
+{
+  if (!mLevelOfDetail || isSelected()) {
+    return false;
+  }
+  return size * QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()) < minimumSize;
+}
+
 /*!
   Applies the shape fill pattern.
   \param painter - pointer to QPainter
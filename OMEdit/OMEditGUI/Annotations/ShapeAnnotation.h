@@ -51,6 +51,7 @@
 #include "Helper.h"
 #include "StringHandler.h"
 #include "Transformation.h"
+#include "AnnotationTree.h"
 
 class MainWindow;
 class GraphicsView;
@@ -62,7 +63,7 @@ class GraphicItem
 public:
   GraphicItem() {}
   void setDefaults();
-  void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QStringList getShapeAnnotation();
   void setOrigin(QPointF origin);
   QPointF getOrigin();
@@ -79,7 +80,7 @@ class FilledShape
 public:
   FilledShape() {}
   void setDefaults();
-  void parseShapeAnnotation(QString annotation);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QStringList getShapeAnnotation();
   void setLineColor(QColor color);
   QColor getLineColor();
@@ -108,6 +109,7 @@ private:
   bool mIsInheritedShape;
   QPointF mOldPosition;
   bool mIsCornerItemClicked;
+  bool mLevelOfDetail;
   QAction *mpShapePropertiesAction;
   QAction *mpManhattanizeShapeAction;
 public:
@@ -117,12 +119,15 @@ public:
   ~ShapeAnnotation();
   void setDefaults();
   void setUserDefaults();
+  void updateShape(ShapeAnnotation *pShapeAnnotation);
   bool isInheritedShape();
   void createActions();
   QPainterPath addPathStroker(QPainterPath &path) const;
   QRectF getBoundingRect() const;
   void applyLinePattern(QPainter *painter);
   void applyFillPattern(QPainter *painter);
+  void setLevelOfDetail(bool levelOfDetail) {mLevelOfDetail = levelOfDetail;}
+  bool isBelowLevelOfDetail(QPainter *painter, qreal size, qreal minimumSize) const;
   virtual QString getShapeAnnotation();
   void initializeTransformation();
   void drawCornerItems();
@@ -171,7 +176,7 @@ public:
   QString getFileName();
   void setImageSource(QString imageSource);
   QString getImageSource();
-  void setImage(QImage image);
+  virtual void setImage(QImage image);
   QImage getImage();
   void rotateClockwise();
   void rotateAntiClockwise();
@@ -765,6 +765,7 @@ bool ShapePropertiesDialog::applyShapeProperties()
     if (mpTextUnderlineCheckBox->isChecked()) textStyles.append(StringHandler::TextStyleUnderLine);
     mpShapeAnnotation->setTextStyles(textStyles);
     mpShapeAnnotation->setTextHorizontalAlignment(StringHandler::getTextAlignmentType(mpTextHorizontalAlignmentComboBox->currentText()));
+    mpTextAnnotation->updateOverflowingRect();
   }
   mpShapeAnnotation->setLineColor(getLineColor());
   mpShapeAnnotation->setLinePattern(StringHandler::getLinePatternType(mpLinePatternComboBox->currentText()));
@@ -44,10 +44,10 @@
  */
 /*!
  * \brief TextAnnotation::TextAnnotation
- * \param annotation - text annotation string.
+ * \param annotation - the arguments of the text annotation.
  * \param pComponent - pointer to Component
  */
-TextAnnotation::TextAnnotation(QString annotation, Component *pComponent)
+TextAnnotation::TextAnnotation(const AnnotationNode &annotation, Component *pComponent)
   : ShapeAnnotation(pComponent), mpComponent(pComponent)
 {
   // set the default values
@@ -61,11 +61,29 @@ TextAnnotation::TextAnnotation(QString annotation, Component *pComponent)
 
 /*!
  * \brief TextAnnotation::TextAnnotation
- * \param annotation - text annotation string.
+ * \param pShapeAnnotation - the parsed text shape to copy.
+ * \param pComponent - pointer to Component
+ */
+TextAnnotation::TextAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pComponent)
+  : ShapeAnnotation(pComponent), mpComponent(pComponent)
+{
+  updateShape(pShapeAnnotation);
+  if (mpComponent && mOriginalTextString.contains("%"))
+  {
+    updateTextString();
+    connect(mpComponent->getRootParentComponent(), SIGNAL(componentDisplayTextChanged()), SLOT(updateTextString()));
+  }
+  setPos(mOrigin);
+  setRotation(mRotation);
+}
+
+/*!
+ * \brief TextAnnotation::TextAnnotation
+ * \param annotation - the arguments of the text annotation.
  * \param inheritedShape
  * \param pGraphicsView - pointer to GraphicsView
  */
-TextAnnotation::TextAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView)
+TextAnnotation::TextAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView)
   : ShapeAnnotation(inheritedShape, pGraphicsView, 0)
 {
   mpComponent = 0;
@@ -80,31 +98,30 @@ TextAnnotation::TextAnnotation(QString annotation, bool inheritedShape, Graphics
   mpGraphicsView->addShapeObject(this);
   mpGraphicsView->scene()->addItem(this);
   connect(this, SIGNAL(updateClassAnnotation()), mpGraphicsView, SLOT(addClassAnnotation()));
+  updateOverflowingRect();
 }
 
 /*!
  * \brief TextAnnotation::parseShapeAnnotation
- * Parses the text annotation string
- * \param annotation - text annotation string.
+ * Reads the text annotation.
+ * \param list - the arguments of the text annotation.
  */
-void TextAnnotation::parseShapeAnnotation(QString annotation)
+void TextAnnotation::parseShapeAnnotation(const AnnotationNode &list)
 {
-  GraphicItem::parseShapeAnnotation(annotation);
-  FilledShape::parseShapeAnnotation(annotation);
-  // parse the shape to get the list of attributes of Text.
-  QStringList list = StringHandler::getStrings(annotation);
+  // list contains the arguments of the Text shape.
+  GraphicItem::parseShapeAnnotation(list);
+  FilledShape::parseShapeAnnotation(list);
   if (list.size() < 11)
     return;
   // 9th item of the list contains the extent points
-  QStringList extentsList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)));
+  AnnotationNode extentsList = list.at(8);
   for (int i = 0 ; i < qMin(extentsList.size(), 2) ; i++)
   {
-    QStringList extentPoints = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(extentsList[i]));
-    if (extentPoints.size() >= 2)
-      mExtents.replace(i, QPointF(extentPoints.at(0).toFloat(), extentPoints.at(1).toFloat()));
+    if (extentsList.at(i).size() >= 2)
+      mExtents.replace(i, extentsList.at(i).toPointF());
   }
   // 10th item of the list contains the textString.
-  mOriginalTextString = StringHandler::removeFirstLastQuotes(list.at(9));
+  mOriginalTextString = list.at(9).toString();
   mTextString = mOriginalTextString;
   if (mpComponent)
   {
@@ -115,54 +132,47 @@ void TextAnnotation::parseShapeAnnotation(QString annotation)
     }
   }
   // 11th item of the list contains the fontSize.
-  mFontSize = list.at(10).toFloat();
+  mFontSize = list.at(10).toDouble();
   //Now comes the optional parameters; fontName and textStyle.
-  annotation = annotation.replace("{", "");
-  annotation = annotation.replace("}", "");
-  // parse the shape to get the list of attributes of Text Annotation.
-  list = StringHandler::getStrings(annotation);
-  int index = 19;
-  while(index < list.size())
+  for (int i = 11 ; i < list.size() ; i++)
   {
-    QString annotationValue = StringHandler::removeFirstLastQuotes(list.at(index));
-    // check textStyles enumeration.
-    if(annotationValue == "TextStyle.Bold")
-    {
-      mTextStyles.append(StringHandler::TextStyleBold);
-      index++;
-    }
-    else if(annotationValue == "TextStyle.Italic")
-    {
-      mTextStyles.append(StringHandler::TextStyleItalic);
-      index++;
-    }
-    else if(annotationValue == "TextStyle.UnderLine")
-    {
-      mTextStyles.append(StringHandler::TextStyleUnderLine);
-      index++;
-    }
-    // check textAlignment enumeration.
-    else if(annotationValue == "TextAlignment.Left")
-    {
-      mHorizontalAlignment = StringHandler::TextAlignmentLeft;
-      index++;
-    }
-    else if(annotationValue == "TextAlignment.Center")
-    {
-      mHorizontalAlignment = StringHandler::TextAlignmentCenter;
-      index++;
-    }
-    else if(annotationValue == "TextAlignment.Right")
-    {
-      mHorizontalAlignment = StringHandler::TextAlignmentRight;
-      index++;
-    }
-    else
+    parseTextOptionalAnnotation(list.at(i));
+  }
+}
+
+/*!
+ * \brief TextAnnotation::parseTextOptionalAnnotation
+ * Parses the optional values of the text annotation. The arrays, e.g the text styles, are read element by element.
+ * \param value
+ */
+void TextAnnotation::parseTextOptionalAnnotation(const AnnotationNode &value)
+{
+  if (value.getType() == AnnotationNode::Array)
+  {
+    for (int i = 0 ; i < value.size() ; i++)
     {
-      mFontName = annotationValue;
-      index++;
+      parseTextOptionalAnnotation(value.at(i));
     }
+    return;
   }
+  QString annotationValue = value.toRawString();
+  // check textStyles enumeration.
+  if (annotationValue == "TextStyle.Bold")
+    mTextStyles.append(StringHandler::TextStyleBold);
+  else if (annotationValue == "TextStyle.Italic")
+    mTextStyles.append(StringHandler::TextStyleItalic);
+  else if (annotationValue == "TextStyle.UnderLine")
+    mTextStyles.append(StringHandler::TextStyleUnderLine);
+  // check textAlignment enumeration.
+  else if (annotationValue == "TextAlignment.Left")
+    mHorizontalAlignment = StringHandler::TextAlignmentLeft;
+  else if (annotationValue == "TextAlignment.Center")
+    mHorizontalAlignment = StringHandler::TextAlignmentCenter;
+  else if (annotationValue == "TextAlignment.Right")
+    mHorizontalAlignment = StringHandler::TextAlignmentRight;
+  // the numbers are the text color.
+  else if (value.getType() != AnnotationNode::Number)
+    mFontName = value.toString();
 }
 
 /*!
@@ -198,7 +208,8 @@ void TextAnnotation::paint(QPainter *painter, const QStyleOptionGraphicsItem *op
 {
   Q_UNUSED(option);
   Q_UNUSED(widget);
-  if (mVisible) {
+  /* the texts of the components are drawn with at least 12 points. Don't draw them when they are too small to be read. */
+  if (mVisible && !isBelowLevelOfDetail(painter, qMax(boundingRect().height(), (qreal)12), 4)) {
     drawTextAnnotaion(painter);
   }
 }
@@ -218,37 +229,7 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
   painter->translate(0, ((-boundingRect().top()) - boundingRect().bottom()));
   mTextString = StringHandler::removeFirstLastQuotes(mTextString);
   mTextString = StringHandler::unparse(QString("\"").append(mTextString).append("\""));
-  QFont font;
-  if (mFontSize > 0) {
-    font = QFont(mFontName, mFontSize, StringHandler::getFontWeight(mTextStyles), StringHandler::getFontItalic(mTextStyles));
-    // set font underline
-    if(StringHandler::getFontUnderline(mTextStyles)) {
-      font.setUnderline(true);
-    }
-    font.setPointSizeF(mFontSize/4);
-    painter->setFont(font);
-  } else {
-    font = QFont(mFontName, mFontSize, StringHandler::getFontWeight(mTextStyles), StringHandler::getFontItalic(mTextStyles));
-    // set font underline
-    if(StringHandler::getFontUnderline(mTextStyles)) {
-      font.setUnderline(true);
-    }
-    painter->setFont(font);
-    QRect fontBoundRect = painter->fontMetrics().boundingRect(boundingRect().toRect(), Qt::TextDontClip, mTextString);
-    float xFactor = boundingRect().width() / fontBoundRect.width();
-    float yFactor = boundingRect().height() / fontBoundRect.height();
-    float factor = xFactor < yFactor ? xFactor : yFactor;
-    QFont f = painter->font();
-    qreal fontSizeFactor = f.pointSizeF()*factor;
-    if ((fontSizeFactor < 12) && mpComponent) {
-      f.setPointSizeF(12);
-    } else if (fontSizeFactor <= 0) {
-      f.setPointSizeF(1);
-    } else {
-      f.setPointSizeF(fontSizeFactor);
-    }
-    painter->setFont(f);
-  }
+  painter->setFont(getTextFont(mTextString, painter->device()));
   if (mpComponent) {
     Component *pComponent = mpComponent->getRootParentComponent();
     if (pComponent && pComponent->getTransformation()) {
@@ -278,13 +259,105 @@ void TextAnnotation::drawTextAnnotaion(QPainter *painter)
     }
   }
   // draw the font
-  if (mpComponent) {
-    painter->drawText(boundingRect(), StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip, mTextString);
-  } else if (boundingRect().width() > 0 && boundingRect().height() > 0) {
+  if (mpComponent || (boundingRect().width() > 0 && boundingRect().height() > 0)) {
     painter->drawText(boundingRect(), StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip, mTextString);
   }
 }
 
+/*!
+ * \brief TextAnnotation::getTextFont
+ * Returns the font of the text. The text without a font size is scaled to fit in the bounding rectangle.
+ * \param textString
+ * \param pPaintDevice - the device the text is drawn on or 0 for the screen.
+ * \return
+ */
+QFont TextAnnotation::getTextFont(const QString &textString, QPaintDevice *pPaintDevice)
+{
+  QFont font(mFontName, mFontSize, StringHandler::getFontWeight(mTextStyles), StringHandler::getFontItalic(mTextStyles));
+  // set font underline
+  if (StringHandler::getFontUnderline(mTextStyles)) {
+    font.setUnderline(true);
+  }
+  if (mFontSize > 0) {
+    font.setPointSizeF(mFontSize/4);
+    return font;
+  }
+  QFontMetrics fontMetrics = pPaintDevice ? QFontMetrics(font, pPaintDevice) : QFontMetrics(font);
+  QRect fontBoundRect = fontMetrics.boundingRect(boundingRect().toRect(), Qt::TextDontClip, textString);
+  float xFactor = boundingRect().width() / fontBoundRect.width();
+  float yFactor = boundingRect().height() / fontBoundRect.height();
+  float factor = xFactor < yFactor ? xFactor : yFactor;
+  qreal fontSizeFactor = font.pointSizeF()*factor;
+  if ((fontSizeFactor < 12) && mpComponent) {
+    font.setPointSizeF(12);
+  } else if (fontSizeFactor <= 0) {
+    font.setPointSizeF(1);
+  } else {
+    font.setPointSizeF(fontSizeFactor);
+  }
+  return font;
+}
+
+/*!
+ * \brief TextAnnotation::updateOverflowingRect
+ * The text is drawn unclipped and may overflow its bounding rectangle. When the view only repaints the bounding rectangles of the
+ * changed items, the overflowing text is repainted at its last position and at its current position.\n
+ * The overflowing area is measured again only when the text or the bounding rectangle has changed.
+ * Called when the text or its component moves, is transformed or changes its text.
+ */
+void TextAnnotation::updateOverflowingRect()
+{
+  GraphicsView *pGraphicsView = mpComponent ? mpComponent->getGraphicsView() : mpGraphicsView;
+  /* the library components are only rendered to images so their scenes are never repainted. */
+  if (!scene() || !pGraphicsView || !pGraphicsView->isOptimizeRendering() || (mpComponent && mpComponent->isLibraryComponent())) {
+    return;
+  }
+  QString textString = StringHandler::removeFirstLastQuotes(mTextString);
+  textString = StringHandler::unparse(QString("\"").append(textString).append("\""));
+  QRectF rect = boundingRect();
+  if (textString != mOverflowingTextString || rect != mOverflowingBoundingRect) {
+    mOverflowingTextString = textString;
+    mOverflowingBoundingRect = rect;
+    int flags = StringHandler::getTextAlignment(mHorizontalAlignment) | Qt::AlignVCenter | Qt::TextDontClip;
+    QRectF textRect = QFontMetricsF(getTextFont(textString, 0)).boundingRect(rect, flags, textString);
+    if (rect.contains(textRect)) {
+      mOverflowingRect = QRectF();
+    } else {
+      // the text may be mirrored around the center of the bounding rectangle so grow it on both sides.
+      qreal dx = qMax(qMax(rect.left() - textRect.left(), textRect.right() - rect.right()), (qreal)0);
+      qreal dy = qMax(qMax(rect.top() - textRect.top(), textRect.bottom() - rect.bottom()), (qreal)0);
+      mOverflowingRect = rect.adjusted(-dx, -dy, dx, dy);
+    }
+  }
+  QRectF sceneRect = mOverflowingRect.isNull() ? QRectF() : mapToScene(mOverflowingRect).boundingRect();
+  if (sceneRect == mOverflowingSceneRect) {
+    return;
+  }
+  if (!mOverflowingSceneRect.isNull()) {
+    scene()->update(mOverflowingSceneRect);
+  }
+  if (!sceneRect.isNull()) {
+    scene()->update(sceneRect);
+  }
+  mOverflowingSceneRect = sceneRect;
+}
+
+/*!
+ * \brief TextAnnotation::itemChange
+ * Reimplementation of ShapeAnnotation::itemChange. Repaints the overflowing text when the text shape is moved or transformed.
+ * \param change
+ * \param value
+ * \return
+ */
+QVariant TextAnnotation::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+  QVariant result = ShapeAnnotation::itemChange(change, value);
+  if (change == QGraphicsItem::ItemPositionHasChanged || change == QGraphicsItem::ItemTransformHasChanged) {
+    updateOverflowingRect();
+  }
+  return result;
+}
+
 /*!
  * \brief TextAnnotation::getShapeAnnotation
  * \return the shape annotation in Modelica syntax.
@@ -420,7 +493,7 @@ void TextAnnotation::updateTextString()
  */
 void TextAnnotation::duplicate()
 {
-  TextAnnotation *pTextAnnotation = new TextAnnotation("", false, mpGraphicsView);
+  TextAnnotation *pTextAnnotation = new TextAnnotation(AnnotationNode(), false, mpGraphicsView);
   QPointF gridStep(mpGraphicsView->getCoOrdinateSystem()->getHorizontalGridStep(),
                    mpGraphicsView->getCoOrdinateSystem()->getVerticalGridStep());
   pTextAnnotation->setOrigin(mOrigin + gridStep);
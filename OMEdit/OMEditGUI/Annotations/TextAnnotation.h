@@ -48,18 +48,28 @@ class TextAnnotation : public ShapeAnnotation
 {
   Q_OBJECT
 public:
-  TextAnnotation(QString annotation, Component *pComponent);
-  TextAnnotation(QString annotation, bool inheritedShape, GraphicsView *pGraphicsView);
-  void parseShapeAnnotation(QString annotation);
+  TextAnnotation(const AnnotationNode &annotation, Component *pComponent);
+  TextAnnotation(ShapeAnnotation *pShapeAnnotation, Component *pComponent);
+  TextAnnotation(const AnnotationNode &annotation, bool inheritedShape, GraphicsView *pGraphicsView);
+  void parseShapeAnnotation(const AnnotationNode &list);
   QRectF boundingRect() const;
   QPainterPath shape() const;
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
   void drawTextAnnotaion(QPainter *painter);
+  void updateOverflowingRect();
   QString getShapeAnnotation();
+protected:
+  virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 private:
   Component *mpComponent;
+  QString mOverflowingTextString;
+  QRectF mOverflowingBoundingRect;
+  QRectF mOverflowingRect;
+  QRectF mOverflowingSceneRect;
 
+  void parseTextOptionalAnnotation(const AnnotationNode &value);
   void updateTextStringHelper(QRegExp regExp);
+  QFont getTextFont(const QString &textString, QPaintDevice *pPaintDevice);
 public slots:
   void updateTextString();
   void duplicate();
@@ -38,6 +38,7 @@
 
 #include "Component.h"
 #include "ComponentProperties.h"
+#include "ComponentClass.h"
 
 Component::Component(QString annotation, QString name, QString className, QString fileName, ComponentInfo *pComponentInfo,
                      StringHandler::ModelicaClasses type, QString transformation, QPointF position, bool inheritedComponent,
@@ -83,6 +84,7 @@ Component::Component(QString annotation, QString name, QString className, QStrin
   mpOriginItem = new OriginItem();
   createResizerItems();
   setToolTip(QString("<b>").append(mClassName).append("</b> ").append(mName));
+  setOptimizeRendering(mpGraphicsView->isOptimizeRendering());
   // if everything is fine with icon then add it to scene
   mpGraphicsView->scene()->addItem(this);
   mpGraphicsView->scene()->addItem(mpOriginItem);
@@ -203,164 +205,108 @@ QString Component::getInheritedClassName()
   return mInheritedClassName;
 }
 
+/*!
+ * \brief Component::getClassInheritedComponents
+ * Creates the inherited components from the shared ComponentClass of the class.
+ * \param isRootComponent
+ * \param isPortComponent
+ */
 void Component::getClassInheritedComponents(bool isRootComponent, bool isPortComponent)
 {
-  // read the component inheritance
-  int inheritanceCount = mpOMCProxy->getInheritanceCount(mClassName);
-  for(int i = 1 ; i <= inheritanceCount ; i++)
-  {
-    QString inheritedClass = mpOMCProxy->getNthInheritedClass(mClassName, i);
-    // avoid cycles
-    if (inheritedClass.compare(mClassName) != 0) {
-      // If the inherited class is one of the builtin type such as Real we can
-      // stop here, because the class can not contain any components, etc.
-      if (!mpOMCProxy->isBuiltinType(inheritedClass)) {
-        // get the inherited class annotation
-        StringHandler::ModelicaClasses type = mpOMCProxy->getClassRestriction(inheritedClass);
-        QString annotationString;
-        if (isLibraryComponent() || !isRootComponent) {
-          annotationString = mpOMCProxy->getIconAnnotation(inheritedClass);
-        } else if (type == StringHandler::Connector && mpGraphicsView->getViewType() == StringHandler::Diagram) {
-          annotationString = mpOMCProxy->getDiagramAnnotation(inheritedClass);
-        } else {
-          annotationString = mpOMCProxy->getIconAnnotation(inheritedClass);
-        }
-        Component *pInheritedComponent;
-        pInheritedComponent  = new Component(annotationString, inheritedClass, type, this);
-        /* if component is the port component and it has inherited components then stack its inherited components behind it. */
-        if (isPortComponent) {
-          pInheritedComponent->setFlag(QGraphicsItem::ItemStacksBehindParent);
-        }
-        mInheritanceList.append(pInheritedComponent);
-      }
+  /* the root components of the diagram view show the diagram annotation of the inherited connector classes. */
+  bool diagramConnectorAnnotations = !isLibraryComponent() && isRootComponent && mpGraphicsView->getViewType() == StringHandler::Diagram;
+  ComponentClass *pComponentClass = mpOMCProxy->getComponentClassCache()->getComponentClass(mClassName, diagramConnectorAnnotations);
+  foreach (ComponentClassInheritance inheritance, pComponentClass->getInheritedClasses()) {
+    Component *pInheritedComponent;
+    pInheritedComponent  = new Component(inheritance.mAnnotation, inheritance.mClassName, inheritance.mType, this);
+    /* if component is the port component and it has inherited components then stack its inherited components behind it. */
+    if (isPortComponent) {
+      pInheritedComponent->setFlag(QGraphicsItem::ItemStacksBehindParent);
     }
+    mInheritanceList.append(pInheritedComponent);
   }
 }
 
+/*!
+ * \brief Component::parseAnnotationString
+ * Creates the shapes of the annotation as copies of the parsed shapes shared through the ComponentClassCache.
+ * \param annotation
+ */
 void Component::parseAnnotationString(QString annotation)
 {
-  // parse the annotation string
-  annotation = StringHandler::removeFirstLastCurlBrackets(annotation);
-  if (annotation.isEmpty())
-    return;
-  QStringList list = StringHandler::getStrings(annotation);
-  if (list.size() < 4)
-    return;
+  ComponentIcon *pComponentIcon = mpOMCProxy->getComponentClassCache()->getComponentIcon(annotation);
   // read the coordinate system
-  qreal left = qMin(list.at(0).toFloat(), list.at(2).toFloat());
-  qreal bottom = qMin(list.at(1).toFloat(), list.at(3).toFloat());
-  qreal right = qMax(list.at(0).toFloat(), list.at(2).toFloat());
-  qreal top = qMax(list.at(1).toFloat(), list.at(3).toFloat());
-  QList<QPointF> extent;
-  extent << QPointF(left, bottom) << QPointF(right, top);
-  mpCoOrdinateSystem->setExtent(extent);
-  // if the list is less that 5 then return
-  if (list.size() < 8)
+  if (!pComponentIcon->hasExtent())
     return;
-  // read aspectratio, scale, grid
-  mpCoOrdinateSystem->setPreserveAspectRatio(list.at(4).contains("true"));
-  mpCoOrdinateSystem->setInitialScale(list.at(5).toFloat());
-  qreal horizontal = list.at(6).toFloat();
-  qreal vertical = list.at(7).toFloat();
-  mpCoOrdinateSystem->setGrid(QPointF(horizontal, vertical));
-  // read the shapes
-  if (list.size() < 9)
+  mpCoOrdinateSystem->setExtent(pComponentIcon->getExtent());
+  if (!pComponentIcon->hasCoOrdinateSystem())
     return;
-  QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)), '(', ')');
-  // Now parse the shapes available in list
-  foreach (QString shape, shapesList)
+  // read aspectratio, scale, grid
+  mpCoOrdinateSystem->setPreserveAspectRatio(pComponentIcon->getPreserveAspectRatio());
+  mpCoOrdinateSystem->setInitialScale(pComponentIcon->getInitialScale());
+  mpCoOrdinateSystem->setGrid(pComponentIcon->getGrid());
+  // Now create the shapes available in list
+  foreach (ComponentIconShape shape, pComponentIcon->getShapes())
   {
-    shape = StringHandler::removeFirstLastCurlBrackets(shape);
-    if (shape.startsWith("Line"))
+    if (shape.mShapeName.compare("Line") == 0)
     {
-      shape = shape.mid(QString("Line").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      LineAnnotation *pLineAnnotation = new LineAnnotation(shape, this);
+      LineAnnotation *pLineAnnotation = new LineAnnotation(shape.mpShapeAnnotation, this);
       mShapesList.append(pLineAnnotation);
     }
-    else if (shape.startsWith("Polygon"))
+    else if (shape.mShapeName.compare("Polygon") == 0)
     {
-      shape = shape.mid(QString("Polygon").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(shape, this);
+      PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(shape.mpShapeAnnotation, this);
       mShapesList.append(pPolygonAnnotation);
     }
-    else if (shape.startsWith("Rectangle"))
+    else if (shape.mShapeName.compare("Rectangle") == 0)
     {
-      shape = shape.mid(QString("Rectangle").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(shape, this);
+      RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(shape.mpShapeAnnotation, this);
       mShapesList.append(pRectangleAnnotation);
     }
-    else if (shape.startsWith("Ellipse"))
+    else if (shape.mShapeName.compare("Ellipse") == 0)
     {
-      shape = shape.mid(QString("Ellipse").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(shape, this);
+      EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(shape.mpShapeAnnotation, this);
       mShapesList.append(pEllipseAnnotation);
     }
-    else if (shape.startsWith("Text"))
+    else if (shape.mShapeName.compare("Text") == 0)
     {
-      QString textShapeAnnotation = shape.mid(QString("Text").length());
-      textShapeAnnotation = StringHandler::removeFirstLastBrackets(textShapeAnnotation);
       //! @note We don't show text annotation that contains % for Library Icons. Only static text for functions are shown.
       if (isLibraryComponent())
       {
         if (mType != StringHandler::Function)
           continue;
-        QStringList list = StringHandler::getStrings(textShapeAnnotation);
-        if (list.size() < 11)
-          continue;
-        if (list.at(9).contains("%"))
+        if (shape.mpShapeAnnotation->getTextString().contains("%"))
           continue;
       }
-      TextAnnotation *pTextAnnotation = new TextAnnotation(shape, this);
+      TextAnnotation *pTextAnnotation = new TextAnnotation(shape.mpShapeAnnotation, this);
       mShapesList.append(pTextAnnotation);
     }
-    else if (shape.startsWith("Bitmap"))
+    else if (shape.mShapeName.compare("Bitmap") == 0)
     {
       /* get the class file path */
-      OMCInterface::getClassInformation_res classInformation = mpOMCProxy->getClassInformation(mClassName);
+      QString fileName = mpOMCProxy->getComponentClassCache()->getComponentClass(mClassName, false)->getFileName();
       /* create the bitmap shape */
-      shape = shape.mid(QString("Bitmap").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
-      BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(classInformation.fileName, shape, this);
+      BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(fileName, shape.mShapeAnnotation, this);
       mShapesList.append(pBitmapAnnotation);
     }
   }
 }
 
+/*!
+ * \brief Component::getClassComponents
+ * Creates the connector components from the shared ComponentClass of the class and of its inherited classes.
+ */
 void Component::getClassComponents()
 {
   foreach (Component *pInheritedComponent, mInheritanceList)
   {
     pInheritedComponent->getClassComponents();
   }
-  // get components
-  QList<ComponentInfo*> componentInfoList = mpOMCProxy->getComponents(mClassName);
-  if (componentInfoList.isEmpty()) {
-    return;
-  }
-  QStringList componentsAnnotations = mpOMCProxy->getComponentAnnotations(mClassName);
-  int i = 0;
-  foreach (ComponentInfo *pComponentInfo, componentInfoList) {
-    // just to be on safe-side.
-    if (componentsAnnotations.size() <= i) {
-      continue;
-    }
-    QString transformation = StringHandler::getPlacementAnnotation(componentsAnnotations.at(i));
-    // if component is protected we don't show it in the icon layer.
-    if (transformation.isEmpty() || pComponentInfo->getProtected() || mpOMCProxy->isBuiltinType(pComponentInfo->getClassName())) {
-      i++;
-      continue;
-    }
-    if (mpOMCProxy->isWhat(StringHandler::Connector, pComponentInfo->getClassName())) {
-      QString result = mpOMCProxy->getIconAnnotation(pComponentInfo->getClassName());
-      Component *pComponent = new Component(result, transformation, pComponentInfo, StringHandler::Connector,
-                                            getRootParentComponent());
-      mComponentsList.append(pComponent);
-    }
-    i++;
+  ComponentClass *pComponentClass = mpOMCProxy->getComponentClassCache()->getComponentClass(mClassName, false);
+  foreach (ComponentClassConnector connector, pComponentClass->getConnectors()) {
+    Component *pComponent = new Component(connector.mAnnotation, connector.mTransformation, new ComponentInfo(connector.mpComponentInfo),
+                                          StringHandler::Connector, getRootParentComponent());
+    mComponentsList.append(pComponent);
   }
 }
 
@@ -629,6 +575,17 @@ ComponentInfo* Component::getComponentInfo()
   return mpComponentInfo;
 }
 
+/*!
+ * \brief Component::setComponentInfo
+ * Replaces the ComponentInfo of the component. The component takes the ownership of pComponentInfo.
+ * \param pComponentInfo
+ */
+void Component::setComponentInfo(ComponentInfo *pComponentInfo)
+{
+  if (mpComponentInfo && mpComponentInfo != pComponentInfo) delete mpComponentInfo;
+  mpComponentInfo = pComponentInfo;
+}
+
 QList<Component*> Component::getInheritanceList()
 {
   return mInheritanceList;
@@ -662,6 +619,30 @@ void Component::setComponentFlags(bool enable)
   setFlag(QGraphicsItem::ItemIsSelectable, enable);
 }
 
+/*!
+ * \brief Component::setOptimizeRendering
+ * Caches the shapes of the component, its inherited components and its connectors in device coordinates and enables their level of detail.
+ * Qt regenerates the cache of a shape whenever its transformation to the device changes e.g., on zoom, rotation, flip or resize, and whenever
+ * the shape is updated. A move only translates the cached pixmap.\n
+ * The texts are not cached since they are drawn unclipped and may overflow their extent.
+ * \param optimize
+ */
+void Component::setOptimizeRendering(bool optimize)
+{
+  foreach (Component *pInheritedComponent, mInheritanceList) {
+    pInheritedComponent->setOptimizeRendering(optimize);
+  }
+  foreach (ShapeAnnotation *pShapeAnnotation, mShapesList) {
+    if (!dynamic_cast<TextAnnotation*>(pShapeAnnotation)) {
+      pShapeAnnotation->setCacheMode(optimize ? QGraphicsItem::DeviceCoordinateCache : QGraphicsItem::NoCache);
+    }
+    pShapeAnnotation->setLevelOfDetail(optimize);
+  }
+  foreach (Component *pComponent, mComponentsList) {
+    pComponent->setOptimizeRendering(optimize);
+  }
+}
+
 QString Component::getTransformationAnnotation()
 {
   QString annotationString;
@@ -763,11 +744,30 @@ void Component::componentNameHasChanged(QString newName)
   mName = newName;
   setToolTip(QString("<b>").append(mClassName).append("</b> ").append(mName));
   emit componentDisplayTextChanged();
+  updateOverflowingTexts();
 }
 
 void Component::componentParameterHasChanged()
 {
   emit componentDisplayTextChanged();
+  updateOverflowingTexts();
+}
+
+/*!
+ * \brief Component::removeSceneItems
+ * Deletes the origin and resizer items that are added to the scene next to the component.
+ * Must be called before deleting a root component that is removed from a scene which is not cleared.
+ */
+void Component::removeSceneItems()
+{
+  if (mpOriginItem) {
+    delete mpOriginItem;
+    mpOriginItem = 0;
+  }
+  if (mpResizerRectangle) {
+    delete mpResizerRectangle;
+    mpResizerRectangle = 0;
+  }
 }
 
 /*!
@@ -835,6 +835,31 @@ void Component::renameInterfacePoint(TLMInterfacePointInfo *pTLMInterfacePointIn
   pTLMInterfacePointInfo->setInterfaceName(interfacePoint);
 }
 
+/*!
+ * \brief Component::updateOverflowingTexts
+ * The texts of the component may be drawn outside of its bounding rectangle.
+ * When the view only repaints the bounding rectangles of the changed items, the overflowing parts of the texts of the component,
+ * its inherited components and its connectors are repainted so that no stale text remains.
+ */
+void Component::updateOverflowingTexts()
+{
+  if (!mpGraphicsView || !mpGraphicsView->isOptimizeRendering()) {
+    return;
+  }
+  foreach (Component *pInheritedComponent, mInheritanceList) {
+    pInheritedComponent->updateOverflowingTexts();
+  }
+  foreach (ShapeAnnotation *pShapeAnnotation, mShapesList) {
+    TextAnnotation *pTextAnnotation = dynamic_cast<TextAnnotation*>(pShapeAnnotation);
+    if (pTextAnnotation) {
+      pTextAnnotation->updateOverflowingRect();
+    }
+  }
+  foreach (Component *pComponent, mComponentsList) {
+    pComponent->updateOverflowingTexts();
+  }
+}
+
 void Component::duplicateHelper(GraphicsView *pGraphicsView)
 {
   Component *pComponent = pGraphicsView->getComponentList().last();
@@ -1574,6 +1599,9 @@ QVariant Component::itemChange(GraphicsItemChange change, const QVariant &value)
     }
   } else if (change == QGraphicsItem::ItemPositionHasChanged) {
     emit componentTransformChange();
+    updateOverflowingTexts();
+  } else if (change == QGraphicsItem::ItemTransformHasChanged) {
+    updateOverflowingTexts();
   }
   else if (change == QGraphicsItem::ItemPositionChange) {
     // move by grid distance while dragging component
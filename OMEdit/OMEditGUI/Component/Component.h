@@ -116,6 +116,7 @@ public:
   QAction* getViewDocumentationAction();
   QAction* getTLMAttributesAction();
   ComponentInfo* getComponentInfo();
+  void setComponentInfo(ComponentInfo *pComponentInfo);
   QList<Component*> getInheritanceList();
   QList<ShapeAnnotation*> getShapesList();
   QList<Component*> getComponentsList();
@@ -125,6 +126,7 @@ public:
   void setOldPosition(QPointF oldPosition) {mOldPosition = oldPosition;}
   QPointF getOldPosition() {return mOldPosition;}
   void setComponentFlags(bool enable);
+  void setOptimizeRendering(bool optimize);
   QString getTransformationAnnotation();
   QString getPlacementAnnotation();
   QString getTransformationOrigin();
@@ -134,6 +136,7 @@ public:
   void emitComponentTransformHasChanged() {emit componentTransformHasChanged();}
   void componentNameHasChanged(QString newName);
   void componentParameterHasChanged();
+  void removeSceneItems();
   QString getParameterDisplayString(QString parameterName);
   void addInterfacePoint(TLMInterfacePointInfo *pTLMInterfacePointInfo);
   void removeInterfacePoint(TLMInterfacePointInfo *pTLMInterfacePointInfo);
@@ -178,6 +181,7 @@ private:
   QList<TLMInterfacePointInfo*> mInterfacePointsList;
   QPointF mOldPosition;
   void duplicateHelper(GraphicsView *pGraphicsView);
+  void updateOverflowingTexts();
 signals:
   void componentDisplayTextChanged();
   void componentTransformChange();
@@ -0,0 +1,293 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include "ComponentClass.h"
+#include "AnnotationTree.h"
+#include "OMCProxy.h"
+#include "Component.h"
+
+/*!
+ * \class ComponentIcon
+ * \brief The parsed coordinate system and shapes of an icon or diagram annotation.
+ * It is shared by all the components that draw the same annotation. The shapes are parsed once into items that are not added
+ * to any scene and the components create their shapes as copies of them. The bitmaps are created from their parsed arguments.
+ */
+/*!
+ * \brief ComponentIcon::ComponentIcon
+ * \param annotation - the icon or diagram annotation returned by OMC.
+ */
+ComponentIcon::ComponentIcon(QString annotation)
+  : mAnnotationTree(annotation)
+{
+  mHasExtent = false;
+  mHasCoOrdinateSystem = false;
+  mPreserveAspectRatio = true;
+  mInitialScale = 0.1;
+  mGrid = QPointF(2, 2);
+  AnnotationNode list = mAnnotationTree.getRoot();
+  // the annotation is enclosed in curly brackets.
+  if (list.size() == 1 && list.at(0).getType() == AnnotationNode::Array) {
+    list = list.at(0);
+  }
+  if (list.size() < 4) {
+    return;
+  }
+  // read the coordinate system
+  qreal left = qMin(list.at(0).toDouble(), list.at(2).toDouble());
+  qreal bottom = qMin(list.at(1).toDouble(), list.at(3).toDouble());
+  qreal right = qMax(list.at(0).toDouble(), list.at(2).toDouble());
+  qreal top = qMax(list.at(1).toDouble(), list.at(3).toDouble());
+  mExtent << QPointF(left, bottom) << QPointF(right, top);
+  mHasExtent = true;
+  if (list.size() < 8) {
+    return;
+  }
+  // read aspectratio, scale, grid
+  mPreserveAspectRatio = list.at(4).toRawString().contains("true");
+  mInitialScale = list.at(5).toDouble();
+  mGrid = QPointF(list.at(6).toDouble(), list.at(7).toDouble());
+  mHasCoOrdinateSystem = true;
+  // read the shapes
+  AnnotationNode shapesList = list.at(8);
+  for (int i = 0 ; i < shapesList.size() ; i++) {
+    AnnotationNode shape = shapesList.at(i);
+    QString shapeName = shape.getName();
+    ComponentIconShape componentIconShape;
+    componentIconShape.mShapeName = shapeName;
+    componentIconShape.mpShapeAnnotation = 0;
+    if (shapeName == "Line") {
+      componentIconShape.mpShapeAnnotation = new LineAnnotation(shape, 0);
+    } else if (shapeName == "Polygon") {
+      componentIconShape.mpShapeAnnotation = new PolygonAnnotation(shape, 0);
+    } else if (shapeName == "Rectangle") {
+      componentIconShape.mpShapeAnnotation = new RectangleAnnotation(shape, 0);
+    } else if (shapeName == "Ellipse") {
+      componentIconShape.mpShapeAnnotation = new EllipseAnnotation(shape, 0);
+    } else if (shapeName == "Text") {
+      componentIconShape.mpShapeAnnotation = new TextAnnotation(shape, 0);
+    } else if (shapeName == "Bitmap") {
+      componentIconShape.mShapeAnnotation = shape;
+    } else {
+      continue;
+    }
+    mShapes.append(componentIconShape);
+  }
+}
+
+/*!
+ * \brief ComponentIcon::~ComponentIcon
+ * Deletes the parsed shapes.
+ */
+ComponentIcon::~ComponentIcon()
+{
+  foreach (ComponentIconShape shape, mShapes) {
+    delete shape.mpShapeAnnotation;
+  }
+}
+
+/*!
+ * \class ComponentClass
+ * \brief The graphical structure of a class shared by all of its components.
+ * Holds the inherited classes with their annotations and the connectors with their placements, so the components of the same
+ * class don't query OMC again. Only the transformation, the name and the parameters are kept per component.
+ */
+/*!
+ * \brief ComponentClass::ComponentClass
+ * \param className
+ * \param diagramConnectorAnnotations - use the diagram annotation of the inherited connector classes.
+ * \param pOMCProxy
+ */
+ComponentClass::ComponentClass(QString className, bool diagramConnectorAnnotations, OMCProxy *pOMCProxy)
+{
+  mClassName = className;
+  mpOMCProxy = pOMCProxy;
+  mConnectorsRead = false;
+  mFileNameRead = false;
+  // read the class inheritance
+  int inheritanceCount = mpOMCProxy->getInheritanceCount(mClassName);
+  for (int i = 1 ; i <= inheritanceCount ; i++) {
+    QString inheritedClass = mpOMCProxy->getNthInheritedClass(mClassName, i);
+    // avoid cycles
+    if (inheritedClass.compare(mClassName) == 0) {
+      continue;
+    }
+    // If the inherited class is one of the builtin type such as Real we can
+    // stop here, because the class can not contain any components, etc.
+    if (mpOMCProxy->isBuiltinType(inheritedClass)) {
+      continue;
+    }
+    ComponentClassInheritance inheritance;
+    inheritance.mClassName = inheritedClass;
+    inheritance.mType = mpOMCProxy->getClassRestriction(inheritedClass);
+    if (diagramConnectorAnnotations && inheritance.mType == StringHandler::Connector) {
+      inheritance.mAnnotation = mpOMCProxy->getDiagramAnnotation(inheritedClass);
+    } else {
+      inheritance.mAnnotation = mpOMCProxy->getIconAnnotation(inheritedClass);
+    }
+    mInheritedClasses.append(inheritance);
+  }
+}
+
+ComponentClass::~ComponentClass()
+{
+  foreach (ComponentClassConnector connector, mConnectors) {
+    delete connector.mpComponentInfo;
+  }
+}
+
+/*!
+ * \brief ComponentClass::getConnectors
+ * Returns the public connectors of the class that have a placement. They are read when first requested.
+ * \return
+ */
+QList<ComponentClassConnector> ComponentClass::getConnectors()
+{
+  if (mConnectorsRead) {
+    return mConnectors;
+  }
+  mConnectorsRead = true;
+  QList<ComponentInfo*> componentInfoList = mpOMCProxy->getComponents(mClassName);
+  if (componentInfoList.isEmpty()) {
+    return mConnectors;
+  }
+  QStringList componentsAnnotations = mpOMCProxy->getComponentAnnotations(mClassName);
+  for (int i = 0 ; i < componentInfoList.size() ; i++) {
+    ComponentInfo *pComponentInfo = componentInfoList.at(i);
+    // just to be on safe-side.
+    if (componentsAnnotations.size() <= i) {
+      delete pComponentInfo;
+      continue;
+    }
+    QString transformation = StringHandler::getPlacementAnnotation(componentsAnnotations.at(i));
+    // if component is protected we don't show it in the icon layer.
+    if (transformation.isEmpty() || pComponentInfo->getProtected() || mpOMCProxy->isBuiltinType(pComponentInfo->getClassName())
+        || !mpOMCProxy->isWhat(StringHandler::Connector, pComponentInfo->getClassName())) {
+      delete pComponentInfo;
+      continue;
+    }
+    ComponentClassConnector connector;
+    connector.mpComponentInfo = pComponentInfo;
+    connector.mTransformation = transformation;
+    connector.mAnnotation = mpOMCProxy->getIconAnnotation(pComponentInfo->getClassName());
+    mConnectors.append(connector);
+  }
+  return mConnectors;
+}
+
+/*!
+ * \brief ComponentClass::getFileName
+ * Returns the file of the class. The bitmaps of the class are relative to it.
+ * \return
+ */
+QString ComponentClass::getFileName()
+{
+  if (!mFileNameRead) {
+    mFileName = mpOMCProxy->getClassInformation(mClassName).fileName;
+    mFileNameRead = true;
+  }
+  return mFileName;
+}
+
+/*!
+ * \class ComponentClassCache
+ * \brief Caches the ComponentClass and the ComponentIcon objects.
+ * The classes are removed when the cached OMC commands of the class are removed. The icons are keyed by the annotation
+ * itself so they never get stale.
+ */
+/*!
+ * \brief ComponentClassCache::ComponentClassCache
+ * \param pOMCProxy
+ */
+ComponentClassCache::ComponentClassCache(OMCProxy *pOMCProxy)
+  : mComponentIconsCache(4 * 1024 * 1024)
+{
+  mpOMCProxy = pOMCProxy;
+}
+
+ComponentClassCache::~ComponentClassCache()
+{
+  qDeleteAll(mComponentClassesHash);
+}
+
+/*!
+ * \brief ComponentClassCache::getComponentClass
+ * Returns the shared ComponentClass of the class. Creates it if it is not cached.
+ * \param className
+ * \param diagramConnectorAnnotations
+ * \return
+ */
+ComponentClass* ComponentClassCache::getComponentClass(QString className, bool diagramConnectorAnnotations)
+{
+  QString key = QString(className).append(diagramConnectorAnnotations ? "|diagram" : "|icon");
+  ComponentClass *pComponentClass = mComponentClassesHash.value(key, 0);
+  if (!pComponentClass) {
+    pComponentClass = new ComponentClass(className, diagramConnectorAnnotations, mpOMCProxy);
+    mComponentClassesHash.insert(key, pComponentClass);
+  }
+  return pComponentClass;
+}
+
+/*!
+ * \brief ComponentClassCache::getComponentIcon
+ * Returns the shared ComponentIcon of the annotation. Creates it if it is not cached.\n
+ * The cost of an icon is the size of its annotation. The returned icon is only valid until the next call since inserting an
+ * icon can evict the others.
+ * \param annotation
+ * \return
+ */
+ComponentIcon* ComponentClassCache::getComponentIcon(QString annotation)
+{
+  ComponentIcon *pComponentIcon = mComponentIconsCache.object(annotation);
+  if (!pComponentIcon) {
+    pComponentIcon = new ComponentIcon(annotation);
+    // QCache deletes an object that costs more than the whole cache right away so limit the cost.
+    mComponentIconsCache.insert(annotation, pComponentIcon, qMin(annotation.size(), mComponentIconsCache.maxCost()));
+  }
+  return pComponentIcon;
+}
+
+/*!
+ * \brief ComponentClassCache::removeComponentClass
+ * Removes the cached ComponentClass of the class.
+ * \param className
+ */
+void ComponentClassCache::removeComponentClass(QString className)
+{
+  delete mComponentClassesHash.take(QString(className).append("|diagram"));
+  delete mComponentClassesHash.take(QString(className).append("|icon"));
+}
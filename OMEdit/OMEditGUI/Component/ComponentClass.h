@@ -0,0 +1,134 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef COMPONENTCLASS_H
+#define COMPONENTCLASS_H
+
+#include <QHash>
+#include <QCache>
+#include <QPointF>
+#include <QStringList>
+
+#include "StringHandler.h"
+#include "AnnotationTree.h"
+
+class OMCProxy;
+class ComponentInfo;
+class ShapeAnnotation;
+
+struct ComponentIconShape
+{
+  QString mShapeName;
+  // the parsed shape. The bitmaps have no parsed shape since their file name is resolved relative to the class file.
+  ShapeAnnotation *mpShapeAnnotation;
+  // the arguments of the bitmap shape.
+  AnnotationNode mShapeAnnotation;
+};
+
+class ComponentIcon
+{
+public:
+  ComponentIcon(QString annotation);
+  ~ComponentIcon();
+  bool hasExtent() {return mHasExtent;}
+  QList<QPointF> getExtent() {return mExtent;}
+  bool hasCoOrdinateSystem() {return mHasCoOrdinateSystem;}
+  bool getPreserveAspectRatio() {return mPreserveAspectRatio;}
+  qreal getInitialScale() {return mInitialScale;}
+  QPointF getGrid() {return mGrid;}
+  QList<ComponentIconShape> getShapes() {return mShapes;}
+private:
+  Q_DISABLE_COPY(ComponentIcon)
+  AnnotationTree mAnnotationTree;
+  bool mHasExtent;
+  QList<QPointF> mExtent;
+  bool mHasCoOrdinateSystem;
+  bool mPreserveAspectRatio;
+  qreal mInitialScale;
+  QPointF mGrid;
+  QList<ComponentIconShape> mShapes;
+};
+
+struct ComponentClassInheritance
+{
+  QString mClassName;
+  StringHandler::ModelicaClasses mType;
+  QString mAnnotation;
+};
+
+struct ComponentClassConnector
+{
+  ComponentInfo *mpComponentInfo;
+  QString mTransformation;
+  QString mAnnotation;
+};
+
+class ComponentClass
+{
+public:
+  ComponentClass(QString className, bool diagramConnectorAnnotations, OMCProxy *pOMCProxy);
+  ~ComponentClass();
+  QString getClassName() {return mClassName;}
+  QList<ComponentClassInheritance> getInheritedClasses() {return mInheritedClasses;}
+  QList<ComponentClassConnector> getConnectors();
+  QString getFileName();
+private:
+  QString mClassName;
+  OMCProxy *mpOMCProxy;
+  QList<ComponentClassInheritance> mInheritedClasses;
+  bool mConnectorsRead;
+  QList<ComponentClassConnector> mConnectors;
+  bool mFileNameRead;
+  QString mFileName;
+};
+
+class ComponentClassCache
+{
+public:
+  ComponentClassCache(OMCProxy *pOMCProxy);
+  ~ComponentClassCache();
+  ComponentClass* getComponentClass(QString className, bool diagramConnectorAnnotations);
+  ComponentIcon* getComponentIcon(QString annotation);
+  void removeComponentClass(QString className);
+private:
+  OMCProxy *mpOMCProxy;
+  QHash<QString, ComponentClass*> mComponentClassesHash;
+  QCache<QString, ComponentIcon> mComponentIconsCache;
+};
+
+#endif // COMPONENTCLASS_H
@@ -182,7 +182,7 @@ void BreakpointDialog::addOrEditBreakpoint()
   } else {  /* if user has selected a class using Browse Classes button */
     LibraryTreeWidget *pLibraryTreeWidget;
     pLibraryTreeWidget = mpBreakpointsTreeModel->getBreakpointsTreeView()->getBreakpointsWidget()->getDebuggerMainWindow()->getMainWindow()->getLibraryTreeWidget();
-    LibraryTreeNode *pLibraryTreeNode = pLibraryTreeWidget->getLibraryTreeNode(mpFileNameTextBox->text());
+    LibraryTreeNode *pLibraryTreeNode = pLibraryTreeWidget->getOrCreateLibraryTreeNode(mpFileNameTextBox->text());
     if (pLibraryTreeNode) {
       if (!pLibraryTreeNode->isSaved()) {
         QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error),
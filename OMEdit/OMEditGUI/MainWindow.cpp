@@ -39,6 +39,8 @@
 #include <QtSvg/QSvgGenerator>
 
 #include "MainWindow.h"
+#include "LibraryTreeCache.h"
+#include "LibraryIconCache.h"
 #include "VariablesWidget.h"
 #include "Helper.h"
 #include "SimulationOutputWidget.h"
@@ -130,6 +132,21 @@ MainWindow::MainWindow(QSplashScreen *pSplashScreen, QWidget *parent)
   setCorner(Qt::TopLeftCorner, Qt::LeftDockWidgetArea);
   connect(mpSearchClassDockWidget, SIGNAL(visibilityChanged(bool)), SLOT(focusSearchClassWidget(bool)));
   mpSearchClassDockWidget->hide();
+  // set the matching algorithm.
+  mpOMCProxy->setMatchingAlgorithm(mpOptionsDialog->getSimulationPage()->getMatchingAlgorithmComboBox()->currentText());
+  // set the index reduction methods.
+  mpOMCProxy->setIndexReductionMethod(mpOptionsDialog->getSimulationPage()->getIndexReductionMethodComboBox()->currentText());
+  // set the OMC Flags before loading the libraries since they are part of the library tree cache key.
+  if (!mpOptionsDialog->getSimulationPage()->getOMCFlagsTextBox()->text().isEmpty())
+    mpOMCProxy->setCommandLineOptions(mpOptionsDialog->getSimulationPage()->getOMCFlagsTextBox()->text());
+  if (mpOptionsDialog->getDebuggerPage()->getGenerateOperationsCheckBox()->isChecked())
+    mpOMCProxy->setCommandLineOptions("+d=infoXmlOperations");
+  // Create the library tree cache shared by all the library trees.
+  mpLibraryTreeCache = new LibraryTreeCache(mpOMCProxy);
+  // Create the icon cache and the icon rendering threads shared by all the library trees.
+  mpLibraryIconCache = new LibraryIconCache;
+  mpLibraryIconsThreadPool = new QThreadPool(this);
+  mpLibraryIconsThreadPool->setMaxThreadCount(QThread::idealThreadCount());
   // Create an object of LibraryTreeWidget
   mpLibraryTreeWidget = new LibraryTreeWidget(false, this);
   // Loads and adds the OM Standard Library into the Library Widget.
@@ -245,15 +262,6 @@ MainWindow::MainWindow(QSplashScreen *pSplashScreen, QWidget *parent)
   mpStatusBar->addPermanentWidget(mpPerspectiveTabbar);
   // set status bar for MainWindow
   setStatusBar(mpStatusBar);
-  // set the matching algorithm.
-  mpOMCProxy->setMatchingAlgorithm(mpOptionsDialog->getSimulationPage()->getMatchingAlgorithmComboBox()->currentText());
-  // set the index reduction methods.
-  mpOMCProxy->setIndexReductionMethod(mpOptionsDialog->getSimulationPage()->getIndexReductionMethodComboBox()->currentText());
-  // set the OMC Flags.
-  if (!mpOptionsDialog->getSimulationPage()->getOMCFlagsTextBox()->text().isEmpty())
-    mpOMCProxy->setCommandLineOptions(mpOptionsDialog->getSimulationPage()->getOMCFlagsTextBox()->text());
-  if (mpOptionsDialog->getDebuggerPage()->getGenerateOperationsCheckBox()->isChecked())
-    mpOMCProxy->setCommandLineOptions("+d=infoXmlOperations");
   // restore OMEdit widgets state
   QSettings *pSettings = OpenModelica::getApplicationSettings();
   if (mpOptionsDialog->getGeneralSettingsPage()->getPreserveUserCustomizations())
@@ -626,6 +634,12 @@ void MainWindow::beforeClosingMainWindow()
   delete mpDebuggerMainWindow;
   delete mpSimulationDialog;
   delete mpTLMCoSimulationDialog;
+  // write the library tree cache
+  delete mpLibraryTreeCache;
+  // wait for the icons being rendered before deleting the icon cache.
+  mpLibraryIconsThreadPool->clear();
+  mpLibraryIconsThreadPool->waitForDone();
+  delete mpLibraryIconCache;
   /* save the TransformationsWidget last window geometry and splitters state. */
   QSettings *pSettings = OpenModelica::getApplicationSettings();
   QHashIterator<QString, TransformationsWidget*> transformationsWidgets(mTransformationsWidgetHash);
@@ -1200,22 +1214,16 @@ void MainWindow::PlotCallbackFunction(void *p, int externalWindow, const char* f
     VariablesTreeItem *pVariableTreeItem;
     VariablesTreeModel *pVariablesTreeModel = pMainWindow->getVariablesWidget()->getVariablesTreeModel();
     bool state = pVariablesTreeModel->blockSignals(true);
+    QList<VariablesTreeItem*> variablesTreeItems;
     foreach (QString variable, variablesList) {
       variable = fileInfo.fileName() + "." + variable;
       pVariableTreeItem = pVariablesTreeModel->findVariablesTreeItem(variable, pVariablesTreeModel->getRootVariablesTreeItem());
       if (pVariableTreeItem) {
-        QModelIndex index = pVariablesTreeModel->variablesTreeItemIndex(pVariableTreeItem);
-        OMPlot::PlotCurve *pPlotCurve = 0;
-        foreach (OMPlot::PlotCurve *curve, pPlotWindow->getPlot()->getPlotCurvesList()) {
-          if (curve->getNameStructure().compare(pVariableTreeItem->getVariableName()) == 0) {
-            pPlotCurve = curve;
-            break;
-          }
-        }
-        pVariablesTreeModel->setData(index, Qt::Checked, Qt::CheckStateRole);
-        pMainWindow->getVariablesWidget()->plotVariables(index, pPlotWindow->getCurveWidth(), pPlotWindow->getCurveStyle(), pPlotCurve);
+        pVariablesTreeModel->setData(pVariablesTreeModel->variablesTreeItemIndex(pVariableTreeItem), Qt::Checked, Qt::CheckStateRole);
+        variablesTreeItems.append(pVariableTreeItem);
       }
     }
+    pMainWindow->getVariablesWidget()->plotVariablesList(variablesTreeItems, pPlotWindow);
     // variables list is empty for plotAll
     if (strcmp(plotType, "plotall") == 0) {
       pVariableTreeItem = pVariablesTreeModel->findVariablesTreeItem(fileInfo.fileName(), pVariablesTreeModel->getRootVariablesTreeItem());
@@ -2320,6 +2328,11 @@ void MainWindow::autoSave()
     {
       if (!pLibraryTreeNode->isSaved() && !pLibraryTreeNode->getFileName().isEmpty())
       {
+        // the nested classes are created lazily. Create them so that childCount() tells if the class is a package.
+        if (pLibraryTreeNode->getParentName().isEmpty())
+        {
+          mpLibraryTreeWidget->createAllChildLibraryTreeNodes(pLibraryTreeNode);
+        }
         // if auto save for single file class is enabled.
         if (pLibraryTreeNode->getParentName().isEmpty() && pLibraryTreeNode->childCount() == 0 && autoSaveForSingleClasses)
         {
@@ -82,6 +82,8 @@ class MessagesWidget;
 class TransformationsWidget;
 class SearchClassWidget;
 class LibraryTreeWidget;
+class LibraryTreeCache;
+class LibraryIconCache;
 class DocumentationWidget;
 class VariablesWidget;
 class SimulationDialog;
@@ -105,6 +107,9 @@ public:
   OptionsDialog* getOptionsDialog();
   MessagesWidget* getMessagesWidget();
   LibraryTreeWidget* getLibraryTreeWidget();
+  LibraryTreeCache* getLibraryTreeCache() {return mpLibraryTreeCache;}
+  LibraryIconCache* getLibraryIconCache() {return mpLibraryIconCache;}
+  QThreadPool* getLibraryIconsThreadPool() {return mpLibraryIconsThreadPool;}
   DocumentationWidget* getDocumentationWidget();
   QDockWidget* getDocumentationDockWidget();
   VariablesWidget* getVariablesWidget();
@@ -195,6 +200,9 @@ private:
   FileDataNotifier *mpErrorFileDataNotifier;
   SearchClassWidget *mpSearchClassWidget;
   QDockWidget *mpSearchClassDockWidget;
+  LibraryTreeCache *mpLibraryTreeCache;
+  LibraryIconCache *mpLibraryIconCache;
+  QThreadPool *mpLibraryIconsThreadPool;
   LibraryTreeWidget *mpLibraryTreeWidget;
   QDockWidget *mpLibraryTreeDockWidget;
   DocumentationWidget *mpDocumentationWidget;
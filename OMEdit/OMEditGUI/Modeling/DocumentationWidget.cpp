@@ -223,7 +223,7 @@ void DocumentationViewer::processLinkClick(QUrl url)
       QString resourceAbsoluteFileName = mpDocumentationWidget->getMainWindow()->getOMCProxy()->uriToFilename("modelica://" + resourceLink);
       QDesktopServices::openUrl("file:///" + resourceAbsoluteFileName);
     } else {
-      LibraryTreeNode *pLibraryTreeNode = mpDocumentationWidget->getMainWindow()->getLibraryTreeWidget()->getLibraryTreeNode(resourceLink);
+      LibraryTreeNode *pLibraryTreeNode = mpDocumentationWidget->getMainWindow()->getLibraryTreeWidget()->getOrCreateLibraryTreeNode(resourceLink);
       // send the new className to DocumentationWidget
       if (pLibraryTreeNode) {
         mpDocumentationWidget->showDocumentation(pLibraryTreeNode->getNameStructure());
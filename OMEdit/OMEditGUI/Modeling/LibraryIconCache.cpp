@@ -0,0 +1,190 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QCryptographicHash>
+
+#include "LibraryIconCache.h"
+#include "Helper.h"
+
+/*!
+ * \class LibraryIconCache
+ * \brief Persistent cache of the rendered library icons.
+ * The icons are kept in an in-memory LRU cache in front of PNG files in OpenModelica::cacheDirectory().
+ * A key is made of the class name, the OpenModelica version, the digest of the icon annotations of the class and of its inherited
+ * classes and the icon size. So the key is known before the icon annotation is parsed and a change in any drawn annotation gives a
+ * new key.
+ * The files are removed oldest first once their total size exceeds the limit.
+ * One instance is owned by the MainWindow and used from the icon rendering threads so all the access is serialized.
+ */
+/*!
+ * \brief LibraryIconCache::LibraryIconCache
+ * \param maximumCost - the size of the in-memory cache in kilobytes.
+ * \param maximumDiskSize - the size limit of the files in bytes.
+ */
+LibraryIconCache::LibraryIconCache(int maximumCost, qint64 maximumDiskSize)
+  : mImagesCache(maximumCost)
+{
+  mCacheDirectory = OpenModelica::cacheDirectory() + "icons/";
+  if (!QDir().exists(mCacheDirectory)) {
+    QDir().mkpath(mCacheDirectory);
+  }
+  mMaximumDiskSize = maximumDiskSize;
+  mDiskSize = 0;
+  QFileInfoList filesInfoList = QDir(mCacheDirectory).entryInfoList(QStringList() << "*.png", QDir::Files);
+  foreach (QFileInfo fileInfo, filesInfoList) {
+    mDiskSize += fileInfo.size();
+  }
+  pruneDiskCache();
+}
+
+/*!
+ * \brief LibraryIconCache::getImage
+ * Looks up the image in the memory cache first and then on the disk.
+ * \param key
+ * \param pImage - set to the cached image. A null image means the class has no icon.
+ * \return true if the image is cached.
+ */
+bool LibraryIconCache::getImage(QString key, QImage *pImage)
+{
+  QMutexLocker cacheLocker(&mCacheMutex);
+  QImage *pCachedImage = mImagesCache.object(key);
+  if (pCachedImage) {
+    *pImage = *pCachedImage;
+    return true;
+  }
+  QFile file(imageFilePath(key));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  QByteArray data = file.readAll();
+  file.close();
+  // an empty file means the class has no icon.
+  QImage image;
+  if (!data.isEmpty() && !image.loadFromData(data, "PNG")) {
+    return false;
+  }
+  *pImage = image;
+  mImagesCache.insert(key, new QImage(image), qMax(1, image.byteCount() / 1024));
+  return true;
+}
+
+/*!
+ * \brief LibraryIconCache::setImage
+ * Adds the image to the memory cache and writes it to the disk.
+ * \param key
+ * \param image
+ */
+void LibraryIconCache::setImage(QString key, QImage image)
+{
+  QMutexLocker cacheLocker(&mCacheMutex);
+  mImagesCache.insert(key, new QImage(image), qMax(1, image.byteCount() / 1024));
+  /* write to a uniquely named temporary file first so that a crash never leaves a partial image behind and several OMEdit
+   * instances never write the same file.
+   */
+  QString fileName = imageFilePath(key);
+  QTemporaryFile file(mCacheDirectory + "XXXXXX.tmp");
+  file.setAutoRemove(false);
+  if (!file.open()) {
+    return;
+  }
+  if (!image.isNull() && !image.save(&file, "PNG")) {
+    file.close();
+    file.remove();
+    return;
+  }
+  qint64 size = file.size();
+  file.close();
+  QFile::remove(fileName);
+  if (!file.rename(fileName)) {
+    file.remove();
+    return;
+  }
+  mDiskSize += size;
+  pruneDiskCache();
+}
+
+/*!
+ * \brief LibraryIconCache::imageKey
+ * The class name is part of the key because the relative bitmap file names in the annotations are resolved against the class.
+ * \param className
+ * \param annotations - the resolved icon annotation of the class including the icon annotations of its inherited classes.
+ * \param size
+ * \return the key of the icon.
+ */
+QString LibraryIconCache::imageKey(QString className, QString annotations, QSize size)
+{
+  QByteArray digest = QCryptographicHash::hash(annotations.toUtf8(), QCryptographicHash::Sha1).toHex();
+  return QString("%1|%2|%3|%4x%5").arg(className).arg(Helper::OpenModelicaVersion).arg(QString(digest))
+      .arg(size.width()).arg(size.height());
+}
+
+/*!
+ * \brief LibraryIconCache::imageFilePath
+ * The class names can be long and can contain characters which are not allowed in file names so the file is named by the digest of the key.
+ * \param key
+ * \return the path of the image file.
+ */
+QString LibraryIconCache::imageFilePath(QString key)
+{
+  return mCacheDirectory + QString(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".png";
+}
+
+/*!
+ * \brief LibraryIconCache::pruneDiskCache
+ * If the files exceed the size limit then removes the oldest ones until three quarters of the limit is used.
+ */
+void LibraryIconCache::pruneDiskCache()
+{
+  if (mDiskSize <= mMaximumDiskSize) {
+    return;
+  }
+  QFileInfoList filesInfoList = QDir(mCacheDirectory).entryInfoList(QStringList() << "*.png" << "*.tmp", QDir::Files,
+                                                                    QDir::Time | QDir::Reversed);
+  mDiskSize = 0;
+  foreach (QFileInfo fileInfo, filesInfoList) {
+    mDiskSize += fileInfo.size();
+  }
+  for (int i = 0 ; i < filesInfoList.size() && mDiskSize > (mMaximumDiskSize / 4) * 3 ; i++) {
+    if (QFile::remove(filesInfoList.at(i).absoluteFilePath())) {
+      mDiskSize -= filesInfoList.at(i).size();
+    }
+  }
+}
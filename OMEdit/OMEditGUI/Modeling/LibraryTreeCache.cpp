@@ -0,0 +1,384 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include <QDir>
+#include <QDirIterator>
+#include <QDataStream>
+#include <QDateTime>
+#include <QTemporaryFile>
+
+#include "LibraryTreeCache.h"
+
+/* Change the version whenever the layout of the cache file changes. */
+#define LIBRARYTREECACHE_MAGIC 0x4F4D4C54
+#define LIBRARYTREECACHE_VERSION 2
+
+/*!
+ * \class LibraryTreeCache
+ * \brief Persistent cache of the library tree.
+ * Keeps the class names, the class information, the documentation class flags, the protected status and the icon annotations
+ * of the libraries loaded at startup. The cache of a library is stored in a file in OpenModelica::cacheDirectory() and is only
+ * used if the OMC version, the OMC annotation version and flags, the library file and the modification time of the library files
+ * are unchanged. One instance is owned by the MainWindow and shared by all the library trees.
+ */
+LibraryTreeCache::LibraryTreeCache(OMCProxy *pOMCProxy)
+{
+  mpOMCProxy = pOMCProxy;
+  mOMCSettingsKey = omcSettingsKey();
+}
+
+LibraryTreeCache::~LibraryTreeCache()
+{
+  saveLibraries();
+  qDeleteAll(mLibrariesHash);
+}
+
+/*!
+ * \brief LibraryTreeCache::updateOMCSettings
+ * Called when the OMC flags are changed. If the settings affecting the class data are changed then the cached libraries are saved
+ * under their old key and dropped, so the data read with the new settings is never mixed with the old one.
+ */
+void LibraryTreeCache::updateOMCSettings()
+{
+  QString settingsKey = omcSettingsKey();
+  if (settingsKey.compare(mOMCSettingsKey) == 0) {
+    return;
+  }
+  saveLibraries();
+  qDeleteAll(mLibrariesHash);
+  mLibrariesHash.clear();
+  mOMCSettingsKey = settingsKey;
+}
+
+/*!
+ * \brief LibraryTreeCache::loadLibrary
+ * Registers the library with the cache and reads its cache file.
+ * \param libraryName - the top level class name.
+ * \param fileName - the file containing the library.
+ * \return true if a valid cache file is found.
+ */
+bool LibraryTreeCache::loadLibrary(QString libraryName, QString fileName)
+{
+  removeLibrary(libraryName);
+  QString key = libraryKey(fileName);
+  if (key.isEmpty()) {
+    return false;
+  }
+  cachedLibrary *pCachedLibrary = new cachedLibrary;
+  pCachedLibrary->mKey = key;
+  pCachedLibrary->mModified = false;
+  pCachedLibrary->mHasClassNames = false;
+  mLibrariesHash.insert(libraryName, pCachedLibrary);
+  if (readLibrary(libraryName, pCachedLibrary)) {
+    return true;
+  }
+  pCachedLibrary->mHasClassNames = false;
+  pCachedLibrary->mClassNames.clear();
+  pCachedLibrary->mClassesInformation.clear();
+  pCachedLibrary->mProtectedClasses.clear();
+  pCachedLibrary->mIconAnnotations.clear();
+  pCachedLibrary->mModified = true;
+  return false;
+}
+
+/*!
+ * \brief LibraryTreeCache::isLibraryCached
+ * \param libraryName
+ * \return true if the library is registered with the cache.
+ */
+bool LibraryTreeCache::isLibraryCached(QString libraryName)
+{
+  return mLibrariesHash.contains(libraryName);
+}
+
+/*!
+ * \brief LibraryTreeCache::removeLibrary
+ * Removes the library from the cache e.g., when the user modifies it. The cache file is not touched since it still matches
+ * the library saved on disk.
+ * \param libraryName
+ */
+void LibraryTreeCache::removeLibrary(QString libraryName)
+{
+  delete mLibrariesHash.take(libraryName);
+}
+
+/*!
+ * \brief LibraryTreeCache::getClassNames
+ * \param libraryName
+ * \param pClassNames - set to the cached recursive class names of the library.
+ * \return true if the class names are found in the cache.
+ */
+bool LibraryTreeCache::getClassNames(QString libraryName, QStringList *pClassNames)
+{
+  cachedLibrary *pCachedLibrary = mLibrariesHash.value(libraryName, 0);
+  if (!pCachedLibrary || !pCachedLibrary->mHasClassNames) {
+    return false;
+  }
+  *pClassNames = pCachedLibrary->mClassNames;
+  return true;
+}
+
+void LibraryTreeCache::setClassNames(QString libraryName, QStringList classNames)
+{
+  cachedLibrary *pCachedLibrary = mLibrariesHash.value(libraryName, 0);
+  if (!pCachedLibrary) {
+    return;
+  }
+  pCachedLibrary->mClassNames = classNames;
+  pCachedLibrary->mHasClassNames = true;
+  pCachedLibrary->mModified = true;
+}
+
+/*!
+ * \brief LibraryTreeCache::getClassInformation
+ * \param className
+ * \param pClassInformation - set to the cached information of the class.
+ * \param protectedStatus - if true then the protected status must be cached as well.
+ * \param iconAnnotation - if true then the icon annotation must be cached as well.
+ * \return true if all the requested information is found in the cache.
+ */
+bool LibraryTreeCache::getClassInformation(QString className, batchedClassInformation *pClassInformation, bool protectedStatus,
+                                           bool iconAnnotation)
+{
+  cachedLibrary *pCachedLibrary = findLibrary(className);
+  if (!pCachedLibrary || !pCachedLibrary->mClassesInformation.contains(className)) {
+    return false;
+  }
+  if ((protectedStatus && !pCachedLibrary->mProtectedClasses.contains(className)) ||
+      (iconAnnotation && !pCachedLibrary->mIconAnnotations.contains(className))) {
+    return false;
+  }
+  *pClassInformation = pCachedLibrary->mClassesInformation.value(className);
+  pClassInformation->mIsProtected = pCachedLibrary->mProtectedClasses.value(className, false);
+  pClassInformation->mIconAnnotation = pCachedLibrary->mIconAnnotations.value(className);
+  return true;
+}
+
+void LibraryTreeCache::setClassInformation(QString className, const batchedClassInformation &classInformation, bool protectedStatus,
+                                           bool iconAnnotation)
+{
+  cachedLibrary *pCachedLibrary = findLibrary(className);
+  if (!pCachedLibrary) {
+    return;
+  }
+  batchedClassInformation information = classInformation;
+  information.mIsProtected = false;
+  information.mIconAnnotation.clear();
+  pCachedLibrary->mClassesInformation.insert(className, information);
+  if (protectedStatus) {
+    pCachedLibrary->mProtectedClasses.insert(className, classInformation.mIsProtected);
+  }
+  if (iconAnnotation) {
+    pCachedLibrary->mIconAnnotations.insert(className, classInformation.mIconAnnotation);
+  }
+  pCachedLibrary->mModified = true;
+}
+
+/*!
+ * \brief LibraryTreeCache::saveLibraries
+ * Writes the modified libraries to their cache files.
+ */
+void LibraryTreeCache::saveLibraries()
+{
+  QHash<QString, cachedLibrary*>::iterator i;
+  for (i = mLibrariesHash.begin() ; i != mLibrariesHash.end() ; ++i) {
+    if (i.value()->mModified) {
+      writeLibrary(i.key(), i.value());
+      i.value()->mModified = false;
+    }
+  }
+}
+
+/*!
+ * \brief LibraryTreeCache::findLibrary
+ * \param className
+ * \return the cached library containing the class.
+ */
+cachedLibrary* LibraryTreeCache::findLibrary(QString className)
+{
+  return mLibrariesHash.value(StringHandler::getFirstWordBeforeDot(className), 0);
+}
+
+/*!
+ * \brief LibraryTreeCache::omcSettingsKey
+ * Creates the key of the OMC settings that affect the class data i.e., the annotation version and the OMC flags.
+ * \return the key.
+ */
+QString LibraryTreeCache::omcSettingsKey()
+{
+  QStringList commandLineOptions = mpOMCProxy->getCommandLineOptions();
+  commandLineOptions.sort();
+  return QString("%1|%2").arg(mpOMCProxy->getAnnotationVersion()).arg(commandLineOptions.join(" "));
+}
+
+/*!
+ * \brief LibraryTreeCache::libraryKey
+ * Creates the key of the library from the OMC version and settings, the library file path and the modification time of the library.
+ * For a library saved as directory structure the latest modification time of all of its files is used.
+ * \param fileName
+ * \return the key or empty string if the file doesn't exist.
+ */
+QString LibraryTreeCache::libraryKey(QString fileName)
+{
+  QFileInfo fileInfo(fileName);
+  if (fileName.isEmpty() || !fileInfo.exists()) {
+    return QString();
+  }
+  QDateTime lastModified = fileInfo.lastModified();
+  qint64 size = fileInfo.size();
+  int filesCount = 1;
+  if (fileInfo.fileName().compare("package.mo") == 0) {
+    filesCount = 0;
+    size = 0;
+    QDirIterator filesIterator(fileInfo.absolutePath(), QStringList() << "*.mo" << "package.order", QDir::Files,
+                               QDirIterator::Subdirectories);
+    while (filesIterator.hasNext()) {
+      filesIterator.next();
+      filesCount++;
+      size += filesIterator.fileInfo().size();
+      if (filesIterator.fileInfo().lastModified() > lastModified) {
+        lastModified = filesIterator.fileInfo().lastModified();
+      }
+    }
+  }
+  return QString("%1|%2|%3|%4|%5|%6").arg(Helper::OpenModelicaVersion).arg(mOMCSettingsKey).arg(fileInfo.absoluteFilePath())
+      .arg(lastModified.toString(Qt::ISODate)).arg(filesCount).arg(size);
+}
+
+/*!
+ * \brief LibraryTreeCache::cacheFilePath
+ * \param libraryName
+ * \return the path of the cache file of the library.
+ */
+QString LibraryTreeCache::cacheFilePath(QString libraryName)
+{
+  QString cachePath = OpenModelica::cacheDirectory() + "libraries/";
+  if (!QDir().exists(cachePath)) {
+    QDir().mkpath(cachePath);
+  }
+  return cachePath + libraryName + ".cache";
+}
+
+/*!
+ * \brief LibraryTreeCache::readLibrary
+ * Reads the cache file of the library.
+ * \param libraryName
+ * \param pCachedLibrary
+ * \return true if the cache file exists and its key matches the library key.
+ */
+bool LibraryTreeCache::readLibrary(QString libraryName, cachedLibrary *pCachedLibrary)
+{
+  QFile file(cacheFilePath(libraryName));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  QDataStream in(&file);
+  quint32 magic;
+  qint32 version;
+  QString key;
+  in >> magic >> version;
+  if (magic != LIBRARYTREECACHE_MAGIC || version != LIBRARYTREECACHE_VERSION) {
+    return false;
+  }
+  in >> key;
+  if (key.compare(pCachedLibrary->mKey) != 0) {
+    return false;
+  }
+  qint32 count;
+  in >> pCachedLibrary->mHasClassNames >> pCachedLibrary->mClassNames >> count;
+  for (int i = 0 ; i < count && in.status() == QDataStream::Ok ; i++) {
+    QString className;
+    batchedClassInformation classInformation;
+    bool partialPrefix, finalPrefix, encapsulatedPrefix, fileReadOnly;
+    qint32 lineNumberStart, columnNumberStart, lineNumberEnd, columnNumberEnd;
+    in >> className >> classInformation.mClassInformation.restriction >> classInformation.mClassInformation.comment
+       >> partialPrefix >> finalPrefix >> encapsulatedPrefix >> classInformation.mClassInformation.fileName >> fileReadOnly
+       >> lineNumberStart >> columnNumberStart >> lineNumberEnd >> columnNumberEnd >> classInformation.mIsDocumentationClass;
+    classInformation.mClassInformation.partialPrefix = partialPrefix;
+    classInformation.mClassInformation.finalPrefix = finalPrefix;
+    classInformation.mClassInformation.encapsulatedPrefix = encapsulatedPrefix;
+    classInformation.mClassInformation.fileReadOnly = fileReadOnly;
+    classInformation.mClassInformation.lineNumberStart = lineNumberStart;
+    classInformation.mClassInformation.columnNumberStart = columnNumberStart;
+    classInformation.mClassInformation.lineNumberEnd = lineNumberEnd;
+    classInformation.mClassInformation.columnNumberEnd = columnNumberEnd;
+    classInformation.mIsProtected = false;
+    pCachedLibrary->mClassesInformation.insert(className, classInformation);
+  }
+  in >> pCachedLibrary->mProtectedClasses >> pCachedLibrary->mIconAnnotations;
+  return in.status() == QDataStream::Ok;
+}
+
+/*!
+ * \brief LibraryTreeCache::writeLibrary
+ * Writes the cache file of the library.
+ * The data is written to a temporary file which is then renamed to the cache file so a crash or another OMEdit instance
+ * never sees a partially written cache file.
+ * \param libraryName
+ * \param pCachedLibrary
+ */
+void LibraryTreeCache::writeLibrary(QString libraryName, cachedLibrary *pCachedLibrary)
+{
+  QString fileName = cacheFilePath(libraryName);
+  QTemporaryFile file(fileName + ".XXXXXX");
+  file.setAutoRemove(false);
+  if (!file.open()) {
+    return;
+  }
+  QDataStream out(&file);
+  out << (quint32)LIBRARYTREECACHE_MAGIC << (qint32)LIBRARYTREECACHE_VERSION << pCachedLibrary->mKey;
+  out << pCachedLibrary->mHasClassNames << pCachedLibrary->mClassNames << (qint32)pCachedLibrary->mClassesInformation.size();
+  QHash<QString, batchedClassInformation>::const_iterator i;
+  for (i = pCachedLibrary->mClassesInformation.constBegin() ; i != pCachedLibrary->mClassesInformation.constEnd() ; ++i) {
+    const OMCInterface::getClassInformation_res &classInformation = i.value().mClassInformation;
+    out << i.key() << classInformation.restriction << classInformation.comment << (bool)classInformation.partialPrefix
+        << (bool)classInformation.finalPrefix << (bool)classInformation.encapsulatedPrefix << classInformation.fileName
+        << (bool)classInformation.fileReadOnly << (qint32)classInformation.lineNumberStart << (qint32)classInformation.columnNumberStart
+        << (qint32)classInformation.lineNumberEnd << (qint32)classInformation.columnNumberEnd << i.value().mIsDocumentationClass;
+  }
+  out << pCachedLibrary->mProtectedClasses << pCachedLibrary->mIconAnnotations;
+  file.close();
+  if (out.status() != QDataStream::Ok) {
+    file.remove();
+    return;
+  }
+  QFile::remove(fileName);
+  if (!file.rename(fileName)) {
+    file.remove();
+  }
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef LIBRARYTREECACHE_H
+#define LIBRARYTREECACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+#include "OMCProxy.h"
+
+/*!
+ * \brief Holds the cached data of one library.
+ */
+struct cachedLibrary
+{
+  QString mKey;
+  bool mModified;
+  bool mHasClassNames;
+  QStringList mClassNames;
+  QHash<QString, batchedClassInformation> mClassesInformation;
+  QHash<QString, bool> mProtectedClasses;
+  QHash<QString, QString> mIconAnnotations;
+};
+
+class LibraryTreeCache
+{
+public:
+  LibraryTreeCache(OMCProxy *pOMCProxy);
+  ~LibraryTreeCache();
+  void updateOMCSettings();
+  bool loadLibrary(QString libraryName, QString fileName);
+  bool isLibraryCached(QString libraryName);
+  void removeLibrary(QString libraryName);
+  bool getClassNames(QString libraryName, QStringList *pClassNames);
+  void setClassNames(QString libraryName, QStringList classNames);
+  bool getClassInformation(QString className, batchedClassInformation *pClassInformation, bool protectedStatus, bool iconAnnotation);
+  void setClassInformation(QString className, const batchedClassInformation &classInformation, bool protectedStatus, bool iconAnnotation);
+  void saveLibraries();
+private:
+  OMCProxy *mpOMCProxy;
+  QString mOMCSettingsKey;
+  QHash<QString, cachedLibrary*> mLibrariesHash;
+
+  QString omcSettingsKey();
+
+  cachedLibrary* findLibrary(QString className);
+  QString libraryKey(QString fileName);
+  QString cacheFilePath(QString libraryName);
+  bool readLibrary(QString libraryName, cachedLibrary *pCachedLibrary);
+  void writeLibrary(QString libraryName, cachedLibrary *pCachedLibrary);
+};
+
+#endif // LIBRARYTREECACHE_H
@@ -37,8 +37,12 @@
  */
 
 #include "LibraryTreeWidget.h"
+#include "LibraryTreeCache.h"
+#include "LibraryIconCache.h"
+#include "ComponentClass.h"
 #include "VariablesWidget.h"
 #include "SimulationOutputWidget.h"
+#include "BitmapImageCache.h"
 
 ItemDelegate::ItemDelegate(QObject *pParent, bool drawRichText, bool drawGrid)
   : QItemDelegate(pParent)
@@ -466,6 +470,8 @@ LibraryTreeWidget::LibraryTreeWidget(bool isSearchTree, MainWindow *pParent)
   setColumnCount(1);
   setExpandsOnDoubleClick(false);
   setContextMenuPolicy(Qt::CustomContextMenu);
+  // the icons of the classes are rendered by the worker threads of MainWindow::getLibraryIconsThreadPool().
+  mLibraryComponentsRenderId = 0;
   createActions();
   connect(this, SIGNAL(itemExpanded(QTreeWidgetItem*)), SLOT(expandLibraryTreeNode(QTreeWidgetItem*)));
   connect(this, SIGNAL(customContextMenuRequested(QPoint)), SLOT(showContextMenu(QPoint)));
@@ -610,14 +616,14 @@ void LibraryTreeWidget::addModelicaLibraries(QSplashScreen *pSplashScreen)
   systemLibs.sort();
   foreach (QString lib, systemLibs) {
     OMCInterface::getClassInformation_res classInformation = mpMainWindow->getOMCProxy()->getClassInformation(lib);
+    mpMainWindow->getLibraryTreeCache()->loadLibrary(lib, classInformation.fileName);
     LibraryTreeNode *pNewLibraryTreeNode = new LibraryTreeNode(LibraryTreeNode::Modelica, lib, "", lib, classInformation, "", true, this);
     pNewLibraryTreeNode->setSystemLibrary(true);
-    bool isDocumentationClass = mpMainWindow->getOMCProxy()->getDocumentationClassAnnotation(lib);
-    pNewLibraryTreeNode->setIsDocumentationClass(isDocumentationClass);
+    pNewLibraryTreeNode->setIsDocumentationClass(getClassesInformation(QStringList() << lib, false, true).first().mIsDocumentationClass);
     // get the Icon for Modelica tree node
     loadLibraryComponent(pNewLibraryTreeNode);
     addTopLevelItem(pNewLibraryTreeNode);
-    mLibraryTreeNodesList.append(pNewLibraryTreeNode);
+    addToLibraryTreeNodesList(pNewLibraryTreeNode);
     createLibraryTreeNodes(pNewLibraryTreeNode);
   }
   // load Modelica User Libraries.
@@ -628,70 +634,184 @@ void LibraryTreeWidget::addModelicaLibraries(QSplashScreen *pSplashScreen)
       continue;
     }
     OMCInterface::getClassInformation_res classInformation = mpMainWindow->getOMCProxy()->getClassInformation(lib);
+    mpMainWindow->getLibraryTreeCache()->loadLibrary(lib, classInformation.fileName);
     LibraryTreeNode *pNewLibraryTreeNode = new LibraryTreeNode(LibraryTreeNode::Modelica, lib, "", lib, classInformation, "", true, this);
-    bool isDocumentationClass = mpMainWindow->getOMCProxy()->getDocumentationClassAnnotation(lib);
-    pNewLibraryTreeNode->setIsDocumentationClass(isDocumentationClass);
+    pNewLibraryTreeNode->setIsDocumentationClass(getClassesInformation(QStringList() << lib, false, true).first().mIsDocumentationClass);
     // get the Icon for Modelica tree node
     loadLibraryComponent(pNewLibraryTreeNode);
     addTopLevelItem(pNewLibraryTreeNode);
-    mLibraryTreeNodesList.append(pNewLibraryTreeNode);
+    addToLibraryTreeNodesList(pNewLibraryTreeNode);
     createLibraryTreeNodes(pNewLibraryTreeNode);
   }
+  mpMainWindow->getLibraryTreeCache()->saveLibraries();
 }
 
+/*!
+ * \brief LibraryTreeWidget::createLibraryTreeNodes
+ * Reads the names of all the nested classes of the LibraryTreeNode. The LibraryTreeNodes of the nested classes are not created here.
+ * They are created level by level when their parent is expanded or looked up.
+ * \param pLibraryTreeNode
+ * \sa LibraryTreeWidget::createChildLibraryTreeNodes
+ */
 void LibraryTreeWidget::createLibraryTreeNodes(LibraryTreeNode *pLibraryTreeNode)
 {
-  QStringList libs = mpMainWindow->getOMCProxy()->getClassNames(pLibraryTreeNode->getNameStructure(), true);
-  if (!libs.isEmpty()) {
-    libs.removeFirst();
-  }
-  QList<LibraryTreeNode*> nodes;
-  foreach (QString lib, libs) {
+  QStringList libs;
+  // the class names of the top level libraries are read from the library cache if possible.
+  bool useLibraryTreeCache = pLibraryTreeNode->getParentName().isEmpty() &&
+      mpMainWindow->getLibraryTreeCache()->isLibraryCached(pLibraryTreeNode->getNameStructure());
+  if (!useLibraryTreeCache || !mpMainWindow->getLibraryTreeCache()->getClassNames(pLibraryTreeNode->getNameStructure(), &libs)) {
+    libs = mpMainWindow->getOMCProxy()->getClassNames(pLibraryTreeNode->getNameStructure(), true);
+    if (!libs.isEmpty()) {
+      libs.removeFirst();
+    }
     /* $Code is a special OpenModelica keyword. No API command will work if we use it. */
-    if (lib.contains("$Code")) {
-      continue;
+    for (int i = libs.size() - 1 ; i >= 0 ; i--) {
+      if (libs.at(i).contains("$Code")) {
+        libs.removeAt(i);
+      }
     }
+    if (useLibraryTreeCache) {
+      mpMainWindow->getLibraryTreeCache()->setClassNames(pLibraryTreeNode->getNameStructure(), libs);
+    }
+  }
+  // forget the nested classes read before and group the class names by their parents.
+  removeUnloadedChildLibraryTreeNodes(pLibraryTreeNode->getNameStructure());
+  foreach (QString lib, libs) {
+    mUnloadedChildLibraryTreeNodesHash[StringHandler::removeLastWordAfterDot(lib)].append(lib);
+  }
+  if (mUnloadedChildLibraryTreeNodesHash.contains(pLibraryTreeNode->getNameStructure())) {
+    pLibraryTreeNode->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+  }
+}
+
+/*!
+ * \brief LibraryTreeWidget::createChildLibraryTreeNodes
+ * Creates the LibraryTreeNodes of the direct nested classes of the LibraryTreeNode which are not created yet.
+ * \param pLibraryTreeNode
+ */
+void LibraryTreeWidget::createChildLibraryTreeNodes(LibraryTreeNode *pLibraryTreeNode)
+{
+  if (!mUnloadedChildLibraryTreeNodesHash.contains(pLibraryTreeNode->getNameStructure())) {
+    return;
+  }
+  QStringList libs = mUnloadedChildLibraryTreeNodesHash.take(pLibraryTreeNode->getNameStructure());
+  // fetch the information of all the classes in one go.
+  QList<batchedClassInformation> classesInformation = getClassesInformation(libs, true);
+  bool showProtectedClasses = mpMainWindow->getOptionsDialog()->getGeneralSettingsPage()->getShowProtectedClasses();
+  for (int i = 0 ; i < libs.size() ; i++) {
+    QString lib = libs.at(i);
     QString name = StringHandler::getLastWordAfterDot(lib);
     QString parentName = StringHandler::removeLastWordAfterDot(lib);
-    OMCInterface::getClassInformation_res classInformation = mpMainWindow->getOMCProxy()->getClassInformation(lib);
-    LibraryTreeNode *pNewLibraryTreeNode = new LibraryTreeNode(LibraryTreeNode::Modelica, name, parentName, lib, classInformation, "",
-                                                               pLibraryTreeNode->isSaved(), this);
+    LibraryTreeNode *pNewLibraryTreeNode = new LibraryTreeNode(LibraryTreeNode::Modelica, name, parentName, lib,
+                                                               classesInformation.at(i).mClassInformation, "", pLibraryTreeNode->isSaved(), this);
     pNewLibraryTreeNode->setSystemLibrary(pLibraryTreeNode->isSystemLibrary());
-    LibraryTreeNode *pParentLibraryTreeNode = getLibraryTreeNode(parentName);
-    if (pParentLibraryTreeNode->isDocumentationClass()) {
+    if (pLibraryTreeNode->isDocumentationClass()) {
       pNewLibraryTreeNode->setIsDocumentationClass(true);
     } else {
-      bool isDocumentationClass = mpMainWindow->getOMCProxy()->getDocumentationClassAnnotation(lib);
-      pNewLibraryTreeNode->setIsDocumentationClass(isDocumentationClass);
+      pNewLibraryTreeNode->setIsDocumentationClass(classesInformation.at(i).mIsDocumentationClass);
+    }
+    pNewLibraryTreeNode->setIsProtected(classesInformation.at(i).mIsProtected);
+    if (mUnloadedChildLibraryTreeNodesHash.contains(lib)) {
+      pNewLibraryTreeNode->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+    pLibraryTreeNode->addChild(pNewLibraryTreeNode);
+    if (pNewLibraryTreeNode->isProtected()) {
+      pNewLibraryTreeNode->setHidden(!showProtectedClasses);
+    }
+    addToLibraryTreeNodesList(pNewLibraryTreeNode);
+  }
+  pLibraryTreeNode->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+/*!
+ * \brief LibraryTreeWidget::createAllChildLibraryTreeNodes
+ * Creates the LibraryTreeNodes of all the nested classes of the LibraryTreeNode. Used before saving where the complete tree is needed.
+ * \param pLibraryTreeNode
+ */
+void LibraryTreeWidget::createAllChildLibraryTreeNodes(LibraryTreeNode *pLibraryTreeNode)
+{
+  createChildLibraryTreeNodes(pLibraryTreeNode);
+  for (int i = 0 ; i < pLibraryTreeNode->childCount() ; i++) {
+    createAllChildLibraryTreeNodes(dynamic_cast<LibraryTreeNode*>(pLibraryTreeNode->child(i)));
+  }
+}
+
+/*!
+ * \brief LibraryTreeWidget::removeUnloadedChildLibraryTreeNodes
+ * Removes the names of the nested classes of nameStructure which are not created yet.
+ * \param nameStructure
+ */
+void LibraryTreeWidget::removeUnloadedChildLibraryTreeNodes(QString nameStructure)
+{
+  mUnloadedChildLibraryTreeNodesHash.remove(nameStructure);
+  QString prefix = nameStructure + ".";
+  QHash<QString, QStringList>::iterator i = mUnloadedChildLibraryTreeNodesHash.begin();
+  while (i != mUnloadedChildLibraryTreeNodesHash.end()) {
+    if (i.key().startsWith(prefix)) {
+      i = mUnloadedChildLibraryTreeNodesHash.erase(i);
+    } else {
+      ++i;
     }
-    nodes.append(pNewLibraryTreeNode);
-    mLibraryTreeNodesList.append(pNewLibraryTreeNode);
   }
-  addLibraryTreeNodes(nodes);
+}
+
+/*!
+ * \brief LibraryTreeWidget::renameUnloadedChildLibraryTreeNodes
+ * Moves the names of the nested classes of oldNameStructure which are not created yet to newNameStructure.
+ * \param oldNameStructure
+ * \param newNameStructure
+ */
+void LibraryTreeWidget::renameUnloadedChildLibraryTreeNodes(QString oldNameStructure, QString newNameStructure)
+{
+  QString prefix = oldNameStructure + ".";
+  QHash<QString, QStringList> renamedChildLibraryTreeNodesHash;
+  QHash<QString, QStringList>::iterator i = mUnloadedChildLibraryTreeNodesHash.begin();
+  while (i != mUnloadedChildLibraryTreeNodesHash.end()) {
+    if (i.key().compare(oldNameStructure) == 0 || i.key().startsWith(prefix)) {
+      QStringList libs;
+      foreach (QString lib, i.value()) {
+        libs.append(newNameStructure + lib.mid(oldNameStructure.length()));
+      }
+      renamedChildLibraryTreeNodesHash.insert(newNameStructure + i.key().mid(oldNameStructure.length()), libs);
+      i = mUnloadedChildLibraryTreeNodesHash.erase(i);
+    } else {
+      ++i;
+    }
+  }
+  QHash<QString, QStringList>::const_iterator j;
+  for (j = renamedChildLibraryTreeNodesHash.constBegin() ; j != renamedChildLibraryTreeNodesHash.constEnd() ; ++j) {
+    mUnloadedChildLibraryTreeNodesHash.insert(j.key(), j.value());
+  }
 }
 
 void LibraryTreeWidget::expandLibraryTreeNode(LibraryTreeNode *pLibraryTreeNode)
 {
+  createChildLibraryTreeNodes(pLibraryTreeNode);
   // set the range for progress bar.
   int progressValue = 0;
   mpMainWindow->getProgressBar()->setRange(0, pLibraryTreeNode->childCount());
   mpMainWindow->showProgressBar();
+  // fetch the information and the icon annotations of all the children in one go.
+  QStringList classNames;
   for (int i = 0 ; i < pLibraryTreeNode->childCount() ; i++) {
-    loadLibraryTreeNode(pLibraryTreeNode, dynamic_cast<LibraryTreeNode*>(pLibraryTreeNode->child(i)));
+    classNames.append(dynamic_cast<LibraryTreeNode*>(pLibraryTreeNode->child(i))->getNameStructure());
+  }
+  QList<batchedClassInformation> classesInformation = getClassesInformation(classNames, true, true);
+  for (int i = 0 ; i < pLibraryTreeNode->childCount() ; i++) {
+    loadLibraryTreeNode(pLibraryTreeNode, dynamic_cast<LibraryTreeNode*>(pLibraryTreeNode->child(i)), classesInformation.at(i));
     mpMainWindow->getProgressBar()->setValue(++progressValue);
   }
   mpMainWindow->hideProgressBar();
 }
 
-void LibraryTreeWidget::loadLibraryTreeNode(LibraryTreeNode *pParentLibraryTreeNode, LibraryTreeNode *pLibraryTreeNode)
+void LibraryTreeWidget::loadLibraryTreeNode(LibraryTreeNode *pParentLibraryTreeNode, LibraryTreeNode *pLibraryTreeNode,
+                                            const batchedClassInformation &classInformation)
 {
   QString className = pLibraryTreeNode->getNameStructure();
-  QString parentName = pParentLibraryTreeNode->getNameStructure();
-  QString name = pLibraryTreeNode->getName();
   mpMainWindow->getStatusBar()->showMessage(QString(Helper::loading).append(": ").append(className));
-  pLibraryTreeNode->setClassInformation(mpMainWindow->getOMCProxy()->getClassInformation(className));
+  pLibraryTreeNode->setClassInformation(classInformation.mClassInformation);
   pLibraryTreeNode->setIsSaved(pParentLibraryTreeNode->isSaved());
-  pLibraryTreeNode->setIsProtected(mpMainWindow->getOMCProxy()->isProtectedClass(parentName, name));
+  pLibraryTreeNode->setIsProtected(classInformation.mIsProtected);
   // update LibraryTreeNode attributes
   pLibraryTreeNode->updateAttributes();
   if (pLibraryTreeNode->isProtected()) {
@@ -701,27 +821,44 @@ void LibraryTreeWidget::loadLibraryTreeNode(LibraryTreeNode *pParentLibraryTreeN
   loadLibraryComponent(pLibraryTreeNode);
 }
 
-void LibraryTreeWidget::addLibraryTreeNodes(QList<LibraryTreeNode *> libraryTreeNodes)
+/*!
+ * \brief LibraryTreeWidget::getClassesInformation
+ * Gets the information of the classes from the library cache. The classes not found in the cache are fetched from OMC in one
+ * batched query and added to the cache.
+ * \param classNames
+ * \param protectedStatus
+ * \param iconAnnotation
+ * \return the list of results in the same order as classNames.
+ * \sa OMCProxy::getClassesInformation
+ */
+QList<batchedClassInformation> LibraryTreeWidget::getClassesInformation(QStringList classNames, bool protectedStatus, bool iconAnnotation)
 {
-  foreach (LibraryTreeNode *pLibraryTreeNode, libraryTreeNodes)
-  {
-    if (pLibraryTreeNode->getParentName().isEmpty())
-    {
-      addTopLevelItem(pLibraryTreeNode);
-    }
-    else
-    {
-      QString parentName = StringHandler::removeLastWordAfterDot(pLibraryTreeNode->getNameStructure());
-      for (int i = 0 ; i < mLibraryTreeNodesList.size() ; i++)
-      {
-        if (mLibraryTreeNodesList[i]->getNameStructure().compare(parentName) == 0)
-        {
-          mLibraryTreeNodesList[i]->addChild(pLibraryTreeNode);
-          break;
-        }
+  OMCProxy *pOMCProxy = mpMainWindow->getOMCProxy();
+  QList<batchedClassInformation> classesInformation;
+  QStringList uncachedClassNames;
+  QList<int> uncachedIndexes;
+  for (int i = 0 ; i < classNames.size() ; i++) {
+    batchedClassInformation classInformation;
+    if (mpMainWindow->getLibraryTreeCache()->getClassInformation(classNames.at(i), &classInformation, protectedStatus, iconAnnotation)) {
+      // put the icon annotation in the OMC cache so LibraryTreeWidget::loadLibraryComponent doesn't query it.
+      if (iconAnnotation) {
+        pOMCProxy->cacheOMCCommand(classNames.at(i), "getIconAnnotation(" + classNames.at(i) + ")", classInformation.mIconAnnotation);
       }
+    } else {
+      uncachedClassNames.append(classNames.at(i));
+      uncachedIndexes.append(i);
     }
+    classesInformation.append(classInformation);
   }
+  if (!uncachedClassNames.isEmpty()) {
+    QList<batchedClassInformation> uncachedClassesInformation;
+    uncachedClassesInformation = pOMCProxy->getClassesInformation(uncachedClassNames, protectedStatus, iconAnnotation);
+    for (int i = 0 ; i < uncachedClassesInformation.size() ; i++) {
+      classesInformation[uncachedIndexes.at(i)] = uncachedClassesInformation.at(i);
+      mpMainWindow->getLibraryTreeCache()->setClassInformation(uncachedClassNames.at(i), uncachedClassesInformation.at(i), protectedStatus, iconAnnotation);
+    }
+  }
+  return classesInformation;
 }
 
 bool LibraryTreeWidget::isLibraryTreeNodeExpanded(QTreeWidgetItem *item)
@@ -756,7 +893,8 @@ LibraryTreeNode* LibraryTreeWidget::addLibraryTreeNode(QString name, QString par
     bool isDocumentationClass = mpMainWindow->getOMCProxy()->getDocumentationClassAnnotation(className);
     pNewLibraryTreeNode->setIsDocumentationClass(isDocumentationClass);
   } else {
-    LibraryTreeNode *pLibraryTreeNode = getLibraryTreeNode(parentName);
+    mpMainWindow->getLibraryTreeCache()->removeLibrary(StringHandler::getFirstWordBeforeDot(parentName));
+    LibraryTreeNode *pLibraryTreeNode = getOrCreateLibraryTreeNode(parentName);
     if (insertIndex == 0) {
       pLibraryTreeNode->addChild(pNewLibraryTreeNode);
     } else {
@@ -771,7 +909,7 @@ LibraryTreeNode* LibraryTreeWidget::addLibraryTreeNode(QString name, QString par
   }
   // load the models icon
   loadLibraryComponent(pNewLibraryTreeNode);
-  mLibraryTreeNodesList.append(pNewLibraryTreeNode);
+  addToLibraryTreeNodesList(pNewLibraryTreeNode);
   mpMainWindow->getStatusBar()->clearMessage();
   return pNewLibraryTreeNode;
 }
@@ -803,7 +941,7 @@ LibraryTreeNode* LibraryTreeWidget::addLibraryTreeNode(LibraryTreeNode::LibraryT
   } else {
     insertTopLevelItem(insertIndex, pNewLibraryTreeNode);
   }
-  mLibraryTreeNodesList.append(pNewLibraryTreeNode);
+  addToLibraryTreeNodesList(pNewLibraryTreeNode);
   mpMainWindow->getStatusBar()->clearMessage();
   return pNewLibraryTreeNode;
 }
@@ -811,29 +949,63 @@ LibraryTreeNode* LibraryTreeWidget::addLibraryTreeNode(LibraryTreeNode::LibraryT
 /*!
  * \brief LibraryTreeWidget::getLibraryTreeNode
  * Search the LibraryTreeNode using the qualified path.
+ * The nested classes are created lazily so only the LibraryTreeNodes created so far are found.
  * \param nameStructure
  * \param caseSensitivity
  * \return
+ * \sa LibraryTreeWidget::getOrCreateLibraryTreeNode
  */
 LibraryTreeNode* LibraryTreeWidget::getLibraryTreeNode(QString nameStructure, Qt::CaseSensitivity caseSensitivity)
 {
-  /* In order to make the search a bit quicker we search in toplevel items first.
-   * If no item is found then we search inside the items.
+  if (caseSensitivity == Qt::CaseSensitive) {
+    return mLibraryTreeNodesHash.value(nameStructure, 0);
+  }
+  /* Several classes might only differ in case. Return the first one in the tree order, like the tree traversal did,
+   * instead of the one inserted last in the index.
    */
-  LibraryTreeNode *pLibraryTreeNode;
-  for (int i = 0 ; i < topLevelItemCount(); i++) {
-    pLibraryTreeNode = dynamic_cast<LibraryTreeNode*>(topLevelItem(i));
-    if (pLibraryTreeNode->getNameStructure().compare(nameStructure, caseSensitivity) == 0) {
-      return pLibraryTreeNode;
+  QList<LibraryTreeNode*> libraryTreeNodes = mLibraryTreeNodesCaseInsensitiveHash.values(nameStructure.toLower());
+  LibraryTreeNode *pLibraryTreeNode = 0;
+  foreach (LibraryTreeNode *pCaseInsensitiveLibraryTreeNode, libraryTreeNodes) {
+    if (!pLibraryTreeNode || isBeforeInTree(pCaseInsensitiveLibraryTreeNode, pLibraryTreeNode)) {
+      pLibraryTreeNode = pCaseInsensitiveLibraryTreeNode;
     }
   }
-  // search all items
-  for (int i = 0 ; i < mLibraryTreeNodesList.size() ; i++) {
-    if (mLibraryTreeNodesList[i]->getNameStructure().compare(nameStructure, caseSensitivity) == 0) {
-      return mLibraryTreeNodesList[i];
+  return pLibraryTreeNode;
+}
+
+/*!
+ * \brief LibraryTreeWidget::getOrCreateLibraryTreeNode
+ * Search the LibraryTreeNode using the qualified path. If it is not created yet then creates the nested classes along the path.
+ * Only the levels listed in the index of the unloaded nested classes are created so a class that doesn't exist costs no OMC query.
+ * \param nameStructure
+ * \param caseSensitivity
+ * \return
+ */
+LibraryTreeNode* LibraryTreeWidget::getOrCreateLibraryTreeNode(QString nameStructure, Qt::CaseSensitivity caseSensitivity)
+{
+  LibraryTreeNode *pLibraryTreeNode = getLibraryTreeNode(nameStructure, caseSensitivity);
+  if (pLibraryTreeNode) {
+    return pLibraryTreeNode;
+  }
+  // find the nearest LibraryTreeNode along the path which is already created.
+  QStringList names = StringHandler::makeVariableParts(nameStructure);
+  int index = names.size() - 1;
+  while (index > 0 && !pLibraryTreeNode) {
+    pLibraryTreeNode = getLibraryTreeNode(QStringList(names.mid(0, index)).join("."), caseSensitivity);
+    if (!pLibraryTreeNode) {
+      index--;
     }
   }
-  return 0;
+  // create the rest of the path level by level.
+  for (; pLibraryTreeNode && index < names.size() ; index++) {
+    QString childNameStructure = pLibraryTreeNode->getNameStructure() + "." + names.at(index);
+    if (!mUnloadedChildLibraryTreeNodesHash.value(pLibraryTreeNode->getNameStructure()).contains(childNameStructure, caseSensitivity)) {
+      return 0;
+    }
+    createChildLibraryTreeNodes(pLibraryTreeNode);
+    pLibraryTreeNode = getLibraryTreeNode(childNameStructure, caseSensitivity);
+  }
+  return pLibraryTreeNode;
 }
 
 QList<LibraryTreeNode*> LibraryTreeWidget::getLibraryTreeNodesList()
@@ -841,29 +1013,119 @@ QList<LibraryTreeNode*> LibraryTreeWidget::getLibraryTreeNodesList()
   return mLibraryTreeNodesList;
 }
 
+/*!
+ * \brief LibraryTreeWidget::setLibraryTreeNodeNameStructure
+ * Renames the LibraryTreeNode and updates the indexes of the LibraryTreeNodes and LibraryComponents.
+ * \param pLibraryTreeNode
+ * \param nameStructure
+ */
+void LibraryTreeWidget::setLibraryTreeNodeNameStructure(LibraryTreeNode *pLibraryTreeNode, QString nameStructure)
+{
+  renameUnloadedChildLibraryTreeNodes(pLibraryTreeNode->getNameStructure(), nameStructure);
+  removeFromLibraryTreeNodesHash(pLibraryTreeNode);
+  LibraryComponent *pLibraryComponent = mLibraryComponentsHash.take(pLibraryTreeNode->getNameStructure());
+  pLibraryTreeNode->setNameStructure(nameStructure);
+  addToLibraryTreeNodesHash(pLibraryTreeNode);
+  if (pLibraryComponent) {
+    pLibraryComponent->mClassName = nameStructure;
+    removeLibraryComponentObject(nameStructure);
+    mLibraryComponentsHash.insert(nameStructure, pLibraryComponent);
+  }
+}
+
 void LibraryTreeWidget::addLibraryComponentObject(LibraryComponent *libraryComponent)
 {
   mLibraryComponentsList.append(libraryComponent);
+  mLibraryComponentsHash.insert(libraryComponent->mClassName, libraryComponent);
+}
+
+/*!
+ * \brief LibraryTreeWidget::removeLibraryComponentObject
+ * Removes the LibraryComponent of the class from the list and the index.
+ * \param className
+ */
+void LibraryTreeWidget::removeLibraryComponentObject(QString className)
+{
+  LibraryComponent *pLibraryComponent = mLibraryComponentsHash.take(className);
+  if (pLibraryComponent) {
+    mLibraryComponentsList.removeOne(pLibraryComponent);
+  }
 }
 
 Component* LibraryTreeWidget::getComponentObject(QString className)
 {
-  foreach (LibraryComponent *pLibraryComponent, mLibraryComponentsList) {
-    if (pLibraryComponent->mClassName == className) {
-      return pLibraryComponent->mpComponent;
-    }
+  LibraryComponent *pLibraryComponent = mLibraryComponentsHash.value(className, 0);
+  if (pLibraryComponent) {
+    return pLibraryComponent->getComponent();
   }
   return 0;
 }
 
 LibraryComponent* LibraryTreeWidget::getLibraryComponentObject(QString className)
 {
-  foreach (LibraryComponent *pLibraryComponent, mLibraryComponentsList) {
-    if (pLibraryComponent->mClassName == className) {
-      return pLibraryComponent;
+  return mLibraryComponentsHash.value(className, 0);
+}
+
+/*!
+ * \brief LibraryTreeWidget::addToLibraryTreeNodesList
+ * Adds the LibraryTreeNode to the list and to the name indexes.
+ * \param pLibraryTreeNode
+ */
+void LibraryTreeWidget::addToLibraryTreeNodesList(LibraryTreeNode *pLibraryTreeNode)
+{
+  mLibraryTreeNodesList.append(pLibraryTreeNode);
+  addToLibraryTreeNodesHash(pLibraryTreeNode);
+}
+
+/*!
+ * \brief LibraryTreeWidget::removeFromLibraryTreeNodesList
+ * Removes the LibraryTreeNode from the list and from the name indexes.
+ * \param pLibraryTreeNode
+ */
+void LibraryTreeWidget::removeFromLibraryTreeNodesList(LibraryTreeNode *pLibraryTreeNode)
+{
+  mLibraryTreeNodesList.removeOne(pLibraryTreeNode);
+  removeFromLibraryTreeNodesHash(pLibraryTreeNode);
+}
+
+void LibraryTreeWidget::addToLibraryTreeNodesHash(LibraryTreeNode *pLibraryTreeNode)
+{
+  mLibraryTreeNodesHash.insert(pLibraryTreeNode->getNameStructure(), pLibraryTreeNode);
+  // several classes might only differ in case so the case-folded index is a multi hash.
+  mLibraryTreeNodesCaseInsensitiveHash.insert(pLibraryTreeNode->getNameStructure().toLower(), pLibraryTreeNode);
+}
+
+void LibraryTreeWidget::removeFromLibraryTreeNodesHash(LibraryTreeNode *pLibraryTreeNode)
+{
+  if (mLibraryTreeNodesHash.value(pLibraryTreeNode->getNameStructure(), 0) == pLibraryTreeNode) {
+    mLibraryTreeNodesHash.remove(pLibraryTreeNode->getNameStructure());
+  }
+  mLibraryTreeNodesCaseInsensitiveHash.remove(pLibraryTreeNode->getNameStructure().toLower(), pLibraryTreeNode);
+}
+
+/*!
+ * \brief LibraryTreeWidget::isBeforeInTree
+ * Compares the positions of the items in a pre-order traversal of the tree.
+ * \param pTreeWidgetItem1
+ * \param pTreeWidgetItem2
+ * \return true if pTreeWidgetItem1 comes before pTreeWidgetItem2.
+ */
+bool LibraryTreeWidget::isBeforeInTree(QTreeWidgetItem *pTreeWidgetItem1, QTreeWidgetItem *pTreeWidgetItem2)
+{
+  QList<int> indexes1, indexes2;
+  for (QTreeWidgetItem *pTreeWidgetItem = pTreeWidgetItem1 ; pTreeWidgetItem ; pTreeWidgetItem = pTreeWidgetItem->parent()) {
+    indexes1.prepend(pTreeWidgetItem->parent() ? pTreeWidgetItem->parent()->indexOfChild(pTreeWidgetItem) : indexOfTopLevelItem(pTreeWidgetItem));
+  }
+  for (QTreeWidgetItem *pTreeWidgetItem = pTreeWidgetItem2 ; pTreeWidgetItem ; pTreeWidgetItem = pTreeWidgetItem->parent()) {
+    indexes2.prepend(pTreeWidgetItem->parent() ? pTreeWidgetItem->parent()->indexOfChild(pTreeWidgetItem) : indexOfTopLevelItem(pTreeWidgetItem));
+  }
+  for (int i = 0 ; i < indexes1.size() && i < indexes2.size() ; i++) {
+    if (indexes1.at(i) != indexes2.at(i)) {
+      return indexes1.at(i) < indexes2.at(i);
     }
   }
-  return 0;
+  // an item comes before its children.
+  return indexes1.size() < indexes2.size();
 }
 
 bool LibraryTreeWidget::isFileWritAble(QString filePath)
@@ -924,7 +1186,9 @@ bool LibraryTreeWidget::unloadClass(LibraryTreeNode *pLibraryTreeNode, bool askQ
     If deleteClass is successfull remove the class from Library Browser and delete the corresponding ModelWidget.
     */
   if (mpMainWindow->getOMCProxy()->deleteClass(pLibraryTreeNode->getNameStructure())) {
+    mpMainWindow->getLibraryTreeCache()->removeLibrary(StringHandler::getFirstWordBeforeDot(pLibraryTreeNode->getNameStructure()));
     /* remove the child nodes first */
+    removeUnloadedChildLibraryTreeNodes(pLibraryTreeNode->getNameStructure());
     unloadClassHelper(pLibraryTreeNode);
     mpMainWindow->getOMCProxy()->removeCachedOMCCommand(pLibraryTreeNode->getNameStructure());
     unloadLibraryTreeNodeAndModelWidget(pLibraryTreeNode);
@@ -997,6 +1261,8 @@ bool LibraryTreeWidget::unloadTLMFile(LibraryTreeNode *pLibraryTreeNode, bool as
 
 void LibraryTreeWidget::unloadClassHelper(LibraryTreeNode *pLibraryTreeNode)
 {
+  // the library is changed so its cache is no longer valid.
+  mpMainWindow->getLibraryTreeCache()->removeLibrary(StringHandler::getFirstWordBeforeDot(pLibraryTreeNode->getNameStructure()));
   for (int i = 0 ; i < pLibraryTreeNode->childCount(); i++)
   {
     LibraryTreeNode *pChildLibraryTreeNode = dynamic_cast<LibraryTreeNode*>(pLibraryTreeNode->child(i));
@@ -1012,12 +1278,9 @@ void LibraryTreeWidget::unloadClassHelper(LibraryTreeNode *pLibraryTreeNode)
       pChildLibraryTreeNode->getModelWidget()->deleteLater();
     }
     mpMainWindow->getOMCProxy()->removeCachedOMCCommand(pChildLibraryTreeNode->getNameStructure());
-    mLibraryTreeNodesList.removeOne(pChildLibraryTreeNode);
+    removeFromLibraryTreeNodesList(pChildLibraryTreeNode);
     mExpandedLibraryTreeNodesList.removeOne(pChildLibraryTreeNode);
-    LibraryComponent *pLibraryComponent = getLibraryComponentObject(pChildLibraryTreeNode->getNameStructure());
-    if (pLibraryComponent) {
-      mLibraryComponentsList.removeOne(pLibraryComponent);
-    }
+    removeLibraryComponentObject(pChildLibraryTreeNode->getNameStructure());
     unloadClassHelper(pChildLibraryTreeNode);
   }
 }
@@ -1028,6 +1291,8 @@ bool LibraryTreeWidget::saveLibraryTreeNode(LibraryTreeNode *pLibraryTreeNode)
   mpMainWindow->getStatusBar()->showMessage(tr("Saving %1").arg(pLibraryTreeNode->getNameStructure()));
   mpMainWindow->showProgressBar();
   if (pLibraryTreeNode->getLibraryType() == LibraryTreeNode::Modelica) {
+    /* the nested classes are saved along with the class so make sure they are all created. */
+    createAllChildLibraryTreeNodes(pLibraryTreeNode);
     result = saveModelicaLibraryTreeNode(pLibraryTreeNode);
   } else if (pLibraryTreeNode->getLibraryType() == LibraryTreeNode::TLM) {
     result = saveTLMLibraryTreeNode(pLibraryTreeNode);
@@ -1123,6 +1388,8 @@ void LibraryTreeWidget::loadDependentLibraries(QStringList libraries)
 /*!
  * \brief LibraryTreeWidget::getLibraryTreeNodeFromFile
  * Search the LibraryTreeNode using the file name and line number.
+ * If the class is not created yet then its name is resolved from the path of the file relative to the library saved as directory
+ * structure, and the nested classes along that path are created.
  * \param fileName
  * \param lineNumber
  * \return LibraryTreeNode
@@ -1145,6 +1412,31 @@ LibraryTreeNode* LibraryTreeWidget::getLibraryTreeNodeFromFile(QString fileName,
       return mLibraryTreeNodesList[i];
     }
   }
+  // the class is not created yet. Find the library saved as directory structure containing the file.
+  QFileInfo fileInfo(fileName);
+  for (int i = 0 ; i < topLevelItemCount(); i++) {
+    pLibraryTreeNode = dynamic_cast<LibraryTreeNode*>(topLevelItem(i));
+    if (!pLibraryTreeNode || pLibraryTreeNode->getLibraryType() != LibraryTreeNode::Modelica) {
+      continue;
+    }
+    QFileInfo libraryFileInfo(pLibraryTreeNode->getFileName());
+    if (libraryFileInfo.fileName().compare("package.mo") != 0) {
+      continue;
+    }
+    QString libraryPath = libraryFileInfo.absolutePath() + "/";
+    if (!fileInfo.absoluteFilePath().startsWith(libraryPath)) {
+      continue;
+    }
+    // e.g. Library/Package/Model.mo is Library.Package.Model and Library/Package/package.mo is Library.Package
+    QStringList names = fileInfo.absoluteFilePath().mid(libraryPath.length()).split("/");
+    names.last() = QFileInfo(names.last()).completeBaseName();
+    if (names.last().compare("package") == 0) {
+      names.removeLast();
+    }
+    names.prepend(pLibraryTreeNode->getNameStructure());
+    pLibraryTreeNode = getOrCreateLibraryTreeNode(names.join("."));
+    return (pLibraryTreeNode && pLibraryTreeNode->inRange(lineNumber)) ? pLibraryTreeNode : 0;
+  }
   return 0;
 }
 
@@ -1577,12 +1869,9 @@ void LibraryTreeWidget::unloadLibraryTreeNodeAndModelWidget(LibraryTreeNode *pLi
   }
   /* delete the complete LibraryTreeNode */
   qDeleteAll(pLibraryTreeNode->takeChildren());
-  mLibraryTreeNodesList.removeOne(pLibraryTreeNode);
+  removeFromLibraryTreeNodesList(pLibraryTreeNode);
   mExpandedLibraryTreeNodesList.removeOne(pLibraryTreeNode);
-  LibraryComponent *pLibraryComponent = getLibraryComponentObject(pLibraryTreeNode->getNameStructure());
-  if (pLibraryComponent) {
-    mLibraryComponentsList.removeOne(pLibraryComponent);
-  }
+  removeLibraryComponentObject(pLibraryTreeNode->getNameStructure());
   /* Update the model switcher toolbar button. */
   mpMainWindow->updateModelSwitcherMenu(0);
   delete pLibraryTreeNode;
@@ -2084,7 +2373,7 @@ void LibraryTreeWidget::showModelWidget(LibraryTreeNode *pLibraryTreeNode, bool
   mpMainWindow->getPerspectiveTabBar()->setCurrentIndex(1);
   /* Search Tree Items never have model widget so find the equivalent Library Tree Node */
   if (isSearchedTree()) {
-    pLibraryTreeNode = mpMainWindow->getLibraryTreeWidget()->getLibraryTreeNode(pLibraryTreeNode->getNameStructure());
+    pLibraryTreeNode = mpMainWindow->getLibraryTreeWidget()->getOrCreateLibraryTreeNode(pLibraryTreeNode->getNameStructure());
     mpMainWindow->getLibraryTreeWidget()->showModelWidget(pLibraryTreeNode, newClass, extendsClass);
     QApplication::restoreOverrideCursor();
     return;
@@ -2103,41 +2392,168 @@ void LibraryTreeWidget::showModelWidget(LibraryTreeNode *pLibraryTreeNode, bool
 
 void LibraryTreeWidget::openLibraryTreeNode(QString nameStructure)
 {
-  LibraryTreeNode *pLibraryTreeNode = getLibraryTreeNode(nameStructure);
+  LibraryTreeNode *pLibraryTreeNode = getOrCreateLibraryTreeNode(nameStructure);
   if (!pLibraryTreeNode)
     return;
   showModelWidget(pLibraryTreeNode);
 }
 
+/*!
+ * \brief LibraryTreeWidget::loadLibraryComponent
+ * Creates the LibraryComponent of the class and queues its icon for rendering in the worker threads.
+ * The LibraryTreeNode shows its default icon until the icon is rendered.
+ * \param pLibraryTreeNode
+ * \sa LibraryTreeWidget::libraryComponentRendered
+ */
 void LibraryTreeWidget::loadLibraryComponent(LibraryTreeNode *pLibraryTreeNode)
 {
   OMCProxy *pOMCProxy = mpMainWindow->getOMCProxy();
   QString result = pOMCProxy->getIconAnnotation(pLibraryTreeNode->getNameStructure());
-  LibraryComponent *pLibraryComponent = getLibraryComponentObject(pLibraryTreeNode->getNameStructure());
-  if (pLibraryComponent) {
-    mLibraryComponentsList.removeOne(pLibraryComponent);
+  removeLibraryComponentObject(pLibraryTreeNode->getNameStructure());
+  LibraryComponent *pLibraryComponent = new LibraryComponent(result, pLibraryTreeNode->getNameStructure(), pOMCProxy);
+  pLibraryComponent->setImageKey(getLibraryIconKey(pLibraryTreeNode, result));
+  addLibraryComponentObject(pLibraryComponent);
+  pLibraryTreeNode->setIcon(0, pLibraryTreeNode->getModelicaNodeIcon());
+  renderLibraryComponent(pLibraryComponent);
+}
+
+/*!
+ * \brief LibraryTreeWidget::getLibraryIconKey
+ * Creates the key of the icon of the class in the LibraryIconCache from the icon annotation of the class and the icon annotations
+ * of all of its inherited classes. So the key changes when any of the annotations drawn in the icon changes.
+ * \param pLibraryTreeNode
+ * \param annotation - the icon annotation of the class.
+ * \return the key or an empty string if the icon should not be cached.
+ */
+QString LibraryTreeWidget::getLibraryIconKey(LibraryTreeNode *pLibraryTreeNode, QString annotation)
+{
+  // the icons of the unsaved classes change while they are edited.
+  if (!pLibraryTreeNode->isSaved()) {
+    return QString();
   }
-  pLibraryComponent = new LibraryComponent(result, pLibraryTreeNode->getNameStructure(), pOMCProxy);
-  QPixmap pixmap = pLibraryComponent->getComponentPixmap(iconSize());
-  // if the component does not have icon annotation check if it has non standard dymola annotation or not.
-  if (pixmap.isNull()) {
-    pOMCProxy->sendCommand("getNamedAnnotation(" + pLibraryTreeNode->getNameStructure() + ", __Dymola_DocumentationClass)");
-    if (StringHandler::unparseBool(StringHandler::removeFirstLastCurlBrackets(pOMCProxy->getResult())) || pLibraryTreeNode->isDocumentationClass()) {
-      result = pOMCProxy->getIconAnnotation("Modelica.Icons.Information");
-      pLibraryComponent = new LibraryComponent(result, pLibraryTreeNode->getNameStructure(), pOMCProxy);
-      pixmap = pLibraryComponent->getComponentPixmap(iconSize());
-      // if still the pixmap is null for some unknown reasons then used the pre defined image
-      if (pixmap.isNull()) {
-        pLibraryTreeNode->setIcon(0, QIcon(":/Resources/icons/info-icon.svg"));
+  QStringList annotations;
+  QSet<QString> classNames;
+  annotations.append(annotation);
+  classNames.insert(pLibraryTreeNode->getNameStructure());
+  getInheritedIconAnnotations(pLibraryTreeNode->getNameStructure(), &annotations, &classNames);
+  return LibraryIconCache::imageKey(pLibraryTreeNode->getNameStructure(), annotations.join("\n"), getLibraryIconImageSize());
+}
+
+/*!
+ * \brief LibraryTreeWidget::getInheritedIconAnnotations
+ * Appends the names and the icon annotations of the inherited classes of the class, depth first in the order they are drawn.
+ * \param className
+ * \param pAnnotations
+ * \param pClassNames - the classes already visited. Used to avoid cycles.
+ */
+void LibraryTreeWidget::getInheritedIconAnnotations(QString className, QStringList *pAnnotations, QSet<QString> *pClassNames)
+{
+  ComponentClass *pComponentClass = mpMainWindow->getOMCProxy()->getComponentClassCache()->getComponentClass(className, false);
+  foreach (ComponentClassInheritance inheritance, pComponentClass->getInheritedClasses()) {
+    if (pClassNames->contains(inheritance.mClassName)) {
+      continue;
+    }
+    pClassNames->insert(inheritance.mClassName);
+    pAnnotations->append(inheritance.mClassName);
+    pAnnotations->append(inheritance.mAnnotation);
+    getInheritedIconAnnotations(inheritance.mClassName, pAnnotations, pClassNames);
+  }
+}
+
+/*!
+ * \brief LibraryTreeWidget::getLibraryIconImageSize
+ * The icons are rendered big enough to be reused for the drag pixmap.
+ * \return the size of the rendered icons.
+ */
+QSize LibraryTreeWidget::getLibraryIconImageSize()
+{
+  return iconSize().expandedTo(QSize(50, 50));
+}
+
+/*!
+ * \brief LibraryTreeWidget::renderLibraryComponent
+ * Queues the icon of the LibraryComponent for rendering in the worker threads.
+ * If the LibraryComponent has a cache key then the worker looks up the LibraryIconCache first and the icon annotation is only parsed
+ * on a cache miss.
+ * \param pLibraryComponent
+ * \param lookupCache
+ * \sa LibraryTreeWidget::libraryComponentRenderRequested
+ */
+void LibraryTreeWidget::renderLibraryComponent(LibraryComponent *pLibraryComponent, bool lookupCache)
+{
+  // the render id tells the rendered icon of a LibraryComponent apart from the one of a LibraryComponent created later for the same class.
+  pLibraryComponent->setRenderId(++mLibraryComponentsRenderId);
+  lookupCache = lookupCache && !pLibraryComponent->getImageKey().isEmpty();
+  mpMainWindow->getLibraryIconsThreadPool()->start(new LibraryComponentRenderTask(pLibraryComponent, getLibraryIconImageSize(), lookupCache,
+                                                                                  mpMainWindow->getLibraryIconCache(), this));
+}
+
+/*!
+ * \brief LibraryTreeWidget::libraryComponentRenderRequested
+ * Slot activated when the icon of the class is not found in the LibraryIconCache.
+ * Queues the icon for rendering.
+ * \param className
+ * \param renderId - the render id of the LibraryComponent when the lookup was queued.
+ */
+void LibraryTreeWidget::libraryComponentRenderRequested(QString className, int renderId)
+{
+  LibraryComponent *pLibraryComponent = getLibraryComponentObject(className);
+  if (pLibraryComponent && pLibraryComponent->getRenderId() == renderId) {
+    renderLibraryComponent(pLibraryComponent, false);
+  }
+}
+
+/*!
+ * \brief LibraryTreeWidget::libraryComponentRendered
+ * Slot activated when the icon of the class is rendered by LibraryComponentRenderTask.\n
+ * Sets the rendered icon on the LibraryTreeNode.
+ * \param className
+ * \param renderId - the render id of the LibraryComponent when the task was queued.
+ * \param image - the rendered icon. A null image means the class has no icon.
+ */
+void LibraryTreeWidget::libraryComponentRendered(QString className, int renderId, QImage image)
+{
+  LibraryTreeNode *pLibraryTreeNode = 0;
+  if (isSearchedTree()) {
+    // the searched classes are only top level items and they are not indexed.
+    for (int i = 0 ; i < topLevelItemCount() ; i++) {
+      LibraryTreeNode *pTopLevelLibraryTreeNode = dynamic_cast<LibraryTreeNode*>(topLevelItem(i));
+      if (pTopLevelLibraryTreeNode->getNameStructure().compare(className) == 0) {
+        pLibraryTreeNode = pTopLevelLibraryTreeNode;
+        break;
       }
-    } else {
-      // if the component does not have non standard dymola annotation as well.
-      pLibraryTreeNode->setIcon(0, pLibraryTreeNode->getModelicaNodeIcon());
     }
   } else {
-    pLibraryTreeNode->setIcon(0, QIcon(pixmap));
+    pLibraryTreeNode = mLibraryTreeNodesHash.value(className, 0);
+  }
+  LibraryComponent *pLibraryComponent = getLibraryComponentObject(className);
+  // the class is unloaded or its LibraryComponent is recreated in the meantime.
+  if (!pLibraryTreeNode || !pLibraryComponent || pLibraryComponent->getRenderId() != renderId) {
+    return;
+  }
+  pLibraryComponent->setRenderedImage(image);
+  if (!image.isNull()) {
+    pLibraryTreeNode->setIcon(0, QIcon(QPixmap::fromImage(image)));
+    return;
+  }
+  // if still the image of the documentation icon is null for some unknown reasons then used the pre defined image
+  if (pLibraryComponent->isDocumentationIcon()) {
+    pLibraryTreeNode->setIcon(0, QIcon(":/Resources/icons/info-icon.svg"));
+    return;
+  }
+  // if the component does not have icon annotation check if it has non standard dymola annotation or not.
+  OMCProxy *pOMCProxy = mpMainWindow->getOMCProxy();
+  pOMCProxy->sendCommand("getNamedAnnotation(" + className + ", __Dymola_DocumentationClass)");
+  if (StringHandler::unparseBool(StringHandler::removeFirstLastCurlBrackets(pOMCProxy->getResult())) || pLibraryTreeNode->isDocumentationClass()) {
+    QString result = pOMCProxy->getIconAnnotation("Modelica.Icons.Information");
+    removeLibraryComponentObject(className);
+    QString imageKey = pLibraryComponent->getImageKey();
+    pLibraryComponent = new LibraryComponent(result, className, pOMCProxy);
+    pLibraryComponent->setImageKey(imageKey.isEmpty() ? imageKey : imageKey + "|documentationIcon");
+    pLibraryComponent->setIsDocumentationIcon(true);
+    addLibraryComponentObject(pLibraryComponent);
+    renderLibraryComponent(pLibraryComponent);
   }
-  addLibraryComponentObject(pLibraryComponent);
 }
 
 void LibraryTreeWidget::mouseDoubleClickEvent(QMouseEvent *event)
@@ -2154,7 +2570,7 @@ void LibraryTreeWidget::startDrag(Qt::DropActions supportedActions)
   // get the component pixmap to show on drag
   LibraryComponent *pLibraryComponent = getLibraryComponentObject(pLibraryTreeNode->getNameStructure());
   if (isSearchedTree()) {
-    pLibraryTreeNode = mpMainWindow->getLibraryTreeWidget()->getLibraryTreeNode(pLibraryTreeNode->getNameStructure());
+    pLibraryTreeNode = mpMainWindow->getLibraryTreeWidget()->getOrCreateLibraryTreeNode(pLibraryTreeNode->getNameStructure());
   }
   QByteArray itemData;
   QDataStream dataStream(&itemData, QIODevice::WriteOnly);
@@ -2166,7 +2582,13 @@ void LibraryTreeWidget::startDrag(Qt::DropActions supportedActions)
   drag->setMimeData(mimeData);
   // if we have component pixmap
   if (pLibraryComponent) {
-    QPixmap pixmap = pLibraryComponent->getComponentPixmap(QSize(50, 50));
+    // reuse the icon rendered for the tree if it is available.
+    QPixmap pixmap;
+    if (pLibraryComponent->isRendered()) {
+      pixmap = QPixmap::fromImage(pLibraryComponent->getRenderedImage()).scaled(50, 50, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    } else {
+      pixmap = pLibraryComponent->getComponentPixmap(QSize(50, 50));
+    }
     drag->setPixmap(pixmap);
     drag->setHotSpot(QPoint((drag->hotSpot().x() + adjust), (drag->hotSpot().y() + adjust)));
   }
@@ -2178,10 +2600,43 @@ Qt::DropActions LibraryTreeWidget::supportedDropActions() const
   return Qt::CopyAction;
 }
 
+/*!
+ * \class LibraryComponent
+ * \brief Holds the icon of a class in the library tree.
+ * The Component and its scene are only created when the icon is rendered or used, so an icon found in the LibraryIconCache never
+ * parses the icon annotation.
+ */
 LibraryComponent::LibraryComponent(QString value, QString className, OMCProxy *omc)
 {
   mClassName = className;
-  mpComponent = new Component(value, className, omc);
+  mValue = value;
+  mpOMCProxy = omc;
+  mpComponent = 0;
+  mpGraphicsView = 0;
+  mHasIconAnnotation = false;
+  mRenderId = 0;
+  mIsDocumentationIcon = false;
+  mRendered = false;
+  mImagesRequested = false;
+}
+
+LibraryComponent::~LibraryComponent()
+{
+  delete mpComponent;
+  delete mpGraphicsView;
+}
+
+/*!
+ * \brief LibraryComponent::getComponent
+ * Creates the Component and its scene if they are not created yet.
+ * \return the Component.
+ */
+Component* LibraryComponent::getComponent()
+{
+  if (mpComponent) {
+    return mpComponent;
+  }
+  mpComponent = new Component(mValue, mClassName, mpOMCProxy);
 
   if (mpComponent->boundingRect().width() > 1)
     mRectangle = mpComponent->boundingRect();
@@ -2198,33 +2653,92 @@ LibraryComponent::LibraryComponent(QString value, QString className, OMCProxy *o
   mpGraphicsView->setScene(new QGraphicsScene);
   mpGraphicsView->setSceneRect(mRectangle);
   mpGraphicsView->scene()->addItem(mpComponent);
+  return mpComponent;
 }
 
-LibraryComponent::~LibraryComponent()
+QPixmap LibraryComponent::getComponentPixmap(QSize size)
 {
-  delete mpComponent;
-  delete mpGraphicsView;
+  QImage image = getComponentImage(size);
+  if (image.isNull())
+    return QPixmap();
+  return QPixmap::fromImage(image);
 }
 
-QPixmap LibraryComponent::getComponentPixmap(QSize size)
+/*!
+ * \brief LibraryComponent::getComponentImage
+ * Renders the icon of the component in the GUI thread.
+ * \param size
+ * \return the rendered icon or a null QImage if the component has no icon annotation.
+ */
+QImage LibraryComponent::getComponentImage(QSize size)
 {
-  // if view is empty we return null QPixmap
-  mHasIconAnnotation = false;
-  hasIconAnnotation(mpComponent);
-  if (!mHasIconAnnotation)
-    return QPixmap();
+  qreal scale;
+  QPicture picture = getComponentPicture(size, &scale);
+  return LibraryComponentRenderTask::renderPicture(picture, mRectangle, scale, size);
+}
 
-  QPixmap pixmap(size);
-  pixmap.fill(QColor(Qt::transparent));
-  QPainter painter(&pixmap);
-  painter.setRenderHint(QPainter::Antialiasing);
-  painter.setRenderHint(QPainter::TextAntialiasing);
-  painter.setRenderHint(QPainter::SmoothPixmapTransform);
-  painter.setWindow(mRectangle.toRect());
-  painter.scale(1.0, -1.0);
-  mpGraphicsView->scene()->render(&painter, mRectangle, mpGraphicsView->sceneRect());
+/*!
+ * \brief LibraryComponent::getComponentPicture
+ * Records the painting of the scene. The scene can only be used from the GUI thread but the recorded QPicture is plain data
+ * which is rasterized by the worker threads.\n
+ * The scene is recorded at the scale of the icon so the bitmaps record their downscaled images. The images of the bitmaps that
+ * are not loaded yet are loaded here.
+ * \param size - the size of the icon.
+ * \param pScale - set to the scale of the recorded picture.
+ * \return the recorded picture or a null QPicture if the component has no icon annotation.
+ * \sa LibraryComponent::getUncachedImages
+ */
+QPicture LibraryComponent::getComponentPicture(QSize size, qreal *pScale)
+{
+  QPicture picture;
+  *pScale = 1;
+  mHasIconAnnotation = false;
+  hasIconAnnotation(getComponent());
+  if (!mHasIconAnnotation) {
+    return picture;
+  }
+  QList<BitmapAnnotation*> bitmapAnnotations;
+  getBitmapAnnotations(mpComponent, &bitmapAnnotations);
+  foreach (BitmapAnnotation *pBitmapAnnotation, bitmapAnnotations) {
+    pBitmapAnnotation->loadLibraryImage();
+  }
+  mImagesRequested = false;
+  *pScale = qMax(size.width() / mRectangle.width(), size.height() / mRectangle.height());
+  QPainter painter(&picture);
+  painter.scale(*pScale, *pScale);
+  mpGraphicsView->scene()->render(&painter, mRectangle, mRectangle);
   painter.end();
-  return pixmap;
+  return picture;
+}
+
+/*!
+ * \brief LibraryComponent::getUncachedImages
+ * Sets the cached images on the bitmaps of the icon.
+ * \return the file names and the imageSources of the images that are not cached.
+ */
+QList<QPair<QString, QString> > LibraryComponent::getUncachedImages()
+{
+  QList<QPair<QString, QString> > imageSources;
+  QList<BitmapAnnotation*> bitmapAnnotations;
+  getBitmapAnnotations(getComponent(), &bitmapAnnotations);
+  foreach (BitmapAnnotation *pBitmapAnnotation, bitmapAnnotations) {
+    QString fileName, imageSource;
+    if (!pBitmapAnnotation->loadCachedLibraryImage(&fileName, &imageSource) && !imageSources.contains(qMakePair(fileName, imageSource))) {
+      imageSources.append(qMakePair(fileName, imageSource));
+    }
+  }
+  return imageSources;
+}
+
+BitmapImageCache* LibraryComponent::getBitmapImageCache()
+{
+  return mpOMCProxy->getBitmapImageCache();
+}
+
+void LibraryComponent::setRenderedImage(QImage image)
+{
+  mRenderedImage = image;
+  mRendered = true;
 }
 
 void LibraryComponent::hasIconAnnotation(Component *pComponent)
@@ -2245,3 +2759,131 @@ void LibraryComponent::hasIconAnnotation(Component *pComponent)
     }
   }
 }
+
+/*!
+ * \brief LibraryComponent::getBitmapAnnotations
+ * Collects the bitmaps of the component, its inherited components and its child components.
+ * \param pComponent
+ * \param pBitmapAnnotations
+ */
+void LibraryComponent::getBitmapAnnotations(Component *pComponent, QList<BitmapAnnotation*> *pBitmapAnnotations)
+{
+  foreach (ShapeAnnotation *pShapeAnnotation, pComponent->getShapesList()) {
+    BitmapAnnotation *pBitmapAnnotation = dynamic_cast<BitmapAnnotation*>(pShapeAnnotation);
+    if (pBitmapAnnotation) {
+      pBitmapAnnotations->append(pBitmapAnnotation);
+    }
+  }
+  foreach (Component *pInheritedComponent, pComponent->getInheritanceList()) {
+    getBitmapAnnotations(pInheritedComponent, pBitmapAnnotations);
+  }
+  foreach (Component *pChildComponent, pComponent->getComponentsList()) {
+    getBitmapAnnotations(pChildComponent, pBitmapAnnotations);
+  }
+}
+
+/*!
+ * \class LibraryComponentRenderTask
+ * \brief Renders the icon of a LibraryComponent in a worker thread of the LibraryTreeWidget icons thread pool.
+ * The task only holds plain data i.e., the QPicture recorded from the scene in the GUI thread, so it never touches the
+ * LibraryComponent which might be deleted while the task is queued.
+ * The images of the bitmaps that are not cached are first loaded by the task so the GUI thread records the icon afterwards
+ * without reading and decoding the images.
+ * LibraryTreeWidget::libraryComponentRendered is invoked in the GUI thread once the icon is found in the cache or rendered.
+ * LibraryTreeWidget::libraryComponentRenderRequested is invoked if a cache lookup misses.
+ */
+/*!
+ * \brief LibraryComponentRenderTask::LibraryComponentRenderTask
+ * Called in the GUI thread.
+ * \param pLibraryComponent
+ * \param size
+ * \param lookupCache - if true then the task only looks up the icon in the LibraryIconCache.
+ * \param pLibraryIconCache
+ * \param pLibraryTreeWidget
+ */
+LibraryComponentRenderTask::LibraryComponentRenderTask(LibraryComponent *pLibraryComponent, QSize size, bool lookupCache,
+                                                       LibraryIconCache *pLibraryIconCache, LibraryTreeWidget *pLibraryTreeWidget)
+{
+  mClassName = pLibraryComponent->mClassName;
+  mRenderId = pLibraryComponent->getRenderId();
+  mLookupCache = lookupCache;
+  mpBitmapImageCache = pLibraryComponent->getBitmapImageCache();
+  mPictureScale = 1;
+  // the icon annotation is only parsed if the icon is rendered.
+  if (!mLookupCache) {
+    // the images that are still not cached after they are loaded, e.g. the missing files, are loaded while recording.
+    if (!pLibraryComponent->isImagesRequested()) {
+      mImageSources = pLibraryComponent->getUncachedImages();
+    }
+    if (mImageSources.isEmpty()) {
+      mPicture = pLibraryComponent->getComponentPicture(size, &mPictureScale);
+      mRectangle = pLibraryComponent->mRectangle;
+    } else {
+      pLibraryComponent->setImagesRequested(true);
+    }
+  }
+  mSize = size;
+  mKey = pLibraryComponent->getImageKey();
+  mpLibraryIconCache = pLibraryIconCache;
+  mpLibraryTreeWidget = pLibraryTreeWidget;
+}
+
+void LibraryComponentRenderTask::run()
+{
+  if (!mpLibraryTreeWidget) {
+    return;
+  }
+  QImage image;
+  if (mLookupCache) {
+    if (!mpLibraryIconCache->getImage(mKey, &image)) {
+      // the icon is not cached so let the GUI thread record it and queue it for rendering.
+      QMetaObject::invokeMethod(mpLibraryTreeWidget, "libraryComponentRenderRequested", Qt::QueuedConnection, Q_ARG(QString, mClassName),
+                                Q_ARG(int, mRenderId));
+      return;
+    }
+  } else if (!mImageSources.isEmpty()) {
+    for (int i = 0 ; i < mImageSources.size() ; i++) {
+      QString key;
+      mpBitmapImageCache->loadImage(mImageSources.at(i).first, mImageSources.at(i).second, &key);
+    }
+    // the images are cached now so let the GUI thread record the icon and queue it for rendering.
+    QMetaObject::invokeMethod(mpLibraryTreeWidget, "libraryComponentRenderRequested", Qt::QueuedConnection, Q_ARG(QString, mClassName),
+                              Q_ARG(int, mRenderId));
+    return;
+  } else {
+    image = renderPicture(mPicture, mRectangle, mPictureScale, mSize);
+    if (!mKey.isEmpty()) {
+      mpLibraryIconCache->setImage(mKey, image);
+    }
+  }
+  QMetaObject::invokeMethod(mpLibraryTreeWidget, "libraryComponentRendered", Qt::QueuedConnection, Q_ARG(QString, mClassName),
+                            Q_ARG(int, mRenderId), Q_ARG(QImage, image));
+}
+
+/*!
+ * \brief LibraryComponentRenderTask::renderPicture
+ * Rasterizes the picture. Unlike QPixmap, QImage can be painted outside the GUI thread.
+ * \param picture
+ * \param rectangle - the scene rectangle of the icon.
+ * \param scale - the scale the picture is recorded at.
+ * \param size
+ * \return the rendered icon or a null QImage if the picture is null.
+ */
+QImage LibraryComponentRenderTask::renderPicture(const QPicture &picture, QRectF rectangle, qreal scale, QSize size)
+{
+  if (picture.isNull()) {
+    return QImage();
+  }
+  QImage image(size, QImage::Format_ARGB32_Premultiplied);
+  image.fill(0);
+  QPainter painter(&image);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setRenderHint(QPainter::TextAntialiasing);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
+  painter.setWindow(rectangle.toRect());
+  painter.scale(1.0, -1.0);
+  painter.scale(1.0 / scale, 1.0 / scale);
+  painter.drawPicture(0, 0, picture);
+  painter.end();
+  return image;
+}
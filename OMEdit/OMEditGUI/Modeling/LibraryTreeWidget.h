@@ -45,9 +45,13 @@
 class MainWindow;
 class Component;
 class OMCProxy;
+struct batchedClassInformation;
 class LibraryTreeWidget;
 class LibraryComponent;
+class LibraryIconCache;
 class ModelWidget;
+class BitmapAnnotation;
+class BitmapImageCache;
 
 class ItemDelegate : public QItemDelegate
 {
@@ -165,18 +169,27 @@ public:
   void createActions();
   void addModelicaLibraries(QSplashScreen *pSplashScreen);
   void createLibraryTreeNodes(LibraryTreeNode *pLibraryTreeNode);
+  void createChildLibraryTreeNodes(LibraryTreeNode *pLibraryTreeNode);
+  void createAllChildLibraryTreeNodes(LibraryTreeNode *pLibraryTreeNode);
+  void removeUnloadedChildLibraryTreeNodes(QString nameStructure);
+  void renameUnloadedChildLibraryTreeNodes(QString oldNameStructure, QString newNameStructure);
+  bool hasUnloadedChildLibraryTreeNodes(QString nameStructure) {return mUnloadedChildLibraryTreeNodesHash.contains(nameStructure);}
   void expandLibraryTreeNode(LibraryTreeNode *pLibraryTreeNode);
-  void loadLibraryTreeNode(LibraryTreeNode *pParentLibraryTreeNode, LibraryTreeNode *pLibraryTreeNode);
-  void addLibraryTreeNodes(QList<LibraryTreeNode*> libraryTreeNodes);
+  void loadLibraryTreeNode(LibraryTreeNode *pParentLibraryTreeNode, LibraryTreeNode *pLibraryTreeNode,
+                           const batchedClassInformation &classInformation);
+  QList<batchedClassInformation> getClassesInformation(QStringList classNames, bool protectedStatus = false, bool iconAnnotation = false);
   bool isLibraryTreeNodeExpanded(QTreeWidgetItem *item);
   static bool sortNodesAscending(const LibraryTreeNode *node1, const LibraryTreeNode *node2);
   LibraryTreeNode* addLibraryTreeNode(QString name, QString parentName = QString(""), bool isSaved = true, int insertIndex = 0);
   LibraryTreeNode* addLibraryTreeNode(LibraryTreeNode::LibraryType type, QString name, bool isSaved, int insertIndex = 0);
   LibraryTreeNode* getLibraryTreeNode(QString nameStructure, Qt::CaseSensitivity caseSensitivity = Qt::CaseSensitive);
+  LibraryTreeNode* getOrCreateLibraryTreeNode(QString nameStructure, Qt::CaseSensitivity caseSensitivity = Qt::CaseSensitive);
   QList<LibraryTreeNode*> getLibraryTreeNodesList();
   void addLibraryComponentObject(LibraryComponent *libraryComponent);
   Component *getComponentObject(QString className);
   LibraryComponent* getLibraryComponentObject(QString className);
+  void removeLibraryComponentObject(QString className);
+  void setLibraryTreeNodeNameStructure(LibraryTreeNode *pLibraryTreeNode, QString nameStructure);
   bool isFileWritAble(QString filePath);
   void showProtectedClasses(bool enable);
   bool unloadClass(LibraryTreeNode *pLibraryTreeNode, bool askQuestion = true);
@@ -195,6 +208,11 @@ private:
   QList<LibraryTreeNode*> mLibraryTreeNodesList;
   QList<LibraryTreeNode*> mExpandedLibraryTreeNodesList;
   QList<LibraryComponent*> mLibraryComponentsList;
+  QHash<QString, LibraryTreeNode*> mLibraryTreeNodesHash;
+  QMultiHash<QString, LibraryTreeNode*> mLibraryTreeNodesCaseInsensitiveHash;
+  QHash<QString, LibraryComponent*> mLibraryComponentsHash;
+  QHash<QString, QStringList> mUnloadedChildLibraryTreeNodesHash;
+  int mLibraryComponentsRenderId;
   QAction *mpViewClassAction;
   QAction *mpViewDocumentationAction;
   QAction *mpNewModelicaClassAction;
@@ -226,6 +244,11 @@ private:
   bool saveSubModelsFolderHelper(LibraryTreeNode *pLibraryTreeNode, QString directoryName);
   bool saveLibraryTreeNodeOneFileOrFolderHelper(LibraryTreeNode *pLibraryTreeNode);
   void unloadLibraryTreeNodeAndModelWidget(LibraryTreeNode *pLibraryTreeNode);
+  void addToLibraryTreeNodesList(LibraryTreeNode *pLibraryTreeNode);
+  void removeFromLibraryTreeNodesList(LibraryTreeNode *pLibraryTreeNode);
+  void addToLibraryTreeNodesHash(LibraryTreeNode *pLibraryTreeNode);
+  void removeFromLibraryTreeNodesHash(LibraryTreeNode *pLibraryTreeNode);
+  bool isBeforeInTree(QTreeWidgetItem *pTreeWidgetItem1, QTreeWidgetItem *pTreeWidgetItem2);
 public slots:
   void expandLibraryTreeNode(QTreeWidgetItem *item);
   void showContextMenu(QPoint point);
@@ -255,6 +278,12 @@ public slots:
   void showModelWidget(LibraryTreeNode *pLibraryTreeNode = 0, bool newClass = false, bool extendsClass = false, QString text = QString());
   void openLibraryTreeNode(QString nameStructure);
   void loadLibraryComponent(LibraryTreeNode *pLibraryTreeNode);
+  QString getLibraryIconKey(LibraryTreeNode *pLibraryTreeNode, QString annotation);
+  void getInheritedIconAnnotations(QString className, QStringList *pAnnotations, QSet<QString> *pClassNames);
+  QSize getLibraryIconImageSize();
+  void renderLibraryComponent(LibraryComponent *pLibraryComponent, bool lookupCache = true);
+  void libraryComponentRenderRequested(QString className, int renderId);
+  void libraryComponentRendered(QString className, int renderId, QImage image);
 protected:
   virtual void mouseDoubleClickEvent(QMouseEvent *event);
   virtual void startDrag(Qt::DropActions supportedActions);
@@ -266,14 +295,63 @@ class LibraryComponent
 public:
   LibraryComponent(QString value, QString className, OMCProxy *omc);
   ~LibraryComponent();
+  Component* getComponent();
   QPixmap getComponentPixmap(QSize size);
+  QImage getComponentImage(QSize size);
+  QPicture getComponentPicture(QSize size, qreal *pScale);
+  QList<QPair<QString, QString> > getUncachedImages();
+  BitmapImageCache* getBitmapImageCache();
+  void setImagesRequested(bool imagesRequested) {mImagesRequested = imagesRequested;}
+  bool isImagesRequested() {return mImagesRequested;}
+  void setImageKey(QString key) {mImageKey = key;}
+  QString getImageKey() {return mImageKey;}
+  void setRenderId(int renderId) {mRenderId = renderId;}
+  int getRenderId() {return mRenderId;}
+  void setIsDocumentationIcon(bool documentationIcon) {mIsDocumentationIcon = documentationIcon;}
+  bool isDocumentationIcon() {return mIsDocumentationIcon;}
+  void setRenderedImage(QImage image);
+  bool isRendered() {return mRendered;}
+  QImage getRenderedImage() {return mRenderedImage;}
   void hasIconAnnotation(Component *pComponent);
 
   QString mClassName;
+  QRectF mRectangle;
+  bool mHasIconAnnotation;
+private:
+  QString mValue;
+  OMCProxy *mpOMCProxy;
   Component *mpComponent;
   QGraphicsView *mpGraphicsView;
+  QString mImageKey;
+  int mRenderId;
+  bool mIsDocumentationIcon;
+  bool mRendered;
+  QImage mRenderedImage;
+  bool mImagesRequested;
+
+  void getBitmapAnnotations(Component *pComponent, QList<BitmapAnnotation*> *pBitmapAnnotations);
+};
+
+class LibraryComponentRenderTask : public QRunnable
+{
+public:
+  LibraryComponentRenderTask(LibraryComponent *pLibraryComponent, QSize size, bool lookupCache, LibraryIconCache *pLibraryIconCache,
+                             LibraryTreeWidget *pLibraryTreeWidget);
+  virtual void run();
+  static QImage renderPicture(const QPicture &picture, QRectF rectangle, qreal scale, QSize size);
+private:
+  QString mClassName;
+  int mRenderId;
+  bool mLookupCache;
+  QList<QPair<QString, QString> > mImageSources;
+  BitmapImageCache *mpBitmapImageCache;
+  QPicture mPicture;
+  qreal mPictureScale;
   QRectF mRectangle;
-  bool mHasIconAnnotation;
+  QSize mSize;
+  QString mKey;
+  LibraryIconCache *mpLibraryIconCache;
+  QPointer<LibraryTreeWidget> mpLibraryTreeWidget;
 };
 
 #endif // LIBRARYTREEWIDGET_H
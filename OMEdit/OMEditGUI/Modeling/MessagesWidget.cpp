@@ -258,7 +258,7 @@ void MessagesWidget::openErrorMessageClass(QUrl url)
   }
   QString className = url.path();
   if (className.startsWith("/")) className.remove(0, 1);
-  LibraryTreeNode *pLibraryTreeNode = mpMainWindow->getLibraryTreeWidget()->getLibraryTreeNode(className);
+  LibraryTreeNode *pLibraryTreeNode = mpMainWindow->getLibraryTreeWidget()->getOrCreateLibraryTreeNode(className);
   if (pLibraryTreeNode) {
     mpMainWindow->getLibraryTreeWidget()->showModelWidget(pLibraryTreeNode);
     ModelWidget *pModelWidget = pLibraryTreeNode->getModelWidget();
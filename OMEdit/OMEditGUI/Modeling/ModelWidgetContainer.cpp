@@ -37,9 +37,11 @@
  */
 
 #include <QNetworkReply>
+#include <QStyleOptionGraphicsItem>
 
 #include "ModelWidgetContainer.h"
 #include "LibraryTreeWidget.h"
+#include "LibraryTreeCache.h"
 #include "MainWindow.h"
 #include "ShapePropertiesDialog.h"
 #include "ComponentProperties.h"
@@ -130,7 +132,6 @@ GraphicsView::GraphicsView(StringHandler::ViewType viewType, ModelWidget *parent
   setFrameShape(QFrame::StyledPanel);
   setDragMode(QGraphicsView::RubberBandDrag);
   setAcceptDrops(true);
-  setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
   setMouseTracking(true);
   mpModelWidget = parent;
   // set the coOrdinate System
@@ -164,6 +165,7 @@ GraphicsView::GraphicsView(StringHandler::ViewType viewType, ModelWidget *parent
   setIsCreatingBitmapShape(false);
   mpClickedComponent = 0;
   setIsMovingComponentsAndShapes(false);
+  setOptimizeRendering(pGraphicalViewsPage->getOptimizeRendering());
   createActions();
 }
 
@@ -345,6 +347,23 @@ bool GraphicsView::isMovingComponentsAndShapes()
   return mIsMovingComponentsAndShapes;
 }
 
+/*!
+ * \brief GraphicsView::setOptimizeRendering
+ * Switches the rendering mode of the view.\n
+ * The optimized mode repaints only the bounding rectangles of the changed items instead of the whole viewport, caches the shapes of the
+ * components in device coordinates and skips the shapes and texts of the components that are too small to be seen.
+ * \param optimize
+ */
+void GraphicsView::setOptimizeRendering(bool optimize)
+{
+  mOptimizeRendering = optimize;
+  setViewportUpdateMode(optimize ? QGraphicsView::BoundingRectViewportUpdate : QGraphicsView::FullViewportUpdate);
+  foreach (Component *pComponent, mComponentsList) {
+    pComponent->setOptimizeRendering(optimize);
+  }
+  viewport()->update();
+}
+
 QAction* GraphicsView::getDeleteConnectionAction()
 {
   return mpDeleteConnectionAction;
@@ -384,7 +403,7 @@ bool GraphicsView::addComponent(QString className, QString fileName, QPointF pos
 {
   MainWindow *pMainWindow = mpModelWidget->getModelWidgetContainer()->getMainWindow();
   LibraryTreeNode *pLibraryTreeNode;
-  pLibraryTreeNode = mpModelWidget->getModelWidgetContainer()->getMainWindow()->getLibraryTreeWidget()->getLibraryTreeNode(className);
+  pLibraryTreeNode = mpModelWidget->getModelWidgetContainer()->getMainWindow()->getLibraryTreeWidget()->getOrCreateLibraryTreeNode(className);
   if (!pLibraryTreeNode) {
     return false;
   }
@@ -555,6 +574,16 @@ void GraphicsView::addComponentObject(Component *pComponent)
   mComponentsList.append(pComponent);
 }
 
+/*!
+ * \brief GraphicsView::addComponentToList
+ * Adds the component to the local list without adding it to the model.
+ * \param pComponent
+ */
+void GraphicsView::addComponentToList(Component *pComponent)
+{
+  mComponentsList.append(pComponent);
+}
+
 /*!
  * \brief GraphicsView::deleteComponentObject
  * Delete the component and its corresponding connectors from the components list and OMC.
@@ -820,6 +849,7 @@ void GraphicsView::removeAllComponents()
 void GraphicsView::removeAllShapes()
 {
   mShapesList.clear();
+  mShapesAnnotation.clear();
 }
 
 void GraphicsView::removeAllConnections()
@@ -834,7 +864,7 @@ void GraphicsView::createLineShape(QPointF point)
   }
 
   if (!isCreatingLineShape()) {
-    mpLineShapeAnnotation = new LineAnnotation("", false, this);
+    mpLineShapeAnnotation = new LineAnnotation(AnnotationNode(), false, this);
     setIsCreatingLineShape(true);
     mpLineShapeAnnotation->addPoint(point);
     mpLineShapeAnnotation->addPoint(point);
@@ -850,7 +880,7 @@ void GraphicsView::createPolygonShape(QPointF point)
   }
 
   if (!isCreatingPolygonShape()) {
-    mpPolygonShapeAnnotation = new PolygonAnnotation("", false, this);
+    mpPolygonShapeAnnotation = new PolygonAnnotation(AnnotationNode(), false, this);
     setIsCreatingPolygonShape(true);
     mpPolygonShapeAnnotation->addPoint(point);
     mpPolygonShapeAnnotation->addPoint(point);
@@ -867,7 +897,7 @@ void GraphicsView::createRectangleShape(QPointF point)
   }
 
   if (!isCreatingRectangleShape()) {
-    mpRectangleShapeAnnotation = new RectangleAnnotation("", false, this);
+    mpRectangleShapeAnnotation = new RectangleAnnotation(AnnotationNode(), false, this);
     setIsCreatingRectangleShape(true);
     mpRectangleShapeAnnotation->replaceExtent(0, point);
     mpRectangleShapeAnnotation->replaceExtent(1, point);
@@ -897,7 +927,7 @@ void GraphicsView::createEllipseShape(QPointF point)
   }
 
   if (!isCreatingEllipseShape()) {
-    mpEllipseShapeAnnotation = new EllipseAnnotation("", false, this);
+    mpEllipseShapeAnnotation = new EllipseAnnotation(AnnotationNode(), false, this);
     setIsCreatingEllipseShape(true);
     mpEllipseShapeAnnotation->replaceExtent(0, point);
     mpEllipseShapeAnnotation->replaceExtent(1, point);
@@ -927,7 +957,7 @@ void GraphicsView::createTextShape(QPointF point)
   }
 
   if (!isCreatingTextShape()) {
-    mpTextShapeAnnotation = new TextAnnotation("", false, this);
+    mpTextShapeAnnotation = new TextAnnotation(AnnotationNode(), false, this);
     setIsCreatingTextShape(true);
     mpTextShapeAnnotation->setTextString("text");
     mpTextShapeAnnotation->replaceExtent(0, point);
@@ -959,7 +989,7 @@ void GraphicsView::createBitmapShape(QPointF point)
   }
 
   if (!isCreatingBitmapShape()) {
-    mpBitmapShapeAnnotation = new BitmapAnnotation(mpModelWidget->getLibraryTreeNode()->getFileName(), "", false, this);
+    mpBitmapShapeAnnotation = new BitmapAnnotation(mpModelWidget->getLibraryTreeNode()->getFileName(), AnnotationNode(), false, this);
     setIsCreatingBitmapShape(true);
     mpBitmapShapeAnnotation->replaceExtent(0, point);
     mpBitmapShapeAnnotation->replaceExtent(1, point);
@@ -1308,6 +1338,8 @@ void GraphicsView::addClassAnnotation()
     annotationString.append("}");
   }
   annotationString.append(")");
+  // the shapes no longer match the annotation they were read from.
+  mShapesAnnotation.clear();
   // add the class annotation to model through OMC
   if (pMainWindow->getOMCProxy()->addClassAnnotation(mpModelWidget->getLibraryTreeNode()->getNameStructure(), annotationString)) {
     mpModelWidget->setModelModified();
@@ -1385,6 +1417,13 @@ void GraphicsView::dropEvent(QDropEvent *event)
   }
 }
 
+/*!
+ * \brief GraphicsView::drawBackground
+ * Reimplementation of QGraphicsView::drawBackground.\n
+ * Draws the white extent rectangle and the grid lines of the exposed rect. All the grid lines are drawn in one drawLines call.
+ * \param painter
+ * \param rect
+ */
 void GraphicsView::drawBackground(QPainter *painter, const QRectF &rect)
 {
   if (mSkipBackground)
@@ -1396,40 +1435,28 @@ void GraphicsView::drawBackground(QPainter *painter, const QRectF &rect)
   if (mpModelWidget->getModelWidgetContainer()->isShowGridLines())
   {
     painter->setBrush(Qt::NoBrush);
-    painter->setPen(QColor(229, 229, 229));
-    /* Draw left half vertical lines */
     int horizontalGridStep = mpCoOrdinateSystem->getHorizontalGridStep() * 10;
-    qreal xAxisStep = 0;
-    qreal yAxisStep = rect.y();
-    xAxisStep -= horizontalGridStep;
-    while (xAxisStep > rect.left())
-    {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(xAxisStep, rect.bottom()));
-      xAxisStep -= horizontalGridStep;
-    }
-    /* Draw right half vertical lines */
-    xAxisStep = 0;
-    while (xAxisStep < rect.right())
-    {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(xAxisStep, rect.bottom()));
-      xAxisStep += horizontalGridStep;
-    }
-    /* Draw left half horizontal lines */
     int verticalGridStep = mpCoOrdinateSystem->getVerticalGridStep() * 10;
-    xAxisStep = rect.x();
-    yAxisStep = 0;
-    yAxisStep += verticalGridStep;
-    while (yAxisStep < rect.bottom())
-    {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(rect.right(), yAxisStep));
-      yAxisStep += verticalGridStep;
-    }
-    /* Draw right half horizontal lines */
-    yAxisStep = 0;
-    while (yAxisStep > rect.top())
-    {
-      painter->drawLine(QPointF(xAxisStep, yAxisStep), QPointF(rect.right(), yAxisStep));
-      yAxisStep -= verticalGridStep;
+    /* In optimized rendering mode don't draw the grid lines when they are too dense to be distinguished. */
+    qreal levelOfDetail = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    bool drawGridLines = horizontalGridStep > 0 && verticalGridStep > 0;
+    if (drawGridLines && isOptimizeRendering()) {
+      drawGridLines = qMin(horizontalGridStep, verticalGridStep) * levelOfDetail >= 4;
+    }
+    if (drawGridLines) {
+      QVector<QLineF> gridLines;
+      /* vertical lines */
+      qreal xAxisStep = floor(rect.left() / horizontalGridStep) * horizontalGridStep;
+      for (; xAxisStep < rect.right() ; xAxisStep += horizontalGridStep) {
+        gridLines.append(QLineF(xAxisStep, rect.top(), xAxisStep, rect.bottom()));
+      }
+      /* horizontal lines */
+      qreal yAxisStep = floor(rect.top() / verticalGridStep) * verticalGridStep;
+      for (; yAxisStep < rect.bottom() ; yAxisStep += verticalGridStep) {
+        gridLines.append(QLineF(rect.left(), yAxisStep, rect.right(), yAxisStep));
+      }
+      painter->setPen(QColor(229, 229, 229));
+      painter->drawLines(gridLines);
     }
     /* set the middle horizontal and vertical line gray */
     painter->setPen(QColor(192, 192, 192));
@@ -2193,6 +2220,8 @@ ModelWidget::ModelWidget(LibraryTreeNode* pLibraryTreeNode, ModelWidgetContainer
       mpDiagramGraphicsView->setCanAddClassAnnotation(true);
     }
     if (!newClass || extendsClass) {
+      // fetch the graphical description of the class in a few round-trips so the calls below are served from the cache.
+      mpModelWidgetContainer->getMainWindow()->getOMCProxy()->prefetchDiagram(getLibraryTreeNode()->getNameStructure());
       getModelIconDiagramShapes(getLibraryTreeNode()->getNameStructure());
       getModelComponents(getLibraryTreeNode()->getNameStructure());
       getModelConnections(getLibraryTreeNode()->getNameStructure());
@@ -2327,11 +2356,13 @@ void ModelWidget::setModelModified()
   mpLibraryTreeNode->setIsSaved(false);
   // clean up the OMC cache for this particular model classname.
   mpModelWidgetContainer->getMainWindow()->getOMCProxy()->removeCachedOMCCommand(mpLibraryTreeNode->getNameStructure());
+  LibraryTreeWidget *pLibraryTreeWidget = mpModelWidgetContainer->getMainWindow()->getLibraryTreeWidget();
+  // the library is modified so its cache is no longer valid.
+  mpModelWidgetContainer->getMainWindow()->getLibraryTreeCache()->removeLibrary(StringHandler::getFirstWordBeforeDot(mpLibraryTreeNode->getNameStructure()));
   /*
     If this model is a child model inside a package.
     Then get the root package. If the package is saved in one file then set the package unsaved.
     */
-  LibraryTreeWidget *pLibraryTreeWidget = mpModelWidgetContainer->getMainWindow()->getLibraryTreeWidget();
   LibraryTreeNode *pLibraryTreeNode;
   pLibraryTreeNode = pLibraryTreeWidget->getLibraryTreeNode(StringHandler::getFirstWordBeforeDot(mpLibraryTreeNode->getNameStructure()));
   if (pLibraryTreeNode->getFileName().compare(mpLibraryTreeNode->getFileName()) == 0) {
@@ -2374,8 +2405,10 @@ void ModelWidget::updateParentModelsText(QString className)
 
 /*!
   Gets the components of the model and place them in the diagram and icon GraphicsView.
+  If pDiagramComponents and pIconComponents are given then the unchanged components are taken from them instead of creating them again.
   */
-void ModelWidget::getModelComponents(QString className, bool inheritedCycle)
+void ModelWidget::getModelComponents(QString className, bool inheritedCycle, QHash<QString, Component*> *pDiagramComponents,
+                                     QHash<QString, Component*> *pIconComponents)
 {
   MainWindow *pMainWindow = mpModelWidgetContainer->getMainWindow();
   // get the inherited components of the class
@@ -2389,7 +2422,7 @@ void ModelWidget::getModelComponents(QString className, bool inheritedCycle)
       Also check for cyclic loops.
       */
     if (!(pMainWindow->getOMCProxy()->isBuiltinType(inheritedClass) || inheritedClass.compare(className) == 0)) {
-      getModelComponents(inheritedClass, true);
+      getModelComponents(inheritedClass, true, pDiagramComponents, pIconComponents);
     }
   }
   // get the components
@@ -2421,13 +2454,26 @@ void ModelWidget::getModelComponents(QString className, bool inheritedCycle)
     // add the component to the diagram view.
     if (!transformation.isEmpty())
     {
-      mpDiagramGraphicsView->addComponentToView(pComponentInfo->getName(), pComponentInfo->getClassName(), transformation,
-                                                QPointF(0.0, 0.0), pComponentInfo, type, false, true, inheritedCycle, className);
+      Component *pComponent = takeUnchangedComponent(pDiagramComponents, mpDiagramGraphicsView, pComponentInfo, type, transformation,
+                                                     inheritedCycle, className);
+      if (pComponent) {
+        mpDiagramGraphicsView->addComponentToList(pComponent);
+      } else {
+        mpDiagramGraphicsView->addComponentToView(pComponentInfo->getName(), pComponentInfo->getClassName(), transformation,
+                                                  QPointF(0.0, 0.0), pComponentInfo, type, false, true, inheritedCycle, className);
+      }
       if (type == StringHandler::Connector && !pComponentInfo->getProtected())
       {
         // add the component to the icon view.
-        mpIconGraphicsView->addComponentToView(pComponentInfo->getName(), pComponentInfo->getClassName(), transformation,
-                                               QPointF(0.0, 0.0), new ComponentInfo(pComponentInfo), type, false, true, inheritedCycle, className);
+        ComponentInfo *pIconComponentInfo = new ComponentInfo(pComponentInfo);
+        pComponent = takeUnchangedComponent(pIconComponents, mpIconGraphicsView, pIconComponentInfo, type, transformation, inheritedCycle,
+                                            className);
+        if (pComponent) {
+          mpIconGraphicsView->addComponentToList(pComponent);
+        } else {
+          mpIconGraphicsView->addComponentToView(pComponentInfo->getName(), pComponentInfo->getClassName(), transformation,
+                                                 QPointF(0.0, 0.0), pIconComponentInfo, type, false, true, inheritedCycle, className);
+        }
       }
     }
     i++;
@@ -2524,6 +2570,20 @@ void ModelWidget::getTLMConnections()
 }
 
 void ModelWidget::getModelIconDiagramShapes(QString className, bool inheritedCycle)
+{
+  getModelIconDiagramShapes(className, StringHandler::Icon, inheritedCycle);
+  getModelIconDiagramShapes(className, StringHandler::Diagram, inheritedCycle);
+}
+
+/*!
+ * \brief ModelWidget::getModelIconDiagramShapes
+ * Gets the shapes of the class and its inherited classes and places them in the icon or diagram GraphicsView.
+ * The annotations the shapes are created from are saved in the GraphicsView so refreshIncrementally() can skip the unchanged views.
+ * \param className
+ * \param viewType
+ * \param inheritedCycle
+ */
+void ModelWidget::getModelIconDiagramShapes(QString className, StringHandler::ViewType viewType, bool inheritedCycle)
 {
   MainWindow *pMainWindow = mpModelWidgetContainer->getMainWindow();
   // get the inherited components of the class
@@ -2537,24 +2597,27 @@ void ModelWidget::getModelIconDiagramShapes(QString className, bool inheritedCyc
       Also check for cyclic loops.
       */
     if (!(pMainWindow->getOMCProxy()->isBuiltinType(inheritedClass) || inheritedClass.compare(className) == 0)) {
-      getModelIconDiagramShapes(inheritedClass, true);
+      getModelIconDiagramShapes(inheritedClass, viewType, true);
     }
   }
-  OMCProxy *pOMCProxy = mpModelWidgetContainer->getMainWindow()->getOMCProxy();
-  QString iconAnnotationString = pOMCProxy->getIconAnnotation(className);
-  getModelIconDiagramShapes(className, iconAnnotationString, StringHandler::Icon, inheritedCycle);
-  QString diagramAnnotationString = pOMCProxy->getDiagramAnnotation(className);
-  getModelIconDiagramShapes(className, diagramAnnotationString, StringHandler::Diagram, inheritedCycle);
+  GraphicsView *pGraphicsView = viewType == StringHandler::Icon ? mpIconGraphicsView : mpDiagramGraphicsView;
+  QString annotationString;
+  if (viewType == StringHandler::Icon) {
+    annotationString = pMainWindow->getOMCProxy()->getIconAnnotation(className);
+  } else {
+    annotationString = pMainWindow->getOMCProxy()->getDiagramAnnotation(className);
+  }
+  getModelIconDiagramShapes(className, annotationString, viewType, inheritedCycle);
+  pGraphicsView->setShapesAnnotation(pGraphicsView->getShapesAnnotation() + className + annotationString);
 }
 
 void ModelWidget::getModelIconDiagramShapes(QString className, QString annotationString, StringHandler::ViewType viewType, bool inheritedCycle)
 {
-  annotationString = StringHandler::removeFirstLastCurlBrackets(annotationString);
-  if (annotationString.isEmpty())
-  {
-    return;
-  }
-  QStringList list = StringHandler::getStrings(annotationString);
+  AnnotationTree annotationTree(annotationString);
+  AnnotationNode list = annotationTree.getRoot();
+  // the annotation is enclosed in curly brackets.
+  if (list.size() == 1 && list.at(0).getType() == AnnotationNode::Array)
+    list = list.at(0);
   // read the coordinate system
   if (list.size() < 8)
     return;
@@ -2563,74 +2626,64 @@ void ModelWidget::getModelIconDiagramShapes(QString className, QString annotatio
     pGraphicsView = mpIconGraphicsView;
   else
     pGraphicsView = mpDiagramGraphicsView;
-  qreal left = qMin(list.at(0).toFloat(), list.at(2).toFloat());
-  qreal bottom = qMin(list.at(1).toFloat(), list.at(3).toFloat());
-  qreal right = qMax(list.at(0).toFloat(), list.at(2).toFloat());
-  qreal top = qMax(list.at(1).toFloat(), list.at(3).toFloat());
+  qreal left = qMin(list.at(0).toDouble(), list.at(2).toDouble());
+  qreal bottom = qMin(list.at(1).toDouble(), list.at(3).toDouble());
+  qreal right = qMax(list.at(0).toDouble(), list.at(2).toDouble());
+  qreal top = qMax(list.at(1).toDouble(), list.at(3).toDouble());
   QList<QPointF> extent;
   extent << QPointF(left, bottom) << QPointF(right, top);
   pGraphicsView->getCoOrdinateSystem()->setExtent(extent);
-  pGraphicsView->getCoOrdinateSystem()->setPreserveAspectRatio((list.at(4).compare("true") == 0) ? true : false);
-  pGraphicsView->getCoOrdinateSystem()->setInitialScale(list.at(5).toFloat());
-  qreal horizontal = list.at(6).toFloat();
-  qreal vertical = list.at(7).toFloat();
+  pGraphicsView->getCoOrdinateSystem()->setPreserveAspectRatio(list.at(4).toBool());
+  pGraphicsView->getCoOrdinateSystem()->setInitialScale(list.at(5).toDouble());
+  qreal horizontal = list.at(6).toDouble();
+  qreal vertical = list.at(7).toDouble();
   pGraphicsView->getCoOrdinateSystem()->setGrid(QPointF(horizontal, vertical));
   pGraphicsView->setExtentRectangle(left, bottom, right, top);
   pGraphicsView->fitInView(pGraphicsView->getExtentRectangle(), Qt::KeepAspectRatio);
   pGraphicsView->setIsCustomScale(false);
   // read the shapes
-  if (list.size() < 9)
-    return;
-  QStringList shapesList = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(list.at(8)), '(', ')');
+  AnnotationNode shapesList = list.at(8);
   // Now parse the shapes available in list
-  foreach (QString shape, shapesList)
+  for (int i = 0 ; i < shapesList.size() ; i++)
   {
-    if (shape.startsWith("Line"))
+    QString shapeName = shapesList.at(i).getName();
+    AnnotationNode shape = shapesList.at(i);
+    if (shapeName == "Line")
     {
-      shape = shape.mid(QString("Line").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
       LineAnnotation *pLineAnnotation = new LineAnnotation(shape, inheritedCycle, pGraphicsView);
       pLineAnnotation->initializeTransformation();
       pLineAnnotation->drawCornerItems();
       pLineAnnotation->setCornerItemsPassive();
     }
-    else if (shape.startsWith("Polygon"))
+    else if (shapeName == "Polygon")
     {
-      shape = shape.mid(QString("Polygon").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
       PolygonAnnotation *pPolygonAnnotation = new PolygonAnnotation(shape, inheritedCycle, pGraphicsView);
       pPolygonAnnotation->initializeTransformation();
       pPolygonAnnotation->drawCornerItems();
       pPolygonAnnotation->setCornerItemsPassive();
     }
-    else if (shape.startsWith("Rectangle"))
+    else if (shapeName == "Rectangle")
     {
-      shape = shape.mid(QString("Rectangle").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
       RectangleAnnotation *pRectangleAnnotation = new RectangleAnnotation(shape, inheritedCycle, pGraphicsView);
       pRectangleAnnotation->initializeTransformation();
       pRectangleAnnotation->drawCornerItems();
       pRectangleAnnotation->setCornerItemsPassive();
     }
-    else if (shape.startsWith("Ellipse"))
+    else if (shapeName == "Ellipse")
     {
-      shape = shape.mid(QString("Ellipse").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
       EllipseAnnotation *pEllipseAnnotation = new EllipseAnnotation(shape, inheritedCycle, pGraphicsView);
       pEllipseAnnotation->initializeTransformation();
       pEllipseAnnotation->drawCornerItems();
       pEllipseAnnotation->setCornerItemsPassive();
     }
-    else if (shape.startsWith("Text"))
+    else if (shapeName == "Text")
     {
-      shape = shape.mid(QString("Text").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
       TextAnnotation *pTextAnnotation = new TextAnnotation(shape, inheritedCycle, pGraphicsView);
       pTextAnnotation->initializeTransformation();
       pTextAnnotation->drawCornerItems();
       pTextAnnotation->setCornerItemsPassive();
     }
-    else if (shape.startsWith("Bitmap"))
+    else if (shapeName == "Bitmap")
     {
       /* get the class file path */
       QString classFileName;
@@ -2638,8 +2691,6 @@ void ModelWidget::getModelIconDiagramShapes(QString className, QString annotatio
       classInformation = mpModelWidgetContainer->getMainWindow()->getOMCProxy()->getClassInformation(className);
       classFileName = classInformation.fileName;
       /* create the bitmap shape */
-      shape = shape.mid(QString("Bitmap").length());
-      shape = StringHandler::removeFirstLastBrackets(shape);
       BitmapAnnotation *pBitmapAnnotation = new BitmapAnnotation(classFileName, shape, inheritedCycle, pGraphicsView);
       pBitmapAnnotation->initializeTransformation();
       pBitmapAnnotation->drawCornerItems();
@@ -2648,7 +2699,39 @@ void ModelWidget::getModelIconDiagramShapes(QString className, QString annotatio
   }
 }
 
-void ModelWidget::getModelConnections(QString className, bool inheritedCycle)
+/*!
+ * \brief ModelWidget::getModelIconDiagramAnnotation
+ * Returns the icon or diagram annotations of the class and its inherited classes in the same form as they are saved by
+ * getModelIconDiagramShapes().
+ * \param className
+ * \param viewType
+ * \return
+ */
+QString ModelWidget::getModelIconDiagramAnnotation(QString className, StringHandler::ViewType viewType)
+{
+  OMCProxy *pOMCProxy = mpModelWidgetContainer->getMainWindow()->getOMCProxy();
+  QString annotation;
+  int inheritanceCount = pOMCProxy->getInheritanceCount(className);
+  for(int i = 1 ; i <= inheritanceCount ; i++) {
+    QString inheritedClass = pOMCProxy->getNthInheritedClass(className, i);
+    if (!(pOMCProxy->isBuiltinType(inheritedClass) || inheritedClass.compare(className) == 0)) {
+      annotation.append(getModelIconDiagramAnnotation(inheritedClass, viewType));
+    }
+  }
+  annotation.append(className);
+  if (viewType == StringHandler::Icon) {
+    annotation.append(pOMCProxy->getIconAnnotation(className));
+  } else {
+    annotation.append(pOMCProxy->getDiagramAnnotation(className));
+  }
+  return annotation;
+}
+
+/*!
+  Gets the connections of the model and place them in the diagram GraphicsView.
+  If pConnections is given then the unchanged connections are taken from it instead of creating them again.
+  */
+void ModelWidget::getModelConnections(QString className, bool inheritedCycle, QMultiHash<QString, LineAnnotation*> *pConnections)
 {
   MainWindow *pMainWindow = mpModelWidgetContainer->getMainWindow();
   // get the inherited connections of the class
@@ -2661,7 +2744,7 @@ void ModelWidget::getModelConnections(QString className, bool inheritedCycle)
       Also check for cyclic loops.
       */
     if (!(pMainWindow->getOMCProxy()->isBuiltinType(inheritedClass) || inheritedClass.compare(className) == 0)) {
-      getModelConnections(inheritedClass, true);
+      getModelConnections(inheritedClass, true, pConnections);
     }
   }
   int connectionCount = pMainWindow->getOMCProxy()->getConnectionCount(className);
@@ -2693,7 +2776,7 @@ void ModelWidget::getModelConnections(QString className, bool inheritedCycle)
     Component *pStartConnectorComponent = 0;
     Component *pEndConnectorComponent = 0;
     if (pStartComponent) {
-      pMainWindow->getOMCProxy()->sendCommand("getClassRestriction(" + pStartComponent->getClassName() + ")");
+      pMainWindow->getOMCProxy()->sendCommand("getClassRestriction(" + pStartComponent->getClassName() + ")", true, pStartComponent->getClassName());
       bool isExpandableConnector = pMainWindow->getOMCProxy()->getResult().toLower().contains("expandable connector");
       // if a component type is connector then we only get one item in startComponentList
       // check the startcomponentlist
@@ -2713,7 +2796,7 @@ void ModelWidget::getModelConnections(QString className, bool inheritedCycle)
     if (pEndComponent) {
       // if a component type is connector then we only get one item in endComponentList
       // check the endcomponentlist
-      pMainWindow->getOMCProxy()->sendCommand("getClassRestriction(" + pEndComponent->getClassName() + ")");
+      pMainWindow->getOMCProxy()->sendCommand("getClassRestriction(" + pEndComponent->getClassName() + ")", true, pEndComponent->getClassName());
       bool isExpandableConnector = pMainWindow->getOMCProxy()->getResult().toLower().contains("expandable connector");
       if (endComponentList.size() < 2 || isExpandableConnector) {
         pEndConnectorComponent = pEndComponent;
@@ -2736,8 +2819,16 @@ void ModelWidget::getModelConnections(QString className, bool inheritedCycle)
       if (shape.startsWith("Line")) {
         shape = shape.mid(QString("Line").length());
         shape = StringHandler::removeFirstLastBrackets(shape);
-        LineAnnotation *pConnectionLineAnnotation = new LineAnnotation(shape, inheritedCycle, pStartConnectorComponent,
-                                                                       pEndConnectorComponent, mpDiagramGraphicsView);
+        LineAnnotation *pConnectionLineAnnotation = takeUnchangedConnection(pConnections, connectionList.at(0), connectionList.at(1), shape,
+                                                                            inheritedCycle, pStartConnectorComponent,
+                                                                            pEndConnectorComponent);
+        if (pConnectionLineAnnotation) {
+          mpDiagramGraphicsView->addConnectionObject(pConnectionLineAnnotation);
+          continue;
+        }
+        pConnectionLineAnnotation = new LineAnnotation(shape, inheritedCycle, pStartConnectorComponent, pEndConnectorComponent,
+                                                       mpDiagramGraphicsView);
+        pConnectionLineAnnotation->setConnectionAnnotation(shape);
         if (pStartConnectorComponent) {
           pStartConnectorComponent->getRootParentComponent()->addConnectionDetails(pConnectionLineAnnotation);
         }
@@ -2779,16 +2870,8 @@ Component* ModelWidget::getConnectorComponent(Component *pConnectorComponent, QS
 void ModelWidget::refresh()
 {
   QApplication::setOverrideCursor(Qt::WaitCursor);
-  /* Clear the OMC commands cache for this class */
+  refreshClassInformation();
   OMCProxy *pOMCProxy = mpModelWidgetContainer->getMainWindow()->getOMCProxy();
-  pOMCProxy->removeCachedOMCCommand(mpLibraryTreeNode->getNameStructure());
-  /* set the LibraryTreeNode filename, type & tooltip */
-  pOMCProxy->setSourceFile(mpLibraryTreeNode->getNameStructure(), mpLibraryTreeNode->getFileName());
-  mpLibraryTreeNode->setClassInformation(pOMCProxy->getClassInformation(mpLibraryTreeNode->getNameStructure()));
-  bool isDocumentationClass = mpModelWidgetContainer->getMainWindow()->getOMCProxy()->getDocumentationClassAnnotation(mpLibraryTreeNode->getNameStructure());
-  mpLibraryTreeNode->setIsDocumentationClass(isDocumentationClass);
-  mpLibraryTreeNode->updateAttributes();
-  mpModelWidgetContainer->getMainWindow()->getLibraryTreeWidget()->loadLibraryComponent(mpLibraryTreeNode);
   /* remove everything from the icon view */
   mpIconGraphicsView->removeAllComponents();
   mpIconGraphicsView->removeAllShapes();
@@ -2807,6 +2890,7 @@ void ModelWidget::refresh()
   }
   else
   {
+    pOMCProxy->prefetchDiagram(getLibraryTreeNode()->getNameStructure());
     getModelIconDiagramShapes(getLibraryTreeNode()->getNameStructure());
     getModelComponents(getLibraryTreeNode()->getNameStructure());
     getModelConnections(getLibraryTreeNode()->getNameStructure());
@@ -2815,6 +2899,159 @@ void ModelWidget::refresh()
   QApplication::restoreOverrideCursor();
 }
 
+/*!
+ * \brief ModelWidget::refreshIncrementally
+ * Updates the icon and diagram views after the class is changed in the text view.
+ * Unlike refresh(), only the components, connections and shapes that differ from the class definition in OMC are created again.
+ */
+void ModelWidget::refreshIncrementally()
+{
+  if (getLibraryTreeNode()->getLibraryType() == LibraryTreeNode::TLM) {
+    refresh();
+    return;
+  }
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  refreshClassInformation();
+  OMCProxy *pOMCProxy = mpModelWidgetContainer->getMainWindow()->getOMCProxy();
+  QString className = getLibraryTreeNode()->getNameStructure();
+  pOMCProxy->prefetchDiagram(className);
+  /* create the shapes again only in the views whose annotations are changed. */
+  QList<GraphicsView*> graphicsViews;
+  graphicsViews << mpIconGraphicsView << mpDiagramGraphicsView;
+  foreach (GraphicsView *pGraphicsView, graphicsViews) {
+    if (pGraphicsView->getShapesAnnotation().compare(getModelIconDiagramAnnotation(className, pGraphicsView->getViewType())) != 0) {
+      QList<ShapeAnnotation*> shapesList = pGraphicsView->getShapesList();
+      pGraphicsView->removeAllShapes();
+      qDeleteAll(shapesList);
+      getModelIconDiagramShapes(className, pGraphicsView->getViewType(), false);
+    }
+  }
+  /* take the current components and connections. The unchanged ones are added back to the views. */
+  QHash<QString, Component*> diagramComponents;
+  foreach (Component *pComponent, mpDiagramGraphicsView->getComponentList()) {
+    diagramComponents.insert(pComponent->getName(), pComponent);
+  }
+  mpDiagramGraphicsView->removeAllComponents();
+  QHash<QString, Component*> iconComponents;
+  foreach (Component *pComponent, mpIconGraphicsView->getComponentList()) {
+    iconComponents.insert(pComponent->getName(), pComponent);
+  }
+  mpIconGraphicsView->removeAllComponents();
+  QMultiHash<QString, LineAnnotation*> connections;
+  foreach (LineAnnotation *pConnectionLineAnnotation, mpDiagramGraphicsView->getConnectionsList()) {
+    connections.insert(pConnectionLineAnnotation->getStartComponentName(), pConnectionLineAnnotation);
+  }
+  mpDiagramGraphicsView->removeAllConnections();
+  getModelComponents(className, false, &diagramComponents, &iconComponents);
+  getModelConnections(className, false, &connections);
+  /* delete the connections and components that are removed or changed. Connections first since they refer to the components. */
+  qDeleteAll(connections);
+  foreach (Component *pComponent, diagramComponents) {
+    pComponent->removeSceneItems();
+    delete pComponent;
+  }
+  foreach (Component *pComponent, iconComponents) {
+    pComponent->removeSceneItems();
+    delete pComponent;
+  }
+  QApplication::restoreOverrideCursor();
+}
+
+/*!
+ * \brief ModelWidget::refreshClassInformation
+ * Clears the OMC commands cache of the class and reads the class information, attributes and library icon again.
+ */
+void ModelWidget::refreshClassInformation()
+{
+  /* Clear the OMC commands cache for this class */
+  OMCProxy *pOMCProxy = mpModelWidgetContainer->getMainWindow()->getOMCProxy();
+  pOMCProxy->removeCachedOMCCommand(mpLibraryTreeNode->getNameStructure());
+  /* set the LibraryTreeNode filename, type & tooltip */
+  pOMCProxy->setSourceFile(mpLibraryTreeNode->getNameStructure(), mpLibraryTreeNode->getFileName());
+  mpLibraryTreeNode->setClassInformation(pOMCProxy->getClassInformation(mpLibraryTreeNode->getNameStructure()));
+  bool isDocumentationClass = pOMCProxy->getDocumentationClassAnnotation(mpLibraryTreeNode->getNameStructure());
+  mpLibraryTreeNode->setIsDocumentationClass(isDocumentationClass);
+  mpLibraryTreeNode->updateAttributes();
+  mpModelWidgetContainer->getMainWindow()->getLibraryTreeWidget()->loadLibraryComponent(mpLibraryTreeNode);
+}
+
+/*!
+ * \brief ModelWidget::takeUnchangedComponent
+ * Removes the component with the same name from pComponents if it still matches the component read from OMC.
+ * The matched component takes the new ComponentInfo and updates its texts since the modifiers might have changed.
+ * \param pComponents
+ * \param pGraphicsView
+ * \param pComponentInfo
+ * \param type
+ * \param transformation
+ * \param inheritedCycle
+ * \param inheritedClassName
+ * \return the unchanged component or 0 if the component is new or changed.
+ */
+Component* ModelWidget::takeUnchangedComponent(QHash<QString, Component*> *pComponents, GraphicsView *pGraphicsView,
+                                               ComponentInfo *pComponentInfo, StringHandler::ModelicaClasses type, QString transformation,
+                                               bool inheritedCycle, QString inheritedClassName)
+{
+  if (!pComponents) {
+    return 0;
+  }
+  Component *pComponent = pComponents->value(pComponentInfo->getName(), 0);
+  if (!pComponent) {
+    return 0;
+  }
+  /* the nested classes are loaded again with the class so their instances are always created again. */
+  if (pComponent->getClassName().compare(pComponentInfo->getClassName()) != 0 || pComponent->getType() != type ||
+      pComponent->isInheritedComponent() != inheritedCycle || pComponent->getInheritedClassName().compare(inheritedClassName) != 0 ||
+      pComponent->getClassName().startsWith(mpLibraryTreeNode->getNameStructure() + ".")) {
+    return 0;
+  }
+  /* compare the placement with the current placement of the component since it might be changed in the view. */
+  Transformation placement(pGraphicsView->getViewType());
+  placement.parseTransformationString(transformation, pComponent->boundingRect().width(), pComponent->boundingRect().height());
+  if (!pComponent->pos().isNull() || pComponent->transform() != placement.getTransformationMatrix() ||
+      pComponent->getTransformation()->getVisible() != placement.getVisible()) {
+    return 0;
+  }
+  pComponents->remove(pComponentInfo->getName());
+  pComponent->setComponentInfo(pComponentInfo);
+  pComponent->componentParameterHasChanged();
+  return pComponent;
+}
+
+/*!
+ * \brief ModelWidget::takeUnchangedConnection
+ * Removes the connection from pConnections that is created from the same annotation and connects the same connectors.
+ * \param pConnections
+ * \param startComponentName
+ * \param endComponentName
+ * \param annotation
+ * \param inheritedCycle
+ * \param pStartConnectorComponent
+ * \param pEndConnectorComponent
+ * \return the unchanged connection or 0 if the connection is new or changed.
+ */
+LineAnnotation* ModelWidget::takeUnchangedConnection(QMultiHash<QString, LineAnnotation*> *pConnections, QString startComponentName,
+                                                     QString endComponentName, QString annotation, bool inheritedCycle,
+                                                     Component *pStartConnectorComponent, Component *pEndConnectorComponent)
+{
+  if (!pConnections) {
+    return 0;
+  }
+  foreach (LineAnnotation *pConnectionLineAnnotation, pConnections->values(startComponentName)) {
+    /* the connection annotation is cleared when the connection is changed in the view. */
+    if (pConnectionLineAnnotation->getEndComponentName().compare(endComponentName) == 0 &&
+        !pConnectionLineAnnotation->getConnectionAnnotation().isEmpty() &&
+        pConnectionLineAnnotation->getConnectionAnnotation().compare(annotation) == 0 &&
+        pConnectionLineAnnotation->isInheritedShape() == inheritedCycle &&
+        pConnectionLineAnnotation->getStartComponent() == pStartConnectorComponent &&
+        pConnectionLineAnnotation->getEndComponent() == pEndConnectorComponent) {
+      pConnections->remove(startComponentName, pConnectionLineAnnotation);
+      return pConnectionLineAnnotation;
+    }
+  }
+  return 0;
+}
+
 /*!
  * \brief ModelWidget::showIconView
  * \param checked
@@ -2970,7 +3207,8 @@ bool ModelWidget::modelicaEditorTextChanged()
     classNames.removeOne(mpLibraryTreeNode->getNameStructure());
     pLibraryTreeWidget->removeFromExpandedLibraryTreeNodesList(mpLibraryTreeNode);
     mpLibraryTreeNode->setExpanded(false);
-    refresh();
+    /* only update the components, connections and shapes that are changed. */
+    refreshIncrementally();
     /* if class has children then create them. */
     pLibraryTreeWidget->createLibraryTreeNodes(mpLibraryTreeNode);
     setModelModified();
@@ -2998,7 +3236,7 @@ bool ModelWidget::modelicaEditorTextChanged()
       - If the class is top level then remove it from the top level and add it to the new parent.
       */
     LibraryTreeNode *pCurrentParentLibraryTreeNode = dynamic_cast<LibraryTreeNode*>(mpLibraryTreeNode->parent());
-    LibraryTreeNode *pNewParentLibraryTreeNode = pLibraryTreeWidget->getLibraryTreeNode(StringHandler::removeLastWordAfterDot(className));
+    LibraryTreeNode *pNewParentLibraryTreeNode = pLibraryTreeWidget->getOrCreateLibraryTreeNode(StringHandler::removeLastWordAfterDot(className));
     /* If really a within is used then the following condition should be true. */
     if ((pNewParentLibraryTreeNode) && (pNewParentLibraryTreeNode != mpLibraryTreeNode))
     {
@@ -3035,7 +3273,7 @@ bool ModelWidget::modelicaEditorTextChanged()
     /* set the LibraryTreeNode name & text */
     mpLibraryTreeNode->setName(StringHandler::getLastWordAfterDot(className));
     mpLibraryTreeNode->setText(0, mpLibraryTreeNode->getName());
-    mpLibraryTreeNode->setNameStructure(className);
+    pLibraryTreeWidget->setLibraryTreeNodeNameStructure(mpLibraryTreeNode, className);
     setModelModified();
     /* get the model components, shapes & connectors */
     refresh();
@@ -116,9 +116,11 @@ private:
   bool mIsCreatingBitmapShape;
   Component *mpClickedComponent;
   bool mIsMovingComponentsAndShapes;
+  bool mOptimizeRendering;
   QList<Component*> mComponentsList;
   QList<LineAnnotation*> mConnectionsList;
   QList<ShapeAnnotation*> mShapesList;
+  QString mShapesAnnotation;
   LineAnnotation *mpConnectionLineAnnotation;
   LineAnnotation *mpLineShapeAnnotation;
   PolygonAnnotation *mpPolygonShapeAnnotation;
@@ -167,7 +169,12 @@ public:
   void setItemsFlags(bool enable);
   void setIsMovingComponentsAndShapes(bool enable);
   bool isMovingComponentsAndShapes();
+  void setOptimizeRendering(bool optimize);
+  bool isOptimizeRendering() {return mOptimizeRendering;}
   QList<ShapeAnnotation*> getShapesList() {return mShapesList;}
+  QList<LineAnnotation*> getConnectionsList() {return mConnectionsList;}
+  void setShapesAnnotation(QString shapesAnnotation) {mShapesAnnotation = shapesAnnotation;}
+  QString getShapesAnnotation() {return mShapesAnnotation;}
   QAction* getDeleteConnectionAction();
   QAction* getDeleteAction();
   QAction* getDuplicateAction();
@@ -184,6 +191,7 @@ public:
                           StringHandler::ModelicaClasses type, bool addObject = true, bool openingClass = false, bool inheritedClass = false,
                           QString inheritedClassName = QString(), QString fileName = QString());
   void addComponentObject(Component *pComponent);
+  void addComponentToList(Component *pComponent);
   void deleteComponentObject(Component *pComponent);
   Component* getComponentObject(QString componentName);
   QString getUniqueComponentName(QString componentName, int number = 1);
@@ -318,14 +326,18 @@ public:
   Label* getCursorPositionLabel() {return mpCursorPositionLabel;}
   void setModelModified();
   void updateParentModelsText(QString className);
-  void getModelComponents(QString className, bool inheritedCycle = false);
+  void getModelComponents(QString className, bool inheritedCycle = false, QHash<QString, Component*> *pDiagramComponents = 0,
+                          QHash<QString, Component*> *pIconComponents = 0);
   void getModelIconDiagramShapes(QString className, bool inheritedCycle = false);
+  void getModelIconDiagramShapes(QString className, StringHandler::ViewType viewType, bool inheritedCycle);
   void getModelIconDiagramShapes(QString className, QString annotationString, StringHandler::ViewType viewType, bool inheritedCycle = false);
-  void getModelConnections(QString className, bool inheritedCycle = false);
+  QString getModelIconDiagramAnnotation(QString className, StringHandler::ViewType viewType);
+  void getModelConnections(QString className, bool inheritedCycle = false, QMultiHash<QString, LineAnnotation*> *pConnections = 0);
   void getTLMComponents();
   void getTLMConnections();
   Component* getConnectorComponent(Component *pConnectorComponent, QString connectorName);
   void refresh();
+  void refreshIncrementally();
 private:
   ModelWidgetContainer *mpModelWidgetContainer;
   LibraryTreeNode *mpLibraryTreeNode;
@@ -348,6 +360,13 @@ private:
   ModelicaTextHighlighter *mpModelicaTextHighlighter;
   TLMHighlighter *mpTLMHighlighter;
   QStatusBar *mpModelStatusBar;
+  void refreshClassInformation();
+  Component* takeUnchangedComponent(QHash<QString, Component*> *pComponents, GraphicsView *pGraphicsView, ComponentInfo *pComponentInfo,
+                                    StringHandler::ModelicaClasses type, QString transformation, bool inheritedCycle,
+                                    QString inheritedClassName);
+  LineAnnotation* takeUnchangedConnection(QMultiHash<QString, LineAnnotation*> *pConnections, QString startComponentName,
+                                          QString endComponentName, QString annotation, bool inheritedCycle,
+                                          Component *pStartConnectorComponent, Component *pEndConnectorComponent);
 private slots:
   void showIconView(bool checked);
   void showDiagramView(bool checked);
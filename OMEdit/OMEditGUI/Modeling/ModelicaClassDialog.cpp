@@ -69,10 +69,17 @@ LibraryBrowseDialog::LibraryBrowseDialog(QString title, QLineEdit *pLineEdit, Li
   mpLibraryBrowseTreeWidget->setIndentation(Helper::treeIndentation);
   mpLibraryBrowseTreeWidget->setExpandsOnDoubleClick(false);
   connect(mpLibraryBrowseTreeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), SLOT(useModelicaClass()));
+  connect(mpLibraryBrowseTreeWidget, SIGNAL(itemExpanded(QTreeWidgetItem*)), SLOT(createChildItems(QTreeWidgetItem*)));
+  // make sure the LibraryTreeNodes of the selected class are created before cloning the tree.
+  if (!pLineEdit->text().isEmpty())
+  {
+    mpLibraryTreeWidget->getOrCreateLibraryTreeNode(pLineEdit->text());
+  }
   for (int i = 0; i < mpLibraryTreeWidget->topLevelItemCount(); i++)
   {
     QTreeWidgetItem *pLibraryTreeItem = mpLibraryTreeWidget->topLevelItem(i)->clone();
     mpLibraryBrowseTreeWidget->addTopLevelItem(pLibraryTreeItem);
+    setChildIndicators(pLibraryTreeItem);
   }
   // if the text box has some value then expand the tree and select the item accordingly.
   if (!pLineEdit->text().isEmpty())
@@ -129,6 +136,46 @@ void LibraryBrowseDialog::unHideChildItems(QTreeWidgetItem *pTreeWidgetItem)
   }
 }
 
+/*!
+ * \brief LibraryBrowseDialog::setChildIndicators
+ * Shows the expand indicator on the items whose nested classes are not created yet.
+ * \param pTreeWidgetItem
+ */
+void LibraryBrowseDialog::setChildIndicators(QTreeWidgetItem *pTreeWidgetItem)
+{
+  if (pTreeWidgetItem->childCount() == 0)
+  {
+    if (mpLibraryTreeWidget->hasUnloadedChildLibraryTreeNodes(pTreeWidgetItem->data(0, Qt::UserRole).toString()))
+      pTreeWidgetItem->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    return;
+  }
+  for (int i = 0 ; i < pTreeWidgetItem->childCount() ; i++)
+    setChildIndicators(pTreeWidgetItem->child(i));
+}
+
+/*!
+ * \brief LibraryBrowseDialog::createChildItems
+ * Slot activated when mpLibraryBrowseTreeWidget itemExpanded SIGNAL is raised.\n
+ * Creates the nested classes of the expanded item if they are not created yet.
+ * \param pTreeWidgetItem
+ */
+void LibraryBrowseDialog::createChildItems(QTreeWidgetItem *pTreeWidgetItem)
+{
+  if (pTreeWidgetItem->childCount() > 0)
+    return;
+  LibraryTreeNode *pLibraryTreeNode = mpLibraryTreeWidget->getLibraryTreeNode(pTreeWidgetItem->data(0, Qt::UserRole).toString());
+  if (!pLibraryTreeNode)
+    return;
+  mpLibraryTreeWidget->createChildLibraryTreeNodes(pLibraryTreeNode);
+  for (int i = 0 ; i < pLibraryTreeNode->childCount() ; i++)
+  {
+    QTreeWidgetItem *pChildItem = pLibraryTreeNode->child(i)->clone();
+    pTreeWidgetItem->addChild(pChildItem);
+    setChildIndicators(pChildItem);
+  }
+  pTreeWidgetItem->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
 void LibraryBrowseDialog::findModelicaClasses()
 {
   mpLibraryBrowseTreeWidget->clearSelection();
@@ -346,7 +393,7 @@ void ModelicaClassDialog::createModelicaClass()
   }
   /* if insert in class is system library. */
   LibraryTreeWidget *pLibraryTreeWidget = mpMainWindow->getLibraryTreeWidget();
-  LibraryTreeNode *pParentLibraryTreeNode = pLibraryTreeWidget->getLibraryTreeNode(mpParentClassTextBox->text());
+  LibraryTreeNode *pParentLibraryTreeNode = pLibraryTreeWidget->getOrCreateLibraryTreeNode(mpParentClassTextBox->text());
   if (pParentLibraryTreeNode) {
     if (pParentLibraryTreeNode->isSystemLibrary()) {
       QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error), GUIMessages::getMessage(
@@ -685,7 +732,7 @@ void SaveAsClassDialog::saveAsModelicaClass()
   }
   /* if insert in class is system library. */
   LibraryTreeWidget *pLibraryTreeWidget = mpMainWindow->getLibraryTreeWidget();
-  LibraryTreeNode *pParentLibraryTreeNode = pLibraryTreeWidget->getLibraryTreeNode(mpParentClassComboBox->currentText());
+  LibraryTreeNode *pParentLibraryTreeNode = pLibraryTreeWidget->getOrCreateLibraryTreeNode(mpParentClassComboBox->currentText());
   if (pParentLibraryTreeNode)
   {
     if (pParentLibraryTreeNode->isSystemLibrary())
@@ -51,6 +51,7 @@ class LibraryBrowseDialog : public QDialog
 public:
   LibraryBrowseDialog(QString title, QLineEdit *pLineEdit, LibraryTreeWidget *pParent);
   void unHideChildItems(QTreeWidgetItem *pItem);
+  void setChildIndicators(QTreeWidgetItem *pItem);
 private:
   QLineEdit *mpLineEdit;
   LibraryTreeWidget *mpLibraryTreeWidget;
@@ -62,6 +63,7 @@ private:
 private slots:
   void findModelicaClasses();
   void useModelicaClass();
+  void createChildItems(QTreeWidgetItem *pItem);
 };
 
 class ModelicaClassDialog : public QDialog
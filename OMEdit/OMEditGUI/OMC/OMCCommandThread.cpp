@@ -0,0 +1,350 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include "meta/meta_modelica.h"
+
+extern "C" {
+int omc_Main_handleCommand(void *threadData, void *imsg, void *ist, void **omsg, void **ost);
+}
+
+#include <stdio.h>
+#include <string.h>
+
+#include "OpenModelicaScriptingAPIQt.h"
+#include "OMCCommandThread.h"
+#include "StringHandler.h"
+
+/* Guards the symbol table of the OMC interface which is shared by the command threads. */
+static QMutex symbolTableMutex;
+
+/*!
+ * \class OMCCommandThread
+ * \brief Executes OMC commands in a dedicated thread.
+ * Every OMC command is executed in a command thread. The thread has its own threadData so OMC checks the stack of the thread
+ * running the command and keeps the error messages of the thread separate from the other command threads.
+ * Commands posted with postCommand() are queued and executed one by one. The errors of each posted command are read in the
+ * same job and kept with the result until they are taken with takeCommandResult() or waitForCommand().
+ * The commandStarted() signal tells that OMC has started the command and the commandFinished() signal tells that a result
+ * is available.
+ * executeCommand() is the synchronous facade. It queues the command and waits for its result. The errors are left in OMC
+ * for the caller to read with the next commands.
+ */
+/*!
+ * \brief OMCCommandThread::OMCCommandThread
+ * \param pOMCInterface - the OMC interface holding the threadData initialized by omc_Main_init and the symbol table.
+ * \param updateSymbolTable - if true then the symbol table returned by the commands replaces the shared symbol table.
+ * Otherwise each command works on a copy of the shared symbol table and its changes are dropped.
+ * \param pParent
+ */
+OMCCommandThread::OMCCommandThread(OMCInterface *pOMCInterface, bool updateSymbolTable, QObject *pParent)
+  : QThread(pParent), mpOMCInterface(pOMCInterface), mUpdateSymbolTable(updateSymbolTable)
+{
+  mRunningRequestId = 0;
+  mLastRequestId = 0;
+  mStopThread = false;
+  /* OMC needs a deep stack. Use the same size as the main thread. */
+  setStackSize(16 * 1024 * 1024);
+  /* OMC allocates with the Boehm GC so the command thread must register itself with it. Allow it from the main thread. */
+  GC_allow_register_threads();
+}
+
+OMCCommandThread::~OMCCommandThread()
+{
+  stopThread();
+}
+
+/*!
+ * \brief OMCCommandThread::executeCommand
+ * Queues the OMC command and blocks until the command thread has executed it.
+ * \param expression - the OMC command.
+ * \param pCommandResult - the command result. mSuccess is false if OMC failed to handle the command e.g., quit().
+ * \return false if the thread is stopped before executing the command.
+ */
+bool OMCCommandThread::executeCommand(const QString &expression, OMCCommandResult *pCommandResult)
+{
+  return waitForCommand(enqueueCommand(expression, false), pCommandResult);
+}
+
+/*!
+ * \brief OMCCommandThread::postCommand
+ * Adds the OMC command to the requests queue and returns immediately.
+ * \param expression - the OMC command.
+ * \return the request id which is passed back with the commandFinished() signal.
+ */
+int OMCCommandThread::postCommand(const QString &expression)
+{
+  return enqueueCommand(expression, true);
+}
+
+/*!
+ * \brief OMCCommandThread::cancelCommand
+ * Removes the command from the requests queue.
+ * \param requestId
+ * \return true if the command was removed. false if it is already running or finished.
+ */
+bool OMCCommandThread::cancelCommand(int requestId)
+{
+  QMutexLocker requestsLocker(&mRequestsMutex);
+  for (int i = 0 ; i < mRequestsQueue.size() ; i++) {
+    if (mRequestsQueue.at(i).mRequestId == requestId) {
+      mRequestsQueue.removeAt(i);
+      mResultsWaitCondition.wakeAll();
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief OMCCommandThread::takeCommandResult
+ * Takes the result of the finished command.
+ * \param requestId
+ * \param pCommandResult
+ * \return false if the command is not finished or its result is already taken.
+ */
+bool OMCCommandThread::takeCommandResult(int requestId, OMCCommandResult *pCommandResult)
+{
+  QMutexLocker requestsLocker(&mRequestsMutex);
+  if (!mResultsHash.contains(requestId)) {
+    return false;
+  }
+  *pCommandResult = mResultsHash.take(requestId);
+  return true;
+}
+
+/*!
+ * \brief OMCCommandThread::waitForCommand
+ * Blocks until the queued or running command is finished and takes its result.
+ * \param requestId
+ * \param pCommandResult
+ * \return false if the command is unknown, cancelled or its result is already taken.
+ */
+bool OMCCommandThread::waitForCommand(int requestId, OMCCommandResult *pCommandResult)
+{
+  QMutexLocker requestsLocker(&mRequestsMutex);
+  forever {
+    if (mResultsHash.contains(requestId)) {
+      *pCommandResult = mResultsHash.take(requestId);
+      return true;
+    }
+    bool pending = mRunningRequestId == requestId;
+    for (int i = 0 ; !pending && i < mRequestsQueue.size() ; i++) {
+      pending = mRequestsQueue.at(i).mRequestId == requestId;
+    }
+    if (!pending) {
+      return false;
+    }
+    mResultsWaitCondition.wait(&mRequestsMutex);
+  }
+}
+
+/*!
+ * \brief OMCCommandThread::pendingCommandsCount
+ * \return the number of commands waiting in the requests queue.
+ */
+int OMCCommandThread::pendingCommandsCount()
+{
+  QMutexLocker requestsLocker(&mRequestsMutex);
+  return mRequestsQueue.size();
+}
+
+/*!
+ * \brief OMCCommandThread::stopThread
+ * Discards the queued commands and waits for the running command to finish.
+ */
+void OMCCommandThread::stopThread()
+{
+  mRequestsMutex.lock();
+  mStopThread = true;
+  mRequestsQueue.clear();
+  mRequestsWaitCondition.wakeAll();
+  mResultsWaitCondition.wakeAll();
+  mRequestsMutex.unlock();
+  if (isRunning() && QThread::currentThread() != this) {
+    wait();
+  }
+}
+
+/*!
+ * \brief OMCCommandThread::plotCallbackFunction
+ * The plot callback of the command thread. The plot windows can only be created in the GUI thread so the arguments are
+ * passed on with the plot() signal.
+ */
+void OMCCommandThread::plotCallbackFunction(void *p, int externalWindow, const char* filename, const char* title, const char* grid,
+                                            const char* plotType, const char* logX, const char* logY, const char* xLabel,
+                                            const char* yLabel, const char* x1, const char* x2, const char* y1, const char* y2,
+                                            const char* curveWidth, const char* curveStyle, const char* legendPosition,
+                                            const char* footer, const char* autoScale, const char* variables)
+{
+  OMCCommandThread *pOMCCommandThread = (OMCCommandThread*)p;
+  if (pOMCCommandThread) {
+    QStringList plotArguments;
+    plotArguments << QString::number(externalWindow) << QString(filename) << QString(title) << QString(grid) << QString(plotType)
+                  << QString(logX) << QString(logY) << QString(xLabel) << QString(yLabel) << QString(x1) << QString(x2)
+                  << QString(y1) << QString(y2) << QString(curveWidth) << QString(curveStyle) << QString(legendPosition)
+                  << QString(footer) << QString(autoScale) << QString(variables);
+    emit pOMCCommandThread->plot(plotArguments);
+  }
+}
+
+/*!
+ * \brief OMCCommandThread::run
+ * Reimplementation of QThread::run(). Takes the commands from the requests queue and executes them.
+ * The errors of the posted commands are read in the same job so they are returned together with the result.
+ */
+void OMCCommandThread::run()
+{
+  struct GC_stack_base stackBase;
+  GC_get_stack_base(&stackBase);
+  GC_register_my_thread(&stackBase);
+  /* Start from a copy of the threadData initialized by omc_Main_init so the thread inherits the OMC settings.
+   * The error messages, the print buffer and the system data are per thread. OMC creates them again for this thread.
+   */
+  threadData_t *threadData = (threadData_t *) calloc(1, sizeof(threadData_t));
+  memcpy(threadData, mpOMCInterface->threadData, sizeof(threadData_t));
+  threadData->localRoots[LOCAL_ROOT_ERROR_MO] = 0;
+  threadData->localRoots[LOCAL_ROOT_PRINT_MO] = 0;
+  threadData->localRoots[LOCAL_ROOT_SYSTEM_MO] = 0;
+  threadData->plotClassPointer = this;
+  threadData->plotCB = OMCCommandThread::plotCallbackFunction;
+  pthread_setspecific(mmc_thread_data_key, threadData);
+  /* the stack overflow checks must use the stack of this thread */
+  mmc_init_stackoverflow(threadData);
+  forever {
+    OMCCommandRequest request;
+    mRequestsMutex.lock();
+    while (mRequestsQueue.isEmpty() && !mStopThread) {
+      mRequestsWaitCondition.wait(&mRequestsMutex);
+    }
+    if (mStopThread) {
+      mRequestsMutex.unlock();
+      break;
+    }
+    request = mRequestsQueue.dequeue();
+    mRunningRequestId = request.mRequestId;
+    mRequestsMutex.unlock();
+    emit commandStarted(request.mRequestId);
+    symbolTableMutex.lock();
+    void *st = mpOMCInterface->st;
+    symbolTableMutex.unlock();
+    OMCCommandResult commandResult;
+    commandResult.mExpression = request.mExpression;
+    commandResult.mResult = handleCommand(threadData, &st, request.mExpression, &commandResult.mSuccess);
+    if (commandResult.mSuccess && request.mReadErrors) {
+      commandResult.mErrorString = StringHandler::unparse(handleCommand(threadData, &st, "getErrorString()", 0).trimmed());
+    }
+    if (mUpdateSymbolTable) {
+      symbolTableMutex.lock();
+      mpOMCInterface->st = st;
+      symbolTableMutex.unlock();
+    }
+    mRequestsMutex.lock();
+    mRunningRequestId = 0;
+    mResultsHash.insert(request.mRequestId, commandResult);
+    mResultsWaitCondition.wakeAll();
+    mRequestsMutex.unlock();
+    emit commandFinished(request.mRequestId);
+  }
+  pthread_setspecific(mmc_thread_data_key, 0);
+  free(threadData);
+  GC_unregister_my_thread();
+}
+
+/*!
+ * \brief OMCCommandThread::enqueueCommand
+ * Adds the OMC command to the requests queue and starts the thread if it is not running.
+ * \param expression - the OMC command.
+ * \param readErrors - if true then the errors of the command are read after it.
+ * \return the request id.
+ */
+int OMCCommandThread::enqueueCommand(const QString &expression, bool readErrors)
+{
+  QMutexLocker requestsLocker(&mRequestsMutex);
+  OMCCommandRequest request;
+  request.mRequestId = ++mLastRequestId;
+  request.mExpression = expression;
+  request.mReadErrors = readErrors;
+  mRequestsQueue.enqueue(request);
+  mStopThread = false;
+  if (!isRunning()) {
+    start();
+  }
+  mRequestsWaitCondition.wakeOne();
+  return request.mRequestId;
+}
+
+/*!
+ * \brief OMCCommandThread::handleCommand
+ * Executes the OMC command. Must only be called from the command thread with its threadData.
+ * \param pThreadData - the threadData of the command thread.
+ * \param pSymbolTable - the symbol table used by the command. Replaced with the symbol table returned by OMC.
+ * \param expression - the OMC command.
+ * \param pSuccess - set to false if OMC failed to handle the command e.g., quit().
+ * \return the command result.
+ */
+QString OMCCommandThread::handleCommand(void *pThreadData, void **pSymbolTable, const QString &expression, bool *pSuccess)
+{
+  QString result;
+  bool success = true;
+  void *reply_str = NULL;
+  threadData_t *threadData = (threadData_t*)pThreadData;
+
+  MMC_TRY_TOP_INTERNAL()
+
+  MMC_TRY_STACK()
+
+  if (omc_Main_handleCommand(threadData, mmc_mk_scon(expression.toStdString().c_str()), *pSymbolTable, &reply_str, pSymbolTable)) {
+    result = MMC_STRINGDATA(reply_str);
+  } else {
+    success = false;
+  }
+
+  MMC_ELSE()
+    result = "";
+    fprintf(stderr, "Stack overflow detected and was not caught.\nSend us a bug report at https://trac.openmodelica.org/OpenModelica/newticket\n    Include the following trace:\n");
+    printStacktraceMessages();
+    fflush(NULL);
+  MMC_CATCH_STACK()
+
+  MMC_CATCH_TOP(result = "");
+
+  if (pSuccess) {
+    *pSuccess = success;
+  }
+  return result;
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef OMCCOMMANDTHREAD_H
+#define OMCCOMMANDTHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class OMCInterface;
+
+struct OMCCommandRequest
+{
+  int mRequestId;
+  QString mExpression;
+  bool mReadErrors;
+};
+
+struct OMCCommandResult
+{
+  QString mExpression;
+  QString mResult;
+  QString mErrorString;
+  bool mSuccess;
+};
+
+class OMCCommandThread : public QThread
+{
+  Q_OBJECT
+public:
+  OMCCommandThread(OMCInterface *pOMCInterface, bool updateSymbolTable, QObject *pParent = 0);
+  ~OMCCommandThread();
+  bool executeCommand(const QString &expression, OMCCommandResult *pCommandResult);
+  int postCommand(const QString &expression);
+  bool cancelCommand(int requestId);
+  bool takeCommandResult(int requestId, OMCCommandResult *pCommandResult);
+  bool waitForCommand(int requestId, OMCCommandResult *pCommandResult);
+  int pendingCommandsCount();
+  void stopThread();
+  static void plotCallbackFunction(void *p, int externalWindow, const char* filename, const char* title, const char* grid,
+                                   const char* plotType, const char* logX, const char* logY, const char* xLabel, const char* yLabel,
+                                   const char* x1, const char* x2, const char* y1, const char* y2, const char* curveWidth,
+                                   const char* curveStyle, const char* legendPosition, const char* footer, const char* autoScale,
+                                   const char* variables);
+protected:
+  virtual void run();
+private:
+  OMCInterface *mpOMCInterface;
+  bool mUpdateSymbolTable;
+  QMutex mRequestsMutex;
+  QWaitCondition mRequestsWaitCondition;
+  QQueue<OMCCommandRequest> mRequestsQueue;
+  QWaitCondition mResultsWaitCondition;
+  QHash<int, OMCCommandResult> mResultsHash;
+  int mRunningRequestId;
+  int mLastRequestId;
+  bool mStopThread;
+  int enqueueCommand(const QString &expression, bool readErrors);
+  QString handleCommand(void *pThreadData, void **pSymbolTable, const QString &expression, bool *pSuccess);
+signals:
+  void commandStarted(int requestId);
+  void commandFinished(int requestId);
+  void plot(QStringList plotArguments);
+};
+
+#endif // OMCCOMMANDTHREAD_H
@@ -58,6 +58,8 @@ void omc_Main_setWindowsPaths(threadData_t *threadData, void* _inOMHome);
 #include <iostream>
 
 #include "OMCProxy.h"
+#include "ComponentClass.h"
+#include "BitmapImageCache.h"
 #include "simulation_options.h"
 
 static QVariant parseExpression(QString result)
@@ -83,6 +85,44 @@ static QVariant parseExpression(QString result)
   return res;
 }
 
+/*!
+ * \brief quoteString
+ * Makes a Modelica string literal of the value for the OMC commands.
+ * \param value
+ * \return the quoted value.
+ */
+static QString quoteString(QString value)
+{
+  return "\"" + value.replace("\\", "\\\\").replace("\"", "\\\"") + "\"";
+}
+
+/*!
+ * \brief parseClassInformation
+ * Parses the result of the getClassInformation command.
+ * \param result - the getClassInformation result.
+ * \param pClassInformation - set to the parsed class information.
+ * \return false if the result is not a class information.
+ */
+static bool parseClassInformation(QString result, OMCInterface::getClassInformation_res *pClassInformation)
+{
+  QVariantList values = parseExpression(result).toList();
+  if (values.size() < 11) {
+    return false;
+  }
+  pClassInformation->restriction = StringHandler::unparse(values.at(0).toString());
+  pClassInformation->comment = StringHandler::unparse(values.at(1).toString());
+  pClassInformation->partialPrefix = values.at(2).toBool();
+  pClassInformation->finalPrefix = values.at(3).toBool();
+  pClassInformation->encapsulatedPrefix = values.at(4).toBool();
+  pClassInformation->fileName = StringHandler::unparse(values.at(5).toString());
+  pClassInformation->fileReadOnly = values.at(6).toBool();
+  pClassInformation->lineNumberStart = values.at(7).toInt();
+  pClassInformation->columnNumberStart = values.at(8).toInt();
+  pClassInformation->lineNumberEnd = values.at(9).toInt();
+  pClassInformation->columnNumberEnd = values.at(10).toInt();
+  return true;
+}
+
 /*!
   \class OMCProxy
   \brief It contains the reference of the CORBA object used to communicate with the OpenModelica Compiler.
@@ -91,8 +131,16 @@ static QVariant parseExpression(QString result)
   \param pMainWindow - pointer to MainWindow
   */
 OMCProxy::OMCProxy(MainWindow *pMainWindow)
-  : QObject(pMainWindow), mHasInitialized(false), mResult("")
-{
+  : QObject(pMainWindow), mHasInitialized(false), mResult(""), mCachedOMCCommandsCache(16 * 1024 * 1024)
+{
+  mCachedOMCCommandsHits = 0;
+  mCachedOMCCommandsMisses = 0;
+  mCachedOMCCommandsKeysCount = 0;
+  mpOMCInterface = 0;
+  mpOMCCommandThread = 0;
+  mpOMCBackgroundCommandThread = 0;
+  mpComponentClassCache = new ComponentClassCache(this);
+  mpBitmapImageCache = new BitmapImageCache;
   mpMainWindow = pMainWindow;
   mCurrentCommandIndex = -1;
   // OMC Commands Logger Widget
@@ -133,7 +181,13 @@ OMCProxy::OMCProxy(MainWindow *pMainWindow)
 
 OMCProxy::~OMCProxy()
 {
+  if (mpOMCCommandThread) {
+    mpOMCBackgroundCommandThread->stopThread();
+    mpOMCCommandThread->stopThread();
+  }
   delete mpOMCLoggerWidget;
+  delete mpComponentClassCache;
+  delete mpBitmapImageCache;
 }
 
 /*!
@@ -190,74 +244,179 @@ void OMCProxy::getNextCommand()
 }
 
 /*!
-  Returns the cached OMC command from the hash.
+ * \brief cachedOMCCommandKey
+ * \param className
+ * \param command
+ * \return the key of the command in the OMC commands cache.
+ */
+static QString cachedOMCCommandKey(const QString &className, const QString &command)
+{
+  return className + QLatin1Char('\n') + command;
+}
+
+/*!
+  Returns the cached OMC command from the cache.
   \param className - the name of the class to search for.
   \param command - the command to search for.
   \return the OMC command
   */
 cachedOMCCommand OMCProxy::getcachedOMCCommand(QString className, QString command)
 {
-  if (mCachedOMCCommandsMap.contains(className))
-  {
-    QList<cachedOMCCommand> commandsList = mCachedOMCCommandsMap.value(className);
-    foreach (cachedOMCCommand omcCommand, commandsList)
-    {
-      if (omcCommand.mOMCCommand.compare(command) == 0)
-        return omcCommand;
-    }
+  cachedOMCCommand omcCommand;
+  QString key = cachedOMCCommandKey(className, command);
+  QString *pCommandResult = mCachedOMCCommandsCache.object(key);
+  if (pCommandResult) {
+    mCachedOMCCommandsHits++;
+    omcCommand.mOMCCommand = command;
+    omcCommand.mOMCCommandResult = *pCommandResult;
+  } else {
+    mCachedOMCCommandsMisses++;
+    // the command might have been evicted from the cache.
+    removeCachedOMCCommandKey(className, key);
   }
-  return cachedOMCCommand();
+  return omcCommand;
 }
 
 /*!
-  Adds the OMC command to the cached hash.
+  Adds the OMC command to the cache.
+  The least recently used commands are evicted when the size of the cached results exceeds the cache limit.
   \param className - the name of the class.
   \param command - the command.
   \param commandResult - the command result
   */
 void OMCProxy::cacheOMCCommand(QString className, QString command, QString commandResult)
 {
-  /* if the className is already in commands hash */
-  if (mCachedOMCCommandsMap.contains(className))
-  {
-    QList<cachedOMCCommand> commandsList = mCachedOMCCommandsMap.value(className);
-    /* if the commands list doesn't contain the command then add it */
-    bool found = false;
-    foreach (cachedOMCCommand omcCommand, commandsList)
-    {
-      if (omcCommand.mOMCCommand.compare(command) == 0)
-      {
-        found = true;
-        break;
+  QString key = cachedOMCCommandKey(className, command);
+  if (mCachedOMCCommandsCache.contains(key)) {
+    return;
+  }
+  if (!mCachedOMCCommandsCache.insert(key, new QString(commandResult), key.size() + commandResult.size())) {
+    return;
+  }
+  QSet<QString> &keys = mCachedOMCCommandsKeysHash[className];
+  if (!keys.contains(key)) {
+    keys.insert(key);
+    mCachedOMCCommandsKeysCount++;
+  }
+  /* the insertion may have evicted other commands. Drop their keys once the stale keys outnumber the cached commands. */
+  if (mCachedOMCCommandsKeysCount > 2 * mCachedOMCCommandsCache.count() + 1024) {
+    pruneCachedOMCCommandsKeys();
+  }
+}
+
+/*!
+ * \brief OMCProxy::removeCachedOMCCommandKey
+ * Removes the key from the keys of the cached OMC commands of the class.
+ * \param className
+ * \param key
+ */
+void OMCProxy::removeCachedOMCCommandKey(QString className, QString key)
+{
+  QHash<QString, QSet<QString> >::iterator iterator = mCachedOMCCommandsKeysHash.find(className);
+  if (iterator == mCachedOMCCommandsKeysHash.end() || !iterator.value().remove(key)) {
+    return;
+  }
+  mCachedOMCCommandsKeysCount--;
+  if (iterator.value().isEmpty()) {
+    mCachedOMCCommandsKeysHash.erase(iterator);
+  }
+}
+
+/*!
+ * \brief OMCProxy::pruneCachedOMCCommandsKeys
+ * Removes the keys of the commands evicted from the OMC commands cache.
+ */
+void OMCProxy::pruneCachedOMCCommandsKeys()
+{
+  QHash<QString, QSet<QString> >::iterator iterator = mCachedOMCCommandsKeysHash.begin();
+  while (iterator != mCachedOMCCommandsKeysHash.end()) {
+    QSet<QString>::iterator keysIterator = iterator.value().begin();
+    while (keysIterator != iterator.value().end()) {
+      if (mCachedOMCCommandsCache.contains(*keysIterator)) {
+        ++keysIterator;
+      } else {
+        keysIterator = iterator.value().erase(keysIterator);
+        mCachedOMCCommandsKeysCount--;
       }
     }
-    if (!found)
-    {
-      cachedOMCCommand omcCommand;
-      omcCommand.mOMCCommand = command;
-      omcCommand.mOMCCommandResult = commandResult;
-      commandsList.append(omcCommand);
-      mCachedOMCCommandsMap.insert(className, commandsList);
+    if (iterator.value().isEmpty()) {
+      iterator = mCachedOMCCommandsKeysHash.erase(iterator);
+    } else {
+      ++iterator;
     }
   }
-  else
-  {
-    QList<cachedOMCCommand> commandsList;
-    cachedOMCCommand omcCommand;
-    omcCommand.mOMCCommand = command;
-    omcCommand.mOMCCommandResult = commandResult;
-    commandsList.append(omcCommand);
-    mCachedOMCCommandsMap.insert(className, commandsList);
-  }
 }
 
 /*!
-  Removes the OMC command from the cached hash.
+  Removes the cached OMC commands of the class and of all the classes that extend or instantiate it.
+  The shared component classes of the removed classes are removed as well.
   \param className - the name of the class.
   */
 void OMCProxy::removeCachedOMCCommand(QString className)
 {
-  mCachedOMCCommandsMap.remove(className);
+  QStringList classNames;
+  QSet<QString> removedClasses;
+  classNames.append(className);
+  while (!classNames.isEmpty()) {
+    QString name = classNames.takeFirst();
+    if (removedClasses.contains(name)) {
+      continue;
+    }
+    removedClasses.insert(name);
+    QSet<QString> keys = mCachedOMCCommandsKeysHash.take(name);
+    mCachedOMCCommandsKeysCount -= keys.size();
+    foreach (QString key, keys) {
+      mCachedOMCCommandsCache.remove(key);
+    }
+    mpComponentClassCache->removeComponentClass(name);
+    // the dependencies are recorded again when the dependent classes are queried.
+    foreach (QString dependentClassName, mDependentClassesHash.take(name)) {
+      classNames.append(dependentClassName);
+    }
+  }
+}
+
+/*!
+ * \brief OMCProxy::addClassDependency
+ * Records that className extends or instantiates usedClassName.
+ * The cached commands of className are removed when the cached commands of usedClassName are removed.
+ * \param className
+ * \param usedClassName
+ */
+void OMCProxy::addClassDependency(QString className, QString usedClassName)
+{
+  if (className.isEmpty() || usedClassName.isEmpty() || className.compare(usedClassName) == 0) {
+    return;
+  }
+  mDependentClassesHash[usedClassName].insert(className);
+}
+
+/*!
+ * \brief OMCProxy::addInheritedClassesDependencies
+ * Records that className depends on the classes it extends.
+ * Used by the cached commands whose result is taken from the base classes, e.g., the short class definitions.
+ * \param className
+ */
+void OMCProxy::addInheritedClassesDependencies(QString className)
+{
+  int inheritanceCount = getInheritanceCount(className);
+  for (int i = 1 ; i <= inheritanceCount ; i++) {
+    // getNthInheritedClass records the dependency.
+    getNthInheritedClass(className, i);
+  }
+}
+
+/*!
+ * \brief OMCProxy::getCachedOMCCommandsStatistics
+ * \return the hits, misses and size of the OMC commands cache.
+ */
+QString OMCProxy::getCachedOMCCommandsStatistics()
+{
+  int lookups = mCachedOMCCommandsHits + mCachedOMCCommandsMisses;
+  double hitRatio = lookups > 0 ? (double)mCachedOMCCommandsHits * 100 / lookups : 0;
+  return QString("OMC commands cache :: hits %1, misses %2, hit ratio %3%, cached commands %4, size %5 of %6 characters")
+      .arg(mCachedOMCCommandsHits).arg(mCachedOMCCommandsMisses).arg(hitRatio, 0, 'f', 1)
+      .arg(mCachedOMCCommandsCache.count()).arg(mCachedOMCCommandsCache.totalCost()).arg(mCachedOMCCommandsCache.maxCost());
 }
 
 /*!
@@ -288,13 +447,19 @@ bool OMCProxy::initializeOMC()
   MMC_TRY_TOP_INTERNAL()
   omc_Main_init(threadData, mmc_mk_nil());
   st = omc_Main_readSettings(threadData, mmc_mk_nil());
-  threadData->plotClassPointer = mpMainWindow;
-  threadData->plotCB = MainWindow::PlotCallbackFunction;
   MMC_CATCH_TOP(return false;)
+  /* The OMC interface only holds the initial threadData and the symbol table. The commands are executed by the command threads.
+   * mpOMCCommandThread executes the commands of sendCommand() and the calling thread waits for them.
+   * mpOMCBackgroundCommandThread executes the commands of sendCommandAsync() so the long running commands don't delay the
+   * commands of the GUI. It works on a copy of the symbol table and its changes to the symbol table are dropped.
+   */
   mpOMCInterface = new OMCInterface(threadData, st);
-  connect(mpOMCInterface, SIGNAL(logCommand(QString,QTime*)), this, SLOT(logCommand(QString,QTime*)));
-  connect(mpOMCInterface, SIGNAL(logResponse(QString,QTime*)), this, SLOT(logResponse(QString,QTime*)));
-  connect(mpOMCInterface, SIGNAL(throwException(QString)), SLOT(showException(QString)));
+  mpOMCCommandThread = new OMCCommandThread(mpOMCInterface, true, this);
+  connect(mpOMCCommandThread, SIGNAL(plot(QStringList)), this, SLOT(plot(QStringList)), Qt::QueuedConnection);
+  mpOMCBackgroundCommandThread = new OMCCommandThread(mpOMCInterface, false, this);
+  connect(mpOMCBackgroundCommandThread, SIGNAL(commandStarted(int)), this, SIGNAL(asyncCommandStarted(int)), Qt::QueuedConnection);
+  connect(mpOMCBackgroundCommandThread, SIGNAL(commandFinished(int)), this, SLOT(handleAsyncCommandFinished(int)),
+          Qt::QueuedConnection);
   mHasInitialized = true;
   // set the locale
   QSettings *pSettings = OpenModelica::getApplicationSettings();
@@ -324,7 +489,16 @@ bool OMCProxy::initializeOMC()
   */
 void OMCProxy::quitOMC()
 {
+  if (!mpOMCCommandThread) {
+    return;
+  }
+  mpOMCBackgroundCommandThread->stopThread();
+  if (mCommunicationLogFileTextStream.device()) {
+    mCommunicationLogFileTextStream << getCachedOMCCommandsStatistics() << "\n\n";
+    mCommunicationLogFileTextStream.flush();
+  }
   sendCommand("quit()");
+  mpOMCCommandThread->stopThread();
   mCommunicationLogFile.close();
   mCommandsMosFile.close();
 }
@@ -332,7 +506,7 @@ void OMCProxy::quitOMC()
 /*!
   Sends the user commands to OMC.
   \param expression - is used to send command as a string.
-  \param cacheCommand - is used to cache the OMC command.
+  \param cacheCommand - is used to cache the OMC command and to look it up in the cache.
   \param className - the class name to store the cache command with.
   \param dontUseCachedCommand - flag used to check whether we want to use cached command or not.
   \see sendCommand()
@@ -347,7 +521,7 @@ void OMCProxy::sendCommand(const QString expression, bool cacheCommand, QString
     }
   }
   /* if OMC command is find in the cached OMC commands then use it and return. */
-  if (!dontUseCachedCommand)
+  if (cacheCommand && !dontUseCachedCommand)
   {
     cachedOMCCommand pOMCCommand = getcachedOMCCommand(className, expression);
     if (!pOMCCommand.mOMCCommandResult.isEmpty())
@@ -365,36 +539,91 @@ void OMCProxy::sendCommand(const QString expression, bool cacheCommand, QString
   QTime commandTime;
   commandTime.start();
   logCommand(expression, &commandTime);
-  // TODO: Call this in a thread that loops over received messages? Avoid MMC_TRY_TOP all the time, etc
-  void *reply_str = NULL;
-  threadData_t *threadData = mpOMCInterface->threadData;
-
-  MMC_TRY_TOP_INTERNAL()
-
-  MMC_TRY_STACK()
-
-  if (!omc_Main_handleCommand(threadData, mmc_mk_scon(expression.toStdString().c_str()), mpOMCInterface->st, &reply_str, &mpOMCInterface->st)) {
+  OMCCommandResult commandResult;
+  if (!mpOMCCommandThread->executeCommand(expression, &commandResult)) {
+    commandResult.mSuccess = false;
+  }
+  mResult = commandResult.mSuccess ? commandResult.mResult : "";
+  if (!commandResult.mSuccess) {
     if (expression == "quit()") {
       return;
     }
     exitApplication();
   }
-  mResult = MMC_STRINGDATA(reply_str);
   logResponse(mResult.trimmed(), &commandTime);
 
   // cache the OMC command
   if (cacheCommand) {
     cacheOMCCommand(className, expression, getResult());
   }
+}
+
+/*!
+ * \brief OMCProxy::sendCommandAsync
+ * Queues the command for the OMC command thread and returns immediately.
+ * The result is reported with the asyncCommandFinished() signal or can be fetched with waitForAsyncCommand().
+ * The asynchronous commands are not cached and must not call back into the GUI e.g., plot().
+ * \param expression - the OMC command.
+ * \return the request id of the command.
+ */
+int OMCProxy::sendCommandAsync(const QString expression)
+{
+  if (!mHasInitialized) {
+    if(!initializeOMC())      // if we are unable to start OMC. Exit the application.
+    {
+      mpMainWindow->setExitApplicationStatus(true);
+      return -1;
+    }
+  }
+  // write command to the commands log.
+  QTime commandTime;
+  commandTime.start();
+  logCommand(expression, &commandTime);
+  int requestId = mpOMCBackgroundCommandThread->postCommand(expression);
+  mAsyncCommandsTimeHash.insert(requestId, commandTime);
+  return requestId;
+}
+
+/*!
+ * \brief OMCProxy::isAsyncCommandRunning
+ * \param requestId
+ * \return true if the asynchronous command is queued or running.
+ */
+bool OMCProxy::isAsyncCommandRunning(int requestId)
+{
+  return mAsyncCommandsTimeHash.contains(requestId);
+}
 
-  MMC_ELSE()
-    mResult = "";
-    fprintf(stderr, "Stack overflow detected and was not caught.\nSend us a bug report at https://trac.openmodelica.org/OpenModelica/newticket\n    Include the following trace:\n");
-    printStacktraceMessages();
-    fflush(NULL);
-  MMC_CATCH_STACK()
+/*!
+ * \brief OMCProxy::cancelAsyncCommand
+ * Cancels the asynchronous command if OMC has not started it yet.
+ * \param requestId
+ * \return true if the command is cancelled.
+ */
+bool OMCProxy::cancelAsyncCommand(int requestId)
+{
+  if (mpOMCBackgroundCommandThread->cancelCommand(requestId)) {
+    QTime commandTime = mAsyncCommandsTimeHash.take(requestId);
+    logResponse(tr("Command cancelled."), &commandTime);
+    return true;
+  }
+  return false;
+}
 
-  MMC_CATCH_TOP(mResult = "");
+/*!
+ * \brief OMCProxy::waitForAsyncCommand
+ * Blocks until the asynchronous command is finished. No events are processed while waiting.
+ * \param requestId
+ * \return the command result.
+ */
+QString OMCProxy::waitForAsyncCommand(int requestId)
+{
+  OMCCommandResult commandResult;
+  if (!mpOMCBackgroundCommandThread->waitForCommand(requestId, &commandResult)) {
+    return "";
+  }
+  finishAsyncCommand(requestId, commandResult);
+  return commandResult.mResult.trimmed();
 }
 
 /*!
@@ -523,9 +752,72 @@ void OMCProxy::sendCustomExpression()
     return;
 
   sendCommand(mpExpressionTextBox->text());
+  // the custom expression might load or delete classes.
+  mNonExistingClasses.clear();
   mpExpressionTextBox->setText(QString());
 }
 
+/*!
+ * \brief OMCProxy::handleAsyncCommandFinished
+ * Slot activated when OMCCommandThread::commandFinished SIGNAL is raised.
+ * Takes the result unless waitForAsyncCommand() has already taken it.
+ * \param requestId
+ */
+void OMCProxy::handleAsyncCommandFinished(int requestId)
+{
+  OMCCommandResult commandResult;
+  if (mpOMCBackgroundCommandThread->takeCommandResult(requestId, &commandResult)) {
+    finishAsyncCommand(requestId, commandResult);
+  }
+}
+
+/*!
+ * \brief OMCProxy::plot
+ * Slot activated when OMCCommandThread::plot SIGNAL is raised.
+ * Passes the arguments of the plot commands executed by OMC to MainWindow::PlotCallbackFunction() in the GUI thread.
+ * \param plotArguments
+ */
+void OMCProxy::plot(QStringList plotArguments)
+{
+  if (plotArguments.size() < 19) {
+    return;
+  }
+  QList<QByteArray> arguments;
+  for (int i = 1 ; i < plotArguments.size() ; i++) {
+    arguments.append(plotArguments.at(i).toUtf8());
+  }
+  try {
+    MainWindow::PlotCallbackFunction(mpMainWindow, plotArguments.at(0).toInt(), arguments.at(0).constData(), arguments.at(1).constData(),
+                                     arguments.at(2).constData(), arguments.at(3).constData(), arguments.at(4).constData(),
+                                     arguments.at(5).constData(), arguments.at(6).constData(), arguments.at(7).constData(),
+                                     arguments.at(8).constData(), arguments.at(9).constData(), arguments.at(10).constData(),
+                                     arguments.at(11).constData(), arguments.at(12).constData(), arguments.at(13).constData(),
+                                     arguments.at(14).constData(), arguments.at(15).constData(), arguments.at(16).constData(),
+                                     arguments.at(17).constData());
+  } catch (OMPlot::PlotException &e) {
+    showException(e.what());
+  }
+}
+
+/*!
+ * \brief OMCProxy::finishAsyncCommand
+ * Writes the response to the logs and emits asyncCommandFinished() with the result and the errors of the command.
+ * \param requestId
+ * \param commandResult
+ */
+void OMCProxy::finishAsyncCommand(int requestId, OMCCommandResult commandResult)
+{
+  if (!mAsyncCommandsTimeHash.contains(requestId)) {
+    return;
+  }
+  if (!commandResult.mSuccess && commandResult.mExpression.compare("quit()") != 0) {
+    exitApplication();
+  }
+  QTime commandTime = mAsyncCommandsTimeHash.take(requestId);
+  logResponse(commandResult.mResult.trimmed(), &commandTime);
+  emit asyncCommandFinished(requestId, commandResult.mResult.trimmed(), commandResult.mErrorString);
+}
+
 /*!
   Removes the CORBA IOR file. We only call this method when we are unable to connect to OMC.\n
   In normal case OMCProxy::stopServer will delete that file.
@@ -556,7 +848,8 @@ void OMCProxy::exitApplication()
   */
 QString OMCProxy::getErrorString(bool warningsAsErrors)
 {
-  return mpOMCInterface->getErrorString(warningsAsErrors);
+  sendCommand(QString("getErrorString(%1)").arg(warningsAsErrors ? "true" : "false"));
+  return StringHandler::unparse(getResult());
 }
 
 /*!
@@ -580,6 +873,62 @@ bool OMCProxy::printMessagesStringInternal()
   return returnValue;
 }
 
+/*!
+ * \brief OMCProxy::printErrorString
+ * Adds the messages of the error string returned by getErrorString() to the Messages Window.\n
+ * Used for the errors of the asynchronous commands which are read by the OMC command thread.
+ * \param errorString
+ * \param errorKind - the kind of the messages.
+ */
+void OMCProxy::printErrorString(QString errorString, QString errorKind)
+{
+  QRegExp fileMessageRegExp("^\\[(.*):(\\d+):(\\d+)-(\\d+):(\\d+):(writable|readonly)\\] (Error|Warning|Notification): (.*)$");
+  QRegExp messageRegExp("^(Error|Warning|Notification): (.*)$");
+  QString fileName, message, errorLevel;
+  bool readOnly = false;
+  int lineStart = 0, columnStart = 0, lineEnd = 0, columnEnd = 0;
+  QStringList lines = errorString.split("\n");
+  /* an empty line marks the end of the error string. */
+  lines.append(QString());
+  foreach (QString line, lines) {
+    bool newMessage = fileMessageRegExp.exactMatch(line) || messageRegExp.exactMatch(line) || line.isEmpty();
+    if (!newMessage) {
+      message.append("\n").append(line);
+      continue;
+    }
+    if (!message.isEmpty()) {
+      MessageItem messageItem(MessageItem::Modelica, fileName, readOnly, lineStart, columnStart, lineEnd, columnEnd, message.trimmed(),
+                              errorKind, errorLevel);
+      mpMainWindow->getMessagesWidget()->addGUIMessage(messageItem);
+      message.clear();
+    }
+    QString level;
+    if (fileMessageRegExp.exactMatch(line)) {
+      fileName = fileMessageRegExp.cap(1).compare("<interactive>") == 0 ? "" : fileMessageRegExp.cap(1);
+      lineStart = fileMessageRegExp.cap(2).toInt();
+      columnStart = fileMessageRegExp.cap(3).toInt();
+      lineEnd = fileMessageRegExp.cap(4).toInt();
+      columnEnd = fileMessageRegExp.cap(5).toInt();
+      readOnly = fileMessageRegExp.cap(6).compare("readonly") == 0;
+      level = fileMessageRegExp.cap(7);
+      message = fileMessageRegExp.cap(8);
+    } else if (messageRegExp.exactMatch(line)) {
+      fileName.clear();
+      lineStart = columnStart = lineEnd = columnEnd = 0;
+      readOnly = false;
+      level = messageRegExp.cap(1);
+      message = messageRegExp.cap(2);
+    }
+    if (level.compare("Error") == 0) {
+      errorLevel = Helper::errorLevel;
+    } else if (level.compare("Warning") == 0) {
+      errorLevel = Helper::warningLevel;
+    } else {
+      errorLevel = Helper::notificationLevel;
+    }
+  }
+}
+
 /*!
   Retrieves the list of errors from OMC
   \return size of errors
@@ -700,7 +1049,8 @@ QString OMCProxy::getErrorLevel()
   */
 QString OMCProxy::getVersion(QString className)
 {
-  return mpOMCInterface->getVersion(className);
+  sendCommand("getVersion(" + className + ")");
+  return StringHandler::unparse(getResult());
 }
 
 /*!
@@ -811,7 +1161,10 @@ void OMCProxy::loadUserLibraries(QSplashScreen *pSplashScreen)
   */
 QStringList OMCProxy::getClassNames(QString className, bool recursive, bool qualified, bool sort, bool builtin, bool showProtected)
 {
-  return mpOMCInterface->getClassNames(className, recursive, qualified, sort, builtin, showProtected);
+  sendCommand(QString("getClassNames(%1, recursive=%2, qualified=%3, sort=%4, builtin=%5, showProtected=%6)").arg(className)
+              .arg(recursive ? "true" : "false").arg(qualified ? "true" : "false").arg(sort ? "true" : "false")
+              .arg(builtin ? "true" : "false").arg(showProtected ? "true" : "false"));
+  return StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
 }
 
 /*!
@@ -822,7 +1175,8 @@ QStringList OMCProxy::getClassNames(QString className, bool recursive, bool qual
   */
 QStringList OMCProxy::searchClassNames(QString searchText, bool findInText)
 {
-  return mpOMCInterface->searchClassNames(searchText, findInText);
+  sendCommand("searchClassNames(" + quoteString(searchText) + ", findInText=" + QString(findInText ? "true" : "false") + ")");
+  return StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
 }
 
 /*!
@@ -832,7 +1186,232 @@ QStringList OMCProxy::searchClassNames(QString searchText, bool findInText)
   */
 OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString className)
 {
-  return mpOMCInterface->getClassInformation(className);
+  OMCInterface::getClassInformation_res classInformation;
+  sendCommand("getClassInformation(" + className + ")");
+  parseClassInformation(getResult(), &classInformation);
+  return classInformation;
+}
+
+/*!
+ * \brief OMCProxy::getClassesInformation
+ * Gets the class information, the documentation class flag, the protected status and the icon annotation of several classes
+ * in a single OMC round-trip using sendBatchedCommands().
+ * The icon annotations are added to the cached OMC commands so the later getIconAnnotation() calls don't go to OMC.
+ * \param classNames - the fully qualified class names.
+ * \param protectedStatus - if true then fetch the protected status of the classes within their parents.
+ * \param iconAnnotation - if true then fetch the icon annotation of the classes.
+ * \return the list of results in the same order as classNames.
+ */
+QList<batchedClassInformation> OMCProxy::getClassesInformation(QStringList classNames, bool protectedStatus, bool iconAnnotation)
+{
+  QList<batchedClassInformation> classesInformation;
+  if (classNames.isEmpty()) {
+    return classesInformation;
+  }
+  int queriesPerClass = 2 + (protectedStatus ? 1 : 0) + (iconAnnotation ? 1 : 0);
+  QStringList commands;
+  foreach (QString className, classNames) {
+    commands << "getClassInformation(" + className + ")";
+    commands << "getNamedAnnotation(" + className + ", DocumentationClass)";
+    if (protectedStatus) {
+      QString parentName = StringHandler::removeLastWordAfterDot(className);
+      if (parentName.compare(className) == 0) {
+        commands << "false";
+      } else {
+        commands << "isProtectedClass(" + parentName + ", \"" + StringHandler::getLastWordAfterDot(className) + "\")";
+      }
+    }
+    if (iconAnnotation) {
+      commands << "getIconAnnotation(" + className + ")";
+    }
+  }
+  QStringList results = sendBatchedCommands(commands);
+  // if OMC didn't return the expected number of results then query the classes one by one.
+  if (results.size() < classNames.size() * queriesPerClass) {
+    foreach (QString className, classNames) {
+      batchedClassInformation classInformation;
+      classInformation.mClassInformation = getClassInformation(className);
+      classInformation.mIsDocumentationClass = getDocumentationClassAnnotation(className);
+      classInformation.mIsProtected = false;
+      if (protectedStatus) {
+        QString parentName = StringHandler::removeLastWordAfterDot(className);
+        if (parentName.compare(className) != 0) {
+          classInformation.mIsProtected = isProtectedClass(parentName, StringHandler::getLastWordAfterDot(className));
+        }
+      }
+      if (iconAnnotation) {
+        classInformation.mIconAnnotation = getIconAnnotation(className);
+      }
+      classesInformation.append(classInformation);
+    }
+    return classesInformation;
+  }
+  for (int i = 0 ; i < classNames.size() ; i++) {
+    int index = i * queriesPerClass;
+    batchedClassInformation classInformation;
+    if (!parseClassInformation(results.at(index++), &classInformation.mClassInformation)) {
+      classInformation.mClassInformation = getClassInformation(classNames.at(i));
+    }
+    classInformation.mIsDocumentationClass = StringHandler::unparseBool(StringHandler::removeFirstLastCurlBrackets(results.at(index++)));
+    classInformation.mIsProtected = protectedStatus ? StringHandler::unparseBool(results.at(index++)) : false;
+    if (iconAnnotation) {
+      classInformation.mIconAnnotation = results.at(index++);
+      cacheOMCCommand(classNames.at(i), "getIconAnnotation(" + classNames.at(i) + ")", classInformation.mIconAnnotation);
+    }
+    classesInformation.append(classInformation);
+  }
+  return classesInformation;
+}
+
+/*!
+ * \brief OMCProxy::sendBatchedCommands
+ * Sends the commands to OMC in one round-trip.
+ * \param commands
+ * \return the result of each command or an empty list if OMC didn't return a result for every command.
+ */
+QStringList OMCProxy::sendBatchedCommands(QStringList commands)
+{
+  QStringList results;
+  if (commands.isEmpty()) {
+    return results;
+  }
+  const QString separator = "\"OMEditBatchSeparator\"";
+  sendCommand(commands.join("; " + separator + "; ") + "; " + separator);
+  QStringList values = getResult().split(separator);
+  // discard the errors of the failed commands. The commands are sent again one by one when they are used.
+  getErrorString();
+  if (values.size() < commands.size()) {
+    return results;
+  }
+  for (int i = 0 ; i < commands.size() ; i++) {
+    results.append(values.at(i).trimmed());
+  }
+  return results;
+}
+
+/*!
+ * \brief OMCProxy::prefetchDiagram
+ * Fetches everything needed to draw the icon and diagram views of the class in a few batched round-trips instead of one
+ * round-trip per query.\n
+ * The classes are walked level by level through their inherited classes and the types of their components. Every result is
+ * stored in the OMC commands cache with the expression used by ModelWidget and Component so building the views hits the cache.
+ * \param className
+ */
+void OMCProxy::prefetchDiagram(QString className)
+{
+  QSet<QString> visitedClasses;
+  QSet<QString> queriedTypes;
+  QSet<QString> diagramClasses;
+  QStringList classNames;
+  classNames.append(className);
+  diagramClasses.insert(className);
+  while (!classNames.isEmpty()) {
+    QStringList levelClasses;
+    foreach (QString name, classNames) {
+      if (!name.isEmpty() && !visitedClasses.contains(name) && !isBuiltinType(name)) {
+        visitedClasses.insert(name);
+        levelClasses.append(name);
+      }
+    }
+    classNames.clear();
+    if (levelClasses.isEmpty()) {
+      break;
+    }
+    /* first round-trip, the inheritance, the components and the annotations of the classes. */
+    QStringList commandClasses, commands;
+    foreach (QString name, levelClasses) {
+      commandClasses << name << name << name << name;
+      commands << "getInheritanceCount(" + name + ")" << "getComponents(" + name + ", useQuotes = true)"
+               << "getComponentAnnotations(" + name + ")" << "getIconAnnotation(" + name + ")";
+      if (diagramClasses.contains(name)) {
+        commandClasses << name << name;
+        commands << "getDiagramAnnotation(" + name + ")" << "getConnectionCount(" + name + ")";
+      }
+    }
+    QStringList results = sendBatchedCommands(commands);
+    if (results.isEmpty()) {
+      return;
+    }
+    for (int i = 0 ; i < commands.size() ; i++) {
+      cacheOMCCommand(commandClasses.at(i), commands.at(i), results.at(i));
+    }
+    /* second round-trip, the inherited classes and the connections. */
+    commandClasses.clear();
+    commands.clear();
+    foreach (QString name, levelClasses) {
+      int inheritanceCount = getInheritanceCount(name);
+      for (int i = 1 ; i <= inheritanceCount ; i++) {
+        commandClasses << name;
+        commands << "getNthInheritedClass(" + name + ", " + QString::number(i) + ")";
+      }
+      if (diagramClasses.contains(name)) {
+        int connectionCount = getConnectionCount(name);
+        for (int i = 1 ; i <= connectionCount ; i++) {
+          commandClasses << name << name;
+          commands << "getNthConnection(" + name + ", " + QString::number(i) + ")"
+                   << "getNthConnectionAnnotation(" + name + ", " + QString::number(i) + ")";
+        }
+      }
+    }
+    results = sendBatchedCommands(commands);
+    if (!commands.isEmpty() && results.isEmpty()) {
+      return;
+    }
+    for (int i = 0 ; i < commands.size() ; i++) {
+      cacheOMCCommand(commandClasses.at(i), commands.at(i), results.at(i));
+    }
+    /* collect the inherited classes and the component types. */
+    QStringList types;
+    foreach (QString name, levelClasses) {
+      int inheritanceCount = getInheritanceCount(name);
+      for (int i = 1 ; i <= inheritanceCount ; i++) {
+        QString inheritedClass = getNthInheritedClass(name, i);
+        if (inheritedClass.compare(name) == 0 || isBuiltinType(inheritedClass)) {
+          continue;
+        }
+        classNames.append(inheritedClass);
+        if (diagramClasses.contains(name)) {
+          diagramClasses.insert(inheritedClass);
+        }
+        if (!queriedTypes.contains(inheritedClass)) {
+          queriedTypes.insert(inheritedClass);
+          types.append(inheritedClass);
+        }
+      }
+      QList<ComponentInfo*> componentsList = getComponents(name);
+      foreach (ComponentInfo *pComponentInfo, componentsList) {
+        QString type = pComponentInfo->getClassName();
+        if (!isBuiltinType(type) && !queriedTypes.contains(type)) {
+          queriedTypes.insert(type);
+          types.append(type);
+        }
+      }
+      qDeleteAll(componentsList);
+    }
+    /* third round-trip, the restriction and the existence of the types. */
+    commands.clear();
+    foreach (QString type, types) {
+      commands << "getClassRestriction(" + type + ")" << "existClass(" + type + ")";
+    }
+    results = sendBatchedCommands(commands);
+    if (!commands.isEmpty() && results.isEmpty()) {
+      return;
+    }
+    for (int i = 0 ; i < types.size() ; i++) {
+      cacheOMCCommand(types.at(i), commands.at(i * 2), results.at(i * 2));
+      if (!StringHandler::unparseBool(results.at(i * 2 + 1))) {
+        mNonExistingClasses.insert(types.at(i));
+      } else {
+        cacheOMCCommand(types.at(i), commands.at(i * 2 + 1), results.at(i * 2 + 1));
+        /* only the types that can be drawn are walked. */
+        StringHandler::ModelicaClasses type = getClassRestriction(types.at(i));
+        if (type == StringHandler::Model || type == StringHandler::Class || type == StringHandler::Connector ||
+            type == StringHandler::Record || type == StringHandler::Block) {
+          classNames.append(types.at(i));
+        }
+      }
+    }
+  }
 }
 
 /*!
@@ -842,7 +1421,8 @@ OMCInterface::getClassInformation_res OMCProxy::getClassInformation(QString clas
   */
 bool OMCProxy::isPackage(QString className)
 {
-  return mpOMCInterface->isPackage(className);
+  sendCommand("isPackage(" + className + ")");
+  return StringHandler::unparseBool(getResult());
 }
 
 /*!
@@ -862,8 +1442,8 @@ bool OMCProxy::isBuiltinType(QString typeName)
   */
 QString OMCProxy::getBuiltinType(QString typeName)
 {
-  QString result = "";
-  result = mpOMCInterface->getBuiltinType(typeName);
+  sendCommand("getBuiltinType(" + typeName + ")");
+  QString result = StringHandler::unparse(getResult());
   getErrorString();
   return result;
 }
@@ -876,51 +1456,52 @@ QString OMCProxy::getBuiltinType(QString typeName)
   */
 bool OMCProxy::isWhat(StringHandler::ModelicaClasses type, QString className)
 {
-  bool result = false;
+  QString command;
   switch (type) {
     case StringHandler::Model:
-      result = mpOMCInterface->isModel(className);
+      command = "isModel";
       break;
     case StringHandler::Class:
-      result = mpOMCInterface->isClass(className);
+      command = "isClass";
       break;
     case StringHandler::Connector:
-      result = mpOMCInterface->isConnector(className);
+      command = "isConnector";
       break;
     case StringHandler::Record:
-      result = mpOMCInterface->isRecord(className);
+      command = "isRecord";
       break;
     case StringHandler::Block:
-      result = mpOMCInterface->isBlock(className);
+      command = "isBlock";
       break;
     case StringHandler::Function:
-      result = mpOMCInterface->isFunction(className);
+      command = "isFunction";
       break;
     case StringHandler::Package:
-      result = mpOMCInterface->isPackage(className);
+      command = "isPackage";
       break;
     case StringHandler::Type:
-      result = mpOMCInterface->isType(className);
+      command = "isType";
       break;
     case StringHandler::Operator:
-      result = mpOMCInterface->isOperator(className);
+      command = "isOperator";
       break;
     case StringHandler::OperatorRecord:
-      result = mpOMCInterface->isOperatorRecord(className);
+      command = "isOperatorRecord";
       break;
     case StringHandler::OperatorFunction:
-      result = mpOMCInterface->isOperatorFunction(className);
+      command = "isOperatorFunction";
       break;
     case StringHandler::Optimization:
-      result = mpOMCInterface->isOptimization(className);
+      command = "isOptimization";
       break;
     case StringHandler::Enumeration:
-      result = mpOMCInterface->isEnumeration(className);
+      command = "isEnumeration";
       break;
     default:
-      result = false;
+      return false;
   }
-  return result;
+  sendCommand(command + "(" + className + ")");
+  return StringHandler::unparseBool(getResult());
 }
 
 /*!
@@ -931,7 +1512,8 @@ bool OMCProxy::isWhat(StringHandler::ModelicaClasses type, QString className)
   */
 bool OMCProxy::isProtectedClass(QString className, QString nestedClassName)
 {
-  return mpOMCInterface->isProtectedClass(className, nestedClassName);
+  sendCommand("isProtectedClass(" + className + ", " + quoteString(nestedClassName) + ")");
+  return StringHandler::unparseBool(getResult());
 }
 
 /*!
@@ -941,7 +1523,8 @@ bool OMCProxy::isProtectedClass(QString className, QString nestedClassName)
   */
 bool OMCProxy::isPartial(QString className)
 {
-  return mpOMCInterface->isPartial(className);
+  sendCommand("isPartial(" + className + ")");
+  return StringHandler::unparseBool(getResult());
 }
 
 /*!
@@ -964,7 +1547,8 @@ bool OMCProxy::isReplaceable(QString parentClassName, QString className)
   */
 StringHandler::ModelicaClasses OMCProxy::getClassRestriction(QString className)
 {
-  QString result = mpOMCInterface->getClassRestriction(className);
+  sendCommand("getClassRestriction(" + className + ")", true, className);
+  QString result = getResult();
 
   if (result.toLower().contains("model"))
     return StringHandler::Model;
@@ -1002,7 +1586,8 @@ StringHandler::ModelicaClasses OMCProxy::getClassRestriction(QString className)
   */
 QString OMCProxy::getParameterValue(QString className, QString parameter)
 {
-  return mpOMCInterface->getParameterValue(className, parameter);
+  sendCommand("getParameterValue(" + className + ", " + quoteString(parameter) + ")");
+  return StringHandler::unparse(getResult());
 }
 
 /*!
@@ -1013,7 +1598,8 @@ QString OMCProxy::getParameterValue(QString className, QString parameter)
   */
 QStringList OMCProxy::getComponentModifierNames(QString className, QString name)
 {
-  return mpOMCInterface->getComponentModifierNames(className, name);
+  sendCommand("getComponentModifierNames(" + className + ", " + quoteString(name) + ")");
+  return StringHandler::unparseStrings(getResult());
 }
 
 /*!
@@ -1053,6 +1639,7 @@ bool OMCProxy::setComponentModifierValue(QString className, QString modifierName
 QStringList OMCProxy::getExtendsModifierNames(QString className, QString extendsClassName)
 {
   sendCommand("getExtendsModifierNames(" + className + "," + extendsClassName + ", useQuotes = true)", true, className);
+  addClassDependency(className, extendsClassName);
   return StringHandler::unparseStrings(getResult());
 }
 
@@ -1066,6 +1653,7 @@ QStringList OMCProxy::getExtendsModifierNames(QString className, QString extends
 QString OMCProxy::getExtendsModifierValue(QString className, QString extendsClassName, QString modifierName)
 {
   sendCommand("getExtendsModifierValue(" + className + "," + extendsClassName + "," + modifierName + ")", true, className);
+  addClassDependency(className, extendsClassName);
   return StringHandler::getModifierValue(getResult()).trimmed();
 }
 
@@ -1094,7 +1682,9 @@ bool OMCProxy::setExtendsModifierValue(QString className, QString extendsClassNa
 bool OMCProxy::isExtendsModifierFinal(QString className, QString extendsClassName, QString modifierName)
 {
   sendCommand("isExtendsModifierFinal(" + className + "," + extendsClassName + "," + modifierName + ")", true, className);
-  return StringHandler::unparseBool(getResult());
+  bool result = StringHandler::unparseBool(getResult());
+  addClassDependency(className, extendsClassName);
+  return result;
 }
 
 /*!
@@ -1203,7 +1793,9 @@ QString OMCProxy::getNthInheritedClass(QString className, int num)
 {
   QString expression = "getNthInheritedClass(" + className + ", " + QString::number(num) + ")";
   sendCommand(expression, true, className);
-  return getResult();
+  QString result = getResult();
+  addClassDependency(className, result);
+  return result;
 }
 
 /*!
@@ -1224,7 +1816,9 @@ QList<ComponentInfo*> OMCProxy::getComponents(QString className)
   {
     if (list.at(i) == "Error")
       continue;
-    componentInfoList.append(new ComponentInfo(list.at(i)));
+    ComponentInfo *pComponentInfo = new ComponentInfo(list.at(i));
+    addClassDependency(className, pComponentInfo->getClassName());
+    componentInfoList.append(pComponentInfo);
   }
 
   return componentInfoList;
@@ -1250,7 +1844,8 @@ QStringList OMCProxy::getComponentAnnotations(QString className)
   */
 QString OMCProxy::getDocumentationAnnotation(QString className)
 {
-  QList<QString> docsList = mpOMCInterface->getDocumentationAnnotation(className);
+  sendCommand("getDocumentationAnnotation(" + className + ")");
+  QList<QString> docsList = StringHandler::unparseStrings(getResult());
   // get the class comment and show it as the first line on the documentation page.
   QString doc = getClassComment(className);
   if (!doc.isEmpty()) doc.prepend("<h4>").append("</h4>");
@@ -1307,7 +1902,8 @@ QString OMCProxy::getDocumentationAnnotation(QString className)
   */
 QString OMCProxy::getClassComment(QString className)
 {
-  return mpOMCInterface->getClassComment(className);
+  sendCommand("getClassComment(" + className + ")");
+  return StringHandler::unparse(getResult());
 }
 
 /*!
@@ -1317,7 +1913,8 @@ QString OMCProxy::getClassComment(QString className)
   */
 QString OMCProxy::changeDirectory(QString directory)
 {
-  return mpOMCInterface->cd(directory);
+  sendCommand("cd(" + quoteString(directory) + ")");
+  return StringHandler::unparse(getResult());
 }
 
 /*!
@@ -1328,10 +1925,10 @@ QString OMCProxy::changeDirectory(QString directory)
   */
 bool OMCProxy::loadModel(QString className, QString priorityVersion, bool notify, QString languageStandard, bool requireExactVersion)
 {
-  bool result = false;
-  QList<QString> priorityVersionList;
-  priorityVersionList << priorityVersion;
-  result = mpOMCInterface->loadModel(className, priorityVersionList, notify, languageStandard, requireExactVersion);
+  sendCommand("loadModel(" + className + ", {" + quoteString(priorityVersion) + "}, " + QString(notify ? "true" : "false") + ", " +
+              quoteString(languageStandard) + ", " + QString(requireExactVersion ? "true" : "false") + ")");
+  bool result = StringHandler::unparseBool(getResult());
+  mNonExistingClasses.clear();
   printMessagesStringInternal();
   return result;
 }
@@ -1343,9 +1940,10 @@ bool OMCProxy::loadModel(QString className, QString priorityVersion, bool notify
   */
 bool OMCProxy::loadFile(QString fileName, QString encoding, bool uses)
 {
-  bool result = false;
   fileName = fileName.replace('\\', '/');
-  result = mpOMCInterface->loadFile(fileName, encoding, uses);
+  sendCommand("loadFile(" + quoteString(fileName) + ", " + quoteString(encoding) + ", " + QString(uses ? "true" : "false") + ")");
+  bool result = StringHandler::unparseBool(getResult());
+  mNonExistingClasses.clear();
   printMessagesStringInternal();
   return result;
 }
@@ -1357,8 +1955,9 @@ bool OMCProxy::loadFile(QString fileName, QString encoding, bool uses)
   */
 bool OMCProxy::loadString(QString value, QString fileName, QString encoding, bool checkError)
 {
-  bool result = false;
-  result = mpOMCInterface->loadString(value, fileName, encoding);
+  sendCommand("loadString(" + quoteString(value) + ", " + quoteString(fileName) + ", " + quoteString(encoding) + ")");
+  bool result = StringHandler::unparseBool(getResult());
+  mNonExistingClasses.clear();
   if (checkError) {
     printMessagesStringInternal();
   }
@@ -1372,9 +1971,9 @@ bool OMCProxy::loadString(QString value, QString fileName, QString encoding, boo
   */
 QList<QString> OMCProxy::parseFile(QString fileName, QString encoding)
 {
-  QList<QString> result;
   fileName = fileName.replace('\\', '/');
-  result = mpOMCInterface->parseFile(fileName, encoding);
+  sendCommand("parseFile(" + quoteString(fileName) + ", " + quoteString(encoding) + ")");
+  QList<QString> result = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
   if (result.isEmpty()) {
     printMessagesStringInternal();
   }
@@ -1388,8 +1987,8 @@ QList<QString> OMCProxy::parseFile(QString fileName, QString encoding)
   */
 QList<QString> OMCProxy::parseString(QString value, QString fileName)
 {
-  QList<QString> result;
-  result = mpOMCInterface->parseString(value, fileName);
+  sendCommand("parseString(" + quoteString(value) + ", " + quoteString(fileName) + ")");
+  QList<QString> result = StringHandler::getStrings(StringHandler::removeFirstLastCurlBrackets(getResult()));
   printMessagesStringInternal();
   return result;
 }
@@ -1436,12 +2035,42 @@ bool OMCProxy::createSubClass(QString type, QString className, QString parentCla
   */
 bool OMCProxy::existClass(QString className)
 {
-  sendCommand("existClass(" + className + ")");
+  QString expression = "existClass(" + className + ")";
+  /* the missing classes are forgotten when classes are loaded and the existing classes are removed when they are deleted. */
+  if (mNonExistingClasses.contains(className)) {
+    return false;
+  }
+  if (!getcachedOMCCommand(className, expression).mOMCCommandResult.isEmpty()) {
+    return true;
+  }
+  sendCommand(expression);
   bool result = StringHandler::unparseBool(getResult());
   getErrorString();
+  if (result) {
+    cacheOMCCommand(className, expression, getResult());
+  } else {
+    mNonExistingClasses.insert(className);
+  }
   return result;
 }
 
+/*!
+ * \brief OMCProxy::removeCachedExistClass
+ * Removes the cached existClass results of the class and of its nested classes.
+ * \param className
+ */
+void OMCProxy::removeCachedExistClass(QString className)
+{
+  QString nestedClassPrefix = className + ".";
+  foreach (QString name, mCachedOMCCommandsKeysHash.keys()) {
+    if (name.compare(className) == 0 || name.startsWith(nestedClassPrefix)) {
+      QString key = cachedOMCCommandKey(name, "existClass(" + name + ")");
+      mCachedOMCCommandsCache.remove(key);
+      removeCachedOMCCommandKey(name, key);
+    }
+  }
+}
+
 /*!
   Renames a class.
   \param oldName - the class old name.
@@ -1451,6 +2080,8 @@ bool OMCProxy::existClass(QString className)
 bool OMCProxy::renameClass(QString oldName, QString newName)
 {
   sendCommand("renameClass(" + oldName + ", " + newName + ")");
+  removeCachedExistClass(oldName);
+  mNonExistingClasses.clear();
   if (StringHandler::unparseBool(getResult()))
     return false;
   else
@@ -1465,6 +2096,7 @@ bool OMCProxy::renameClass(QString oldName, QString newName)
 bool OMCProxy::deleteClass(QString className)
 {
   sendCommand("deleteClass(" + className + ")");
+  removeCachedExistClass(className);
   if (StringHandler::unparseBool(getResult()))
     return true;
   else
@@ -1839,6 +2471,19 @@ bool OMCProxy::translateModel(QString className, QString simualtionParameters)
   return res;
 }
 
+/*!
+ * \brief OMCProxy::translateModelAsync
+ * Queues the translateModel command for the OMC command thread.
+ * The result is reported with the asyncCommandFinished() signal.
+ * \param className - the name of the class.
+ * \param simualtionParameters - the simulation parameters.
+ * \return the request id of the command.
+ */
+int OMCProxy::translateModelAsync(QString className, QString simualtionParameters)
+{
+  return sendCommandAsync("translateModel(" + className + "," + simualtionParameters + ")");
+}
+
 /*!
   Reads the simulation result variables from the result file.
   \param fileName - the result file name
@@ -1956,7 +2601,9 @@ bool OMCProxy::translateModelFMU(QString className, double version, QString file
 {
   bool result = false;
   fileNamePrefix = fileNamePrefix.isEmpty() ? "<default>" : fileNamePrefix;
-  QString res = mpOMCInterface->translateModelFMU(className, QString::number(version), "me", fileNamePrefix);
+  sendCommand("translateModelFMU(" + className + ", " + quoteString(QString::number(version)) + ", \"me\", " +
+              quoteString(fileNamePrefix) + ")");
+  QString res = StringHandler::unparse(getResult());
   if (res.compare("SimCode: The model " + className + " has been translated to FMU") == 0) {
     result = true;
     mpMainWindow->getLibraryTreeWidget()->loadDependentLibraries(getClassNames());
@@ -2130,6 +2777,27 @@ bool OMCProxy::clearCommandLineOptions()
   }
 }
 
+/*!
+ * \brief OMCProxy::getCommandLineOptions
+ * Returns the OMC flags that differ from their default values.
+ * \return the list of flags e.g. +d=initialization
+ */
+QStringList OMCProxy::getCommandLineOptions()
+{
+  sendCommand("getCommandLineOptions()");
+  return StringHandler::unparseStrings(getResult());
+}
+
+/*!
+ * \brief OMCProxy::getAnnotationVersion
+ * \return the Modelica annotation version used by OMC e.g. 3.x
+ */
+QString OMCProxy::getAnnotationVersion()
+{
+  sendCommand("getAnnotationVersion()");
+  return StringHandler::unparse(getResult());
+}
+
 /*!
   Helper function for getDocumentationAnnotation. Takes the documentation html and replaces the modelica links with absolute pahts.\n
   This function also makes the html valid. e.g html like,\n
@@ -2171,12 +2839,17 @@ QString OMCProxy::makeDocumentationUriToFileName(QString documentation)
 
 /*!
   Takes the Modelica file link as modelica://Modelica/Resources/Images/ABC.png and returns the absolute path for it.
+  The result is cached for the top level class of the link so it is resolved again only when that class is unloaded or changed.
   \param uri - the modelica link of the file
   \return absolute path
   */
 QString OMCProxy::uriToFilename(QString uri)
 {
-  sendCommand("uriToFilename(\"" + uri + "\")");
+  QString className;
+  if (uri.startsWith("modelica://", Qt::CaseInsensitive)) {
+    className = StringHandler::getFirstWordBeforeDot(uri.mid(QString("modelica://").length()).section('/', 0, 0));
+  }
+  sendCommand("uriToFilename(\"" + uri + "\")", !className.isEmpty(), className);
   QString result = StringHandler::removeFirstLastBrackets(getResult());
   result = result.prepend("{").append("}");
   QStringList results = StringHandler::unparseStrings(result);
@@ -2225,7 +2898,9 @@ QStringList OMCProxy::getAvailableLibraries()
 QString OMCProxy::getDerivedClassModifierValue(QString className, QString modifierName)
 {
   sendCommand("getDerivedClassModifierValue(" + className + "," + modifierName + ")", true, className);
-  return StringHandler::getModifierValue(StringHandler::unparse(getResult()));
+  QString modifierValue = StringHandler::getModifierValue(StringHandler::unparse(getResult()));
+  addInheritedClassesDependencies(className);
+  return modifierValue;
 }
 
 /*!
@@ -2280,8 +2955,9 @@ bool OMCProxy::setDebugFlags(QString debugFlags)
 
 bool OMCProxy::exportToFigaro(QString className, QString directory, QString database, QString mode, QString options, QString processor)
 {
-  bool result = false;
-  result = mpOMCInterface->exportToFigaro(className, directory, database, mode, options, processor);
+  sendCommand("exportToFigaro(" + className + ", " + quoteString(directory) + ", " + quoteString(database) + ", " +
+              quoteString(mode) + ", " + quoteString(options) + ", " + quoteString(processor) + ")");
+  bool result = StringHandler::unparseBool(getResult());
   if (!result) {
     printMessagesStringInternal();
   }
@@ -2303,6 +2979,7 @@ bool OMCProxy::copyClass(QString className, QString newClassName, QString withIn
     expression = "copyClass(" + className + ",\"" + newClassName + "\"," + withIn + ")";
   }
   sendCommand(expression);
+  mNonExistingClasses.clear();
   bool result = StringHandler::unparseBool(getResult());
   if (!result) printMessagesStringInternal();
   return result;
@@ -2318,6 +2995,7 @@ QStringList OMCProxy::getEnumerationLiterals(QString className)
   sendCommand("getEnumerationLiterals(" + className + ")", true, className);
   QStringList enumerationLiterals = StringHandler::unparseStrings(getResult());
   printMessagesStringInternal();
+  addInheritedClassesDependencies(className);
   return enumerationLiterals;
 }
 
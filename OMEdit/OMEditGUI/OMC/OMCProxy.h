@@ -44,12 +44,15 @@
 #include "Component.h"
 #include "StringHandler.h"
 #include "Utilities.h"
+#include "OMCCommandThread.h"
 
 class MainWindow;
 class CustomExpressionBox;
 class ComponentInfo;
 class StringHandler;
 class OMCInterface;
+class ComponentClassCache;
+class BitmapImageCache;
 
 struct cachedOMCCommand
 {
@@ -57,6 +60,14 @@ struct cachedOMCCommand
   QString mOMCCommandResult;
 };
 
+struct batchedClassInformation
+{
+  OMCInterface::getClassInformation_res mClassInformation;
+  bool mIsDocumentationClass;
+  bool mIsProtected;
+  QString mIconAnnotation;
+};
+
 class OMCProxy : public QObject
 {
   Q_OBJECT
@@ -77,8 +88,23 @@ private:
   QTextStream mCommandsLogFileTextStream;
   MainWindow *mpMainWindow;
   int mAnnotationVersion;
-  QMap<QString, QList<cachedOMCCommand> > mCachedOMCCommandsMap;
+  QCache<QString, QString> mCachedOMCCommandsCache;
+  QHash<QString, QSet<QString> > mCachedOMCCommandsKeysHash;
+  QHash<QString, QSet<QString> > mDependentClassesHash;
+  int mCachedOMCCommandsHits;
+  int mCachedOMCCommandsMisses;
+  int mCachedOMCCommandsKeysCount;
+  void removeCachedOMCCommandKey(QString className, QString key);
+  void pruneCachedOMCCommandsKeys();
+  QSet<QString> mNonExistingClasses;
+  void removeCachedExistClass(QString className);
   OMCInterface *mpOMCInterface;
+  OMCCommandThread *mpOMCCommandThread;
+  OMCCommandThread *mpOMCBackgroundCommandThread;
+  QHash<int, QTime> mAsyncCommandsTimeHash;
+  void finishAsyncCommand(int requestId, OMCCommandResult commandResult);
+  ComponentClassCache *mpComponentClassCache;
+  BitmapImageCache *mpBitmapImageCache;
 public:
   OMCProxy(MainWindow *pMainWindow);
   ~OMCProxy();
@@ -88,15 +114,27 @@ public:
   cachedOMCCommand getcachedOMCCommand(QString className, QString command);
   void cacheOMCCommand(QString className, QString command, QString commandResult);
   void removeCachedOMCCommand(QString className);
+  void addClassDependency(QString className, QString usedClassName);
+  void addInheritedClassesDependencies(QString className);
+  QString getCachedOMCCommandsStatistics();
+  ComponentClassCache* getComponentClassCache() {return mpComponentClassCache;}
+  BitmapImageCache* getBitmapImageCache() {return mpBitmapImageCache;}
   bool initializeOMC();
   void quitOMC();
   void sendCommand(const QString expression, bool cacheCommand = false, QString className = QString(), bool dontUseCachedCommand = false);
+  QStringList sendBatchedCommands(QStringList commands);
+  void prefetchDiagram(QString className);
+  int sendCommandAsync(const QString expression);
+  bool isAsyncCommandRunning(int requestId);
+  bool cancelAsyncCommand(int requestId);
+  QString waitForAsyncCommand(int requestId);
   void setResult(QString value);
   QString getResult();
   void exitApplication();
   void removeObjectRefFile();
   QString getErrorString(bool warningsAsErrors = false);
   bool printMessagesStringInternal();
+  void printErrorString(QString errorString, QString errorKind);
   int getMessagesStringInternal();
   void setCurrentError(int errorIndex);
   QString getErrorFileName();
@@ -115,6 +153,7 @@ public:
                             bool sort = false, bool builtin = false, bool showProtected = "true");
   QStringList searchClassNames(QString searchText, bool findInText = "false");
   OMCInterface::getClassInformation_res getClassInformation(QString className);
+  QList<batchedClassInformation> getClassesInformation(QStringList classNames, bool protectedStatus = false, bool iconAnnotation = false);
   bool isPackage(QString className);
   bool isBuiltinType(QString typeName);
   QString getBuiltinType(QString typeName);
@@ -179,6 +218,7 @@ public:
   bool simulate(QString className, QString simualtionParameters);
   bool buildModel(QString className, QString simualtionParameters);
   bool translateModel(QString className, QString simualtionParameters);
+  int translateModelAsync(QString className, QString simualtionParameters);
   QStringList readSimulationResultVars(QString fileName);
   bool closeSimulationResultFile();
   QString checkModel(QString className);
@@ -197,6 +237,8 @@ public:
   bool setIndexReductionMethod(QString method);
   bool setCommandLineOptions(QString options);
   bool clearCommandLineOptions();
+  QStringList getCommandLineOptions();
+  QString getAnnotationVersion();
   QString makeDocumentationUriToFileName(QString documentation);
   QString uriToFilename(QString uri);
   QString getModelicaPath();
@@ -216,12 +258,17 @@ public:
   void getNonLinearSolvers(QStringList *methods, QStringList *descriptions);
 signals:
   void commandFinished();
+  void asyncCommandStarted(int requestId);
+  void asyncCommandFinished(int requestId, QString result, QString errorString);
 public slots:
   void logCommand(QString command, QTime *commandTime);
   void logResponse(QString response, QTime *responseTime);
   void showException(QString exception);
   void openOMCLoggerWidget();
   void sendCustomExpression();
+private slots:
+  void handleAsyncCommandFinished(int requestId);
+  void plot(QStringList plotArguments);
 };
 
 class CustomExpressionBox : public QLineEdit
@@ -92,11 +92,15 @@ SOURCES += main.cpp \
   Util/Helper.cpp \
   Util/Utilities.cpp \
   Util/StringHandler.cpp \
+  Util/AnnotationTree.cpp \
   MainWindow.cpp \
   $$OPENMODELICAHOME/include/omc/scripting-API/OpenModelicaScriptingAPIQt.cpp \
   OMC/OMCProxy.cpp \
+  OMC/OMCCommandThread.cpp \
   Modeling/MessagesWidget.cpp \
   Modeling/LibraryTreeWidget.cpp \
+  Modeling/LibraryTreeCache.cpp \
+  Modeling/LibraryIconCache.cpp \
   Modeling/ModelWidgetContainer.cpp \
   Modeling/ModelicaClassDialog.cpp \
   Options/OptionsDialog.cpp \
@@ -109,6 +113,7 @@ SOURCES += main.cpp \
   Editors/TLMEditor.cpp \
   Plotting/PlotWindowContainer.cpp \
   Component/Component.cpp \
+  Component/ComponentClass.cpp \
   Annotations/ShapeAnnotation.cpp \
   Component/CornerItem.cpp \
   Annotations/LineAnnotation.cpp \
@@ -117,13 +122,17 @@ SOURCES += main.cpp \
   Annotations/EllipseAnnotation.cpp \
   Annotations/TextAnnotation.cpp \
   Annotations/BitmapAnnotation.cpp \
+  Annotations/BitmapImageCache.cpp \
   Component/ComponentProperties.cpp \
   Component/Transformation.cpp \
   Modeling/DocumentationWidget.cpp \
   Simulation/SimulationDialog.cpp \
   Simulation/SimulationOutputWidget.cpp \
   Simulation/SimulationProcessThread.cpp \
+  Simulation/SimulationJobScheduler.cpp \
+  Simulation/ParameterSweepDialog.cpp \
   Simulation/SimulationOutputHandler.cpp \
+  Simulation/SimulationMessageLog.cpp \
   TLM/FetchInterfaceDataDialog.cpp \
   TLM/FetchInterfaceDataThread.cpp \
   TLM/TLMCoSimulationDialog.cpp \
@@ -131,6 +140,8 @@ SOURCES += main.cpp \
   TLM/TLMCoSimulationThread.cpp \
   FMI/ImportFMUDialog.cpp \
   Plotting/VariablesWidget.cpp \
+  Plotting/MatResultFile.cpp \
+  Plotting/PlotCurveDecimator.cpp \
   Options/NotificationsDialog.cpp \
   Annotations/ShapePropertiesDialog.cpp \
   TransformationalDebugger/OMDumpXML.cpp \
@@ -155,11 +166,15 @@ SOURCES += main.cpp \
 HEADERS  += Util/Helper.h \
   Util/Utilities.h \
   Util/StringHandler.h \
+  Util/AnnotationTree.h \
   MainWindow.h \
   $$OPENMODELICAHOME/include/omc/scripting-API/OpenModelicaScriptingAPIQt.h \
   OMC/OMCProxy.h \
+  OMC/OMCCommandThread.h \
   Modeling/MessagesWidget.h \
   Modeling/LibraryTreeWidget.h \
+  Modeling/LibraryTreeCache.h \
+  Modeling/LibraryIconCache.h \
   Modeling/ModelWidgetContainer.h \
   Modeling/ModelicaClassDialog.h \
   Options/OptionsDialog.h \
@@ -172,6 +187,7 @@ HEADERS  += Util/Helper.h \
   Editors/TLMEditor.h \
   Plotting/PlotWindowContainer.h \
   Component/Component.h \
+  Component/ComponentClass.h \
   Annotations/ShapeAnnotation.h \
   Component/CornerItem.h \
   Annotations/LineAnnotation.h \
@@ -180,6 +196,7 @@ HEADERS  += Util/Helper.h \
   Annotations/EllipseAnnotation.h \
   Annotations/TextAnnotation.h \
   Annotations/BitmapAnnotation.h \
+  Annotations/BitmapImageCache.h \
   Component/ComponentProperties.h \
   Component/Transformation.h \
   Modeling/DocumentationWidget.h \
@@ -187,7 +204,10 @@ HEADERS  += Util/Helper.h \
   Simulation/SimulationDialog.h \
   Simulation/SimulationOutputWidget.h \
   Simulation/SimulationProcessThread.h \
+  Simulation/SimulationJobScheduler.h \
+  Simulation/ParameterSweepDialog.h \
   Simulation/SimulationOutputHandler.h \
+  Simulation/SimulationMessageLog.h \
   TLM/FetchInterfaceDataDialog.h \
   TLM/FetchInterfaceDataThread.h \
   TLM/TLMCoSimulationOptions.h \
@@ -196,6 +216,8 @@ HEADERS  += Util/Helper.h \
   TLM/TLMCoSimulationThread.h \
   FMI/ImportFMUDialog.h \
   Plotting/VariablesWidget.h \
+  Plotting/MatResultFile.h \
+  Plotting/PlotCurveDecimator.h \
   Options/NotificationsDialog.h \
   Annotations/ShapePropertiesDialog.h \
   TransformationalDebugger/OMDumpXML.cpp \
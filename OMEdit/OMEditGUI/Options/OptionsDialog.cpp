@@ -37,6 +37,7 @@
  */
 
 #include "OptionsDialog.h"
+#include "LibraryTreeCache.h"
 #include <limits>
 
 //! @class OptionsDialog
@@ -288,6 +289,8 @@ void OptionsDialog::readGraphicalViewsSettings()
     mpGraphicalViewsPage->setDiagramViewScaleFactor(mpSettings->value("DiagramView/scaleFactor").toDouble());
   if (mpSettings->contains("DiagramView/preserveAspectRatio"))
     mpGraphicalViewsPage->setDiagramViewPreserveAspectRation(mpSettings->value("DiagramView/preserveAspectRatio").toBool());
+  if (mpSettings->contains("graphicalViews/optimizeRendering"))
+    mpGraphicalViewsPage->setOptimizeRendering(mpSettings->value("graphicalViews/optimizeRendering").toBool());
 }
 
 //! Reads the Simulation section settings from omedit.ini
@@ -311,6 +314,9 @@ void OptionsDialog::readSimulationSettings()
   if (mpSettings->contains("simulation/saveClassBeforeSimulation")) {
     mpSimulationPage->getSaveClassBeforeSimulationCheckBox()->setChecked(mpSettings->value("simulation/saveClassBeforeSimulation").toBool());
   }
+  if (mpSettings->contains("simulation/simulationJobsProcessors")) {
+    mpSimulationPage->getSimulationJobsProcessorsSpinBox()->setValue(mpSettings->value("simulation/simulationJobsProcessors").toInt());
+  }
   if (mpSettings->contains("simulation/outputMode")) {
     mpSimulationPage->setOutputMode(mpSettings->value("simulation/outputMode").toString());
   }
@@ -705,6 +711,15 @@ void OptionsDialog::saveGraphicalViewsSettings()
   mpSettings->setValue("DiagramView/gridVertical", mpGraphicalViewsPage->getDiagramViewGridVertical());
   mpSettings->setValue("DiagramView/scaleFactor", mpGraphicalViewsPage->getDiagramViewScaleFactor());
   mpSettings->setValue("DiagramView/preserveAspectRatio", mpGraphicalViewsPage->getDiagramViewPreserveAspectRation());
+  mpSettings->setValue("graphicalViews/optimizeRendering", mpGraphicalViewsPage->getOptimizeRendering());
+  // apply the rendering mode to the opened models
+  foreach (QMdiSubWindow *pSubWindow, mpMainWindow->getModelWidgetContainer()->subWindowList()) {
+    ModelWidget *pModelWidget = qobject_cast<ModelWidget*>(pSubWindow->widget());
+    if (pModelWidget && pModelWidget->getIconGraphicsView() && pModelWidget->getDiagramGraphicsView()) {
+      pModelWidget->getIconGraphicsView()->setOptimizeRendering(mpGraphicalViewsPage->getOptimizeRendering());
+      pModelWidget->getDiagramGraphicsView()->setOptimizeRendering(mpGraphicalViewsPage->getOptimizeRendering());
+    }
+  }
 }
 
 //! Saves the Simulation section settings to omedit.ini
@@ -720,6 +735,7 @@ void OptionsDialog::saveSimulationSettings()
   else
     mpSimulationPage->getOMCFlagsTextBox()->setText(mpSettings->value("simulation/OMCFlags").toString());
   mpSettings->setValue("simulation/saveClassBeforeSimulation", mpSimulationPage->getSaveClassBeforeSimulationCheckBox()->isChecked());
+  mpSettings->setValue("simulation/simulationJobsProcessors", mpSimulationPage->getSimulationJobsProcessorsSpinBox()->value());
   mpSettings->setValue("simulation/outputMode", mpSimulationPage->getOutputMode());
 }
 
@@ -1074,6 +1090,8 @@ void OptionsDialog::saveSettings()
   savePlottingSettings();
   saveFigaroSettings();
   saveDebuggerSettings();
+  // the OMC flags are part of the library tree cache key.
+  mpMainWindow->getLibraryTreeCache()->updateOMCSettings();
   saveFMISettings();
   saveTLMSettings();
   saveTLMEditorSettings();
@@ -2279,11 +2297,16 @@ GraphicalViewsPage::GraphicalViewsPage(OptionsDialog *pOptionsDialog)
   mpDiagramViewWidget->setLayout(pDiagramViewMainLayout);
   // add Diagram View Widget as a tab
   mpGraphicalViewsTabWidget->addTab(mpDiagramViewWidget, tr("Diagram View"));
+  // optimize rendering
+  mpOptimizeRenderingCheckBox = new QCheckBox(tr("Optimize rendering of large diagrams"));
+  mpOptimizeRenderingCheckBox->setToolTip(tr("Repaints only the changed parts of the views, caches the component icons and hides the details that are too small to be seen."));
+  mpOptimizeRenderingCheckBox->setChecked(true);
   // set Main Layout
-  QHBoxLayout *pHBoxLayout = new QHBoxLayout;
-  pHBoxLayout->setContentsMargins(0, 0, 0, 0);
-  pHBoxLayout->addWidget(mpGraphicalViewsTabWidget);
-  setLayout(pHBoxLayout);
+  QVBoxLayout *pVBoxLayout = new QVBoxLayout;
+  pVBoxLayout->setContentsMargins(0, 0, 0, 0);
+  pVBoxLayout->addWidget(mpGraphicalViewsTabWidget);
+  pVBoxLayout->addWidget(mpOptimizeRenderingCheckBox);
+  setLayout(pVBoxLayout);
 }
 
 void GraphicalViewsPage::setIconViewExtentLeft(double extentLeft)
@@ -2446,6 +2469,16 @@ bool GraphicalViewsPage::getDiagramViewPreserveAspectRation()
   return mpDiagramViewPreserveAspectRatioCheckBox->isChecked();
 }
 
+void GraphicalViewsPage::setOptimizeRendering(bool optimize)
+{
+  mpOptimizeRenderingCheckBox->setChecked(optimize);
+}
+
+bool GraphicalViewsPage::getOptimizeRendering()
+{
+  return mpOptimizeRenderingCheckBox->isChecked();
+}
+
 //! @class SimulationPage
 //! @brief Creates an interface for simulation settings.
 
@@ -2490,6 +2523,13 @@ SimulationPage::SimulationPage(OptionsDialog *pOptionsDialog)
   mpSaveClassBeforeSimulationCheckBox = new QCheckBox(tr("Save class before simulation"));
   mpSaveClassBeforeSimulationCheckBox->setToolTip(tr("Disabling this will effect the debugger functionality."));
   mpSaveClassBeforeSimulationCheckBox->setChecked(true);
+  // simulation jobs processors
+  mpSimulationJobsProcessorsLabel = new Label(tr("Processors for simulation jobs:"));
+  mpSimulationJobsProcessorsLabel->setToolTip(tr("The number of processors shared by all the running compilations and simulations."));
+  mpSimulationJobsProcessorsSpinBox = new QSpinBox;
+  mpSimulationJobsProcessorsSpinBox->setMinimum(1);
+  mpSimulationJobsProcessorsSpinBox->setMaximum(1024);
+  mpSimulationJobsProcessorsSpinBox->setValue(mpOptionsDialog->getMainWindow()->getOMCProxy()->numProcessors().toInt());
   // simulation output format
   mpOutputGroupBox = new QGroupBox(Helper::output);
   mpStructuredRadioButton = new QRadioButton(tr("Structured"));
@@ -2519,7 +2559,9 @@ SimulationPage::SimulationPage(OptionsDialog *pOptionsDialog)
   pSimulationLayout->addWidget(mpOMCFlagsLabel, 2, 0);
   pSimulationLayout->addWidget(mpOMCFlagsTextBox, 2, 1);
   pSimulationLayout->addWidget(mpSaveClassBeforeSimulationCheckBox, 3, 0, 1, 2);
-  pSimulationLayout->addWidget(mpOutputGroupBox, 4, 0, 1, 2);
+  pSimulationLayout->addWidget(mpSimulationJobsProcessorsLabel, 4, 0);
+  pSimulationLayout->addWidget(mpSimulationJobsProcessorsSpinBox, 4, 1);
+  pSimulationLayout->addWidget(mpOutputGroupBox, 5, 0, 1, 2);
   mpSimulationGroupBox->setLayout(pSimulationLayout);
   // set the layout
   QVBoxLayout *pLayout = new QVBoxLayout;
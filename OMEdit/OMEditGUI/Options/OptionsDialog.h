@@ -397,6 +397,8 @@ public:
   double getDiagramViewScaleFactor();
   void setDiagramViewPreserveAspectRation(bool preserveAspectRation);
   bool getDiagramViewPreserveAspectRation();
+  void setOptimizeRendering(bool optimize);
+  bool getOptimizeRendering();
 private:
   OptionsDialog *mpOptionsDialog;
   QTabWidget *mpGraphicalViewsTabWidget;
@@ -438,6 +440,7 @@ private:
   Label *mpDiagramViewScaleFactorLabel;
   DoubleSpinBox *mpDiagramViewScaleFactorSpinBox;
   QCheckBox *mpDiagramViewPreserveAspectRatioCheckBox;
+  QCheckBox *mpOptimizeRenderingCheckBox;
 };
 
 class SimulationPage : public QWidget
@@ -449,6 +452,7 @@ public:
   QComboBox* getIndexReductionMethodComboBox();
   QLineEdit* getOMCFlagsTextBox();
   QCheckBox *getSaveClassBeforeSimulationCheckBox() {return mpSaveClassBeforeSimulationCheckBox;}
+  QSpinBox* getSimulationJobsProcessorsSpinBox() {return mpSimulationJobsProcessorsSpinBox;}
   void setOutputMode(QString value);
   QString getOutputMode();
 private:
@@ -461,6 +465,8 @@ private:
   Label *mpOMCFlagsLabel;
   QLineEdit *mpOMCFlagsTextBox;
   QCheckBox *mpSaveClassBeforeSimulationCheckBox;
+  Label *mpSimulationJobsProcessorsLabel;
+  QSpinBox *mpSimulationJobsProcessorsSpinBox;
   QGroupBox *mpOutputGroupBox;
   QRadioButton *mpStructuredRadioButton;
   QRadioButton *mpFormattedTextRadioButton;
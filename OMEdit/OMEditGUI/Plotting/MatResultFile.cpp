@@ -0,0 +1,545 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include "MatResultFile.h"
+
+/*!
+ * \class MatResultFile
+ * \brief Reads the MAT v4 result files.
+ * The file is memory mapped once and only the matrix headers, the variable names and the data info are read when it is opened.
+ * The descriptions are skipped. The trajectories are read from data_1 and data_2 when a variable is requested and the recently
+ * read trajectories are cached. If the file can't be mapped then it is read with QFile.\n
+ * The result file of a running simulation grows at the end of data_2. It is refreshed to read the new time points.
+ */
+/*!
+ * \brief MatResultFile::MatResultFile
+ * \param fileName - the absolute file path.
+ */
+MatResultFile::MatResultFile(QString fileName)
+  : mTrajectoriesCache(8 * 1024 * 1024)
+{
+  mFile.setFileName(fileName);
+  mpData = 0;
+  mTransposed = true;
+}
+
+MatResultFile::~MatResultFile()
+{
+  if (mpData) {
+    mFile.unmap(const_cast<uchar*>(mpData));
+  }
+  mFile.close();
+}
+
+/*!
+ * \brief MatResultFile::open
+ * Opens the file and reads the variables index.
+ * \param pErrorString - set when the file can't be read.
+ * \return
+ */
+bool MatResultFile::open(QString *pErrorString)
+{
+  if (!mFile.open(QIODevice::ReadOnly)) {
+    *pErrorString = mFile.errorString();
+    return false;
+  }
+  mLastModified = QFileInfo(mFile).lastModified();
+  mpData = mFile.map(0, mFile.size());
+  qint64 offset = 0;
+  MatMatrix aclass, names, descriptions, dataInfo;
+  if (!readMatrixHeader(&offset, &aclass, pErrorString) || !readMatrixHeader(&offset, &names, pErrorString)
+      || !readMatrixHeader(&offset, &descriptions, pErrorString) || !readMatrixHeader(&offset, &dataInfo, pErrorString)) {
+    mFile.close();
+    return false;
+  }
+  if (aclass.mRows < 4 || readString(aclass, 0, false).compare("Atrajectory") != 0) {
+    *pErrorString = QObject::tr("%1 is not a trajectory file.").arg(mFile.fileName());
+    mFile.close();
+    return false;
+  }
+  // the fourth row of Aclass is binTrans or binNormal.
+  mTransposed = readString(aclass, 3, false).compare("binNormal") != 0;
+  // the data sets may be missing if the simulation failed.
+  mData1.mRows = mData1.mColumns = 0;
+  mData2.mRows = mData2.mColumns = 0;
+  QString errorString;
+  if (readMatrixHeader(&offset, &mData1, &errorString)) {
+    readMatrixHeader(&offset, &mData2, &errorString);
+  }
+  // read the variables index.
+  int variablesCount = mTransposed ? names.mColumns : names.mRows;
+  mVariablesHash.reserve(variablesCount);
+  for (int i = 0 ; i < variablesCount ; i++) {
+    int dataSet = mTransposed ? readElement(dataInfo, 0, i) : readElement(dataInfo, i, 0);
+    int index = mTransposed ? readElement(dataInfo, 1, i) : readElement(dataInfo, i, 1);
+    mVariablesHash.insert(readString(names, i, mTransposed), qMakePair(dataSet, index));
+  }
+  return true;
+}
+
+/*!
+ * \brief MatResultFile::refresh
+ * Reads the number of the complete time points in the file again. The file is mapped again only when it has new time points.
+ * The variables index is kept.
+ * \param pErrorString - set when the file is written again.
+ * \return
+ */
+bool MatResultFile::refresh(QString *pErrorString)
+{
+  // only data_2 in binTrans format grows.
+  qint64 columnSize = (qint64)mData2.mRows * mData2.mElementSize;
+  if (!mTransposed || columnSize == 0) {
+    return true;
+  }
+  qint64 size = mFile.size();
+  if (mData2.mOffset + mData2.mColumns * columnSize > size) {
+    *pErrorString = QObject::tr("Unexpected end of file %1.").arg(mFile.fileName());
+    return false;
+  }
+  if ((size - mData2.mOffset) / columnSize == mData2.mColumns) {
+    return true;
+  }
+  if (mpData) {
+    mFile.unmap(const_cast<uchar*>(mpData));
+    mpData = 0;
+  }
+  // open the file again so no stale data is read from the file buffer if the file can't be mapped.
+  mFile.close();
+  if (!mFile.open(QIODevice::ReadOnly)) {
+    *pErrorString = mFile.errorString();
+    return false;
+  }
+  mLastModified = QFileInfo(mFile).lastModified();
+  size = mFile.size();
+  mpData = mFile.map(0, size);
+  mData2.mColumns = (size - mData2.mOffset) / columnSize;
+  mTrajectoriesCache.clear();
+  return true;
+}
+
+/*!
+ * \brief MatResultFile::getStartTime
+ * \return the first time point.
+ */
+double MatResultFile::getStartTime()
+{
+  return getTimePointsCount() > 0 ? readValue(mData2, 0, 0) : 0;
+}
+
+/*!
+ * \brief MatResultFile::getStopTime
+ * \return the last time point.
+ */
+double MatResultFile::getStopTime()
+{
+  int count = getTimePointsCount();
+  return count > 0 ? readValue(mData2, 0, count - 1) : 0;
+}
+
+/*!
+ * \brief MatResultFile::readFinalValue
+ * Reads the value of the variable at the stop time.
+ * \param variable
+ * \param pValue
+ * \return
+ */
+bool MatResultFile::readFinalValue(const QString &variable, double *pValue)
+{
+  QHash<QString, QPair<int, int> >::const_iterator iterator = mVariablesHash.constFind(variable);
+  if (iterator == mVariablesHash.constEnd() || iterator.value().second == 0) {
+    return false;
+  }
+  int column = qAbs(iterator.value().second) - 1;
+  double sign = iterator.value().second < 0 ? -1 : 1;
+  // data set 1 has the parameters, the other variables are in data set 2.
+  if (iterator.value().first == 1) {
+    if (column >= (mTransposed ? mData1.mRows : mData1.mColumns)) {
+      return false;
+    }
+    *pValue = sign * readValue(mData1, column, 0);
+  } else {
+    int count = getTimePointsCount();
+    if (count == 0 || column >= (mTransposed ? mData2.mRows : mData2.mColumns)) {
+      return false;
+    }
+    *pValue = sign * readValue(mData2, column, count - 1);
+  }
+  return true;
+}
+
+/*!
+ * \brief MatResultFile::readVariable
+ * Reads the trajectory of the variable at all the time points.
+ * \param variable
+ * \param pValues
+ * \return
+ */
+bool MatResultFile::readVariable(const QString &variable, QVector<double> *pValues)
+{
+  QHash<QString, QVector<double> > valuesHash;
+  readVariables(QStringList(variable), &valuesHash);
+  if (!valuesHash.contains(variable)) {
+    return false;
+  }
+  *pValues = valuesHash.value(variable);
+  return true;
+}
+
+/*!
+ * \brief MatResultFile::readVariables
+ * Reads the trajectories of the variables in one pass over data_2. The variables that are not in the file are skipped.
+ * \param variables
+ * \param pValuesHash - the trajectories of the variables.
+ * \param fromTimeIndex - the first time point to read. Only the complete trajectories are cached.
+ */
+void MatResultFile::readVariables(const QStringList &variables, QHash<QString, QVector<double> > *pValuesHash, int fromTimeIndex)
+{
+  int count = qMax(getTimePointsCount() - fromTimeIndex, 0);
+  QStringList data2Variables;
+  QList<int> data2Columns;
+  QList<double> data2Signs;
+  foreach (QString variable, variables) {
+    if (pValuesHash->contains(variable) || data2Variables.contains(variable)) {
+      continue;
+    }
+    QVector<double> *pCachedValues = fromTimeIndex == 0 ? mTrajectoriesCache.object(variable) : 0;
+    if (pCachedValues) {
+      pValuesHash->insert(variable, *pCachedValues);
+      continue;
+    }
+    QHash<QString, QPair<int, int> >::const_iterator iterator = mVariablesHash.constFind(variable);
+    if (iterator == mVariablesHash.constEnd() || iterator.value().second == 0) {
+      continue;
+    }
+    int column = qAbs(iterator.value().second) - 1;
+    double sign = iterator.value().second < 0 ? -1 : 1;
+    if (iterator.value().first == 1) {
+      if (column >= (mTransposed ? mData1.mRows : mData1.mColumns)) {
+        continue;
+      }
+      QVector<double> values(count);
+      values.fill(sign * readValue(mData1, column, 0));
+      pValuesHash->insert(variable, values);
+      if (fromTimeIndex == 0) {
+        mTrajectoriesCache.insert(variable, new QVector<double>(values), qMax(count, 1));
+      }
+    } else if (column < (mTransposed ? mData2.mRows : mData2.mColumns)) {
+      data2Variables.append(variable);
+      data2Columns.append(column);
+      data2Signs.append(sign);
+    }
+  }
+  if (data2Variables.isEmpty()) {
+    return;
+  }
+  QVector<QVector<double> > trajectories(data2Variables.size(), QVector<double>(count));
+  if (mTransposed) {
+    // binTrans stores the values of a time point together so read all the variables of a time point before moving to the next.
+    for (int i = 0 ; i < count ; i++) {
+      for (int j = 0 ; j < data2Variables.size() ; j++) {
+        trajectories[j][i] = data2Signs.at(j) * readValue(mData2, data2Columns.at(j), fromTimeIndex + i);
+      }
+    }
+  } else {
+    for (int j = 0 ; j < data2Variables.size() ; j++) {
+      for (int i = 0 ; i < count ; i++) {
+        trajectories[j][i] = data2Signs.at(j) * readValue(mData2, data2Columns.at(j), fromTimeIndex + i);
+      }
+    }
+  }
+  for (int j = 0 ; j < data2Variables.size() ; j++) {
+    pValuesHash->insert(data2Variables.at(j), trajectories.at(j));
+    if (fromTimeIndex == 0) {
+      mTrajectoriesCache.insert(data2Variables.at(j), new QVector<double>(trajectories.at(j)), qMax(count, 1));
+    }
+  }
+}
+
+/*!
+ * \brief MatResultFile::readMatrixHeader
+ * Reads the header of the matrix and moves the offset to the next matrix.
+ * \param pOffset
+ * \param pMatrix
+ * \param pErrorString
+ * \return
+ */
+bool MatResultFile::readMatrixHeader(qint64 *pOffset, MatMatrix *pMatrix, QString *pErrorString)
+{
+  qint32 header[5];
+  if (!readBytes(*pOffset, (char*)header, sizeof(header))) {
+    *pErrorString = QObject::tr("Unexpected end of file %1.").arg(mFile.fileName());
+    return false;
+  }
+  int type = header[0];
+  if (type < 0 || type >= 1000 || header[1] < 0 || header[2] < 0 || header[3] != 0 || header[4] < 0) {
+    *pErrorString = QObject::tr("%1 is not a little endian MAT v4 file.").arg(mFile.fileName());
+    return false;
+  }
+  pMatrix->mPrecision = (type % 100) / 10;
+  switch (pMatrix->mPrecision) {
+    case 0:
+      pMatrix->mElementSize = 8;
+      break;
+    case 1:
+    case 2:
+      pMatrix->mElementSize = 4;
+      break;
+    case 3:
+    case 4:
+      pMatrix->mElementSize = 2;
+      break;
+    case 5:
+      pMatrix->mElementSize = 1;
+      break;
+    default:
+      *pErrorString = QObject::tr("Unknown matrix type %1 in %2.").arg(type).arg(mFile.fileName());
+      return false;
+  }
+  pMatrix->mRows = header[1];
+  pMatrix->mColumns = header[2];
+  pMatrix->mOffset = *pOffset + sizeof(header) + header[4];
+  qint64 size = (qint64)pMatrix->mRows * pMatrix->mColumns * pMatrix->mElementSize;
+  qint64 columnSize = (qint64)pMatrix->mRows * pMatrix->mElementSize;
+  if (pMatrix == &mData2 && mTransposed && columnSize > 0 && pMatrix->mOffset <= mFile.size()) {
+    /* data_2 is the last matrix. The file of a running simulation has no final number of time points yet and the last time
+     * point may be incomplete so use the complete time points in the file.
+     */
+    pMatrix->mColumns = (mFile.size() - pMatrix->mOffset) / columnSize;
+    size = pMatrix->mColumns * columnSize;
+  } else if (pMatrix->mOffset + size > mFile.size()) {
+    *pErrorString = QObject::tr("Unexpected end of file %1.").arg(mFile.fileName());
+    return false;
+  }
+  *pOffset = pMatrix->mOffset + size;
+  return true;
+}
+
+/*!
+ * \brief MatResultFile::readBytes
+ * Reads from the mapped memory or from the file.
+ * \param offset
+ * \param pBuffer
+ * \param size
+ * \return
+ */
+bool MatResultFile::readBytes(qint64 offset, char *pBuffer, qint64 size)
+{
+  if (offset < 0 || offset + size > mFile.size()) {
+    return false;
+  }
+  if (mpData) {
+    memcpy(pBuffer, mpData + offset, size);
+    return true;
+  }
+  return mFile.seek(offset) && mFile.read(pBuffer, size) == size;
+}
+
+/*!
+ * \brief MatResultFile::readElement
+ * \param matrix
+ * \param row
+ * \param column
+ * \return the element of the column-major matrix.
+ */
+double MatResultFile::readElement(const MatMatrix &matrix, int row, int column)
+{
+  char buffer[8];
+  qint64 offset = matrix.mOffset + ((qint64)column * matrix.mRows + row) * matrix.mElementSize;
+  if (!readBytes(offset, buffer, matrix.mElementSize)) {
+    return 0;
+  }
+  switch (matrix.mPrecision) {
+    case 0: {
+      double value;
+      memcpy(&value, buffer, sizeof(value));
+      return value;
+    }
+    case 1: {
+      float value;
+      memcpy(&value, buffer, sizeof(value));
+      return value;
+    }
+    case 2: {
+      qint32 value;
+      memcpy(&value, buffer, sizeof(value));
+      return value;
+    }
+    case 3: {
+      qint16 value;
+      memcpy(&value, buffer, sizeof(value));
+      return value;
+    }
+    case 4: {
+      quint16 value;
+      memcpy(&value, buffer, sizeof(value));
+      return value;
+    }
+    default:
+      return (uchar)buffer[0];
+  }
+}
+
+/*!
+ * \brief MatResultFile::readString
+ * Reads a string from the text matrix.
+ * \param matrix
+ * \param index - the row or column of the string.
+ * \param transposed - if true then the strings are stored in the columns otherwise in the rows.
+ * \return
+ */
+QString MatResultFile::readString(const MatMatrix &matrix, int index, bool transposed)
+{
+  QByteArray string;
+  int length = transposed ? matrix.mRows : matrix.mColumns;
+  string.reserve(length);
+  for (int i = 0 ; i < length ; i++) {
+    char c = transposed ? readElement(matrix, i, index) : readElement(matrix, index, i);
+    if (c == '\0') {
+      break;
+    }
+    string.append(c);
+  }
+  return QString::fromLatin1(string).trimmed();
+}
+
+/*!
+ * \brief MatResultFile::readValue
+ * \param matrix - data_1 or data_2.
+ * \param variableIndex
+ * \param timeIndex
+ * \return the value of the variable at the time point.
+ */
+double MatResultFile::readValue(const MatMatrix &matrix, int variableIndex, int timeIndex)
+{
+  if (mTransposed) {
+    return readElement(matrix, variableIndex, timeIndex);
+  } else {
+    return readElement(matrix, timeIndex, variableIndex);
+  }
+}
+
+/*!
+ * \class MatResultFilesCache
+ * \brief Keeps the opened result files so the plots of a result file share one mapping and one variables index.
+ * A result file changed on disk is opened again.
+ */
+MatResultFilesCache::MatResultFilesCache()
+{
+}
+
+MatResultFilesCache::~MatResultFilesCache()
+{
+  qDeleteAll(mMatResultFilesHash);
+  qDeleteAll(mGrowingMatResultFilesHash);
+}
+
+/*!
+ * \brief MatResultFilesCache::getMatResultFile
+ * \param fileName
+ * \param pErrorString - set when the file can't be opened.
+ * \return the opened result file or 0.
+ */
+MatResultFile* MatResultFilesCache::getMatResultFile(QString fileName, QString *pErrorString)
+{
+  QFileInfo fileInfo(fileName);
+  QString filePath = fileInfo.absoluteFilePath();
+  MatResultFile *pMatResultFile = mMatResultFilesHash.value(filePath, 0);
+  if (pMatResultFile) {
+    if (fileInfo.lastModified() == pMatResultFile->getLastModified()) {
+      return pMatResultFile;
+    }
+    removeMatResultFile(filePath);
+  }
+  pMatResultFile = new MatResultFile(filePath);
+  if (!pMatResultFile->open(pErrorString)) {
+    delete pMatResultFile;
+    return 0;
+  }
+  mMatResultFilesHash.insert(filePath, pMatResultFile);
+  return pMatResultFile;
+}
+
+/*!
+ * \brief MatResultFilesCache::getGrowingMatResultFile
+ * Returns the result file of a running simulation. The file is opened once and then refreshed to read the new time points.
+ * \param fileName
+ * \param pLastTimePointsCount - set to the time points before the refresh or 0 when the file is opened.
+ * \param pErrorString - set when the file can't be read.
+ * \return the result file or 0 if it has no time points yet.
+ */
+MatResultFile* MatResultFilesCache::getGrowingMatResultFile(QString fileName, int *pLastTimePointsCount, QString *pErrorString)
+{
+  QString filePath = QFileInfo(fileName).absoluteFilePath();
+  MatResultFile *pMatResultFile = mGrowingMatResultFilesHash.value(filePath, 0);
+  if (pMatResultFile) {
+    *pLastTimePointsCount = pMatResultFile->getTimePointsCount();
+    if (pMatResultFile->refresh(pErrorString)) {
+      return pMatResultFile;
+    }
+    delete mGrowingMatResultFilesHash.take(filePath);
+    return 0;
+  }
+  *pLastTimePointsCount = 0;
+  pMatResultFile = new MatResultFile(filePath);
+  // data_2 may not be written yet and the matrix headers are only read when the file is opened.
+  if (!pMatResultFile->open(pErrorString) || pMatResultFile->getTimePointsCount() == 0) {
+    delete pMatResultFile;
+    return 0;
+  }
+  mGrowingMatResultFilesHash.insert(filePath, pMatResultFile);
+  return pMatResultFile;
+}
+
+/*!
+ * \brief MatResultFilesCache::removeMatResultFile
+ * Closes the result file and the result file of the running simulation. Called before the file is written again and when
+ * the simulation is finished.
+ * \param fileName
+ */
+void MatResultFilesCache::removeMatResultFile(QString fileName)
+{
+  QString filePath = QFileInfo(fileName).absoluteFilePath();
+  MatResultFile *pMatResultFile = mMatResultFilesHash.take(filePath);
+  if (pMatResultFile) {
+    delete pMatResultFile;
+  }
+  pMatResultFile = mGrowingMatResultFilesHash.take(filePath);
+  if (pMatResultFile) {
+    delete pMatResultFile;
+  }
+}
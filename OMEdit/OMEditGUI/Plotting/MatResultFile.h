@@ -0,0 +1,101 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef MATRESULTFILE_H
+#define MATRESULTFILE_H
+
+#include "MainWindow.h"
+
+struct MatMatrix
+{
+  int mPrecision;
+  int mRows;
+  int mColumns;
+  int mElementSize;
+  qint64 mOffset;
+};
+
+class MatResultFile
+{
+public:
+  MatResultFile(QString fileName);
+  ~MatResultFile();
+  QString getFileName() {return mFile.fileName();}
+  QDateTime getLastModified() {return mLastModified;}
+  bool open(QString *pErrorString);
+  bool refresh(QString *pErrorString);
+  bool isOpen() {return mFile.isOpen();}
+  QStringList getVariables() {return mVariablesHash.keys();}
+  bool hasVariable(const QString &variable) {return mVariablesHash.contains(variable);}
+  int getTimePointsCount() {return mTransposed ? mData2.mColumns : mData2.mRows;}
+  double getStartTime();
+  double getStopTime();
+  bool readFinalValue(const QString &variable, double *pValue);
+  bool readVariable(const QString &variable, QVector<double> *pValues);
+  void readVariables(const QStringList &variables, QHash<QString, QVector<double> > *pValuesHash, int fromTimeIndex = 0);
+private:
+  QFile mFile;
+  QDateTime mLastModified;
+  const uchar *mpData;
+  bool mTransposed;
+  MatMatrix mData1;
+  MatMatrix mData2;
+  QHash<QString, QPair<int, int> > mVariablesHash;
+  QCache<QString, QVector<double> > mTrajectoriesCache;
+
+  bool readMatrixHeader(qint64 *pOffset, MatMatrix *pMatrix, QString *pErrorString);
+  bool readBytes(qint64 offset, char *pBuffer, qint64 size);
+  double readElement(const MatMatrix &matrix, int row, int column);
+  QString readString(const MatMatrix &matrix, int index, bool transposed);
+  double readValue(const MatMatrix &matrix, int variableIndex, int timeIndex);
+};
+
+class MatResultFilesCache
+{
+public:
+  MatResultFilesCache();
+  ~MatResultFilesCache();
+  MatResultFile* getMatResultFile(QString fileName, QString *pErrorString);
+  MatResultFile* getGrowingMatResultFile(QString fileName, int *pLastTimePointsCount, QString *pErrorString);
+  void removeMatResultFile(QString fileName);
+private:
+  QHash<QString, MatResultFile*> mMatResultFilesHash;
+  QHash<QString, MatResultFile*> mGrowingMatResultFilesHash;
+};
+
+#endif // MATRESULTFILE_H
@@ -0,0 +1,269 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include <qwt_scale_div.h>
+#include <qwt_scale_widget.h>
+
+#include "PlotCurveDecimator.h"
+
+using namespace OMPlot;
+
+/*!
+ * \class PlotCurveDecimator
+ * \brief Decimates the large curves of a plot window to the width of the plot canvas.
+ * A pyramid of bucket minimums and maximums is built once for every curve. When the x-axis scale or the canvas size changes
+ * the visible samples are reduced to a minimum and a maximum per pixel column and the samples outside the visible range are
+ * reduced to a few coarse buckets, so the redraw cost depends on the canvas width and not on the number of samples.\n
+ * Only the drawn data is decimated. The x and y axis vectors of the curves are unchanged and are used for the exports.
+ */
+/*!
+ * \brief PlotCurveDecimator::PlotCurveDecimator
+ * \param pPlotWindow
+ */
+PlotCurveDecimator::PlotCurveDecimator(PlotWindow *pPlotWindow)
+  : QObject(pPlotWindow)
+{
+  mpPlotWindow = pPlotWindow;
+  mLowerBound = 0;
+  mUpperBound = 0;
+  mWidth = 0;
+  mUpdateTimer.setSingleShot(true);
+  mUpdateTimer.setInterval(0);
+  connect(&mUpdateTimer, SIGNAL(timeout()), SLOT(updatePlotCurves()));
+  connect(mpPlotWindow->getPlot()->axisWidget(QwtPlot::xBottom), SIGNAL(scaleDivChanged()), SLOT(scheduleUpdate()));
+  mpPlotWindow->getPlot()->canvas()->installEventFilter(this);
+}
+
+PlotCurveDecimator::~PlotCurveDecimator()
+{
+  qDeleteAll(mLevelsOfDetailHash);
+}
+
+/*!
+ * \brief PlotCurveDecimator::getPlotCurveDecimator
+ * Returns the decimator of the plot window. Creates it if the plot window doesn't have one.
+ * \param pPlotWindow
+ * \return
+ */
+PlotCurveDecimator* PlotCurveDecimator::getPlotCurveDecimator(PlotWindow *pPlotWindow)
+{
+  PlotCurveDecimator *pPlotCurveDecimator = pPlotWindow->findChild<PlotCurveDecimator*>();
+  if (!pPlotCurveDecimator) {
+    pPlotCurveDecimator = new PlotCurveDecimator(pPlotWindow);
+  }
+  return pPlotCurveDecimator;
+}
+
+/*!
+ * \brief PlotCurveDecimator::decimatePlotCurves
+ * Sets the decimated data of the curves for the current x-axis scale. Rebuilds the levels of detail of the curves whose data is
+ * changed. The plot is not replotted.
+ */
+void PlotCurveDecimator::decimatePlotCurves()
+{
+  Plot *pPlot = mpPlotWindow->getPlot();
+  QList<PlotCurve*> plotCurves = pPlot->getPlotCurvesList();
+  // forget the removed curves.
+  foreach (PlotCurve *pPlotCurve, mLevelsOfDetailHash.keys()) {
+    if (!plotCurves.contains(pPlotCurve)) {
+      delete mLevelsOfDetailHash.take(pPlotCurve);
+    }
+  }
+  const QwtScaleDiv &scaleDiv = pPlot->axisScaleDiv(QwtPlot::xBottom);
+  mLowerBound = qMin(scaleDiv.lowerBound(), scaleDiv.upperBound());
+  mUpperBound = qMax(scaleDiv.lowerBound(), scaleDiv.upperBound());
+  mWidth = qMax(pPlot->canvas()->width(), 1);
+  foreach (PlotCurve *pPlotCurve, plotCurves) {
+    int size = pPlotCurve->getSize();
+    PlotCurveLevelsOfDetail *pLevelsOfDetail = mLevelsOfDetailHash.value(pPlotCurve, 0);
+    if (!pLevelsOfDetail || pLevelsOfDetail->mpXValues != pPlotCurve->getXAxisVector()
+        || pLevelsOfDetail->mpYValues != pPlotCurve->getYAxisVector() || pLevelsOfDetail->mSize != size) {
+      // the small curves are drawn with all the samples.
+      if (size <= 4 * mWidth) {
+        delete mLevelsOfDetailHash.take(pPlotCurve);
+        continue;
+      }
+      if (!pLevelsOfDetail) {
+        pLevelsOfDetail = new PlotCurveLevelsOfDetail;
+        mLevelsOfDetailHash.insert(pPlotCurve, pLevelsOfDetail);
+      }
+      pLevelsOfDetail->mpXValues = pPlotCurve->getXAxisVector();
+      pLevelsOfDetail->mpYValues = pPlotCurve->getYAxisVector();
+      pLevelsOfDetail->mSize = size;
+      buildLevelsOfDetail(pLevelsOfDetail);
+    }
+    // the visible range plus one sample on each side so the lines to the canvas borders are drawn.
+    const double *pXValues = pLevelsOfDetail->mpXValues;
+    int first = qMax(int(std::lower_bound(pXValues, pXValues + size, mLowerBound) - pXValues) - 1, 0);
+    int last = qMin(int(std::upper_bound(pXValues, pXValues + size, mUpperBound) - pXValues), size - 1);
+    pLevelsOfDetail->mXValues.clear();
+    pLevelsOfDetail->mYValues.clear();
+    pLevelsOfDetail->mXValues.reserve(4 * mWidth + 1024);
+    pLevelsOfDetail->mYValues.reserve(4 * mWidth + 1024);
+    if (first > 0) {
+      decimateRange(pLevelsOfDetail, 0, first - 1, 256);
+    }
+    if (first <= last) {
+      decimateRange(pLevelsOfDetail, first, last, mWidth);
+    }
+    if (last < size - 1) {
+      decimateRange(pLevelsOfDetail, last + 1, size - 1, 256);
+    }
+    pPlotCurve->setData(pLevelsOfDetail->mXValues.constData(), pLevelsOfDetail->mYValues.constData(),
+                        pLevelsOfDetail->mXValues.size());
+  }
+}
+
+/*!
+ * \brief PlotCurveDecimator::buildLevelsOfDetail
+ * Builds the minimums and maximums of the buckets of 2, 4, 8, ... samples until a level has at most 64 buckets.
+ * \param pLevelsOfDetail
+ */
+void PlotCurveDecimator::buildLevelsOfDetail(PlotCurveLevelsOfDetail *pLevelsOfDetail)
+{
+  pLevelsOfDetail->mMinimums.clear();
+  pLevelsOfDetail->mMaximums.clear();
+  const double *pYValues = pLevelsOfDetail->mpYValues;
+  int size = pLevelsOfDetail->mSize;
+  QVector<double> minimums((size + 1) / 2), maximums((size + 1) / 2);
+  for (int i = 0 ; i < minimums.size() ; i++) {
+    double first = pYValues[2 * i];
+    double second = (2 * i + 1 < size) ? pYValues[2 * i + 1] : first;
+    minimums[i] = qMin(first, second);
+    maximums[i] = qMax(first, second);
+  }
+  pLevelsOfDetail->mMinimums.append(minimums);
+  pLevelsOfDetail->mMaximums.append(maximums);
+  while (pLevelsOfDetail->mMinimums.last().size() > 64) {
+    const QVector<double> &lastMinimums = pLevelsOfDetail->mMinimums.last();
+    const QVector<double> &lastMaximums = pLevelsOfDetail->mMaximums.last();
+    int count = lastMinimums.size();
+    minimums = QVector<double>((count + 1) / 2);
+    maximums = QVector<double>((count + 1) / 2);
+    for (int i = 0 ; i < minimums.size() ; i++) {
+      int second = qMin(2 * i + 1, count - 1);
+      minimums[i] = qMin(lastMinimums[2 * i], lastMinimums[second]);
+      maximums[i] = qMax(lastMaximums[2 * i], lastMaximums[second]);
+    }
+    pLevelsOfDetail->mMinimums.append(minimums);
+    pLevelsOfDetail->mMaximums.append(maximums);
+  }
+}
+
+/*!
+ * \brief PlotCurveDecimator::decimateRange
+ * Appends the samples first to last reduced to at least the given number of buckets. Every bucket adds its minimum and maximum
+ * at the x value of its first sample. The last sample of the range is always added.
+ * \param pLevelsOfDetail
+ * \param first
+ * \param last
+ * \param buckets
+ */
+void PlotCurveDecimator::decimateRange(PlotCurveLevelsOfDetail *pLevelsOfDetail, int first, int last, int buckets)
+{
+  const double *pXValues = pLevelsOfDetail->mpXValues;
+  const double *pYValues = pLevelsOfDetail->mpYValues;
+  int count = last - first + 1;
+  if (count <= 2 * buckets) {
+    for (int i = first ; i <= last ; i++) {
+      pLevelsOfDetail->mXValues.append(pXValues[i]);
+      pLevelsOfDetail->mYValues.append(pYValues[i]);
+    }
+    return;
+  }
+  // the level with buckets of 2^(level + 1) samples that still gives at least the requested number of buckets.
+  int level = 0;
+  while (level + 1 < pLevelsOfDetail->mMinimums.size() && (count >> (level + 2)) >= buckets) {
+    level++;
+  }
+  const QVector<double> &minimums = pLevelsOfDetail->mMinimums.at(level);
+  const QVector<double> &maximums = pLevelsOfDetail->mMaximums.at(level);
+  int shift = level + 1;
+  for (int bucket = first >> shift ; bucket <= (last >> shift) ; bucket++) {
+    double x = pXValues[qMax(bucket << shift, first)];
+    pLevelsOfDetail->mXValues.append(x);
+    pLevelsOfDetail->mYValues.append(minimums.at(bucket));
+    pLevelsOfDetail->mXValues.append(x);
+    pLevelsOfDetail->mYValues.append(maximums.at(bucket));
+  }
+  pLevelsOfDetail->mXValues.append(pXValues[last]);
+  pLevelsOfDetail->mYValues.append(pYValues[last]);
+}
+
+/*!
+ * \brief PlotCurveDecimator::eventFilter
+ * Decimates the curves again when the plot canvas is resized.
+ * \param pObject
+ * \param pEvent
+ * \return
+ */
+bool PlotCurveDecimator::eventFilter(QObject *pObject, QEvent *pEvent)
+{
+  if (pEvent->type() == QEvent::Resize) {
+    scheduleUpdate();
+  }
+  return QObject::eventFilter(pObject, pEvent);
+}
+
+/*!
+ * \brief PlotCurveDecimator::scheduleUpdate
+ * Slot activated when the x-axis scale is changed by zooming, panning or fitting in view.
+ * The update is queued so the curves are decimated once per change and not during the replot.
+ */
+void PlotCurveDecimator::scheduleUpdate()
+{
+  if (!mLevelsOfDetailHash.isEmpty()) {
+    mUpdateTimer.start();
+  }
+}
+
+/*!
+ * \brief PlotCurveDecimator::updatePlotCurves
+ * Decimates the curves for the new x-axis scale and replots.
+ */
+void PlotCurveDecimator::updatePlotCurves()
+{
+  Plot *pPlot = mpPlotWindow->getPlot();
+  const QwtScaleDiv &scaleDiv = pPlot->axisScaleDiv(QwtPlot::xBottom);
+  if (qMin(scaleDiv.lowerBound(), scaleDiv.upperBound()) == mLowerBound
+      && qMax(scaleDiv.lowerBound(), scaleDiv.upperBound()) == mUpperBound && pPlot->canvas()->width() == mWidth) {
+    return;
+  }
+  decimatePlotCurves();
+  pPlot->replot();
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef PLOTCURVEDECIMATOR_H
+#define PLOTCURVEDECIMATOR_H
+
+#include "MainWindow.h"
+#include "PlotWindow.h"
+
+struct PlotCurveLevelsOfDetail
+{
+  const double *mpXValues;
+  const double *mpYValues;
+  int mSize;
+  // mMinimums[i] and mMaximums[i] hold the extremes of the buckets of 2^(i+1) samples.
+  QList<QVector<double> > mMinimums;
+  QList<QVector<double> > mMaximums;
+  // the decimated samples set on the curve. The curve doesn't copy them.
+  QVector<double> mXValues;
+  QVector<double> mYValues;
+};
+
+class PlotCurveDecimator : public QObject
+{
+  Q_OBJECT
+public:
+  PlotCurveDecimator(OMPlot::PlotWindow *pPlotWindow);
+  ~PlotCurveDecimator();
+  static PlotCurveDecimator* getPlotCurveDecimator(OMPlot::PlotWindow *pPlotWindow);
+  void decimatePlotCurves();
+private:
+  OMPlot::PlotWindow *mpPlotWindow;
+  QHash<OMPlot::PlotCurve*, PlotCurveLevelsOfDetail*> mLevelsOfDetailHash;
+  QTimer mUpdateTimer;
+  double mLowerBound;
+  double mUpperBound;
+  int mWidth;
+
+  void buildLevelsOfDetail(PlotCurveLevelsOfDetail *pLevelsOfDetail);
+  void decimateRange(PlotCurveLevelsOfDetail *pLevelsOfDetail, int first, int last, int buckets);
+protected:
+  virtual bool eventFilter(QObject *pObject, QEvent *pEvent);
+private slots:
+  void scheduleUpdate();
+  void updatePlotCurves();
+};
+
+#endif // PLOTCURVEDECIMATOR_H
@@ -37,7 +37,8 @@
  */
 
 #include "VariablesWidget.h"
-#include "util/read_matlab4.h"
+#include "ParameterSweepDialog.h"
+#include "MatResultFile.h"
 
 using namespace OMPlot;
 
@@ -60,6 +61,7 @@ using namespace OMPlot;
 VariablesTreeItem::VariablesTreeItem(const QVector<QVariant> &variableItemData, VariablesTreeItem *pParent, bool isRootItem)
 {
   mpParentVariablesTreeItem = pParent;
+  mRow = 0;
   mIsRootItem = isRootItem;
   mFilePath = variableItemData[0].toString();
   mFileName = variableItemData[1].toString();
@@ -101,6 +103,10 @@ QIcon VariablesTreeItem::getVariableTreeItemIcon(QString name) const
 void VariablesTreeItem::insertChild(int position, VariablesTreeItem *pVariablesTreeItem)
 {
   mChildren.insert(position, pVariablesTreeItem);
+  // update the rows of the children after the inserted one.
+  for (int i = position ; i < mChildren.size() ; i++) {
+    mChildren[i]->mRow = i;
+  }
 }
 
 VariablesTreeItem* VariablesTreeItem::child(int row)
@@ -116,7 +122,18 @@ void VariablesTreeItem::removeChildren()
 
 void VariablesTreeItem::removeChild(VariablesTreeItem *pVariablesTreeItem)
 {
-  mChildren.removeOne(pVariablesTreeItem);
+  int position = pVariablesTreeItem->mRow;
+  if (position >= mChildren.size() || mChildren.at(position) != pVariablesTreeItem) {
+    position = mChildren.indexOf(pVariablesTreeItem);
+  }
+  if (position < 0) {
+    return;
+  }
+  mChildren.removeAt(position);
+  // update the rows of the children after the removed one.
+  for (int i = position ; i < mChildren.size() ; i++) {
+    mChildren[i]->mRow = i;
+  }
 }
 
 int VariablesTreeItem::columnCount() const
@@ -200,10 +217,7 @@ QVariant VariablesTreeItem::data(int column, int role) const
 
 int VariablesTreeItem::row() const
 {
-  if (mpParentVariablesTreeItem)
-    return mpParentVariablesTreeItem->mChildren.indexOf(const_cast<VariablesTreeItem*>(this));
-
-  return 0;
+  return mRow;
 }
 
 VariablesTreeItem* VariablesTreeItem::parent()
@@ -213,15 +227,15 @@ VariablesTreeItem* VariablesTreeItem::parent()
 
 VariablesTreeItem* VariablesTreeItem::rootParent()
 {
-  // since we have global mpRootVariablesTreeItem so we return one level down from this function in order to get the top level item.
-  VariablesTreeItem *pVariablesTreeItem, *pVariablesTreeItem1;
-  pVariablesTreeItem = this;
-  pVariablesTreeItem1 = this;
-  while (pVariablesTreeItem->mpParentVariablesTreeItem) {
-    pVariablesTreeItem1 = pVariablesTreeItem;
+  /* the result file items are the root items. They are either top level items or grouped under the item of a parameter sweep.
+   * Stop at the top level item so the item of a parameter sweep returns itself and not the invisible root item of the model.
+   */
+  VariablesTreeItem *pVariablesTreeItem = this;
+  while (!pVariablesTreeItem->mIsRootItem && pVariablesTreeItem->mpParentVariablesTreeItem &&
+         pVariablesTreeItem->mpParentVariablesTreeItem->mpParentVariablesTreeItem) {
     pVariablesTreeItem = pVariablesTreeItem->mpParentVariablesTreeItem;
   }
-  return pVariablesTreeItem1;
+  return pVariablesTreeItem;
 }
 
 VariablesTreeModel::VariablesTreeModel(VariablesTreeView *pVariablesTreeView)
@@ -335,35 +349,128 @@ Qt::ItemFlags VariablesTreeModel::flags(const QModelIndex &index) const
   return flags;
 }
 
+/*!
+ * \brief VariablesTreeModel::findVariablesTreeItem
+ * Finds the variable in the subtree of root.
+ * \param name - the fully qualified variable name i.e., result file name followed by the variable name.
+ * \param root
+ * \return the VariablesTreeItem or 0 if not found.
+ */
 VariablesTreeItem* VariablesTreeModel::findVariablesTreeItem(const QString &name, VariablesTreeItem *root) const
 {
-  if (root->getVariableName() == name)
-    return root;
-  for (int i = root->getChildren().size(); --i >= 0; )
-    if (VariablesTreeItem *item = findVariablesTreeItem(name, root->getChildren().at(i)))
-      return item;
+  QString fileName;
+  if (root && root != mpRootVariablesTreeItem) {
+    fileName = root->getFileName();
+  } else {
+    // the name starts with the name of its result file.
+    foreach (VariablesTreeItem *pResultVariablesTreeItem, getResultVariablesTreeItems()) {
+      QString resultVariableName = pResultVariablesTreeItem->getVariableName();
+      if ((name.compare(resultVariableName) == 0 || name.startsWith(resultVariableName + ".")) &&
+          resultVariableName.length() > fileName.length()) {
+        fileName = resultVariableName;
+      }
+    }
+  }
+  VariablesTreeItem *pVariablesTreeItem = mVariablesTreeItemsHash.value(fileName).value(name, 0);
+  if (pVariablesTreeItem) {
+    // make sure the item is in the subtree of root.
+    for (VariablesTreeItem *pParentVariablesTreeItem = pVariablesTreeItem ; pParentVariablesTreeItem ;
+         pParentVariablesTreeItem = pParentVariablesTreeItem->parent()) {
+      if (pParentVariablesTreeItem == root) {
+        return pVariablesTreeItem;
+      }
+    }
+  }
   return 0;
 }
 
+/*!
+ * \brief VariablesTreeModel::getResultVariablesTreeItems
+ * \return the items of the result files including the ones grouped under the parameter sweep items.
+ */
+QList<VariablesTreeItem*> VariablesTreeModel::getResultVariablesTreeItems() const
+{
+  QList<VariablesTreeItem*> resultVariablesTreeItems;
+  foreach (VariablesTreeItem *pTopVariablesTreeItem, mpRootVariablesTreeItem->getChildren()) {
+    if (pTopVariablesTreeItem->isRootItem()) {
+      resultVariablesTreeItems.append(pTopVariablesTreeItem);
+    } else {
+      resultVariablesTreeItems.append(pTopVariablesTreeItem->getChildren());
+    }
+  }
+  return resultVariablesTreeItems;
+}
+
+/*!
+ * \brief VariablesTreeModel::getParameterSweepVariablesTreeItem
+ * Finds or creates the top level item which groups the result files of the parameter sweep.
+ * \param simulationOptions - the simulation options of a run of the sweep.
+ * \return the parameter sweep item.
+ */
+VariablesTreeItem* VariablesTreeModel::getParameterSweepVariablesTreeItem(SimulationOptions simulationOptions)
+{
+  QString parameterSweepName = simulationOptions.getParameterSweepName();
+  foreach (VariablesTreeItem *pTopVariablesTreeItem, mpRootVariablesTreeItem->getChildren()) {
+    if (!pTopVariablesTreeItem->isRootItem() && pTopVariablesTreeItem->getVariableName().compare(parameterSweepName) == 0) {
+      return pTopVariablesTreeItem;
+    }
+  }
+  QString toolTip = tr("%1: %2\n%3: %4").arg(Helper::parameterSweep).arg(parameterSweepName).arg(Helper::fileLocation)
+      .arg(simulationOptions.getWorkingDirectory());
+  QVector<QVariant> variableData;
+  variableData << simulationOptions.getWorkingDirectory() << "" << parameterSweepName << parameterSweepName << "" << "" << "" << ""
+               << toolTip;
+  VariablesTreeItem *pParameterSweepVariablesTreeItem = new VariablesTreeItem(variableData, mpRootVariablesTreeItem);
+  int row = rowCount();
+  beginInsertRows(QModelIndex(), row, row);
+  mpRootVariablesTreeItem->insertChild(row, pParameterSweepVariablesTreeItem);
+  endInsertRows();
+  return pParameterSweepVariablesTreeItem;
+}
+
+/*!
+ * \brief VariablesTreeModel::variablesTreeItemIndex
+ * \param pVariablesTreeItem
+ * \return the QModelIndex of the VariablesTreeItem. Uses the row stored in the item so no search is needed.
+ */
 QModelIndex VariablesTreeModel::variablesTreeItemIndex(const VariablesTreeItem *pVariablesTreeItem) const
 {
-  return variablesTreeItemIndexHelper(pVariablesTreeItem, mpRootVariablesTreeItem, QModelIndex());
+  if (!pVariablesTreeItem || pVariablesTreeItem == mpRootVariablesTreeItem)
+    return QModelIndex();
+  return createIndex(pVariablesTreeItem->row(), 0, const_cast<VariablesTreeItem*>(pVariablesTreeItem));
 }
 
-QModelIndex VariablesTreeModel::variablesTreeItemIndexHelper(const VariablesTreeItem *pVariablesTreeItem,
-                                                             const VariablesTreeItem *pParentVariablesTreeItem,
-                                                             const QModelIndex &parentIndex) const
+/*!
+ * \brief VariablesTreeModel::addToVariablesTreeItemsHash
+ * Adds the VariablesTreeItem to the variables index of its result file.
+ * \param pVariablesTreeItem
+ */
+void VariablesTreeModel::addToVariablesTreeItemsHash(VariablesTreeItem *pVariablesTreeItem)
 {
-  if (pVariablesTreeItem == pParentVariablesTreeItem)
-    return parentIndex;
-  for (int i = pParentVariablesTreeItem->getChildren().size(); --i >= 0; ) {
-    const VariablesTreeItem *childItem = pParentVariablesTreeItem->getChildren().at(i);
-    QModelIndex childIndex = index(i, 0, parentIndex);
-    QModelIndex index = variablesTreeItemIndexHelper(pVariablesTreeItem, childItem, childIndex);
-    if (index.isValid())
-      return index;
+  mVariablesTreeItemsHash[pVariablesTreeItem->getFileName()].insert(pVariablesTreeItem->getVariableName(), pVariablesTreeItem);
+}
+
+/*!
+ * \brief VariablesTreeModel::removeFromVariablesTreeItemsHash
+ * Removes the VariablesTreeItem and its children from the variables index of its result file.
+ * \param pVariablesTreeItem
+ */
+void VariablesTreeModel::removeFromVariablesTreeItemsHash(VariablesTreeItem *pVariablesTreeItem)
+{
+  if (pVariablesTreeItem->isRootItem()) {
+    mVariablesTreeItemsHash.remove(pVariablesTreeItem->getFileName());
+    return;
+  }
+  QHash<QString, QHash<QString, VariablesTreeItem*> >::iterator iterator = mVariablesTreeItemsHash.find(pVariablesTreeItem->getFileName());
+  if (iterator == mVariablesTreeItemsHash.end()) {
+    return;
+  }
+  if (iterator.value().value(pVariablesTreeItem->getVariableName(), 0) == pVariablesTreeItem) {
+    iterator.value().remove(pVariablesTreeItem->getVariableName());
+  }
+  foreach (VariablesTreeItem *pChildVariablesTreeItem, pVariablesTreeItem->getChildren()) {
+    removeFromVariablesTreeItemsHash(pChildVariablesTreeItem);
   }
-  return QModelIndex();
 }
 
 void VariablesTreeModel::parseInitXml(QXmlStreamReader &xmlReader)
@@ -425,14 +532,20 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
   QString toolTip = tr("Simulation Result File: %1\n%2: %3/%4").arg(fileName).arg(Helper::fileLocation).arg(filePath).arg(fileName);
   QRegExp resultTypeRegExp("(_res.mat|_res.plt|_res.csv)");
   QString text = QString(fileName).remove(resultTypeRegExp);
-  QModelIndex index = variablesTreeItemIndex(mpRootVariablesTreeItem);
+  // the result files of a parameter sweep are grouped under one item.
+  VariablesTreeItem *pResultParentVariablesTreeItem = mpRootVariablesTreeItem;
+  if (!simulationOptions.getParameterSweepName().isEmpty()) {
+    pResultParentVariablesTreeItem = getParameterSweepVariablesTreeItem(simulationOptions);
+  }
+  QModelIndex index = variablesTreeItemIndex(pResultParentVariablesTreeItem);
   QVector<QVariant> Variabledata;
   Variabledata << filePath << fileName << fileName << text << "" << "" << "" << "" << toolTip;
-  VariablesTreeItem *pTopVariablesTreeItem = new VariablesTreeItem(Variabledata, mpRootVariablesTreeItem, true);
+  VariablesTreeItem *pTopVariablesTreeItem = new VariablesTreeItem(Variabledata, pResultParentVariablesTreeItem, true);
   pTopVariablesTreeItem->setSimulationOptions(simulationOptions);
-  int row = rowCount();
+  int row = rowCount(index);
   beginInsertRows(index, row, row);
-  mpRootVariablesTreeItem->insertChild(row, pTopVariablesTreeItem);
+  pResultParentVariablesTreeItem->insertChild(row, pTopVariablesTreeItem);
+  addToVariablesTreeItemsHash(pTopVariablesTreeItem);
   endInsertRows();
   /* open the model_init.xml file for reading */
   if (simulationOptions.isValid()) {
@@ -449,19 +562,18 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
                                                  .arg(initFile.errorString()), Helper::scriptingKind, Helper::errorLevel));
     }
   }
-  /* open the .mat file */
-  ModelicaMatReader matReader;
-  matReader.file = 0;
-  const char *msg[] = {""};
+  /* open the .mat file. The file stays open in the MatResultFilesCache for plotting. */
+  MatResultFile *pMatResultFile = 0;
   if (fileName.endsWith(".mat"))
   {
-    //Read in mat file
-    if (0 != (msg[0] = omc_new_matlab4_reader(QString(filePath + "/" + fileName).toStdString().c_str(), &matReader)))
+    QString errorString;
+    MatResultFilesCache *pMatResultFilesCache = mpVariablesTreeView->getVariablesWidget()->getMatResultFilesCache();
+    if (!(pMatResultFile = pMatResultFilesCache->getMatResultFile(QString(filePath + "/" + fileName), &errorString)))
     {
       MessagesWidget *pMessagesWidget = mpVariablesTreeView->getVariablesWidget()->getMainWindow()->getMessagesWidget();
       pMessagesWidget->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
                                                  GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(fileName)
-                                                 .arg(QString(msg[0])), Helper::scriptingKind, Helper::errorLevel));
+                                                 .arg(errorString), Helper::scriptingKind, Helper::errorLevel));
     }
   }
   QStringList variables;
@@ -522,11 +634,13 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
         variableData << filePath << fileName << pParentVariablesTreeItem->getVariableName() + "." + variable << variable;
       /* find the variable in the xml file */
       QString variableToFind = variableData[2].toString();
-      variableToFind.remove(QRegExp(pTopVariablesTreeItem->getVariableName() + "."));
+      if (variableToFind.startsWith(pTopVariablesTreeItem->getVariableName() + ".")) {
+        variableToFind.remove(0, pTopVariablesTreeItem->getVariableName().length() + 1);
+      }
       /* get the variable information i.e value, unit, displayunit, description */
       QString value, unit, displayUnit, description;
       bool changeAble = false;
-      getVariableInformation(&matReader, variableToFind, &value, &changeAble, &unit, &displayUnit, &description);
+      getVariableInformation(pMatResultFile, variableToFind, &value, &changeAble, &unit, &displayUnit, &description);
       variableData << StringHandler::unparse(QString("\"").append(value).append("\""));
       /* set the variable unit */
       variableData << StringHandler::unparse(QString("\"").append(unit).append("\""));
@@ -541,6 +655,7 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       int row = rowCount(index);
       beginInsertRows(index, row, row);
       pParentVariablesTreeItem->insertChild(row, pVariablesTreeItem);
+      addToVariablesTreeItemsHash(pVariablesTreeItem);
       endInsertRows();
       if (count == 1)
         parentVariable = variable;
@@ -549,13 +664,11 @@ void VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       count++;
     }
   }
-  /* close the .mat file */
-  if (fileName.endsWith(".mat"))
-  {
-    if (matReader.file)
-      omc_free_matlab4_reader(&matReader);
-  }
   mpVariablesTreeView->collapseAll();
+  if (pResultParentVariablesTreeItem != mpRootVariablesTreeItem) {
+    QModelIndex parentIndex = variablesTreeItemIndex(pResultParentVariablesTreeItem);
+    mpVariablesTreeView->expand(mpVariablesTreeView->getVariablesWidget()->getVariableTreeProxyModel()->mapFromSource(parentIndex));
+  }
   QModelIndex idx = variablesTreeItemIndex(pTopVariablesTreeItem);
   idx = mpVariablesTreeView->getVariablesWidget()->getVariableTreeProxyModel()->mapFromSource(idx);
   mpVariablesTreeView->expand(idx);
@@ -573,12 +686,26 @@ bool VariablesTreeModel::removeVariableTreeItem(QString variable)
   VariablesTreeItem *pVariablesTreeItem = findVariablesTreeItem(variable, mpRootVariablesTreeItem);
   if (pVariablesTreeItem)
   {
+    /* close the result file of the removed result */
+    if (pVariablesTreeItem->isRootItem()) {
+      mpVariablesTreeView->getVariablesWidget()->getMatResultFilesCache()->removeMatResultFile(QString(pVariablesTreeItem->getFilePath())
+                                                                                              .append("/").append(pVariablesTreeItem->getFileName()));
+    }
     beginRemoveRows(variablesTreeItemIndex(pVariablesTreeItem), 0, pVariablesTreeItem->getChildren().size());
+    removeFromVariablesTreeItemsHash(pVariablesTreeItem);
     pVariablesTreeItem->removeChildren();
     VariablesTreeItem *pParentVariablesTreeItem = pVariablesTreeItem->parent();
     pParentVariablesTreeItem->removeChild(pVariablesTreeItem);
     delete pVariablesTreeItem;
     endRemoveRows();
+    // remove the parameter sweep item with its last result.
+    if (pParentVariablesTreeItem != mpRootVariablesTreeItem && pParentVariablesTreeItem->getChildren().isEmpty()) {
+      int row = pParentVariablesTreeItem->row();
+      beginRemoveRows(QModelIndex(), row, row);
+      mpRootVariablesTreeItem->removeChild(pParentVariablesTreeItem);
+      delete pParentVariablesTreeItem;
+      endRemoveRows();
+    }
     return true;
   }
   return false;
@@ -593,28 +720,43 @@ void VariablesTreeModel::unCheckVariables(VariablesTreeItem *pVariablesTreeItem)
   }
 }
 
+/*!
+ * \brief VariablesTreeModel::plotAllVariables
+ * Checks all the variables under the item and plots them in one batch.
+ * \param pVariablesTreeItem
+ * \param pPlotWindow
+ */
 void VariablesTreeModel::plotAllVariables(VariablesTreeItem *pVariablesTreeItem, PlotWindow *pPlotWindow)
+{
+  QList<VariablesTreeItem*> variablesTreeItems;
+  getLeafVariablesTreeItems(pVariablesTreeItem, &variablesTreeItems);
+  bool state = blockSignals(true);
+  foreach (VariablesTreeItem *pLeafVariablesTreeItem, variablesTreeItems) {
+    setData(variablesTreeItemIndex(pLeafVariablesTreeItem), Qt::Checked, Qt::CheckStateRole);
+  }
+  blockSignals(state);
+  mpVariablesTreeView->getVariablesWidget()->plotVariablesList(variablesTreeItems, pPlotWindow);
+}
+
+/*!
+ * \brief VariablesTreeModel::getLeafVariablesTreeItems
+ * Collects the items under pVariablesTreeItem that have no children.
+ * \param pVariablesTreeItem
+ * \param pVariablesTreeItems
+ */
+void VariablesTreeModel::getLeafVariablesTreeItems(VariablesTreeItem *pVariablesTreeItem, QList<VariablesTreeItem*> *pVariablesTreeItems)
 {
   QList<VariablesTreeItem*> variablesTreeItems = pVariablesTreeItem->getChildren();
   if (variablesTreeItems.size() == 0) {
-    QModelIndex index = variablesTreeItemIndex(pVariablesTreeItem);
-    OMPlot::PlotCurve *pPlotCurve = 0;
-    foreach (OMPlot::PlotCurve *curve, pPlotWindow->getPlot()->getPlotCurvesList()) {
-      if (curve->getNameStructure().compare(pVariablesTreeItem->getVariableName()) == 0) {
-        pPlotCurve = curve;
-        break;
-      }
-    }
-    setData(index, Qt::Checked, Qt::CheckStateRole);
-    mpVariablesTreeView->getVariablesWidget()->plotVariables(index, pPlotWindow->getCurveWidth(), pPlotWindow->getCurveStyle(), pPlotCurve);
+    pVariablesTreeItems->append(pVariablesTreeItem);
   } else {
     for (int i = 0 ; i < variablesTreeItems.size() ; i++) {
-      plotAllVariables(variablesTreeItems[i], pPlotWindow);
+      getLeafVariablesTreeItems(variablesTreeItems[i], pVariablesTreeItems);
     }
   }
 }
 
-void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble,
+void VariablesTreeModel::getVariableInformation(MatResultFile *pMatResultFile, QString variableToFind, QString *value, bool *changeAble,
                                                 QString *unit, QString *displayUnit, QString *description)
 {
   QHash<QString, QString> hash = mScalarVariablesList.value(variableToFind);
@@ -628,25 +770,24 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
     /* if the variable is not a tunable parameter then read the final value of the variable. Only mat result files are supported. */
     else
     {
-      if ((pMatReader->file != NULL) && strcmp(pMatReader->fileName, ""))
+      if (pMatResultFile)
       {
         *value = "";
         if (variableToFind.compare("time") == 0)
         {
-          *value = QString::number(omc_matlab4_stopTime(pMatReader));
+          *value = QString::number(pMatResultFile->getStopTime());
         }
         else
         {
-          ModelicaMatVariable_t *var;
-          if (0 == (var = omc_matlab4_find_var(pMatReader, variableToFind.toStdString().c_str())))
-          {
-            qDebug() << QString("%1 not found in %2").arg(variableToFind).arg(pMatReader->fileName);
-          }
           double res;
-          if (var && !omc_matlab4_val(&res, pMatReader, var, omc_matlab4_stopTime(pMatReader)))
+          if (pMatResultFile->readFinalValue(variableToFind, &res))
           {
             *value = QString::number(res);
           }
+          else
+          {
+            qDebug() << QString("%1 not found in %2").arg(variableToFind).arg(pMatResultFile->getFileName());
+          }
         }
       }
     }
@@ -654,9 +795,9 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
     *displayUnit = hash["displayUnit"];
     *description = hash["description"];
   }
-  else if ((variableToFind.compare("time") == 0) && (pMatReader->file != NULL) && strcmp(pMatReader->fileName, ""))
+  else if ((variableToFind.compare("time") == 0) && pMatResultFile)
   {
-    *value = QString::number(omc_matlab4_stopTime(pMatReader));
+    *value = QString::number(pMatResultFile->getStopTime());
   }
 }
 
@@ -838,11 +979,120 @@ void VariablesWidget::insertVariablesItemsToTree(QString fileName, QString fileP
   findVariables();
 }
 
+/*!
+ * \brief VariablesWidget::updateVariablesWhileSimulating
+ * Reads the mat result file of a running simulation. Adds the result variables to the tree when the file has the first
+ * time points and then appends the new time points to the plotted curves of the result.\n
+ * The file stays open until the simulation is finished and only the time points written since the last update are read.
+ * The curves with another number of time points, e.g. the curves of a previous run, are read again from the first time point.\n
+ * The result file of a previous run is skipped until the running simulation writes it.
+ * \param simulationOptions
+ * \param resultFileLastModifiedDateTime - the last modified datetime of the result file when the simulation started.
+ * \return true if the result variables are added to the tree.
+ */
+bool VariablesWidget::updateVariablesWhileSimulating(SimulationOptions simulationOptions, QDateTime resultFileLastModifiedDateTime)
+{
+  QString fileName = simulationOptions.getResultFileName();
+  if (!fileName.endsWith(".mat")) {
+    return false;
+  }
+  QString filePath = QString(simulationOptions.getWorkingDirectory()).append("/").append(fileName);
+  QFileInfo resultFileInfo(filePath);
+  if (!resultFileInfo.exists() ||
+      (resultFileLastModifiedDateTime.isValid() && resultFileInfo.lastModified() <= resultFileLastModifiedDateTime)) {
+    return false;
+  }
+  QString errorString;
+  int lastTimePointsCount;
+  MatResultFile *pMatResultFile = mMatResultFilesCache.getGrowingMatResultFile(filePath, &lastTimePointsCount, &errorString);
+  if (!pMatResultFile) {
+    return false;
+  }
+  if (!mpVariablesTreeModel->findVariablesTreeItem(fileName, mpVariablesTreeModel->getRootVariablesTreeItem())) {
+    QStringList variables = pMatResultFile->getVariables();
+    variables.sort();
+    insertVariablesItemsToTree(fileName, simulationOptions.getWorkingDirectory(), variables, simulationOptions);
+    return true;
+  }
+  int timePointsCount = pMatResultFile->getTimePointsCount();
+  foreach (QMdiSubWindow *pSubWindow, mpMainWindow->getPlotWindowContainer()->subWindowList(QMdiArea::StackingOrder)) {
+    PlotWindow *pPlotWindow = qobject_cast<PlotWindow*>(pSubWindow->widget());
+    if (!pPlotWindow || pPlotWindow->getPlotType() != PlotWindow::PLOT) {
+      continue;
+    }
+    // the curves with the time points of the last update get the new time points and the other curves are read again.
+    QList<PlotCurve*> appendPlotCurves, readPlotCurves;
+    QStringList appendVariables("time"), readVariables("time");
+    foreach (PlotCurve *pPlotCurve, pPlotWindow->getPlot()->getPlotCurvesList()) {
+      if (pPlotCurve->getFileName().compare(fileName) != 0) {
+        continue;
+      }
+      VariablesTreeItem *pVariablesTreeItem = mpVariablesTreeModel->findVariablesTreeItem(pPlotCurve->getNameStructure(),
+                                                                                           mpVariablesTreeModel->getRootVariablesTreeItem());
+      if (!pVariablesTreeItem) {
+        continue;
+      }
+      if (lastTimePointsCount > 0 && pPlotCurve->getSize() == lastTimePointsCount) {
+        if (timePointsCount > lastTimePointsCount) {
+          appendPlotCurves.append(pPlotCurve);
+          appendVariables.append(pVariablesTreeItem->getPlotVariable());
+        }
+      } else {
+        readPlotCurves.append(pPlotCurve);
+        readVariables.append(pVariablesTreeItem->getPlotVariable());
+      }
+    }
+    if (appendPlotCurves.isEmpty() && readPlotCurves.isEmpty()) {
+      continue;
+    }
+    QHash<QString, QVector<double> > valuesHash;
+    if (!appendPlotCurves.isEmpty()) {
+      pMatResultFile->readVariables(appendVariables, &valuesHash, lastTimePointsCount);
+      QVector<double> timeValues = valuesHash.value("time");
+      for (int i = 0 ; i < appendPlotCurves.size() ; i++) {
+        PlotCurve *pPlotCurve = appendPlotCurves.at(i);
+        QVector<double> values = valuesHash.value(appendVariables.at(i + 1));
+        if (timeValues.isEmpty() || values.size() != timeValues.size()) {
+          continue;
+        }
+        for (int j = 0 ; j < timeValues.size() ; j++) {
+          pPlotCurve->addXAxisValue(timeValues.at(j));
+          pPlotCurve->addYAxisValue(values.at(j));
+        }
+        pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+      }
+    }
+    if (!readPlotCurves.isEmpty()) {
+      valuesHash.clear();
+      pMatResultFile->readVariables(readVariables, &valuesHash);
+      QVector<double> timeValues = valuesHash.value("time");
+      for (int i = 0 ; i < readPlotCurves.size() ; i++) {
+        PlotCurve *pPlotCurve = readPlotCurves.at(i);
+        if (!valuesHash.contains("time") || !valuesHash.contains(readVariables.at(i + 1))) {
+          continue;
+        }
+        pPlotCurve->setXAxisVector(timeValues);
+        pPlotCurve->setYAxisVector(valuesHash.value(readVariables.at(i + 1)));
+        pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+      }
+    }
+    PlotCurveDecimator::getPlotCurveDecimator(pPlotWindow)->decimatePlotCurves();
+    if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+      pPlotWindow->fitInView();
+    } else {
+      pPlotWindow->getPlot()->replot();
+    }
+  }
+  return false;
+}
+
 void VariablesWidget::variablesUpdated()
 {
   foreach (QMdiSubWindow *pSubWindow, mpMainWindow->getPlotWindowContainer()->subWindowList(QMdiArea::StackingOrder))
   {
     PlotWindow *pPlotWindow = qobject_cast<PlotWindow*>(pSubWindow->widget());
+    // the curves of the plot windows are re-read in one batch.
+    QList<VariablesTreeItem*> variablesTreeItems;
     foreach (PlotCurve *pPlotCurve, pPlotWindow->getPlot()->getPlotCurvesList())
     {
       if (pPlotWindow->getPlotType() == PlotWindow::PLOT)
@@ -854,10 +1104,9 @@ void VariablesWidget::variablesUpdated()
         if (pVariableTreeItem)
         {
           bool state = mpVariablesTreeModel->blockSignals(true);
-          QModelIndex index = mpVariablesTreeModel->variablesTreeItemIndex(pVariableTreeItem);
-          mpVariablesTreeModel->setData(index, Qt::Checked, Qt::CheckStateRole);
-          plotVariables(index, pPlotCurve->getCurveWidth(), pPlotCurve->getCurveStyle(), pPlotCurve, pPlotWindow);
+          mpVariablesTreeModel->setData(mpVariablesTreeModel->variablesTreeItemIndex(pVariableTreeItem), Qt::Checked, Qt::CheckStateRole);
           mpVariablesTreeModel->blockSignals(state);
+          variablesTreeItems.append(pVariableTreeItem);
         }
         else
         {
@@ -891,7 +1140,9 @@ void VariablesWidget::variablesUpdated()
         }
       }
     }
-    if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+    if (!variablesTreeItems.isEmpty()) {
+      plotVariablesList(variablesTreeItems, pPlotWindow);
+    } else if (pPlotWindow->getAutoScaleButton()->isChecked()) {
       pPlotWindow->fitInView();
     } else {
       pPlotWindow->getPlot()->replot();
@@ -1005,6 +1256,12 @@ void VariablesWidget::reSimulate(bool showSetup)
   index = mpVariableTreeProxyModel->mapToSource(index);
   VariablesTreeItem *pVariablesTreeItem = static_cast<VariablesTreeItem*>(index.internalPointer());
   pVariablesTreeItem = pVariablesTreeItem->rootParent();
+  // the item of a parameter sweep only groups the results of the sweep.
+  if (!pVariablesTreeItem->isRootItem()) {
+    QMessageBox::information(this, QString(Helper::applicationName).append(" - ").append(Helper::information),
+                             tr("You must select a class to re-simulate."), Helper::ok);
+    return;
+  }
   SimulationOptions simulationOptions = pVariablesTreeItem->getSimulationOptions();
   if (simulationOptions.isValid()) {
     simulationOptions.setReSimulate(true);
@@ -1058,6 +1315,156 @@ void VariablesWidget::updateInitXmlFile(SimulationOptions simulationOptions)
   }
 }
 
+/*!
+ * \brief VariablesWidget::plotMatResultVariable
+ * Plots the variable of a mat result file. Only the time and the variable trajectories are read from the file.
+ * \param pVariablesTreeItem
+ * \param curveThickness
+ * \param curveStyle
+ * \param pPlotCurve - the existing curve of the variable or 0.
+ * \param pPlotWindow
+ * \return false if the variable is not in a mat result file or can't be read.
+ */
+bool VariablesWidget::plotMatResultVariable(VariablesTreeItem *pVariablesTreeItem, qreal curveThickness, int curveStyle, PlotCurve *pPlotCurve,
+                                            PlotWindow *pPlotWindow)
+{
+  if (!pVariablesTreeItem->getFileName().endsWith(".mat")) {
+    return false;
+  }
+  QString errorString;
+  MatResultFile *pMatResultFile = mMatResultFilesCache.getMatResultFile(QString(pVariablesTreeItem->getFilePath()).append("/")
+                                                                        .append(pVariablesTreeItem->getFileName()), &errorString);
+  QVector<double> timeValues, values;
+  if (!pMatResultFile || !pMatResultFile->readVariable("time", &timeValues)
+      || !pMatResultFile->readVariable(pVariablesTreeItem->getPlotVariable(), &values)) {
+    return false;
+  }
+  setMatResultPlotCurve(pVariablesTreeItem, curveThickness, curveStyle, pPlotCurve, pPlotWindow, timeValues, values);
+  return true;
+}
+
+/*!
+ * \brief VariablesWidget::setMatResultPlotCurve
+ * Sets the trajectory of the variable on its curve. Creates the curve if it doesn't exist.
+ * \param pVariablesTreeItem
+ * \param curveThickness
+ * \param curveStyle
+ * \param pPlotCurve - the existing curve of the variable or 0.
+ * \param pPlotWindow
+ * \param timeValues
+ * \param values
+ */
+void VariablesWidget::setMatResultPlotCurve(VariablesTreeItem *pVariablesTreeItem, qreal curveThickness, int curveStyle, PlotCurve *pPlotCurve,
+                                            PlotWindow *pPlotWindow, const QVector<double> &timeValues, const QVector<double> &values)
+{
+  if (!pPlotCurve) {
+    pPlotCurve = new PlotCurve(pVariablesTreeItem->getFileName(), pVariablesTreeItem->getPlotVariable(), pVariablesTreeItem->getUnit(),
+                               pPlotWindow->getPlot());
+    pPlotWindow->getPlot()->addPlotCurve(pPlotCurve);
+  }
+  pPlotCurve->setCurveWidth(curveThickness);
+  pPlotCurve->setCurveStyle(curveStyle);
+  pPlotCurve->setXAxisVector(timeValues);
+  pPlotCurve->setYAxisVector(values);
+  pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
+  pPlotCurve->attach(pPlotWindow->getPlot());
+}
+
+/*!
+ * \brief VariablesWidget::plotVariablesList
+ * Plots the checked variables in one batch. The trajectories of the variables of a mat result file are read in one pass over the
+ * file and the plot is fitted in view or replotted once at the end. The existing curves of the variables are updated and keep
+ * their width and style.\n
+ * The parametric plots pair the variables so they are plotted one by one.
+ * \param variablesTreeItems
+ * \param pPlotWindow
+ */
+void VariablesWidget::plotVariablesList(QList<VariablesTreeItem*> variablesTreeItems, PlotWindow *pPlotWindow)
+{
+  if (variablesTreeItems.isEmpty()) {
+    return;
+  }
+  if (pPlotWindow->getPlotType() != PlotWindow::PLOT) {
+    foreach (VariablesTreeItem *pVariablesTreeItem, variablesTreeItems) {
+      plotVariables(mpVariablesTreeModel->variablesTreeItemIndex(pVariablesTreeItem), pPlotWindow->getCurveWidth(),
+                    pPlotWindow->getCurveStyle(), 0, pPlotWindow);
+    }
+    return;
+  }
+  QHash<QString, PlotCurve*> plotCurvesHash;
+  foreach (PlotCurve *pPlotCurve, pPlotWindow->getPlot()->getPlotCurvesList()) {
+    plotCurvesHash.insert(pPlotCurve->getNameStructure(), pPlotCurve);
+  }
+  // group the variables by the result file.
+  QStringList fileNames;
+  QHash<QString, QList<VariablesTreeItem*> > fileVariablesHash;
+  foreach (VariablesTreeItem *pVariablesTreeItem, variablesTreeItems) {
+    QString fileName = QString(pVariablesTreeItem->getFilePath()).append("/").append(pVariablesTreeItem->getFileName());
+    if (!fileVariablesHash.contains(fileName)) {
+      fileNames.append(fileName);
+    }
+    fileVariablesHash[fileName].append(pVariablesTreeItem);
+  }
+  qreal curveThickness = pPlotWindow->getCurveWidth();
+  int curveStyle = pPlotWindow->getCurveStyle();
+  try
+  {
+    foreach (QString fileName, fileNames) {
+      QList<VariablesTreeItem*> fileVariablesTreeItems = fileVariablesHash.value(fileName);
+      QList<VariablesTreeItem*> otherVariablesTreeItems;
+      QHash<QString, QVector<double> > valuesHash;
+      if (fileName.endsWith(".mat")) {
+        QString errorString;
+        MatResultFile *pMatResultFile = mMatResultFilesCache.getMatResultFile(fileName, &errorString);
+        if (pMatResultFile) {
+          QStringList variables("time");
+          foreach (VariablesTreeItem *pVariablesTreeItem, fileVariablesTreeItems) {
+            variables.append(pVariablesTreeItem->getPlotVariable());
+          }
+          pMatResultFile->readVariables(variables, &valuesHash);
+        }
+      }
+      foreach (VariablesTreeItem *pVariablesTreeItem, fileVariablesTreeItems) {
+        if (!valuesHash.contains("time") || !valuesHash.contains(pVariablesTreeItem->getPlotVariable())) {
+          otherVariablesTreeItems.append(pVariablesTreeItem);
+          continue;
+        }
+        PlotCurve *pPlotCurve = plotCurvesHash.value(pVariablesTreeItem->getVariableName(), 0);
+        setMatResultPlotCurve(pVariablesTreeItem, pPlotCurve ? pPlotCurve->getCurveWidth() : curveThickness,
+                              pPlotCurve ? pPlotCurve->getCurveStyle() : curveStyle, pPlotCurve, pPlotWindow, valuesHash.value("time"),
+                              valuesHash.value(pVariablesTreeItem->getPlotVariable()));
+      }
+      // the other result files are read by the plot window.
+      if (!otherVariablesTreeItems.isEmpty()) {
+        pPlotWindow->initializeFile(fileName);
+        foreach (VariablesTreeItem *pVariablesTreeItem, otherVariablesTreeItems) {
+          PlotCurve *pPlotCurve = plotCurvesHash.value(pVariablesTreeItem->getVariableName(), 0);
+          pPlotWindow->setCurveWidth(pPlotCurve ? pPlotCurve->getCurveWidth() : curveThickness);
+          pPlotWindow->setCurveStyle(pPlotCurve ? pPlotCurve->getCurveStyle() : curveStyle);
+          pPlotWindow->setUnit(pVariablesTreeItem->getUnit());
+          pPlotWindow->setVariablesList(QStringList(pVariablesTreeItem->getPlotVariable()));
+          pPlotWindow->plot(pPlotCurve);
+        }
+        pPlotWindow->setCurveWidth(curveThickness);
+        pPlotWindow->setCurveStyle(curveStyle);
+      }
+    }
+  }
+  catch (PlotException &e)
+  {
+    QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error), e.what(), Helper::ok);
+  }
+  PlotCurveDecimator::getPlotCurveDecimator(pPlotWindow)->decimatePlotCurves();
+  if (pPlotWindow->getAutoScaleButton()->isChecked()) {
+    pPlotWindow->fitInView();
+  } else {
+    pPlotWindow->getPlot()->replot();
+    if (pPlotWindow->getPlot()->getPlotZoomer()->zoomStack().size() == 1) {
+      pPlotWindow->getPlot()->getPlotZoomer()->setZoomBase(false);
+    }
+  }
+}
+
 void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickness, int curveStyle, PlotCurve *pPlotCurve,
                                     PlotWindow *pPlotWindow)
 {
@@ -1095,12 +1502,16 @@ void VariablesWidget::plotVariables(const QModelIndex &index, qreal curveThickne
       // check the item checkstate
       if (pVariablesTreeItem->isChecked())
       {
-        pPlotWindow->initializeFile(QString(pVariablesTreeItem->getFilePath()).append("/").append(pVariablesTreeItem->getFileName()));
         pPlotWindow->setCurveWidth(curveThickness);
         pPlotWindow->setCurveStyle(curveStyle);
-        pPlotWindow->setVariablesList(QStringList(pVariablesTreeItem->getPlotVariable()));
         pPlotWindow->setUnit(pVariablesTreeItem->getUnit());
-        pPlotWindow->plot(pPlotCurve);
+        /* the mat result files are read by the shared MatResultFile. The other result files are read by the plot window. */
+        if (!plotMatResultVariable(pVariablesTreeItem, curveThickness, curveStyle, pPlotCurve, pPlotWindow)) {
+          pPlotWindow->initializeFile(QString(pVariablesTreeItem->getFilePath()).append("/").append(pVariablesTreeItem->getFileName()));
+          pPlotWindow->setVariablesList(QStringList(pVariablesTreeItem->getPlotVariable()));
+          pPlotWindow->plot(pPlotCurve);
+        }
+        PlotCurveDecimator::getPlotCurveDecimator(pPlotWindow)->decimatePlotCurves();
         if (pPlotWindow->getAutoScaleButton()->isChecked()) {
           pPlotWindow->fitInView();
         } else {
@@ -1320,11 +1731,17 @@ void VariablesWidget::showContextMenu(QPoint point)
     QAction *pReSimulateSetupAction = new QAction(QIcon(":/Resources/icons/re-simulation-center.svg"), Helper::reSimulateSetup, this);
     pReSimulateSetupAction->setStatusTip(Helper::reSimulateSetupTip);
     connect(pReSimulateSetupAction, SIGNAL(triggered()), this, SLOT(showReSimulateSetup()));
+    /* parameter sweep action */
+    QAction *pParameterSweepAction = new QAction(Helper::parameterSweep, this);
+    pParameterSweepAction->setData(pVariablesTreeItem->getVariableName());
+    pParameterSweepAction->setStatusTip(Helper::parameterSweepTip);
+    connect(pParameterSweepAction, SIGNAL(triggered()), this, SLOT(showParameterSweepDialog()));
 
     QMenu menu(this);
     menu.addAction(pDeleteResultAction);
     menu.addAction(pReSimulateAction);
     menu.addAction(pReSimulateSetupAction);
+    menu.addAction(pParameterSweepAction);
     point.setY(point.y() + adjust);
     menu.exec(mpVariablesTreeView->mapToGlobal(point));
   }
@@ -1355,3 +1772,28 @@ void VariablesWidget::showReSimulateSetup()
 {
   reSimulate(true);
 }
+
+/*!
+ * \brief VariablesWidget::showParameterSweepDialog
+ * Slot activated when pParameterSweepAction triggered signal is raised.\n
+ * Opens the ParameterSweepDialog for the result file.
+ */
+void VariablesWidget::showParameterSweepDialog()
+{
+  QAction *pAction = qobject_cast<QAction*>(sender());
+  if (!pAction) {
+    return;
+  }
+  VariablesTreeItem *pVariablesTreeItem = mpVariablesTreeModel->findVariablesTreeItem(pAction->data().toString(),
+                                                                                      mpVariablesTreeModel->getRootVariablesTreeItem());
+  if (!pVariablesTreeItem) {
+    return;
+  }
+  if (pVariablesTreeItem->getSimulationOptions().isValid()) {
+    ParameterSweepDialog *pParameterSweepDialog = new ParameterSweepDialog(pVariablesTreeItem, this);
+    pParameterSweepDialog->exec();
+  } else {
+    QMessageBox::information(this, QString(Helper::applicationName).append(" - ").append(Helper::information),
+                             tr("You cannot re-simulate this class.<br />This is just a result file loaded via menu <b>File->Open Result File(s)</b>."), Helper::ok);
+  }
+}
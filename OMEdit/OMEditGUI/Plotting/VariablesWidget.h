@@ -42,6 +42,8 @@
 #include "MainWindow.h"
 #include "SimulationDialog.h"
 #include "PlotWindow.h"
+#include "MatResultFile.h"
+#include "PlotCurveDecimator.h"
 
 class MainWindow;
 class VariablesTreeItem
@@ -77,6 +79,7 @@ public:
 private:
   QList<VariablesTreeItem*> mChildren;
   VariablesTreeItem *mpParentVariablesTreeItem;
+  int mRow;
   bool mIsRootItem;
   QString mFilePath;
   QString mFileName;
@@ -109,20 +112,24 @@ public:
   QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const;
   Qt::ItemFlags flags(const QModelIndex &index) const;
   VariablesTreeItem* findVariablesTreeItem(const QString &name, VariablesTreeItem *root) const;
+  QList<VariablesTreeItem*> getResultVariablesTreeItems() const;
+  VariablesTreeItem* getParameterSweepVariablesTreeItem(SimulationOptions simulationOptions);
   QModelIndex variablesTreeItemIndex(const VariablesTreeItem *pVariablesTreeItem) const;
-  QModelIndex variablesTreeItemIndexHelper(const VariablesTreeItem *pVariablesTreeItem, const VariablesTreeItem *pParentVariablesTreeItem,
-                                           const QModelIndex &parentIndex) const;
   void parseInitXml(QXmlStreamReader &xmlReader);
   QHash<QString, QString> parseScalarVariable(QXmlStreamReader &xmlReader);
   void insertVariablesItems(QString fileName, QString filePath, QStringList variablesList, SimulationOptions simulationOptions);
   bool removeVariableTreeItem(QString variable);
   void unCheckVariables(VariablesTreeItem *pVariablesTreeItem);
   void plotAllVariables(VariablesTreeItem *pVariablesTreeItem, OMPlot::PlotWindow *pPlotWindow);
+  void getLeafVariablesTreeItems(VariablesTreeItem *pVariablesTreeItem, QList<VariablesTreeItem*> *pVariablesTreeItems);
 private:
   VariablesTreeView *mpVariablesTreeView;
   VariablesTreeItem *mpRootVariablesTreeItem;
   QHash<QString, QHash<QString,QString> > mScalarVariablesList;
-  void getVariableInformation(ModelicaMatReader *pMatReader, QString variableToFind, QString *value, bool *changeAble, QString *unit,
+  QHash<QString, QHash<QString, VariablesTreeItem*> > mVariablesTreeItemsHash;
+  void addToVariablesTreeItemsHash(VariablesTreeItem *pVariablesTreeItem);
+  void removeFromVariablesTreeItemsHash(VariablesTreeItem *pVariablesTreeItem);
+  void getVariableInformation(MatResultFile *pMatResultFile, QString variableToFind, QString *value, bool *changeAble, QString *unit,
                               QString *displayUnit, QString *description);
 signals:
   void itemChecked(const QModelIndex &index, qreal curveThickness, int curveStyle);
@@ -163,6 +170,7 @@ public:
   VariableTreeProxyModel* getVariableTreeProxyModel() {return mpVariableTreeProxyModel;}
   VariablesTreeModel* getVariablesTreeModel() {return mpVariablesTreeModel;}
   VariablesTreeView* getVariablesTreeView() {return mpVariablesTreeView;}
+  MatResultFilesCache* getMatResultFilesCache() {return &mMatResultFilesCache;}
   void insertVariablesItemsToTree(QString fileName, QString filePath, QStringList variablesList, SimulationOptions simulationOptions);
   void variablesUpdated();
   void updateVariablesTreeHelper(QMdiSubWindow *pSubWindow);
@@ -171,6 +179,8 @@ public:
   void findVariableAndUpdateValue(QDomDocument xmlDocument, QHash<QString, QHash<QString, QString> > variables);
   void reSimulate(bool showSetup);
   void updateInitXmlFile(SimulationOptions simulationOptions);
+  bool updateVariablesWhileSimulating(SimulationOptions simulationOptions, QDateTime resultFileLastModifiedDateTime);
+  void plotVariablesList(QList<VariablesTreeItem*> variablesTreeItems, OMPlot::PlotWindow *pPlotWindow);
 private:
   MainWindow *mpMainWindow;
   QLineEdit *mpFindVariablesTextBox;
@@ -184,6 +194,12 @@ private:
   QList<QStringList> mPlotParametricVariables;
   QString mFileName;
   QMdiSubWindow *mpLastActiveSubWindow;
+  MatResultFilesCache mMatResultFilesCache;
+
+  bool plotMatResultVariable(VariablesTreeItem *pVariablesTreeItem, qreal curveThickness, int curveStyle, OMPlot::PlotCurve *pPlotCurve,
+                             OMPlot::PlotWindow *pPlotWindow);
+  void setMatResultPlotCurve(VariablesTreeItem *pVariablesTreeItem, qreal curveThickness, int curveStyle, OMPlot::PlotCurve *pPlotCurve,
+                             OMPlot::PlotWindow *pPlotWindow, const QVector<double> &timeValues, const QVector<double> &values);
 public slots:
   void plotVariables(const QModelIndex &index, qreal curveThickness, int curveStyle, OMPlot::PlotCurve *pPlotCurve = 0,
                      OMPlot::PlotWindow *pPlotWindow = 0);
@@ -192,6 +208,7 @@ public slots:
   void findVariables();
   void directReSimulate();
   void showReSimulateSetup();
+  void showParameterSweepDialog();
 };
 
 #endif // VARIABLESWIDGET_H
@@ -0,0 +1,399 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include "ParameterSweepDialog.h"
+#include "VariablesWidget.h"
+
+/*!
+ * \class ParameterSweepDialog
+ * \brief Re-simulates an already built model for a set of parameter values.
+ * The values are generated from the ranges of the selected parameters either as a full factorial grid or as a latin hypercube.
+ * Each run passes its values with the -override flag so the _init.xml file is written only once for the whole sweep.
+ * The runs are queued in the SimulationJobScheduler and use the same executable.
+ */
+/*!
+ * \brief ParameterSweepDialog::ParameterSweepDialog
+ * \param pVariablesTreeItem - the result file item of the Variables Browser.
+ * \param pVariablesWidget
+ */
+ParameterSweepDialog::ParameterSweepDialog(VariablesTreeItem *pVariablesTreeItem, VariablesWidget *pVariablesWidget)
+  : QDialog(pVariablesWidget->getMainWindow(), Qt::WindowTitleHint), mpVariablesWidget(pVariablesWidget)
+{
+  mSimulationOptions = pVariablesTreeItem->getSimulationOptions();
+  setWindowTitle(QString(Helper::applicationName).append(" - ").append(Helper::parameterSweep).append(" - ")
+                 .append(mSimulationOptions.getClassName()));
+  setAttribute(Qt::WA_DeleteOnClose);
+  setMinimumWidth(550);
+  // heading
+  mpHeadingLabel = new Label(QString("%1 - %2").arg(Helper::parameterSweep).arg(pVariablesTreeItem->getVariableName()));
+  mpHeadingLabel->setElideMode(Qt::ElideMiddle);
+  mpHeadingLabel->setFont(QFont(Helper::systemFontInfo.family(), Helper::headingFontSize));
+  // horizontal separator
+  mpHorizontalLine = new QFrame();
+  mpHorizontalLine->setFrameShape(QFrame::HLine);
+  mpHorizontalLine->setFrameShadow(QFrame::Sunken);
+  // parameters table
+  mpParametersTableWidget = new QTableWidget(0, 4);
+  QStringList headerLabels;
+  headerLabels << tr("Parameter") << tr("Value") << tr("Minimum") << tr("Maximum");
+  mpParametersTableWidget->setHorizontalHeaderLabels(headerLabels);
+  mpParametersTableWidget->verticalHeader()->setVisible(false);
+  mpParametersTableWidget->horizontalHeader()->setStretchLastSection(true);
+  addParameters(pVariablesTreeItem);
+  mpParametersTableWidget->resizeColumnToContents(0);
+  connect(mpParametersTableWidget, SIGNAL(itemChanged(QTableWidgetItem*)), SLOT(updateRunsCount()));
+  // design
+  mpDesignLabel = new Label(tr("Design:"));
+  mpDesignComboBox = new QComboBox;
+  mpDesignComboBox->addItem(tr("Full Factorial Grid"), ParameterSweepDialog::FullFactorial);
+  mpDesignComboBox->addItem(tr("Latin Hypercube"), ParameterSweepDialog::LatinHypercube);
+  connect(mpDesignComboBox, SIGNAL(currentIndexChanged(int)), SLOT(updateRunsCount()));
+  mpStepsLabel = new Label(tr("Values per Parameter:"));
+  mpStepsSpinBox = new QSpinBox;
+  mpStepsSpinBox->setRange(2, 1000);
+  mpStepsSpinBox->setValue(3);
+  connect(mpStepsSpinBox, SIGNAL(valueChanged(int)), SLOT(updateRunsCount()));
+  mpSamplesLabel = new Label(tr("Number of Samples:"));
+  mpSamplesSpinBox = new QSpinBox;
+  mpSamplesSpinBox->setRange(1, 100000);
+  mpSamplesSpinBox->setValue(10);
+  connect(mpSamplesSpinBox, SIGNAL(valueChanged(int)), SLOT(updateRunsCount()));
+  mpRunsLabel = new Label;
+  // buttons
+  mpRunButton = new QPushButton(tr("Run"));
+  mpRunButton->setAutoDefault(true);
+  connect(mpRunButton, SIGNAL(clicked()), SLOT(runParameterSweep()));
+  mpCancelButton = new QPushButton(Helper::cancel);
+  mpCancelButton->setAutoDefault(false);
+  connect(mpCancelButton, SIGNAL(clicked()), SLOT(reject()));
+  mpButtonBox = new QDialogButtonBox(Qt::Horizontal);
+  mpButtonBox->addButton(mpRunButton, QDialogButtonBox::ActionRole);
+  mpButtonBox->addButton(mpCancelButton, QDialogButtonBox::ActionRole);
+  // layout
+  QGridLayout *pMainLayout = new QGridLayout;
+  pMainLayout->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+  pMainLayout->addWidget(mpHeadingLabel, 0, 0, 1, 2);
+  pMainLayout->addWidget(mpHorizontalLine, 1, 0, 1, 2);
+  pMainLayout->addWidget(mpParametersTableWidget, 2, 0, 1, 2);
+  pMainLayout->addWidget(mpDesignLabel, 3, 0);
+  pMainLayout->addWidget(mpDesignComboBox, 3, 1);
+  pMainLayout->addWidget(mpStepsLabel, 4, 0);
+  pMainLayout->addWidget(mpStepsSpinBox, 4, 1);
+  pMainLayout->addWidget(mpSamplesLabel, 5, 0);
+  pMainLayout->addWidget(mpSamplesSpinBox, 5, 1);
+  pMainLayout->addWidget(mpRunsLabel, 6, 0, 1, 2);
+  pMainLayout->addWidget(mpButtonBox, 7, 0, 1, 2, Qt::AlignRight);
+  setLayout(pMainLayout);
+  updateRunsCount();
+}
+
+/*!
+ * \brief ParameterSweepDialog::addParameters
+ * Adds the editable variables of the result file to the parameters table.
+ * \param pVariablesTreeItem
+ */
+void ParameterSweepDialog::addParameters(VariablesTreeItem *pVariablesTreeItem)
+{
+  foreach (VariablesTreeItem *pChildVariablesTreeItem, pVariablesTreeItem->getChildren()) {
+    if (pChildVariablesTreeItem->getChildren().isEmpty()) {
+      if (!pChildVariablesTreeItem->isEditable()) {
+        continue;
+      }
+      QString value = pChildVariablesTreeItem->data(1, Qt::DisplayRole).toString();
+      int row = mpParametersTableWidget->rowCount();
+      mpParametersTableWidget->insertRow(row);
+      QTableWidgetItem *pParameterItem = new QTableWidgetItem(pChildVariablesTreeItem->getPlotVariable());
+      pParameterItem->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+      pParameterItem->setCheckState(Qt::Unchecked);
+      pParameterItem->setToolTip(pChildVariablesTreeItem->getPlotVariable());
+      mpParametersTableWidget->setItem(row, 0, pParameterItem);
+      QTableWidgetItem *pValueItem = new QTableWidgetItem(value);
+      pValueItem->setFlags(Qt::ItemIsEnabled);
+      mpParametersTableWidget->setItem(row, 1, pValueItem);
+      mpParametersTableWidget->setItem(row, 2, new QTableWidgetItem(value));
+      mpParametersTableWidget->setItem(row, 3, new QTableWidgetItem(value));
+    } else {
+      addParameters(pChildVariablesTreeItem);
+    }
+  }
+}
+
+/*!
+ * \brief ParameterSweepDialog::getSelectedParametersCount
+ * \return the number of checked parameters.
+ */
+int ParameterSweepDialog::getSelectedParametersCount()
+{
+  int count = 0;
+  for (int i = 0 ; i < mpParametersTableWidget->rowCount() ; i++) {
+    if (mpParametersTableWidget->item(i, 0)->checkState() == Qt::Checked) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/*!
+ * \brief ParameterSweepDialog::getRunsCount
+ * \return the number of simulation runs of the sweep.
+ */
+int ParameterSweepDialog::getRunsCount()
+{
+  int parametersCount = getSelectedParametersCount();
+  if (parametersCount == 0) {
+    return 0;
+  }
+  if (mpDesignComboBox->itemData(mpDesignComboBox->currentIndex()).toInt() == ParameterSweepDialog::LatinHypercube) {
+    return mpSamplesSpinBox->value();
+  }
+  // limit the full factorial grid so the count doesn't overflow.
+  return (int)qMin(qPow(mpStepsSpinBox->value(), parametersCount), 1.0e9);
+}
+
+/*!
+ * \brief ParameterSweepDialog::generateSamples
+ * Generates the parameter values of every run.
+ * \param minimums
+ * \param maximums
+ * \return the list of runs. Each run contains the values of the selected parameters.
+ */
+QList<QStringList> ParameterSweepDialog::generateSamples(QList<double> minimums, QList<double> maximums)
+{
+  QList<QStringList> samples;
+  int parametersCount = minimums.size();
+  int runs = getRunsCount();
+  if (mpDesignComboBox->itemData(mpDesignComboBox->currentIndex()).toInt() == ParameterSweepDialog::LatinHypercube) {
+    // divide every range into runs intervals and pick each interval exactly once in random order.
+    QList<QList<int> > intervals;
+    for (int p = 0 ; p < parametersCount ; p++) {
+      QList<int> permutation;
+      for (int i = 0 ; i < runs ; i++) {
+        permutation.append(i);
+      }
+      for (int i = runs - 1 ; i > 0 ; i--) {
+        permutation.swap(i, qrand() % (i + 1));
+      }
+      intervals.append(permutation);
+    }
+    for (int i = 0 ; i < runs ; i++) {
+      QStringList values;
+      for (int p = 0 ; p < parametersCount ; p++) {
+        double position = (intervals.at(p).at(i) + (double)qrand() / ((double)RAND_MAX + 1.0)) / runs;
+        values.append(QString::number(minimums.at(p) + (maximums.at(p) - minimums.at(p)) * position, 'g', 15));
+      }
+      samples.append(values);
+    }
+  } else {
+    int steps = mpStepsSpinBox->value();
+    for (int i = 0 ; i < runs ; i++) {
+      QStringList values;
+      int index = i;
+      for (int p = 0 ; p < parametersCount ; p++) {
+        double position = (double)(index % steps) / (steps - 1);
+        index /= steps;
+        values.append(QString::number(minimums.at(p) + (maximums.at(p) - minimums.at(p)) * position, 'g', 15));
+      }
+      samples.append(values);
+    }
+  }
+  return samples;
+}
+
+/*!
+ * \brief ParameterSweepDialog::getSweepName
+ * \return a name for the sweep which is not used in the working directory.
+ */
+QString ParameterSweepDialog::getSweepName()
+{
+  for (int i = 1 ; ; i++) {
+    QString sweepName = QString("%1_sweep%2").arg(mSimulationOptions.getOutputFileName()).arg(i);
+    if (!QFile::exists(QString("%1/%2.csv").arg(mSimulationOptions.getWorkingDirectory()).arg(sweepName))) {
+      return sweepName;
+    }
+  }
+  return QString();
+}
+
+/*!
+ * \brief ParameterSweepDialog::getResultFileName
+ * \param sweepName
+ * \param run
+ * \return the result file name of the run.
+ */
+QString ParameterSweepDialog::getResultFileName(QString sweepName, int run)
+{
+  return QString("%1_%2_res.%3").arg(sweepName).arg(run).arg(mSimulationOptions.getOutputFormat());
+}
+
+/*!
+ * \brief ParameterSweepDialog::writeSweepSummary
+ * Writes the result file and the parameter values of every run to a csv file.
+ * \param fileName
+ * \param parameters
+ * \param samples
+ * \return true on success.
+ */
+bool ParameterSweepDialog::writeSweepSummary(QString fileName, QStringList parameters, QList<QStringList> samples)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    MessagesWidget *pMessagesWidget = mpVariablesWidget->getMainWindow()->getMessagesWidget();
+    pMessagesWidget->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                               GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(file.fileName())
+                                               .arg(file.errorString()), Helper::scriptingKind, Helper::errorLevel));
+    return false;
+  }
+  QTextStream textStream(&file);
+  textStream.setCodec(Helper::utf8.toStdString().data());
+  textStream.setGenerateByteOrderMark(false);
+  textStream << "\"run\",\"resultFile\",\"" << parameters.join("\",\"") << "\"\n";
+  QString sweepName = QFileInfo(fileName).completeBaseName();
+  for (int i = 0 ; i < samples.size() ; i++) {
+    textStream << i + 1 << ",\"" << getResultFileName(sweepName, i + 1) << "\"," << samples.at(i).join(",") << "\n";
+  }
+  file.close();
+  return true;
+}
+
+/*!
+ * \brief ParameterSweepDialog::createSimulationFlags
+ * Adds the parameter values to the -override flag and sets the result file of the run.
+ * \param parameters
+ * \param values
+ * \param resultFileName
+ * \return the simulation flags of the run.
+ */
+QStringList ParameterSweepDialog::createSimulationFlags(QStringList parameters, QStringList values, QString resultFileName)
+{
+  QStringList overrides;
+  for (int i = 0 ; i < parameters.size() ; i++) {
+    overrides.append(QString("%1=%2").arg(parameters.at(i)).arg(values.at(i)));
+  }
+  QStringList simulationFlags = mSimulationOptions.getSimulationFlags();
+  bool overrideFound = false;
+  for (int i = 0 ; i < simulationFlags.size() ; i++) {
+    if (simulationFlags.at(i).startsWith("-override=")) {
+      simulationFlags[i] = simulationFlags.at(i) + "," + overrides.join(",");
+      overrideFound = true;
+    } else if (simulationFlags.at(i).startsWith("-r=")) {
+      simulationFlags[i] = "-r=" + resultFileName;
+    }
+  }
+  if (!overrideFound) {
+    simulationFlags.append("-override=" + overrides.join(","));
+  }
+  return simulationFlags;
+}
+
+/*!
+ * \brief ParameterSweepDialog::updateRunsCount
+ * Slot activated when a parameter is checked, the design or its size is changed.\n
+ * Shows the number of runs of the sweep.
+ */
+void ParameterSweepDialog::updateRunsCount()
+{
+  bool latinHypercube = mpDesignComboBox->itemData(mpDesignComboBox->currentIndex()).toInt() == ParameterSweepDialog::LatinHypercube;
+  mpStepsSpinBox->setEnabled(!latinHypercube);
+  mpSamplesSpinBox->setEnabled(latinHypercube);
+  int runs = getRunsCount();
+  mpRunsLabel->setText(tr("Number of runs: %1").arg(runs));
+  mpRunButton->setEnabled(runs > 0);
+}
+
+/*!
+ * \brief ParameterSweepDialog::runParameterSweep
+ * Slot activated when mpRunButton clicked signal is raised.\n
+ * Generates the runs of the sweep and queues them for re-simulation.
+ */
+void ParameterSweepDialog::runParameterSweep()
+{
+  const int maximumRuns = 10000;
+  QStringList parameters;
+  QList<double> minimums, maximums;
+  for (int i = 0 ; i < mpParametersTableWidget->rowCount() ; i++) {
+    if (mpParametersTableWidget->item(i, 0)->checkState() != Qt::Checked) {
+      continue;
+    }
+    bool minimumOk, maximumOk;
+    double minimum = mpParametersTableWidget->item(i, 2)->text().toDouble(&minimumOk);
+    double maximum = mpParametersTableWidget->item(i, 3)->text().toDouble(&maximumOk);
+    if (!minimumOk || !maximumOk) {
+      QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error),
+                            tr("Invalid range of parameter <b>%1</b>.").arg(mpParametersTableWidget->item(i, 0)->text()), Helper::ok);
+      return;
+    }
+    parameters.append(mpParametersTableWidget->item(i, 0)->text());
+    minimums.append(minimum);
+    maximums.append(maximum);
+  }
+  int runs = getRunsCount();
+  if (runs > maximumRuns) {
+    QMessageBox::critical(this, QString(Helper::applicationName).append(" - ").append(Helper::error),
+                          tr("The parameter sweep has %1 runs. The maximum number of runs is %2.").arg(runs).arg(maximumRuns), Helper::ok);
+    return;
+  }
+  qsrand(QDateTime::currentDateTime().toTime_t());
+  QList<QStringList> samples = generateSamples(minimums, maximums);
+  // write the values edited in the Variables Browser once. The runs only override the swept parameters.
+  mSimulationOptions.setReSimulate(true);
+  mpVariablesWidget->updateInitXmlFile(mSimulationOptions);
+  QString sweepName = getSweepName();
+  QString summaryFileName = QString("%1/%2.csv").arg(mSimulationOptions.getWorkingDirectory()).arg(sweepName);
+  if (!writeSweepSummary(summaryFileName, parameters, samples)) {
+    return;
+  }
+  SimulationDialog *pSimulationDialog = mpVariablesWidget->getMainWindow()->getSimulationDialog();
+  for (int i = 0 ; i < samples.size() ; i++) {
+    SimulationOptions simulationOptions = mSimulationOptions;
+    QString resultFileName = getResultFileName(sweepName, i + 1);
+    simulationOptions.setResultFileName(resultFileName);
+    simulationOptions.setSimulationFlags(createSimulationFlags(parameters, samples.at(i), resultFileName));
+    simulationOptions.setShowSimulationOutput(false);
+    simulationOptions.setParameterSweepName(sweepName);
+    // the runs must not start the debuggers.
+    simulationOptions.setLaunchTransformationalDebugger(false);
+    simulationOptions.setLaunchAlgorithmicDebugger(false);
+    pSimulationDialog->reSimulate(simulationOptions);
+  }
+  MessagesWidget *pMessagesWidget = mpVariablesWidget->getMainWindow()->getMessagesWidget();
+  pMessagesWidget->addGUIMessage(MessageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                                             tr("Started the parameter sweep %1 with %2 runs. The parameter values of the runs are written to %3.")
+                                             .arg(sweepName).arg(samples.size()).arg(summaryFileName),
+                                             Helper::scriptingKind, Helper::notificationLevel));
+  accept();
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef PARAMETERSWEEPDIALOG_H
+#define PARAMETERSWEEPDIALOG_H
+
+#include "MainWindow.h"
+#include "SimulationOptions.h"
+
+class VariablesWidget;
+class VariablesTreeItem;
+
+class ParameterSweepDialog : public QDialog
+{
+  Q_OBJECT
+public:
+  enum Design {
+    FullFactorial,
+    LatinHypercube
+  };
+  ParameterSweepDialog(VariablesTreeItem *pVariablesTreeItem, VariablesWidget *pVariablesWidget);
+private:
+  VariablesWidget *mpVariablesWidget;
+  SimulationOptions mSimulationOptions;
+  Label *mpHeadingLabel;
+  QFrame *mpHorizontalLine;
+  QTableWidget *mpParametersTableWidget;
+  Label *mpDesignLabel;
+  QComboBox *mpDesignComboBox;
+  Label *mpStepsLabel;
+  QSpinBox *mpStepsSpinBox;
+  Label *mpSamplesLabel;
+  QSpinBox *mpSamplesSpinBox;
+  Label *mpRunsLabel;
+  QPushButton *mpRunButton;
+  QPushButton *mpCancelButton;
+  QDialogButtonBox *mpButtonBox;
+
+  void addParameters(VariablesTreeItem *pVariablesTreeItem);
+  int getSelectedParametersCount();
+  int getRunsCount();
+  QList<QStringList> generateSamples(QList<double> minimums, QList<double> maximums);
+  QString getSweepName();
+  QString getResultFileName(QString sweepName, int run);
+  bool writeSweepSummary(QString fileName, QStringList parameters, QList<QStringList> samples);
+  QStringList createSimulationFlags(QStringList parameters, QStringList values, QString resultFileName);
+private slots:
+  void updateRunsCount();
+  void runParameterSweep();
+};
+
+#endif // PARAMETERSWEEPDIALOG_H
@@ -43,6 +43,7 @@
 
 #include "SimulationDialog.h"
 #include "SimulationOutputWidget.h"
+#include "SimulationJobScheduler.h"
 #include "VariablesWidget.h"
 
 /*!
@@ -59,6 +60,17 @@ SimulationDialog::SimulationDialog(MainWindow *pParent)
   mpMainWindow = pParent;
   resize(550, 550);
   setUpForm();
+  mpSimulationJobScheduler = new SimulationJobScheduler(mpMainWindow, this);
+  // cancel translation button. Added to the status bar when the first translation is started.
+  mpCancelTranslationButton = new QToolButton;
+  mpCancelTranslationButton->setText(Helper::cancelTranslation);
+  mpCancelTranslationButton->setToolTip(Helper::cancelTranslation);
+  mpCancelTranslationButton->setAutoRaise(true);
+  mpCancelTranslationButton->setVisible(false);
+  connect(mpCancelTranslationButton, SIGNAL(clicked()), SLOT(cancelTranslations()));
+  mRunningTranslationRequestId = 0;
+  connect(mpMainWindow->getOMCProxy(), SIGNAL(asyncCommandStarted(int)), SLOT(translationStarted(int)));
+  connect(mpMainWindow->getOMCProxy(), SIGNAL(asyncCommandFinished(int,QString,QString)), SLOT(translationFinished(int,QString,QString)));
 }
 
 SimulationDialog::~SimulationDialog()
@@ -81,6 +93,9 @@ SimulationDialog::~SimulationDialog()
     }
   }
   mSimulationOutputWidgetsList.clear();
+  if (!mpCancelTranslationButton->parentWidget()) {
+    delete mpCancelTranslationButton;
+  }
 }
 
 /*!
@@ -290,6 +305,9 @@ void SimulationDialog::setUpForm()
   mpStoreVariablesAtEventsCheckBox->setChecked(true);
   // show generated files checkbox
   mpShowGeneratedFilesCheckBox = new QCheckBox(tr("Show Generated Files"));
+  // plot while simulating checkbox
+  mpPlotWhileSimulatingCheckBox = new QCheckBox(tr("Plot While Simulating"));
+  mpPlotWhileSimulatingCheckBox->setToolTip(tr("Shows the variables of the mat result file and updates the plotted curves during the simulation."));
   // set Output Tab Layout
   QGridLayout *pOutputTabLayout = new QGridLayout;
   pOutputTabLayout->setAlignment(Qt::AlignTop);
@@ -308,6 +326,7 @@ void SimulationDialog::setUpForm()
   pOutputTabLayout->addWidget(mpEquidistantTimeGridCheckBox, 6, 0, 1, 3);
   pOutputTabLayout->addWidget(mpStoreVariablesAtEventsCheckBox, 7, 0, 1, 3);
   pOutputTabLayout->addWidget(mpShowGeneratedFilesCheckBox, 8, 0, 1, 3);
+  pOutputTabLayout->addWidget(mpPlotWhileSimulatingCheckBox, 9, 0, 1, 3);
   mpOutputTab->setLayout(pOutputTabLayout);
   // add Output Tab to Simulation TabWidget
   mpSimulationTabWidget->addTab(mpOutputTab, Helper::output);
@@ -641,6 +660,8 @@ void SimulationDialog::initializeFields(bool isReSimulate, SimulationOptions sim
     mpStoreVariablesAtEventsCheckBox->setChecked(simulationOptions.getStoreVariablesAtEvents());
     // show generated files checkbox
     mpShowGeneratedFilesCheckBox->setChecked(simulationOptions.getShowGeneratedFiles());
+    // plot while simulating checkbox
+    mpPlotWhileSimulatingCheckBox->setChecked(simulationOptions.getPlotWhileSimulating());
     // Model Setup File
     mpModelSetupFileTextBox->setText(simulationOptions.getModelSetupFile());
     // Initialization Methods
@@ -710,10 +731,14 @@ void SimulationDialog::initializeFields(bool isReSimulate, SimulationOptions sim
 }
 
 /*!
-  Used for non-interactive simulation.\n
-  Sends the translateModel command to OMC.
-  */
-bool SimulationDialog::translateModel(QString simulationParameters)
+ * \brief SimulationDialog::translateModel
+ * Used for non-interactive simulation.\n
+ * Queues the translateModel command for the OMC command thread so the GUI is not blocked while the model is translated.
+ * \param simulationParameters
+ * \return the request id of the translateModel command or -1 if the translation is not started.
+ * \sa SimulationDialog::translationFinished()
+ */
+int SimulationDialog::translateModel(QString simulationParameters)
 {
   // check reset messages number before simulation option
   if (mpMainWindow->getOptionsDialog()->getMessagesPage()->getResetMessagesNumberBeforeSimulationCheckBox()->isChecked()) {
@@ -723,7 +748,7 @@ bool SimulationDialog::translateModel(QString simulationParameters)
   if (mpMainWindow->getOptionsDialog()->getSimulationPage()->getSaveClassBeforeSimulationCheckBox()->isChecked() &&
       !mpLibraryTreeNode->isSaved() &&
       !mpMainWindow->getLibraryTreeWidget()->saveLibraryTreeNode(mpLibraryTreeNode)) {
-    return false;
+    return -1;
   }
   /*
     set the debugging flag before translation
@@ -732,7 +757,43 @@ bool SimulationDialog::translateModel(QString simulationParameters)
   if (mpLaunchAlgorithmicDebuggerCheckBox->isChecked()) {
     mpMainWindow->getOMCProxy()->setCommandLineOptions("+d=gendebugsymbols");
   }
-  return mpMainWindow->getOMCProxy()->translateModel(mClassName, simulationParameters);
+  return mpMainWindow->getOMCProxy()->translateModelAsync(mClassName, simulationParameters);
+}
+
+/*!
+ * \brief SimulationDialog::updateTranslationProgress
+ * Shows the progress bar, the status message and the cancel button while translations are running.
+ * OMC can't interrupt a running translation so the cancel button is only enabled while some translations are queued.
+ */
+void SimulationDialog::updateTranslationProgress()
+{
+  if (mTranslationsHash.isEmpty()) {
+    mpCancelTranslationButton->setVisible(false);
+    mpMainWindow->hideProgressBar();
+    mpMainWindow->getStatusBar()->clearMessage();
+  } else {
+    QStringList classNames;
+    foreach (int requestId, mTranslationsHash.keys()) {
+      if (requestId != mRunningTranslationRequestId) {
+        classNames.append(mTranslationsHash.value(requestId).getClassName());
+      }
+    }
+    QString message;
+    if (mTranslationsHash.contains(mRunningTranslationRequestId)) {
+      message = tr("Translating %1.").arg(mTranslationsHash.value(mRunningTranslationRequestId).getClassName());
+    }
+    if (!classNames.isEmpty()) {
+      message = QString("%1 %2").arg(message).arg(tr("Queued %1.").arg(classNames.join(", "))).trimmed();
+    }
+    mpMainWindow->getStatusBar()->showMessage(message);
+    mpMainWindow->getProgressBar()->setRange(0, 0);
+    mpMainWindow->showProgressBar();
+    if (!mpCancelTranslationButton->parentWidget()) {
+      mpMainWindow->getStatusBar()->addPermanentWidget(mpCancelTranslationButton);
+    }
+    mpCancelTranslationButton->setEnabled(!classNames.isEmpty());
+    mpCancelTranslationButton->setVisible(true);
+  }
 }
 
 SimulationOptions SimulationDialog::createSimulationOptions()
@@ -770,6 +831,7 @@ SimulationOptions SimulationDialog::createSimulationOptions()
   simulationOptions.setEquidistantTimeGrid(mpEquidistantTimeGridCheckBox->isChecked());
   simulationOptions.setStoreVariablesAtEvents(mpStoreVariablesAtEventsCheckBox->isChecked());
   simulationOptions.setShowGeneratedFiles(mpShowGeneratedFilesCheckBox->isChecked());
+  simulationOptions.setPlotWhileSimulating(mpPlotWhileSimulatingCheckBox->isChecked());
   simulationOptions.setModelSetupFile(mpModelSetupFileTextBox->text());
   simulationOptions.setInitializationMethod(mpInitializationMethodComboBox->currentText());
   simulationOptions.setEquationSystemInitializationFile(mpEquationSystemInitializationFileTextBox->text());
@@ -982,7 +1044,7 @@ void SimulationDialog::createAndShowSimulationOutputWidget(SimulationOptions sim
     }
     showAlgorithmicDebugger(simulationOptions);
   } else {
-    if (simulationOptions.isReSimulate()) {
+    if (simulationOptions.isReSimulate() && simulationOptions.getParameterSweepName().isEmpty()) {
       if (mpMainWindow->getOptionsDialog()->getDebuggerPage()->getAlwaysShowTransformationsCheckBox()->isChecked() ||
           simulationOptions.getLaunchTransformationalDebugger() || simulationOptions.getProfiling() != "none") {
         mpMainWindow->showTransformationsWidget(simulationOptions.getWorkingDirectory() + "/" + simulationOptions.getOutputFileName() + "_info.json");
@@ -993,7 +1055,10 @@ void SimulationDialog::createAndShowSimulationOutputWidget(SimulationOptions sim
     int xPos = QApplication::desktop()->availableGeometry().width() - pSimulationOutputWidget->frameSize().width() - 20;
     int yPos = QApplication::desktop()->availableGeometry().height() - pSimulationOutputWidget->frameSize().height() - 20;
     pSimulationOutputWidget->setGeometry(xPos, yPos, pSimulationOutputWidget->width(), pSimulationOutputWidget->height());
-    pSimulationOutputWidget->show();
+    // the parameter sweep runs are only shown from the archived simulations list.
+    if (simulationOptions.getShowSimulationOutput()) {
+      pSimulationOutputWidget->show();
+    }
   }
 }
 
@@ -1070,12 +1135,33 @@ void SimulationDialog::simulationProcessFinished(SimulationOptions simulationOpt
   if (regExp.indexIn(simulationOptions.getResultFileName()) != -1 &&
       resultFileInfo.exists() && resultFileLastModifiedDateTime <= resultFileInfo.lastModified()) {
     VariablesWidget *pVariablesWidget = mpMainWindow->getVariablesWidget();
-    OMCProxy *pOMCProxy = mpMainWindow->getOMCProxy();
-    QStringList list = pOMCProxy->readSimulationResultVars(simulationOptions.getResultFileName());
-    // close the simulation result file.
-    pOMCProxy->closeSimulationResultFile();
+    QStringList list;
+    if (simulationOptions.getResultFileName().endsWith(".mat")) {
+      // read the variables with the shared mat reader which is then reused for plotting the variables.
+      QString resultFilePath = QString(workingDirectory).append("/").append(simulationOptions.getResultFileName());
+      QString errorString;
+      MatResultFilesCache *pMatResultFilesCache = pVariablesWidget->getMatResultFilesCache();
+      pMatResultFilesCache->removeMatResultFile(resultFilePath);
+      MatResultFile *pMatResultFile = pMatResultFilesCache->getMatResultFile(resultFilePath, &errorString);
+      if (pMatResultFile) {
+        list = pMatResultFile->getVariables();
+        list.sort();
+      }
+    } else {
+      OMCProxy *pOMCProxy = mpMainWindow->getOMCProxy();
+      list = pOMCProxy->readSimulationResultVars(simulationOptions.getResultFileName());
+      // close the simulation result file.
+      pOMCProxy->closeSimulationResultFile();
+    }
     if (list.size() > 0) {
-      mpMainWindow->getPerspectiveTabBar()->setCurrentIndex(2);
+      // switch the perspective only for the first finished run of a parameter sweep.
+      QString parameterSweepName = simulationOptions.getParameterSweepName();
+      if (parameterSweepName.isEmpty() || !mShownParameterSweepsSet.contains(parameterSweepName)) {
+        if (!parameterSweepName.isEmpty()) {
+          mShownParameterSweepsSet.insert(parameterSweepName);
+        }
+        mpMainWindow->getPerspectiveTabBar()->setCurrentIndex(2);
+      }
       pVariablesWidget->insertVariablesItemsToTree(simulationOptions.getResultFileName(), workingDirectory, list, simulationOptions);
       mpMainWindow->getVariablesDockWidget()->show();
     }
@@ -1188,19 +1274,86 @@ void SimulationDialog::simulate()
     simulationOptions = createSimulationOptions();
     // before simulating save the simulation options.
     saveSimulationOptions();
-    // show the progress bar
-    mpMainWindow->getStatusBar()->showMessage(tr("Translating %1.").arg(mClassName));
-    mpMainWindow->getProgressBar()->setRange(0, 0);
-    mpMainWindow->showProgressBar();
-    bool isTranslationSuccessful = mIsReSimulate ? true : translateModel(simulationParameters);
-    // hide the progress bar
-    mpMainWindow->hideProgressBar();
-    mpMainWindow->getStatusBar()->clearMessage();
-    mIsReSimulate = false;
-    accept();
-    if (isTranslationSuccessful) {
+    if (mIsReSimulate) {
+      mIsReSimulate = false;
+      accept();
       createAndShowSimulationOutputWidget(simulationOptions);
+    } else {
+      int requestId = translateModel(simulationParameters);
+      accept();
+      /* The SimulationOutputWidget is created when the translation is finished.
+       * See SimulationDialog::translationFinished().
+       */
+      if (requestId > 0) {
+        mTranslationsHash.insert(requestId, simulationOptions);
+        updateTranslationProgress();
+      }
+    }
+  }
+}
+
+/*!
+ * \brief SimulationDialog::cancelTranslations
+ * Slot activated when mpCancelTranslationButton clicked signal is raised.\n
+ * Removes the queued translations. OMC can't interrupt a running translation so the translation which OMC has already started
+ * is not cancelled.
+ */
+void SimulationDialog::cancelTranslations()
+{
+  foreach (int requestId, mTranslationsHash.keys()) {
+    if (requestId == mRunningTranslationRequestId || !mpMainWindow->getOMCProxy()->cancelAsyncCommand(requestId)) {
+      continue;
     }
+    SimulationOptions simulationOptions = mTranslationsHash.take(requestId);
+    MessageItem messageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                            tr("Translation of %1 is cancelled.").arg(simulationOptions.getClassName()),
+                            Helper::scriptingKind, Helper::notificationLevel);
+    mpMainWindow->getMessagesWidget()->addGUIMessage(messageItem);
+  }
+  updateTranslationProgress();
+}
+
+/*!
+ * \brief SimulationDialog::translationStarted
+ * Slot activated when OMCProxy asyncCommandStarted signal is raised.\n
+ * Tells the user which of the queued translations OMC is running now.
+ * \param requestId
+ */
+void SimulationDialog::translationStarted(int requestId)
+{
+  if (!mTranslationsHash.contains(requestId)) {
+    return;
+  }
+  mRunningTranslationRequestId = requestId;
+  MessageItem messageItem(MessageItem::Modelica, "", false, 0, 0, 0, 0,
+                          tr("Translation of %1 is started.").arg(mTranslationsHash.value(requestId).getClassName()),
+                          Helper::scriptingKind, Helper::notificationLevel);
+  mpMainWindow->getMessagesWidget()->addGUIMessage(messageItem);
+  updateTranslationProgress();
+}
+
+/*!
+ * \brief SimulationDialog::translationFinished
+ * Slot activated when OMCProxy asyncCommandFinished signal is raised.\n
+ * Shows the translation messages and hands the translated model over to the SimulationOutputWidget.
+ * \param requestId
+ * \param result
+ * \param errorString - the messages of the translation read by the OMC command thread.
+ */
+void SimulationDialog::translationFinished(int requestId, QString result, QString errorString)
+{
+  if (requestId == mRunningTranslationRequestId) {
+    mRunningTranslationRequestId = 0;
+  }
+  if (!mTranslationsHash.contains(requestId)) {
+    return;
+  }
+  SimulationOptions simulationOptions = mTranslationsHash.take(requestId);
+  updateTranslationProgress();
+  mpMainWindow->getOMCProxy()->printErrorString(errorString, Helper::translationKind);
+  mpMainWindow->getLibraryTreeWidget()->loadDependentLibraries(mpMainWindow->getOMCProxy()->getClassNames());
+  if (StringHandler::unparseBool(result)) {
+    createAndShowSimulationOutputWidget(simulationOptions);
   }
 }
 
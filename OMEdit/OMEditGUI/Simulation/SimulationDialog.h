@@ -70,6 +70,7 @@ private:
 };
 
 class MainWindow;
+class SimulationJobScheduler;
 class SimulationDialog : public QDialog
 {
   Q_OBJECT
@@ -77,6 +78,7 @@ public:
   SimulationDialog(MainWindow *pParent = 0);
   ~SimulationDialog();
   QTreeWidget* getArchivedSimulationsTreeWidget() {return mpArchivedSimulationsTreeWidget;}
+  SimulationJobScheduler* getSimulationJobScheduler() {return mpSimulationJobScheduler;}
   void show(LibraryTreeNode *pLibraryTreeNode, bool isReSimulate, SimulationOptions simulationOptions);
   void directSimulate(LibraryTreeNode *pLibraryTreeNode, bool launchTransformationalDebugger, bool launchAlgorithmicDebugger);
 private:
@@ -134,6 +136,7 @@ private:
   QCheckBox *mpEquidistantTimeGridCheckBox;
   QCheckBox *mpStoreVariablesAtEventsCheckBox;
   QCheckBox *mpShowGeneratedFilesCheckBox;
+  QCheckBox *mpPlotWhileSimulatingCheckBox;
   // Simulation Flags Tab
   QWidget *mpSimulationFlagsTab;
   QScrollArea *mpSimulationFlagsTabScrollArea;
@@ -192,15 +195,21 @@ private:
   QPushButton *mpSimulateButton;
   QDialogButtonBox *mpButtonBox;
   QList<SimulationOutputWidget*> mSimulationOutputWidgetsList;
+  SimulationJobScheduler *mpSimulationJobScheduler;
   LibraryTreeNode *mpLibraryTreeNode;
   QString mClassName;
   QString mFileName;
   bool mIsReSimulate;
+  QHash<int, SimulationOptions> mTranslationsHash;
+  int mRunningTranslationRequestId;
+  QSet<QString> mShownParameterSweepsSet;
+  QToolButton *mpCancelTranslationButton;
 
   void setUpForm();
   bool validate();
   void initializeFields(bool isReSimulate, SimulationOptions simulationOptions);
-  bool translateModel(QString simulationParameters);
+  int translateModel(QString simulationParameters);
+  void updateTranslationProgress();
   SimulationOptions createSimulationOptions();
   void createAndShowSimulationOutputWidget(SimulationOptions simulationOptions);
   void showSimulationOutputWidget(SimulationOutputWidget *pSimulationOutputWidget);
@@ -217,8 +226,11 @@ public slots:
   void browseEquationSystemInitializationFile();
   void showArchivedSimulation(QTreeWidgetItem *pTreeWidgetItem);
   void simulate();
+  void cancelTranslations();
 private slots:
   void resultFileNameChanged(QString text);
+  void translationStarted(int requestId);
+  void translationFinished(int requestId, QString result, QString errorString);
 };
 
 #endif // SIMULATIONDIALOG_H
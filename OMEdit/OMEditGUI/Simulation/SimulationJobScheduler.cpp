@@ -0,0 +1,213 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include "SimulationJobScheduler.h"
+#include "SimulationProcessThread.h"
+
+/*!
+ * \brief executableKey
+ * \param pSimulationProcessThread
+ * \return the path of the simulation executable of the job.
+ */
+static QString executableKey(SimulationProcessThread *pSimulationProcessThread)
+{
+  SimulationOptions simulationOptions = pSimulationProcessThread->getSimulationOutputWidget()->getSimulationOptions();
+  return QString("%1/%2").arg(simulationOptions.getWorkingDirectory()).arg(simulationOptions.getOutputFileName());
+}
+
+/*!
+ * \class SimulationJobScheduler
+ * \brief Runs the compilation and simulation stages of the simulation jobs within a global processors budget.
+ * A compilation stage uses the number of processors set in the simulation options and a simulation stage uses one processor.
+ * The stages waiting for the processors are queued. The simulation stages are started before the compilation stages
+ * because they are closer to completion. An executable is never rebuilt while it is being compiled or simulated and
+ * it is not simulated while it is being compiled, so the re-simulations reuse the already built executables safely.
+ */
+/*!
+ * \brief SimulationJobScheduler::SimulationJobScheduler
+ * \param pMainWindow
+ * \param pParent
+ */
+SimulationJobScheduler::SimulationJobScheduler(MainWindow *pMainWindow, QObject *pParent)
+  : QObject(pParent), mpMainWindow(pMainWindow)
+{
+  mUsedProcessors = 0;
+}
+
+/*!
+ * \brief SimulationJobScheduler::addCompilationJob
+ * Queues the compilation stage of the job.
+ * \param pSimulationProcessThread
+ */
+void SimulationJobScheduler::addCompilationJob(SimulationProcessThread *pSimulationProcessThread)
+{
+  mQueuedCompilationJobsList.append(pSimulationProcessThread);
+  scheduleJobs();
+}
+
+/*!
+ * \brief SimulationJobScheduler::addSimulationJob
+ * Queues the simulation stage of the job.
+ * \param pSimulationProcessThread
+ */
+void SimulationJobScheduler::addSimulationJob(SimulationProcessThread *pSimulationProcessThread)
+{
+  mQueuedSimulationJobsList.append(pSimulationProcessThread);
+  scheduleJobs();
+}
+
+/*!
+ * \brief SimulationJobScheduler::jobStageFinished
+ * Releases the processors used by the running stage of the job and starts the queued stages.
+ * \param pSimulationProcessThread
+ */
+void SimulationJobScheduler::jobStageFinished(SimulationProcessThread *pSimulationProcessThread)
+{
+  if (!mRunningJobsHash.contains(pSimulationProcessThread)) {
+    return;
+  }
+  SimulationJob simulationJob = mRunningJobsHash.take(pSimulationProcessThread);
+  mUsedProcessors -= simulationJob.mProcessors;
+  if (simulationJob.mCompilation) {
+    mCompilingExecutablesSet.remove(simulationJob.mExecutable);
+  } else if (--mRunningExecutablesHash[simulationJob.mExecutable] <= 0) {
+    mRunningExecutablesHash.remove(simulationJob.mExecutable);
+  }
+  scheduleJobs();
+}
+
+/*!
+ * \brief SimulationJobScheduler::removeQueuedJob
+ * Removes the job from the queues.
+ * \param pSimulationProcessThread
+ * \return true if the job was queued.
+ */
+bool SimulationJobScheduler::removeQueuedJob(SimulationProcessThread *pSimulationProcessThread)
+{
+  bool removed = mQueuedCompilationJobsList.removeOne(pSimulationProcessThread);
+  removed = mQueuedSimulationJobsList.removeOne(pSimulationProcessThread) || removed;
+  if (removed) {
+    updateQueuedJobs();
+  }
+  return removed;
+}
+
+/*!
+ * \brief SimulationJobScheduler::getProcessorsBudget
+ * \return the number of processors that all the simulation jobs can use together.
+ */
+int SimulationJobScheduler::getProcessorsBudget()
+{
+  return qMax(1, mpMainWindow->getOptionsDialog()->getSimulationPage()->getSimulationJobsProcessorsSpinBox()->value());
+}
+
+/*!
+ * \brief SimulationJobScheduler::getCompilationProcessors
+ * \param pSimulationProcessThread
+ * \return the number of processors used by the compilation stage of the job.
+ */
+int SimulationJobScheduler::getCompilationProcessors(SimulationProcessThread *pSimulationProcessThread)
+{
+  int processors = pSimulationProcessThread->getSimulationOutputWidget()->getSimulationOptions().getNumberOfProcessors();
+  return qBound(1, processors, getProcessorsBudget());
+}
+
+/*!
+ * \brief SimulationJobScheduler::scheduleJobs
+ * Starts the queued stages as long as there are free processors.
+ */
+void SimulationJobScheduler::scheduleJobs()
+{
+  int budget = getProcessorsBudget();
+  // start the simulation stages first.
+  for (int i = 0 ; i < mQueuedSimulationJobsList.size() && mUsedProcessors < budget ; ) {
+    SimulationProcessThread *pSimulationProcessThread = mQueuedSimulationJobsList.at(i);
+    QString executable = executableKey(pSimulationProcessThread);
+    if (mCompilingExecutablesSet.contains(executable)) {
+      i++;
+      continue;
+    }
+    mQueuedSimulationJobsList.removeAt(i);
+    SimulationJob simulationJob;
+    simulationJob.mCompilation = false;
+    simulationJob.mProcessors = 1;
+    simulationJob.mExecutable = executable;
+    mRunningJobsHash.insert(pSimulationProcessThread, simulationJob);
+    mUsedProcessors += simulationJob.mProcessors;
+    mRunningExecutablesHash[executable]++;
+    pSimulationProcessThread->startSimulation();
+  }
+  // start the compilation stages in the order they are queued. A job that doesn't fit in the budget blocks the ones after it.
+  for (int i = 0 ; i < mQueuedCompilationJobsList.size() ; ) {
+    SimulationProcessThread *pSimulationProcessThread = mQueuedCompilationJobsList.at(i);
+    QString executable = executableKey(pSimulationProcessThread);
+    if (mCompilingExecutablesSet.contains(executable) || mRunningExecutablesHash.contains(executable)) {
+      i++;
+      continue;
+    }
+    int processors = getCompilationProcessors(pSimulationProcessThread);
+    if (mUsedProcessors > 0 && mUsedProcessors + processors > budget) {
+      break;
+    }
+    mQueuedCompilationJobsList.removeAt(i);
+    SimulationJob simulationJob;
+    simulationJob.mCompilation = true;
+    simulationJob.mProcessors = processors;
+    simulationJob.mExecutable = executable;
+    mRunningJobsHash.insert(pSimulationProcessThread, simulationJob);
+    mUsedProcessors += simulationJob.mProcessors;
+    mCompilingExecutablesSet.insert(executable);
+    pSimulationProcessThread->startCompilation(processors);
+  }
+  updateQueuedJobs();
+}
+
+/*!
+ * \brief SimulationJobScheduler::updateQueuedJobs
+ * Shows the position of the queued jobs in the archived simulations list.
+ */
+void SimulationJobScheduler::updateQueuedJobs()
+{
+  int position = 0;
+  foreach (SimulationProcessThread *pSimulationProcessThread, mQueuedSimulationJobsList) {
+    pSimulationProcessThread->getSimulationOutputWidget()->setJobQueued(++position);
+  }
+  foreach (SimulationProcessThread *pSimulationProcessThread, mQueuedCompilationJobsList) {
+    pSimulationProcessThread->getSimulationOutputWidget()->setJobQueued(++position);
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef SIMULATIONJOBSCHEDULER_H
+#define SIMULATIONJOBSCHEDULER_H
+
+#include "MainWindow.h"
+
+class SimulationProcessThread;
+
+struct SimulationJob
+{
+  bool mCompilation;
+  int mProcessors;
+  QString mExecutable;
+};
+
+class SimulationJobScheduler : public QObject
+{
+  Q_OBJECT
+public:
+  SimulationJobScheduler(MainWindow *pMainWindow, QObject *pParent = 0);
+  void addCompilationJob(SimulationProcessThread *pSimulationProcessThread);
+  void addSimulationJob(SimulationProcessThread *pSimulationProcessThread);
+  void jobStageFinished(SimulationProcessThread *pSimulationProcessThread);
+  bool removeQueuedJob(SimulationProcessThread *pSimulationProcessThread);
+  int getProcessorsBudget();
+  int getUsedProcessors() {return mUsedProcessors;}
+  int getQueuedJobsCount() {return mQueuedCompilationJobsList.size() + mQueuedSimulationJobsList.size();}
+private:
+  MainWindow *mpMainWindow;
+  QList<SimulationProcessThread*> mQueuedCompilationJobsList;
+  QList<SimulationProcessThread*> mQueuedSimulationJobsList;
+  QHash<SimulationProcessThread*, SimulationJob> mRunningJobsHash;
+  QSet<QString> mCompilingExecutablesSet;
+  QHash<QString, int> mRunningExecutablesHash;
+  int mUsedProcessors;
+
+  int getCompilationProcessors(SimulationProcessThread *pSimulationProcessThread);
+  void scheduleJobs();
+  void updateQueuedJobs();
+};
+
+#endif // SIMULATIONJOBSCHEDULER_H
@@ -0,0 +1,318 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include "SimulationMessageLog.h"
+#include "SimulationOutputHandler.h"
+
+/*!
+ * \class SimulationMessageLog
+ * \brief An append-only log of the simulation messages.
+ * The messages are written to a file, one record per line, and only a small index is kept in memory.
+ * The index stores the tree structure and the stream, type and level of each message. The records of a top level message
+ * also store the types and streams used in the whole subtree so the messages can be filtered without reading the file.
+ * The message text is read from the file when it is needed and the recently used messages are cached.
+ * Every log uses its own file which is removed with the log. If the file can't be created then the records are kept in memory.
+ */
+/*!
+ * \brief SimulationMessageLog::SimulationMessageLog
+ * \param fileTemplate - the template of the unique log file name. \sa QTemporaryFile::setFileTemplate()
+ */
+SimulationMessageLog::SimulationMessageLog(QString fileTemplate)
+  : mSimulationMessagesCache(1000)
+{
+  mFile.setFileTemplate(fileTemplate);
+  if (mFile.open()) {
+    mpDevice = &mFile;
+  } else {
+    mBuffer.open(QIODevice::ReadWrite);
+    mpDevice = &mBuffer;
+  }
+  mSize = 0;
+}
+
+SimulationMessageLog::~SimulationMessageLog()
+{
+  mpDevice->close();
+  // the QTemporaryFile removes the log file.
+}
+
+/*!
+ * \brief SimulationMessageLog::appendSimulationMessage
+ * Appends the top level message and its children to the log.
+ * \param pSimulationMessage
+ * \return the record of the message.
+ */
+int SimulationMessageLog::appendSimulationMessage(SimulationMessage *pSimulationMessage)
+{
+  QByteArray data;
+  int record = appendSimulationMessageHelper(pSimulationMessage, -1, mTopLevelRecords.size(), &data);
+  mTopLevelRecords.append(record);
+  mpDevice->seek(mSize);
+  mpDevice->write(data);
+  mSize += data.size();
+  return record;
+}
+
+/*!
+ * \brief SimulationMessageLog::matchesFilter
+ * Checks the types and streams of the message and its children.
+ * \param record
+ * \param typesMask - the mask of the message types. \sa getTypeMask()
+ * \param stream - the stream index in getStreams() or -1 for all streams.
+ * \return
+ */
+bool SimulationMessageLog::matchesFilter(int record, quint32 typesMask, int stream) const
+{
+  const SimulationMessageRecord &simulationMessageRecord = mRecords.at(record);
+  if (!(simulationMessageRecord.mTypesMask & typesMask)) {
+    return false;
+  }
+  if (stream >= 0 && !(simulationMessageRecord.mStreamsMask & ((quint64)1 << qMin(stream, 63)))) {
+    return false;
+  }
+  return true;
+}
+
+/*!
+ * \brief SimulationMessageLog::findTopLevelRecords
+ * Scans the log sequentially and finds the messages containing the text.
+ * \param firstRecord - the record to start the search from.
+ * \param text
+ * \param caseSensitivity
+ * \return the top level records of the found messages.
+ */
+QSet<int> SimulationMessageLog::findTopLevelRecords(int firstRecord, const QString &text, Qt::CaseSensitivity caseSensitivity)
+{
+  QSet<int> records;
+  if (firstRecord >= mRecords.size()) {
+    return records;
+  }
+  // read with a separate device so the position of the log device is not changed.
+  QIODevice *pDevice;
+  if (isFileOpen()) {
+    mFile.flush();
+    pDevice = new QFile(mFile.fileName());
+  } else {
+    pDevice = new QBuffer;
+    static_cast<QBuffer*>(pDevice)->setData(mBuffer.data());
+  }
+  if (pDevice->open(QIODevice::ReadOnly) && pDevice->seek(mRecords.at(firstRecord).mOffset)) {
+    int record = firstRecord;
+    while (record < mRecords.size() && !pDevice->atEnd()) {
+      QByteArray line = pDevice->readLine();
+      line.chop(1);
+      // the text is the last field of the record.
+      int textStart = line.lastIndexOf('\t') + 1;
+      if (unescape(line.mid(textStart)).contains(text, caseSensitivity)) {
+        int topLevelRecord = record;
+        while (mRecords.at(topLevelRecord).mParent >= 0) {
+          topLevelRecord = mRecords.at(topLevelRecord).mParent;
+        }
+        records.insert(topLevelRecord);
+      }
+      record++;
+    }
+  }
+  delete pDevice;
+  return records;
+}
+
+/*!
+ * \brief SimulationMessageLog::getSimulationMessage
+ * Reads the message from the log. The message is owned by the log and is only valid until the next call.
+ * The returned message has no children, use the index to traverse the tree.
+ * \param record
+ * \return
+ */
+SimulationMessage* SimulationMessageLog::getSimulationMessage(int record)
+{
+  SimulationMessage *pSimulationMessage = mSimulationMessagesCache.object(record);
+  if (pSimulationMessage) {
+    return pSimulationMessage;
+  }
+  const SimulationMessageRecord &simulationMessageRecord = mRecords.at(record);
+  pSimulationMessage = new SimulationMessage;
+  pSimulationMessage->mStream = mStreams.at(simulationMessageRecord.mStream);
+  pSimulationMessage->mType = (StringHandler::SimulationMessageType)simulationMessageRecord.mType;
+  pSimulationMessage->mLevel = simulationMessageRecord.mLevel;
+  if (mpDevice->seek(simulationMessageRecord.mOffset)) {
+    QByteArray line = mpDevice->readLine();
+    line.chop(1);
+    QList<QByteArray> fields = line.split('\t');
+    if (fields.size() == 5) {
+      pSimulationMessage->mIndex = QString::fromUtf8(fields.at(3));
+      pSimulationMessage->mText = unescape(fields.at(4));
+    }
+  }
+  mSimulationMessagesCache.insert(record, pSimulationMessage);
+  return pSimulationMessage;
+}
+
+/*!
+ * \brief SimulationMessageLog::appendSimulationMessageHelper
+ * Adds the records of the message and its children and appends their lines to pData.
+ * \param pSimulationMessage
+ * \param parent - the parent record or -1 for top level messages.
+ * \param row - the row of the message in its parent.
+ * \param pData
+ * \return the record of the message.
+ */
+int SimulationMessageLog::appendSimulationMessageHelper(SimulationMessage *pSimulationMessage, int parent, int row, QByteArray *pData)
+{
+  SimulationMessageRecord simulationMessageRecord;
+  simulationMessageRecord.mOffset = mSize + pData->size();
+  simulationMessageRecord.mParent = parent;
+  simulationMessageRecord.mRow = row;
+  simulationMessageRecord.mStream = getStreamId(pSimulationMessage->mStream);
+  simulationMessageRecord.mType = pSimulationMessage->mType;
+  simulationMessageRecord.mLevel = qMin(pSimulationMessage->mLevel, 255);
+  simulationMessageRecord.mTypesMask = getTypeMask(pSimulationMessage->mType);
+  simulationMessageRecord.mStreamsMask = (quint64)1 << qMin((int)simulationMessageRecord.mStream, 63);
+  int record = mRecords.size();
+  mRecords.append(simulationMessageRecord);
+  // stream, type, level, index and text separated by tabs.
+  pData->append(escape(pSimulationMessage->mStream)).append('\t');
+  pData->append(StringHandler::getSimulationMessageTypeString(pSimulationMessage->mType).toUtf8()).append('\t');
+  pData->append(QByteArray::number(pSimulationMessage->mLevel)).append('\t');
+  pData->append(escape(pSimulationMessage->mIndex)).append('\t');
+  pData->append(escape(pSimulationMessage->mText)).append('\n');
+  if (!pSimulationMessage->mChildren.isEmpty()) {
+    QVector<int> children;
+    children.reserve(pSimulationMessage->mChildren.size());
+    for (int i = 0 ; i < pSimulationMessage->mChildren.size() ; i++) {
+      int childRecord = appendSimulationMessageHelper(pSimulationMessage->mChildren.at(i), record, i, pData);
+      mRecords[record].mTypesMask |= mRecords.at(childRecord).mTypesMask;
+      mRecords[record].mStreamsMask |= mRecords.at(childRecord).mStreamsMask;
+      children.append(childRecord);
+    }
+    mChildrenHash.insert(record, children);
+  }
+  return record;
+}
+
+/*!
+ * \brief SimulationMessageLog::getStreamId
+ * \param stream
+ * \return the index of the stream in mStreams.
+ */
+int SimulationMessageLog::getStreamId(const QString &stream)
+{
+  QHash<QString, int>::const_iterator iterator = mStreamsHash.constFind(stream);
+  if (iterator != mStreamsHash.constEnd()) {
+    return iterator.value();
+  }
+  // don't let a broken output overflow the stream ids.
+  if (mStreams.size() > 0xFFFF) {
+    return 0;
+  }
+  mStreams.append(stream);
+  mStreamsHash.insert(stream, mStreams.size() - 1);
+  return mStreams.size() - 1;
+}
+
+/*!
+ * \brief SimulationMessageLog::escape
+ * Escapes the characters that separate the fields and records.
+ * \param text
+ * \return the escaped utf-8 text.
+ */
+QByteArray SimulationMessageLog::escape(const QString &text)
+{
+  QByteArray data = text.toUtf8();
+  if (data.indexOf('\\') < 0 && data.indexOf('\t') < 0 && data.indexOf('\n') < 0 && data.indexOf('\r') < 0) {
+    return data;
+  }
+  QByteArray escapedData;
+  escapedData.reserve(data.size() + 16);
+  for (int i = 0 ; i < data.size() ; i++) {
+    switch (data.at(i)) {
+      case '\\':
+        escapedData.append("\\\\");
+        break;
+      case '\t':
+        escapedData.append("\\t");
+        break;
+      case '\n':
+        escapedData.append("\\n");
+        break;
+      case '\r':
+        escapedData.append("\\r");
+        break;
+      default:
+        escapedData.append(data.at(i));
+        break;
+    }
+  }
+  return escapedData;
+}
+
+/*!
+ * \brief SimulationMessageLog::unescape
+ * \param text - the escaped utf-8 text.
+ * \return
+ * \sa escape()
+ */
+QString SimulationMessageLog::unescape(const QByteArray &text)
+{
+  if (text.indexOf('\\') < 0) {
+    return QString::fromUtf8(text.constData(), text.size());
+  }
+  QByteArray data;
+  data.reserve(text.size());
+  for (int i = 0 ; i < text.size() ; i++) {
+    if (text.at(i) == '\\' && i + 1 < text.size()) {
+      switch (text.at(++i)) {
+        case 't':
+          data.append('\t');
+          break;
+        case 'n':
+          data.append('\n');
+          break;
+        case 'r':
+          data.append('\r');
+          break;
+        default:
+          data.append(text.at(i));
+          break;
+      }
+    } else {
+      data.append(text.at(i));
+    }
+  }
+  return QString::fromUtf8(data.constData(), data.size());
+}
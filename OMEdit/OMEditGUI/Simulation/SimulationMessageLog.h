@@ -0,0 +1,97 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef SIMULATIONMESSAGELOG_H
+#define SIMULATIONMESSAGELOG_H
+
+#include "MainWindow.h"
+
+class SimulationMessage;
+
+struct SimulationMessageRecord
+{
+  qint64 mOffset;
+  int mParent;
+  int mRow;
+  quint16 mStream;
+  quint8 mType;
+  quint8 mLevel;
+  quint32 mTypesMask;
+  quint64 mStreamsMask;
+};
+
+class SimulationMessageLog
+{
+public:
+  SimulationMessageLog(QString fileTemplate);
+  ~SimulationMessageLog();
+  QString getFileName() const {return mFile.fileName();}
+  bool isFileOpen() const {return mpDevice == &mFile;}
+  int count() const {return mRecords.size();}
+  const QVector<int>& getTopLevelRecords() const {return mTopLevelRecords;}
+  int getParentRecord(int record) const {return mRecords.at(record).mParent;}
+  int getRow(int record) const {return mRecords.at(record).mRow;}
+  int getLevel(int record) const {return mRecords.at(record).mLevel;}
+  int getChildrenCount(int record) const {return mChildrenHash.value(record).size();}
+  int getChildRecord(int record, int row) const {return mChildrenHash.value(record).value(row, -1);}
+  QStringList getStreams() const {return mStreams;}
+  static quint32 getTypeMask(StringHandler::SimulationMessageType type) {return 1 << type;}
+  static quint32 getAllTypesMask() {return 0xFFFFFFFF;}
+  int appendSimulationMessage(SimulationMessage *pSimulationMessage);
+  bool matchesFilter(int record, quint32 typesMask, int stream) const;
+  QSet<int> findTopLevelRecords(int firstRecord, const QString &text, Qt::CaseSensitivity caseSensitivity);
+  SimulationMessage* getSimulationMessage(int record);
+private:
+  QTemporaryFile mFile;
+  QBuffer mBuffer;
+  QIODevice *mpDevice;
+  qint64 mSize;
+  QVector<SimulationMessageRecord> mRecords;
+  QVector<int> mTopLevelRecords;
+  QHash<int, QVector<int> > mChildrenHash;
+  QStringList mStreams;
+  QHash<QString, int> mStreamsHash;
+  QCache<int, SimulationMessage> mSimulationMessagesCache;
+
+  int appendSimulationMessageHelper(SimulationMessage *pSimulationMessage, int parent, int row, QByteArray *pData);
+  int getStreamId(const QString &stream);
+  static QByteArray escape(const QString &text);
+  static QString unescape(const QByteArray &text);
+};
+
+#endif // SIMULATIONMESSAGELOG_H
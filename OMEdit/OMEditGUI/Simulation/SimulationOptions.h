@@ -72,6 +72,7 @@ public:
     setEquidistantTimeGrid(true);
     setStoreVariablesAtEvents(true);
     setShowGeneratedFiles(false);
+    setPlotWhileSimulating(false);
     setModelSetupFile("");
     setInitializationMethod("");
     setEquationSystemInitializationFile("");
@@ -105,6 +106,8 @@ public:
     setAdditionalSimulationFlags("");
     setIsValid(false);
     setReSimulate(false);
+    setShowSimulationOutput(true);
+    setParameterSweepName("");
     setWorkingDirectory("");
     setFileName("");
   }
@@ -162,6 +165,8 @@ public:
   bool getStoreVariablesAtEvents() {return mStoreVariablesAtEvents;}
   void setShowGeneratedFiles(bool showGeneratedFiles) {mShowGeneratedFiles = showGeneratedFiles;}
   bool getShowGeneratedFiles() {return mShowGeneratedFiles;}
+  void setPlotWhileSimulating(bool plotWhileSimulating) {mPlotWhileSimulating = plotWhileSimulating;}
+  bool getPlotWhileSimulating() {return mPlotWhileSimulating;}
   void setModelSetupFile(QString modelSetupFile) {mModelSetupFile = modelSetupFile;}
   QString getModelSetupFile() {return mModelSetupFile;}
   void setInitializationMethod(QString initializationMethod) {mInitializationMethod = initializationMethod;}
@@ -231,6 +236,10 @@ public:
   bool isValid() {return mValid;}
   void setReSimulate(bool reSimulate) {mReSimulate = reSimulate;}
   bool isReSimulate() {return mReSimulate;}
+  void setShowSimulationOutput(bool showSimulationOutput) {mShowSimulationOutput = showSimulationOutput;}
+  bool getShowSimulationOutput() {return mShowSimulationOutput;}
+  void setParameterSweepName(QString parameterSweepName) {mParameterSweepName = parameterSweepName;}
+  QString getParameterSweepName() {return mParameterSweepName;}
   void setWorkingDirectory(QString workingDirectory) {mWorkingDirectory = workingDirectory;}
   QString getWorkingDirectory() const {return mWorkingDirectory;}
   void setFileName(QString fileName) {mFileName = fileName;}
@@ -262,6 +271,7 @@ private:
   bool mEquidistantTimeGrid;
   bool mStoreVariablesAtEvents;
   bool mShowGeneratedFiles;
+  bool mPlotWhileSimulating;
   QString mModelSetupFile;
   QString mInitializationMethod;
   QString mEquationSystemInitializationFile;
@@ -297,6 +307,8 @@ private:
   QStringList mSimulationFlags;
   bool mValid;
   bool mReSimulate;
+  bool mShowSimulationOutput;
+  QString mParameterSweepName;
   QString mWorkingDirectory;
   QString mFileName;
 };
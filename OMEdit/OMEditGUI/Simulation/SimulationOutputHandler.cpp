@@ -36,20 +36,50 @@
  */
 
 #include "SimulationOutputHandler.h"
+#include "SimulationMessageLog.h"
+
+/*!
+ * \brief maximumBufferSize
+ * The maximum size of an incomplete tag kept between the output chunks.
+ */
+static const int maximumBufferSize = 1024 * 1024;
+/*!
+ * \brief flushInterval
+ * The interval in milliseconds in which the parsed messages are added to the view.
+ */
+static const int flushInterval = 50;
+
+/*!
+ * \brief isSpace
+ * \param c
+ * \return true if c is a xml white space character.
+ */
+static inline bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
 
 /*!
   \class SimulationMessageModel
   \brief Data model for Simulation output messages.
+  The messages are read from SimulationMessageLog when the view asks for them. The top level rows are the top level
+  messages which match the filter. The index internal id is the record of the message in the log.
   */
 /*!
   \param pSimulationOutputWidget - a pointer to SimulationOutputWidget.
+  \param pSimulationMessageLog - a pointer to SimulationMessageLog.
   \param pParent - a pointer to QObject.
   */
-SimulationMessageModel::SimulationMessageModel(SimulationOutputWidget *pSimulationOutputWidget, QObject *pParent)
+SimulationMessageModel::SimulationMessageModel(SimulationOutputWidget *pSimulationOutputWidget, SimulationMessageLog *pSimulationMessageLog,
+                                               QObject *pParent)
   : QAbstractItemModel(pParent)
 {
   mpSimulationOutputWidget = pSimulationOutputWidget;
-  mpRootSimulationMessage = new SimulationMessage;
+  mpSimulationMessageLog = pSimulationMessageLog;
+  mFilteredTopLevelRecordsCount = 0;
+  mTypesMask = SimulationMessageLog::getAllTypesMask();
+  mStream = -1;
+  mCaseSensitivity = Qt::CaseInsensitive;
 }
 
 /*!
@@ -61,17 +91,15 @@ QModelIndex SimulationMessageModel::index(int row, int column, const QModelIndex
     return QModelIndex();
   }
 
-  SimulationMessage *pParentSimulationMessage = 0;
   if (!parent.isValid()) {
-    pParentSimulationMessage = mpRootSimulationMessage;
-  } else {
-    pParentSimulationMessage = static_cast<SimulationMessage*>(parent.internalPointer());
-  }
-  SimulationMessage *pChildSimulationMessage = pParentSimulationMessage->child(row);
-  if (pChildSimulationMessage) {
-    return createIndex(row, column, pChildSimulationMessage);
+    return createIndex(row, column, mRows.at(row));
   } else {
-    return QModelIndex();
+    int record = mpSimulationMessageLog->getChildRecord(getRecord(parent), row);
+    if (record >= 0) {
+      return createIndex(row, column, record);
+    } else {
+      return QModelIndex();
+    }
   }
 }
 
@@ -84,12 +112,18 @@ QModelIndex SimulationMessageModel::parent(const QModelIndex &child) const
     return QModelIndex();
   }
 
-  SimulationMessage *pChildSimulationMessage = static_cast<SimulationMessage*>(child.internalPointer());
-  SimulationMessage *pParentSimulationMessage = pChildSimulationMessage->parent();
-  if (pParentSimulationMessage == mpRootSimulationMessage) {
+  int parentRecord = mpSimulationMessageLog->getParentRecord(getRecord(child));
+  if (parentRecord < 0) {
     return QModelIndex();
+  } else if (mpSimulationMessageLog->getParentRecord(parentRecord) < 0) {
+    // the top level rows are sorted by the records.
+    QVector<int>::const_iterator iterator = qBinaryFind(mRows.constBegin(), mRows.constEnd(), parentRecord);
+    if (iterator == mRows.constEnd()) {
+      return QModelIndex();
+    }
+    return createIndex(iterator - mRows.constBegin(), 0, parentRecord);
   } else {
-  return createIndex(pParentSimulationMessage->row(), 0, pParentSimulationMessage);
+    return createIndex(mpSimulationMessageLog->getRow(parentRecord), 0, parentRecord);
   }
 }
 
@@ -99,17 +133,15 @@ QModelIndex SimulationMessageModel::parent(const QModelIndex &child) const
   */
 int SimulationMessageModel::rowCount(const QModelIndex &parent) const
 {
-  SimulationMessage *pParentSimulationMessage;
   if (parent.column() > 0) {
     return 0;
   }
 
   if (!parent.isValid()) {
-    pParentSimulationMessage = mpRootSimulationMessage;
+    return mRows.size();
   } else {
-    pParentSimulationMessage = static_cast<SimulationMessage*>(parent.internalPointer());
+    return mpSimulationMessageLog->getChildrenCount(getRecord(parent));
   }
-  return pParentSimulationMessage->children().size();
 }
 
 /*!
@@ -130,37 +162,38 @@ QVariant SimulationMessageModel::data(const QModelIndex &index, int role) const
     return QVariant();
   }
 
-  SimulationMessage *pSimulationMessage = static_cast<SimulationMessage*>(index.internalPointer());
-  QString debugLink;
-  QString text;
-  QString toolTip;
+  if (role == Qt::TextAlignmentRole) {
+    return QVariant(Qt::AlignLeft | Qt::AlignTop);
+  } else if (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != Qt::ForegroundRole) {
+    return QVariant();
+  }
+  SimulationMessage *pSimulationMessage = getSimulationMessage(index);
   QVariant variant = QVariant();
   if (pSimulationMessage) {
-    // create debuglink
-    SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
-    debugLink = QString("&nbsp;<a href=\"omedittransformationsbrowser://%1?index=%2\">Debug more</a>")
-        .arg(QUrl::fromLocalFile(simulationOptions.getWorkingDirectory() + "/" + simulationOptions.getOutputFileName() + "_info.json").path())
-        .arg(pSimulationMessage->mIndex);
-    // create display text
-    text = pSimulationMessage->mText + (pSimulationMessage->mIndex.isEmpty() ? "" : debugLink);
-    // create tooltip
-    toolTip = QString("%1 | %2 | %3")
-        .arg(pSimulationMessage->mStream)
-        .arg(StringHandler::getSimulationMessageTypeString(pSimulationMessage->mType))
-        .arg(pSimulationMessage->mText);
+    /* The messages are stored as plain text. The html text is only created for the items that are shown. */
     switch (role)
     {
       case Qt::DisplayRole:
-        variant = text;
+        if (pSimulationMessage->mIndex.isEmpty()) {
+          variant = Qt::convertFromPlainText(pSimulationMessage->mText);
+        } else {
+          // create debuglink
+          SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+          QString debugLink = QString("&nbsp;<a href=\"omedittransformationsbrowser://%1?index=%2\">Debug more</a>")
+              .arg(QUrl::fromLocalFile(simulationOptions.getWorkingDirectory() + "/" + simulationOptions.getOutputFileName() + "_info.json").path())
+              .arg(pSimulationMessage->mIndex);
+          variant = Qt::convertFromPlainText(pSimulationMessage->mText) + debugLink;
+        }
         break;
       case Qt::ToolTipRole:
-        variant = toolTip;
+        variant = QString("%1 | %2 | %3")
+            .arg(pSimulationMessage->mStream)
+            .arg(StringHandler::getSimulationMessageTypeString(pSimulationMessage->mType))
+            .arg(pSimulationMessage->mText);
         break;
       case Qt::ForegroundRole:
         variant = StringHandler::getSimulationMessageTypeColor(pSimulationMessage->mType);
         break;
-      case Qt::TextAlignmentRole:
-        variant = QVariant(Qt::AlignLeft | Qt::AlignTop);
       default:
         break;
     }
@@ -168,43 +201,73 @@ QVariant SimulationMessageModel::data(const QModelIndex &index, int role) const
   return variant;
 }
 
+/*!
+ * \brief SimulationMessageModel::getSimulationMessage
+ * \param index
+ * \return the message read from the log. The message is only valid until the next message is read.
+ */
+SimulationMessage* SimulationMessageModel::getSimulationMessage(const QModelIndex &index) const
+{
+  if (!index.isValid()) {
+    return 0;
+  }
+  return mpSimulationMessageLog->getSimulationMessage(getRecord(index));
+}
+
 /*!
   Returns the depth/level of the QModelIndex.\n
   Needed by ItemDelegate to properly word wrap the top level and child items.
   */
 int SimulationMessageModel::getDepth(const QModelIndex &index) const
 {
-  QModelIndex index1 = index;
-  int depth = 1;
-  while (index1.parent().isValid()) {
-    index1 = index1.parent();
-    SimulationMessage *pSimulationMessage = static_cast<SimulationMessage*>(index.internalPointer());
-    if (pSimulationMessage == mpRootSimulationMessage) {
-      break;
-    }
-    depth++;
+  if (!index.isValid()) {
+    return 1;
   }
-  return depth;
+  return mpSimulationMessageLog->getLevel(getRecord(index)) + 1;
 }
 
 /*!
-  Inserts the simulation message in the data.
-  \param pSimulationMessage - the simulation message to insert.
-  */
-void SimulationMessageModel::insertSimulationMessage(SimulationMessage *pSimulationMessage)
+ * \brief SimulationMessageModel::simulationMessagesAppended
+ * Adds the rows of the top level messages appended to the log which match the filter.
+ */
+void SimulationMessageModel::simulationMessagesAppended()
 {
-  if (pSimulationMessage) {
-    int row = mpRootSimulationMessage->children().size();
-    beginInsertRows(QModelIndex(), row, row);
-    mpRootSimulationMessage->insertChild(row, pSimulationMessage);
-    endInsertRows();
+  const QVector<int> &topLevelRecords = mpSimulationMessageLog->getTopLevelRecords();
+  if (mFilteredTopLevelRecordsCount >= topLevelRecords.size()) {
+    return;
+  }
+  QVector<int> rows = filterTopLevelRecords(mFilteredTopLevelRecordsCount);
+  mFilteredTopLevelRecordsCount = topLevelRecords.size();
+  if (rows.isEmpty()) {
+    return;
   }
+  beginInsertRows(QModelIndex(), mRows.size(), mRows.size() + rows.size() - 1);
+  mRows += rows;
+  endInsertRows();
 }
 
 /*!
-  Emits the QAbstractItemModel::layoutChanged which calls the ItemDelegate::sizeHint.\n
-  This is needed for views which shows rich text using QTextDocument.\n
-  The ItemDelegate then automatically word wraps the text and finds the optimal height for multiline items.
+ * \brief SimulationMessageModel::setFilter
+ * Filters the top level messages. A message matches if it or one of its children matches.
+ * \param typesMask - the mask of the message types. \sa SimulationMessageLog::getTypeMask()
+ * \param stream - the stream index in SimulationMessageLog::getStreams() or -1 for all streams.
+ * \param text - the text to find. An empty text matches all messages.
+ * \param caseSensitivity
+ */
+void SimulationMessageModel::setFilter(quint32 typesMask, int stream, QString text, Qt::CaseSensitivity caseSensitivity)
+{
+  mTypesMask = typesMask;
+  mStream = stream;
+  mFilterText = text;
+  mCaseSensitivity = caseSensitivity;
+  beginResetModel();
+  mRows = filterTopLevelRecords(0);
+  mFilteredTopLevelRecordsCount = mpSimulationMessageLog->getTopLevelRecords().size();
+  endResetModel();
+}
+
+/*!
+  Emits the QAbstractItemModel::layoutChanged which calls the ItemDelegate::sizeHint.
   */
 void SimulationMessageModel::callLayoutChanged()
 {
@@ -213,68 +276,57 @@ void SimulationMessageModel::callLayoutChanged()
 }
 
 /*!
-  Retuns the list of selected rows of the model.\n
-  The rows are returned as they are displayed in the view without any ordering/sorting.\n
-  Beats the QTreeView::selectionModel()::selectedRows() which returns the nested item rows first.
-  */
-QModelIndexList SimulationMessageModel::selectedRows()
+ * \brief lessThanRecord
+ * Sorts the indexes by records which is the order in which they are displayed.
+ */
+static bool lessThanRecord(const QModelIndex &index1, const QModelIndex &index2)
 {
-  mSelectedRowsList.clear();
-  selectedRowsHelper(mpRootSimulationMessage);
-  return mSelectedRowsList;
+  return index1.internalId() < index2.internalId();
 }
 
 /*!
-  Finds the QModelIndex represented by the specified SimulationMessage.
+  Retuns the list of selected rows of the model.\n
+  The rows are returned as they are displayed in the view without any ordering/sorting.\n
+  Beats the QTreeView::selectionModel()::selectedRows() which returns the nested item rows first.
   */
-QModelIndex SimulationMessageModel::simulationMessageIndex(const SimulationMessage *pSimulationMessage) const
+QModelIndexList SimulationMessageModel::selectedRows()
 {
-  return simulationMessageIndexHelper(pSimulationMessage, mpRootSimulationMessage, QModelIndex());
+  QModelIndexList selectedRowsList = mpSimulationOutputWidget->getSimulationOutputTree()->selectionModel()->selectedRows();
+  qSort(selectedRowsList.begin(), selectedRowsList.end(), lessThanRecord);
+  return selectedRowsList;
 }
 
 /*!
-  Helper function for selectedRows.
-  \param pParentSimulationMessage - a pointer to SimulationMessage.
-  \sa selectedRows()
-  */
-void SimulationMessageModel::selectedRowsHelper(SimulationMessage *pParentSimulationMessage)
+ * \brief SimulationMessageModel::filterTopLevelRecords
+ * \param first - the first top level message to filter.
+ * \return the records of the top level messages from first which match the filter.
+ */
+QVector<int> SimulationMessageModel::filterTopLevelRecords(int first) const
 {
-  foreach (SimulationMessage *pSimulationMessage, pParentSimulationMessage->children()) {
-    QModelIndex index = simulationMessageIndex(pSimulationMessage);
-    if (index.isValid()) {
-      if (mpSimulationOutputWidget->getSimulationOutputTree()->selectionModel()->isSelected(index)) {
-        mSelectedRowsList.append(index);
-      }
-      if (pSimulationMessage->children().size() > 0) {
-        selectedRowsHelper(pSimulationMessage);
-      }
+  const QVector<int> &topLevelRecords = mpSimulationMessageLog->getTopLevelRecords();
+  QVector<int> rows;
+  if (first >= topLevelRecords.size()) {
+    return rows;
+  }
+  QSet<int> foundRecords;
+  if (!mFilterText.isEmpty()) {
+    foundRecords = mpSimulationMessageLog->findTopLevelRecords(topLevelRecords.at(first), mFilterText, mCaseSensitivity);
+  }
+  for (int i = first ; i < topLevelRecords.size() ; i++) {
+    int record = topLevelRecords.at(i);
+    if (mpSimulationMessageLog->matchesFilter(record, mTypesMask, mStream) && (mFilterText.isEmpty() || foundRecords.contains(record))) {
+      rows.append(record);
     }
   }
-}
-
-/*!
-  Helper function to find the QModelIndex.
-  \sa simulationMessageIndex()
-  */
-QModelIndex SimulationMessageModel::simulationMessageIndexHelper(const SimulationMessage *pSimulationMessage,
-                                                             const SimulationMessage *pParentSimulationMessage,
-                                                             const QModelIndex &parentIndex) const
-{
-  if (pSimulationMessage == pParentSimulationMessage)
-    return parentIndex;
-  for (int i = pParentSimulationMessage->children().size(); --i >= 0; ) {
-    const SimulationMessage *pChildSimulationMessage = pParentSimulationMessage->children().at(i);
-    QModelIndex childIndex = index(i, 0, parentIndex);
-    QModelIndex index = simulationMessageIndexHelper(pSimulationMessage, pChildSimulationMessage, childIndex);
-    if (index.isValid())
-      return index;
-  }
-  return QModelIndex();
+  return rows;
 }
 
 /*!
   \class SimulationOutputHandler
   \brief Parses the xml output of simulation executable.
+  The output is tokenized incrementally on the raw bytes. Only an incomplete tag is kept between the output chunks.
+  The parsed messages are appended to SimulationMessageLog, a <result file>_messages_XXXXXX.log file of the run, in batches every
+  flushInterval milliseconds and then shown in the view.
   */
 /*
   <message stream="LOG_STATS" type="info" text="events">
@@ -289,121 +341,324 @@ QModelIndex SimulationMessageModel::simulationMessageIndexHelper(const Simulatio
   \param pSimulationOutputWidget - a pointer to SimulationOutputWidget.
   \param simulationOutput - the simulation output
   */
-SimulationOutputHandler::SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget, QString simulationOutput)
+SimulationOutputHandler::SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget, QByteArray simulationOutput)
 {
   mpSimulationOutputWidget = pSimulationOutputWidget;
-  mLevel = 0;
-  mpSimulationMessage = 0;
+  SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+  mpSimulationMessageLog = new SimulationMessageLog(QString("%1/%2_messages_XXXXXX.log").arg(simulationOptions.getWorkingDirectory())
+                                                    .arg(QFileInfo(simulationOptions.getResultFileName()).completeBaseName()));
   if (mpSimulationOutputWidget->isOutputStructured()) {
-    mpSimulationMessageModel = new SimulationMessageModel(mpSimulationOutputWidget);
+    mpSimulationMessageModel = new SimulationMessageModel(mpSimulationOutputWidget, mpSimulationMessageLog);
   } else {
     mpSimulationMessageModel = 0;
   }
-  mXmlSimpleReader.setContentHandler(this);
-  mXmlSimpleReader.setErrorHandler(this);
-  mpXmlInputSource = new QXmlInputSource;
-  mpXmlInputSource->setData(simulationOutput.prepend("<root>"));
-  mOutputBuffer = mpXmlInputSource->data();
-  mXmlSimpleReader.parse(mpXmlInputSource, true);
+  mFlushTimer.setSingleShot(true);
+  mFlushTimer.setInterval(flushInterval);
+  connect(&mFlushTimer, SIGNAL(timeout()), SLOT(flushSimulationMessages()));
+  parseSimulationOutput(simulationOutput);
 }
 
 SimulationOutputHandler::~SimulationOutputHandler()
 {
-  delete mpXmlInputSource;
+  qDeleteAll(mPendingSimulationMessages);
+  // the first message of the stack owns the others.
+  if (!mSimulationMessagesStack.isEmpty()) {
+    delete mSimulationMessagesStack.first();
+  }
+  if (mpSimulationMessageModel) {
+    delete mpSimulationMessageModel;
+  }
+  delete mpSimulationMessageLog;
 }
 
 /*!
-  Sets the new simulation output data and continues the parsing.
-  */
-void SimulationOutputHandler::parseSimulationOutput(QString output)
+ * \brief SimulationOutputHandler::parseSimulationOutput
+ * Tokenizes the new simulation output. The incomplete tag or line at the end is kept for the next output.
+ * \param output
+ */
+void SimulationOutputHandler::parseSimulationOutput(QByteArray output)
+{
+  mBuffer.append(output);
+  const char *pData = mBuffer.constData();
+  int size = mBuffer.size();
+  int position = 0;
+  while (position < size) {
+    if (pData[position] == '<') {
+      int tagEnd = findTagEnd(position);
+      if (tagEnd < 0) {
+        break;
+      }
+      parseTag(pData + position + 1, tagEnd - position - 1);
+      position = tagEnd + 1;
+    } else {
+      int textEnd = mBuffer.indexOf('<', position);
+      // if there is no tag then only take the complete lines.
+      if (textEnd < 0) {
+        textEnd = mBuffer.lastIndexOf('\n') + 1;
+        if (textEnd <= position) {
+          break;
+        }
+      }
+      addTextMessage(pData + position, textEnd - position);
+      position = textEnd;
+    }
+  }
+  mBuffer.remove(0, position);
+  // don't let a broken tag grow the buffer without a limit.
+  if (mBuffer.size() > maximumBufferSize) {
+    addTextMessage(mBuffer.constData(), mBuffer.size());
+    mBuffer.clear();
+  }
+  if (!mPendingSimulationMessages.isEmpty() && !mFlushTimer.isActive()) {
+    mFlushTimer.start();
+  }
+}
+
+/*!
+ * \brief SimulationOutputHandler::finishSimulationOutput
+ * Called when the simulation process is finished.\n
+ * Queues the messages which are not closed and the remaining output which has no new line or is an incomplete tag, and shows them.
+ */
+void SimulationOutputHandler::finishSimulationOutput()
 {
-  mpXmlInputSource->setData(output);
-  mOutputBuffer.append(mpXmlInputSource->data());
-  mXmlSimpleReader.parseContinue();
+  // the first message of the stack owns the others.
+  if (!mSimulationMessagesStack.isEmpty()) {
+    mPendingSimulationMessages.append(mSimulationMessagesStack.first());
+    mSimulationMessagesStack.clear();
+  }
+  if (!mBuffer.isEmpty()) {
+    addTextMessage(mBuffer.constData(), mBuffer.size());
+    mBuffer.clear();
+  }
+  flushSimulationMessages();
 }
 
 /*!
-  The reader calls this function when it has parsed a start element tag.
-  */
-bool SimulationOutputHandler::startElement(const QString &namespaceURI, const QString &localName, const QString &qName,
-                                           const QXmlAttributes &atts)
+ * \brief SimulationOutputHandler::findTagEnd
+ * \param position - the position of the tag start in the buffer.
+ * \return the position of the closing > of the tag or -1 if the tag is incomplete.
+ */
+int SimulationOutputHandler::findTagEnd(int position)
 {
-  Q_UNUSED(namespaceURI);
-  Q_UNUSED(localName);
-  if (qName == "message") {
-    if (mpSimulationOutputWidget->isOutputStructured()) {
-      mpSimulationMessage = new SimulationMessage(mpSimulationMessageModel->getRootSimulationMessage());
-    } else {
-      mpSimulationMessage = new SimulationMessage;
-    }
-    mpSimulationMessage->mStream = atts.value("stream");
-    mpSimulationMessage->mType = StringHandler::getSimulationMessageType(atts.value("type"));
-    mpSimulationMessage->mText = Qt::convertFromPlainText(atts.value("text"));
-    mpSimulationMessage->mLevel = mLevel;
-    mSimulationMessagesLevelMap.insert(mLevel, mpSimulationMessage);
-    if (mLevel > 0) {
-      SimulationMessage *pSimulationMessage = mSimulationMessagesLevelMap.value(mLevel - 1, 0);
-      if (pSimulationMessage) {
-        mpSimulationMessage->setParent(pSimulationMessage);
-        pSimulationMessage->mChildren.append(mpSimulationMessage);
+  const char *pData = mBuffer.constData();
+  int size = mBuffer.size();
+  char quote = 0;
+  for (int i = position + 1 ; i < size ; i++) {
+    char c = pData[i];
+    if (quote) {
+      if (c == quote) {
+        quote = 0;
       }
+    } else if (c == '"' || c == '\'') {
+      quote = c;
+    } else if (c == '>') {
+      return i;
     }
-    mLevel++;
-  } else if (qName == "used") {
-    if (mpSimulationMessage) {
-      mpSimulationMessage->mIndex = atts.value("index");
+  }
+  return -1;
+}
+
+/*!
+ * \brief SimulationOutputHandler::parseTag
+ * Handles the message and used tags. The other tags are ignored.
+ * \param pData - the tag contents without the enclosing < and >.
+ * \param size
+ */
+void SimulationOutputHandler::parseTag(const char *pData, int size)
+{
+  if (size > 0 && pData[0] == '/') {
+    if (QByteArray::fromRawData(pData + 1, size - 1).trimmed() == "message") {
+      endMessage();
+    }
+    return;
+  }
+  bool selfClosing = size > 0 && pData[size - 1] == '/';
+  if (selfClosing) {
+    size--;
+  }
+  int nameEnd = 0;
+  while (nameEnd < size && !isSpace(pData[nameEnd])) {
+    nameEnd++;
+  }
+  QByteArray name = QByteArray::fromRawData(pData, nameEnd);
+  if (name == "message") {
+    startMessage(parseAttributes(pData + nameEnd, size - nameEnd));
+    if (selfClosing) {
+      endMessage();
+    }
+  } else if (name == "used") {
+    if (!mSimulationMessagesStack.isEmpty()) {
+      mSimulationMessagesStack.last()->mIndex = parseAttributes(pData + nameEnd, size - nameEnd).value("index");
     }
   }
-  return true;
 }
 
 /*!
-  The reader calls this function when it has parsed a end element tag.
-  */
-bool SimulationOutputHandler::endElement(const QString &namespaceURI, const QString &localName, const QString &qName)
+ * \brief SimulationOutputHandler::parseAttributes
+ * \param pData - the attributes part of the tag.
+ * \param size
+ * \return the attributes with their decoded values.
+ */
+QHash<QByteArray, QString> SimulationOutputHandler::parseAttributes(const char *pData, int size)
 {
-  Q_UNUSED(namespaceURI);
-  Q_UNUSED(localName);
-  if (qName == "message") {
-    mLevel--;
-    // if mLevel is 0 then we have finished the one complete top level message tag. Add it to SimulationMessageModel now.
-    if (mLevel == 0) {
-      if (mpSimulationOutputWidget->isOutputStructured()) {
-        mpSimulationMessageModel->insertSimulationMessage(mSimulationMessagesLevelMap.value(0, 0));
+  QHash<QByteArray, QString> attributes;
+  int i = 0;
+  while (i < size) {
+    while (i < size && isSpace(pData[i])) {
+      i++;
+    }
+    int nameStart = i;
+    while (i < size && pData[i] != '=' && !isSpace(pData[i])) {
+      i++;
+    }
+    QByteArray name(pData + nameStart, i - nameStart);
+    while (i < size && pData[i] != '"' && pData[i] != '\'') {
+      i++;
+    }
+    if (i >= size) {
+      break;
+    }
+    char quote = pData[i++];
+    int valueStart = i;
+    while (i < size && pData[i] != quote) {
+      i++;
+    }
+    attributes.insert(name, decodeEntities(QByteArray::fromRawData(pData + valueStart, i - valueStart)));
+    i++;
+  }
+  return attributes;
+}
+
+/*!
+ * \brief SimulationOutputHandler::decodeEntities
+ * Converts the utf-8 value to QString and replaces the xml entities.
+ * \param value
+ * \return
+ */
+QString SimulationOutputHandler::decodeEntities(const QByteArray &value)
+{
+  QString text = QString::fromUtf8(value.constData(), value.size());
+  if (!text.contains('&')) {
+    return text;
+  }
+  QString decodedText;
+  decodedText.reserve(text.size());
+  int i = 0;
+  while (i < text.size()) {
+    int entityEnd = text.at(i) == '&' ? text.indexOf(';', i) : -1;
+    if (entityEnd < 0 || entityEnd - i > 10) {
+      decodedText.append(text.at(i++));
+      continue;
+    }
+    QString entity = text.mid(i + 1, entityEnd - i - 1);
+    if (entity == "lt") {
+      decodedText.append('<');
+    } else if (entity == "gt") {
+      decodedText.append('>');
+    } else if (entity == "amp") {
+      decodedText.append('&');
+    } else if (entity == "quot") {
+      decodedText.append('"');
+    } else if (entity == "apos") {
+      decodedText.append('\'');
+    } else if (entity.startsWith('#')) {
+      bool ok;
+      uint code = entity.startsWith("#x") ? entity.mid(2).toUInt(&ok, 16) : entity.mid(1).toUInt(&ok, 10);
+      if (ok) {
+        decodedText.append(QString::fromUcs4(&code, 1));
       } else {
-        mpSimulationOutputWidget->writeSimulationMessage(mSimulationMessagesLevelMap.value(0, 0));
+        decodedText.append(text.mid(i, entityEnd - i + 1));
       }
+    } else {
+      decodedText.append(text.mid(i, entityEnd - i + 1));
     }
+    i = entityEnd + 1;
   }
-  return true;
+  return decodedText;
 }
 
 /*!
-  Reports a non-recoverable error. Details of the error are stored in exception.
-  */
-bool SimulationOutputHandler::fatalError(const QXmlParseException &exception)
+ * \brief SimulationOutputHandler::addTextMessage
+ * Adds the text outside of the message tags as a stdout message.
+ * \param pData
+ * \param size
+ */
+void SimulationOutputHandler::addTextMessage(const char *pData, int size)
 {
-  // read the error message
-  QString error = QString("Fatal error on line %1, column %2: %3\nXML ::\n%4")
-      .arg(exception.lineNumber())
-      .arg(exception.columnNumber())
-      .arg(exception.message())
-      .arg(mOutputBuffer);
-  // construct the SimulationMessage object with error
-  SimulationMessage *pSimulationMessage;
-  if (mpSimulationOutputWidget->isOutputStructured()) {
-    pSimulationMessage = new SimulationMessage(mpSimulationMessageModel->getRootSimulationMessage());
-  } else {
-    pSimulationMessage = new SimulationMessage;
+  // the text inside the message tags is not used.
+  if (!mSimulationMessagesStack.isEmpty()) {
+    return;
+  }
+  QByteArray text = QByteArray::fromRawData(pData, size).trimmed();
+  if (text.isEmpty()) {
+    return;
+  }
+  SimulationMessage *pSimulationMessage = new SimulationMessage;
+  pSimulationMessage->mStream = "stdout";
+  pSimulationMessage->mType = StringHandler::Unknown;
+  pSimulationMessage->mText = QString::fromUtf8(text.constData(), text.size());
+  mPendingSimulationMessages.append(pSimulationMessage);
+}
+
+/*!
+ * \brief SimulationOutputHandler::startMessage
+ * Creates the message and adds it to its parent message.
+ * \param attributes
+ */
+void SimulationOutputHandler::startMessage(const QHash<QByteArray, QString> &attributes)
+{
+  SimulationMessage *pParentSimulationMessage = mSimulationMessagesStack.isEmpty() ? 0 : mSimulationMessagesStack.last();
+  SimulationMessage *pSimulationMessage = new SimulationMessage(pParentSimulationMessage);
+  pSimulationMessage->mStream = attributes.value("stream");
+  pSimulationMessage->mType = StringHandler::getSimulationMessageType(attributes.value("type"));
+  pSimulationMessage->mText = attributes.value("text");
+  pSimulationMessage->mLevel = mSimulationMessagesStack.size();
+  if (pParentSimulationMessage) {
+    pParentSimulationMessage->mChildren.append(pSimulationMessage);
   }
-  pSimulationMessage->mStream = "stderr";
-  pSimulationMessage->mType = StringHandler::getSimulationMessageType("error");
-  pSimulationMessage->mText = error;
-  pSimulationMessage->mLevel = 0;
+  mSimulationMessagesStack.append(pSimulationMessage);
+}
+
+/*!
+ * \brief SimulationOutputHandler::endMessage
+ * If the top level message is complete then queues it for the view.
+ */
+void SimulationOutputHandler::endMessage()
+{
+  if (mSimulationMessagesStack.isEmpty()) {
+    return;
+  }
+  SimulationMessage *pSimulationMessage = mSimulationMessagesStack.takeLast();
+  if (mSimulationMessagesStack.isEmpty()) {
+    mPendingSimulationMessages.append(pSimulationMessage);
+  }
+}
+
+/*!
+ * \brief SimulationOutputHandler::flushSimulationMessages
+ * Slot activated when mFlushTimer timeout signal is raised.\n
+ * Appends the parsed messages to the log and shows them. Also called when the simulation is finished.
+ */
+void SimulationOutputHandler::flushSimulationMessages()
+{
+  mFlushTimer.stop();
+  if (mPendingSimulationMessages.isEmpty()) {
+    return;
+  }
+  QList<SimulationMessage*> simulationMessages = mPendingSimulationMessages;
+  mPendingSimulationMessages.clear();
+  int streamsCount = mpSimulationMessageLog->getStreams().size();
+  foreach (SimulationMessage *pSimulationMessage, simulationMessages) {
+    mpSimulationMessageLog->appendSimulationMessage(pSimulationMessage);
+  }
+  if (!mpSimulationOutputWidget->isOutputStructured()) {
+    mpSimulationOutputWidget->writeSimulationMessages(simulationMessages);
+  }
+  qDeleteAll(simulationMessages);
   if (mpSimulationOutputWidget->isOutputStructured()) {
-    mpSimulationMessageModel->insertSimulationMessage(pSimulationMessage);
-  } else {
-    mpSimulationOutputWidget->writeSimulationMessage(pSimulationMessage);
+    mpSimulationMessageModel->simulationMessagesAppended();
+    if (mpSimulationMessageLog->getStreams().size() != streamsCount) {
+      mpSimulationOutputWidget->updateSimulationOutputStreams(mpSimulationMessageLog->getStreams());
+    }
   }
-  return false;
 }
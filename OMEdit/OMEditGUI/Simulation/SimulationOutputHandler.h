@@ -53,7 +53,8 @@ public:
 public:
   SimulationMessage(SimulationMessage *pParentSimulationMessage = 0)
     : mpParentSimulationMessage(pParentSimulationMessage)
-  {mStream = ""; mType = StringHandler::Unknown; mText = ""; mIndex = "";}
+  {mStream = ""; mType = StringHandler::Unknown; mText = ""; mLevel = 0; mIndex = "";}
+  ~SimulationMessage() {qDeleteAll(mChildren);}
   void setParent(SimulationMessage *pParentSimulationMessage) {mpParentSimulationMessage = pParentSimulationMessage;}
   SimulationMessage *parent() {return mpParentSimulationMessage;}
   SimulationMessage *child(int row) {return mChildren.value(row);}
@@ -69,52 +70,66 @@ public:
   }
 };
 
+class SimulationMessageLog;
 class SimulationMessageModel : public QAbstractItemModel
 {
   Q_OBJECT
 public:
-  SimulationMessageModel(SimulationOutputWidget *pSimulationOutputWidget, QObject *pParent = 0);
+  SimulationMessageModel(SimulationOutputWidget *pSimulationOutputWidget, SimulationMessageLog *pSimulationMessageLog, QObject *pParent = 0);
   virtual QModelIndex index(int row, int column, const QModelIndex &parent) const;
   virtual QModelIndex parent(const QModelIndex &child) const;
   virtual int rowCount(const QModelIndex &parent) const;
   virtual int columnCount(const QModelIndex &parent) const;
   virtual QVariant data(const QModelIndex &index, int role) const;
-  SimulationMessage* getRootSimulationMessage() {return mpRootSimulationMessage;}
+  SimulationMessageLog* getSimulationMessageLog() {return mpSimulationMessageLog;}
+  SimulationMessage* getSimulationMessage(const QModelIndex &index) const;
   int getDepth(const QModelIndex &index) const;
-  void insertSimulationMessage(SimulationMessage *pSimulationMessage);
+  void simulationMessagesAppended();
+  void setFilter(quint32 typesMask, int stream, QString text, Qt::CaseSensitivity caseSensitivity);
   void callLayoutChanged();
   QModelIndexList selectedRows();
-  QModelIndex simulationMessageIndex(const SimulationMessage *pSimulationMessage) const;
 private:
   SimulationOutputWidget *mpSimulationOutputWidget;
-  SimulationMessage* mpRootSimulationMessage;
-  QModelIndexList mSelectedRowsList;
+  SimulationMessageLog *mpSimulationMessageLog;
+  QVector<int> mRows;
+  int mFilteredTopLevelRecordsCount;
+  quint32 mTypesMask;
+  int mStream;
+  QString mFilterText;
+  Qt::CaseSensitivity mCaseSensitivity;
 
-  void selectedRowsHelper(SimulationMessage *pParentSimulationMessage);
-  QModelIndex simulationMessageIndexHelper(const SimulationMessage *pSimulationMessage, const SimulationMessage *pParentSimulationMessage,
-                                           const QModelIndex &parentIndex) const;
+  int getRecord(const QModelIndex &index) const {return (int)index.internalId();}
+  QVector<int> filterTopLevelRecords(int first) const;
 };
 
-class SimulationOutputHandler : private QXmlDefaultHandler
+class SimulationOutputHandler : public QObject
 {
+  Q_OBJECT
 private:
   SimulationOutputWidget *mpSimulationOutputWidget;
-  int mLevel;
-  SimulationMessage* mpSimulationMessage;
-  QMap<int, SimulationMessage*> mSimulationMessagesLevelMap;
-  QString mOutputBuffer;
+  QByteArray mBuffer;
+  QList<SimulationMessage*> mSimulationMessagesStack;
+  QList<SimulationMessage*> mPendingSimulationMessages;
+  QTimer mFlushTimer;
+  SimulationMessageLog *mpSimulationMessageLog;
   SimulationMessageModel *mpSimulationMessageModel;
-  QXmlSimpleReader mXmlSimpleReader;
-  QXmlInputSource *mpXmlInputSource;
 
-  bool startElement(const QString &namespaceURI, const QString &localName, const QString &qName, const QXmlAttributes &atts);
-  bool endElement(const QString &namespaceURI, const QString &localName, const QString &qName);
-  bool fatalError(const QXmlParseException &exception);
+  int findTagEnd(int position);
+  void parseTag(const char *pData, int size);
+  QHash<QByteArray, QString> parseAttributes(const char *pData, int size);
+  QString decodeEntities(const QByteArray &value);
+  void addTextMessage(const char *pData, int size);
+  void startMessage(const QHash<QByteArray, QString> &attributes);
+  void endMessage();
 public:
-  SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget, QString simulationOutput);
+  SimulationOutputHandler(SimulationOutputWidget *pSimulationOutputWidget, QByteArray simulationOutput);
   ~SimulationOutputHandler();
+  SimulationMessageLog* getSimulationMessageLog() {return mpSimulationMessageLog;}
   SimulationMessageModel* getSimulationMessageModel() {return mpSimulationMessageModel;}
-  void parseSimulationOutput(QString output);
+  void parseSimulationOutput(QByteArray output);
+  void finishSimulationOutput();
+public slots:
+  void flushSimulationMessages();
 };
 
 #endif // SIMULATIONOUTPUTHANDLER_H
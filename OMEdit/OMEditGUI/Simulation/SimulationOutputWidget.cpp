@@ -36,8 +36,21 @@
  */
 
 #include "SimulationOutputWidget.h"
+#include "SimulationJobScheduler.h"
 #include "VariablesWidget.h"
 #include "CEditor.h"
+#include "SimulationMessageLog.h"
+
+/*!
+ * \brief maximumSimulationOutputBlockCount
+ * The maximum number of lines kept in the unstructured simulation output. The complete output is in the messages log file.
+ */
+static const int maximumSimulationOutputBlockCount = 10000;
+/*!
+ * \brief plotWhileSimulatingInterval
+ * The interval in milliseconds in which the result file of a running simulation is read.
+ */
+static const int plotWhileSimulatingInterval = 1000;
 
 /*!
   \class SimulationOutputTree
@@ -141,7 +154,7 @@ void SimulationOutputTree::copyMessages()
     QStringList textToCopy;
     const QModelIndexList modelIndexes = pSimulationMessageModel->selectedRows();
     foreach (QModelIndex modelIndex, modelIndexes) {
-      SimulationMessage *pSimulationMessage = static_cast<SimulationMessage*>(modelIndex.internalPointer());
+      SimulationMessage *pSimulationMessage = pSimulationMessageModel->getSimulationMessage(modelIndex);
       if (pSimulationMessage) {
         textToCopy.append(QString("%1 | %2 | %3")
                           .arg(pSimulationMessage->mStream)
@@ -191,6 +204,13 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
   connect(mpCancelButton, SIGNAL(clicked()), SLOT(cancelCompilationOrSimulation()));
   mpProgressBar = new QProgressBar;
   mpProgressBar->setAlignment(Qt::AlignHCenter);
+  // simulation statistics label
+  mpSimulationStatisticsLabel = new Label;
+  mpSimulationStatisticsLabel->hide();
+  // plot while simulating timer
+  mpPlotWhileSimulatingTimer = new QTimer(this);
+  mpPlotWhileSimulatingTimer->setInterval(plotWhileSimulatingInterval);
+  connect(mpPlotWhileSimulatingTimer, SIGNAL(timeout()), SLOT(updateVariablesWhileSimulating()));
   // Generated Files tab widget
   mpGeneratedFilesTabWidget = new QTabWidget;
   mpGeneratedFilesTabWidget->setMovable(true);
@@ -200,14 +220,52 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
     mIsOutputStructured = true;
     // simulation output browser
     mpSimulationOutputTextBrowser = 0;
+    // simulation output filters
+    mpSimulationOutputTypesComboBox = new QComboBox;
+    mpSimulationOutputTypesComboBox->addItem(tr("All Messages"), SimulationMessageLog::getAllTypesMask());
+    mpSimulationOutputTypesComboBox->addItem(tr("Errors"), SimulationMessageLog::getTypeMask(StringHandler::Error)
+                                             | SimulationMessageLog::getTypeMask(StringHandler::Assert));
+    mpSimulationOutputTypesComboBox->addItem(tr("Warnings and Errors"), SimulationMessageLog::getTypeMask(StringHandler::SMWarning)
+                                             | SimulationMessageLog::getTypeMask(StringHandler::Error)
+                                             | SimulationMessageLog::getTypeMask(StringHandler::Assert));
+    mpSimulationOutputTypesComboBox->addItem(tr("Debug"), SimulationMessageLog::getTypeMask(StringHandler::Debug));
+    connect(mpSimulationOutputTypesComboBox, SIGNAL(currentIndexChanged(int)), SLOT(filterSimulationOutput()));
+    mpSimulationOutputStreamsComboBox = new QComboBox;
+    mpSimulationOutputStreamsComboBox->addItem(tr("All Streams"), -1);
+    connect(mpSimulationOutputStreamsComboBox, SIGNAL(currentIndexChanged(int)), SLOT(filterSimulationOutput()));
+    mpFindSimulationOutputTextBox = new QLineEdit;
+    mpFindSimulationOutputTextBox->setPlaceholderText(Helper::findMessages);
+    connect(mpFindSimulationOutputTextBox, SIGNAL(returnPressed()), SLOT(filterSimulationOutput()));
+    connect(mpFindSimulationOutputTextBox, SIGNAL(textEdited(QString)), SLOT(findSimulationOutputTextEdited(QString)));
+    mpFindCaseSensitiveCheckBox = new QCheckBox(tr("Case Sensitive"));
+    connect(mpFindCaseSensitiveCheckBox, SIGNAL(toggled(bool)), SLOT(filterSimulationOutput()));
     // simulation output tree
     mpSimulationOutputTree = new SimulationOutputTree(this);
-    mpGeneratedFilesTabWidget->addTab(mpSimulationOutputTree, Helper::output);
+    QWidget *pSimulationOutputWidget = new QWidget;
+    QGridLayout *pSimulationOutputGridLayout = new QGridLayout;
+    pSimulationOutputGridLayout->setContentsMargins(0, 0, 0, 0);
+    pSimulationOutputGridLayout->addWidget(mpSimulationOutputTypesComboBox, 0, 0);
+    pSimulationOutputGridLayout->addWidget(mpSimulationOutputStreamsComboBox, 0, 1);
+    pSimulationOutputGridLayout->addWidget(mpFindSimulationOutputTextBox, 0, 2);
+    pSimulationOutputGridLayout->addWidget(mpFindCaseSensitiveCheckBox, 0, 3);
+    pSimulationOutputGridLayout->addWidget(mpSimulationOutputTree, 1, 0, 1, 4);
+    pSimulationOutputGridLayout->setColumnStretch(2, 1);
+    pSimulationOutputWidget->setLayout(pSimulationOutputGridLayout);
+    mpGeneratedFilesTabWidget->addTab(pSimulationOutputWidget, Helper::output);
   } else {
     mIsOutputStructured = false;
     // simulation output browser
     mpSimulationOutputTextBrowser = new QTextBrowser;
     mpSimulationOutputTextBrowser->setFont(QFont(Helper::monospacedFontInfo.family()));
+    /* keep the document small. The messages are appended in one edit block per flush so the document is laid out once
+     * for all of them instead of once per message.
+     */
+    mpSimulationOutputTextBrowser->document()->setMaximumBlockCount(maximumSimulationOutputBlockCount);
+    mpSimulationOutputTextBrowser->setToolTip(tr("Shows the last %1 lines of the output.").arg(maximumSimulationOutputBlockCount));
+    mpSimulationOutputTypesComboBox = 0;
+    mpSimulationOutputStreamsComboBox = 0;
+    mpFindSimulationOutputTextBox = 0;
+    mpFindCaseSensitiveCheckBox = 0;
     mpSimulationOutputTextBrowser->setOpenLinks(false);
     mpSimulationOutputTextBrowser->setOpenExternalLinks(false);
     connect(mpSimulationOutputTextBrowser, SIGNAL(anchorClicked(QUrl)), SLOT(openTransformationBrowser(QUrl)));
@@ -287,7 +345,8 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
   pMainLayout->addWidget(mpProgressLabel, 0, 0, 1, 2);
   pMainLayout->addWidget(mpProgressBar, 1, 0);
   pMainLayout->addWidget(mpCancelButton, 1, 1);
-  pMainLayout->addWidget(mpGeneratedFilesTabWidget, 2, 0, 1, 2);
+  pMainLayout->addWidget(mpSimulationStatisticsLabel, 2, 0, 1, 2);
+  pMainLayout->addWidget(mpGeneratedFilesTabWidget, 3, 0, 1, 2);
   setLayout(pMainLayout);
   // create the ArchivedSimulationItem
   mpArchivedSimulationItem = new ArchivedSimulationItem(mSimulationOptions, this);
@@ -304,11 +363,22 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
   connect(mpSimulationProcessThread, SIGNAL(sendSimulationFinished(int,QProcess::ExitStatus)),
           SLOT(simulationProcessFinished(int,QProcess::ExitStatus)));
   connect(mpSimulationProcessThread, SIGNAL(sendSimulationProgress(int)), mpProgressBar, SLOT(setValue(int)));
-  mpSimulationProcessThread->start();
+  connect(mpSimulationProcessThread, SIGNAL(sendSimulationStatistics(SimulationProgress)), SLOT(updateSimulationStatistics(SimulationProgress)));
+  // queue the job. The SimulationJobScheduler starts the thread when the processors are available.
+  SimulationJobScheduler *pSimulationJobScheduler = mpMainWindow->getSimulationDialog()->getSimulationJobScheduler();
+  if (mSimulationOptions.isReSimulate()) {
+    pSimulationJobScheduler->addSimulationJob(mpSimulationProcessThread);
+  } else {
+    pSimulationJobScheduler->addCompilationJob(mpSimulationProcessThread);
+  }
 }
 
 SimulationOutputWidget::~SimulationOutputWidget()
 {
+  // the scheduler must not start the job of a deleted widget.
+  if (mpMainWindow->getSimulationDialog()) {
+    mpMainWindow->getSimulationDialog()->getSimulationJobScheduler()->removeQueuedJob(mpSimulationProcessThread);
+  }
   if (mpSimulationOutputHandler) {
     delete mpSimulationOutputHandler;
   }
@@ -334,11 +404,31 @@ void SimulationOutputWidget::addGeneratedFileTab(QString fileName)
   }
 }
 
+/*!
+ * \brief SimulationOutputWidget::writeSimulationMessages
+ * Writes the simulation messages in a formatted text form.\n
+ * The messages are inserted in one edit block so the text browser is laid out once for all of them.
+ * \param simulationMessages - the simulation output messages.
+ */
+void SimulationOutputWidget::writeSimulationMessages(QList<SimulationMessage*> simulationMessages)
+{
+  QTextCursor textCursor(mpSimulationOutputTextBrowser->document());
+  textCursor.movePosition(QTextCursor::End);
+  textCursor.beginEditBlock();
+  foreach (SimulationMessage *pSimulationMessage, simulationMessages) {
+    writeSimulationMessage(pSimulationMessage, &textCursor);
+  }
+  textCursor.endEditBlock();
+  /* move the cursor */
+  mpSimulationOutputTextBrowser->setTextCursor(textCursor);
+}
+
 /*!
   Writes the simulation output in a formatted text form.\n
   \param - pSimulationMessage - the simulation output message.
+  \param - pTextCursor - the cursor at the end of the output.
   */
-void SimulationOutputWidget::writeSimulationMessage(SimulationMessage *pSimulationMessage)
+void SimulationOutputWidget::writeSimulationMessage(SimulationMessage *pSimulationMessage, QTextCursor *pTextCursor)
 {
   static QString lastSream;
   static QString lastType;
@@ -349,32 +439,67 @@ void SimulationOutputWidget::writeSimulationMessage(SimulationMessage *pSimulati
   for (int i = 0 ; i < pSimulationMessage->mLevel ; ++i)
     error += "| ";
   error += pSimulationMessage->mText;
-  /* move the cursor down before adding to the logger. */
-  QTextCursor textCursor = mpSimulationOutputTextBrowser->textCursor();
-  textCursor.movePosition(QTextCursor::End);
-  mpSimulationOutputTextBrowser->setTextCursor(textCursor);
   /* set the text color */
-  QTextCharFormat charFormat = mpSimulationOutputTextBrowser->currentCharFormat();
+  QTextCharFormat charFormat;
   charFormat.setForeground(StringHandler::getSimulationMessageTypeColor(pSimulationMessage->mType));
-  mpSimulationOutputTextBrowser->setCurrentCharFormat(charFormat);
-  /* append the output */
   /* write the error message */
-  mpSimulationOutputTextBrowser->insertPlainText(error);
+  pTextCursor->insertText(error, charFormat);
   /* write the error link */
   if (!pSimulationMessage->mIndex.isEmpty()) {
-    mpSimulationOutputTextBrowser->insertHtml("&nbsp;<a href=\"omedittransformationsbrowser://" + QUrl::fromLocalFile(mSimulationOptions.getWorkingDirectory() + "/" + mSimulationOptions.getFileNamePrefix() + "_info.xml").path() + "?index=" + pSimulationMessage->mIndex + "\">Debug more</a><br />");
-  } else {
-    mpSimulationOutputTextBrowser->insertPlainText("\n");
+    pTextCursor->insertText(QString(QChar(QChar::Nbsp)), charFormat);
+    QTextCharFormat linkCharFormat;
+    linkCharFormat.setAnchor(true);
+    linkCharFormat.setAnchorHref("omedittransformationsbrowser://" + QUrl::fromLocalFile(mSimulationOptions.getWorkingDirectory() + "/" + mSimulationOptions.getFileNamePrefix() + "_info.xml").path() + "?index=" + pSimulationMessage->mIndex);
+    linkCharFormat.setForeground(mpSimulationOutputTextBrowser->palette().link());
+    linkCharFormat.setFontUnderline(true);
+    pTextCursor->insertText("Debug more", linkCharFormat);
   }
+  pTextCursor->insertText("\n", charFormat);
   /* save the current stream & type as last */
   lastSream = pSimulationMessage->mStream;
   lastType = type;
   /* write the child messages */
   foreach (SimulationMessage* pSimulationMessage, pSimulationMessage->mChildren) {
-    writeSimulationMessage(pSimulationMessage);
+    writeSimulationMessage(pSimulationMessage, pTextCursor);
+  }
+}
+
+/*!
+ * \brief SimulationOutputWidget::updateSimulationOutputStreams
+ * Adds the new streams of the simulation messages to the streams filter.
+ * \param streams - the streams in the order of SimulationMessageLog::getStreams().
+ */
+void SimulationOutputWidget::updateSimulationOutputStreams(QStringList streams)
+{
+  if (!mpSimulationOutputStreamsComboBox) {
+    return;
+  }
+  // the first item is All Streams.
+  for (int i = mpSimulationOutputStreamsComboBox->count() - 1 ; i < streams.size() ; i++) {
+    mpSimulationOutputStreamsComboBox->addItem(streams.at(i), i);
   }
 }
 
+/*!
+ * \brief SimulationOutputWidget::setJobQueued
+ * Called by the SimulationJobScheduler when the job is waiting for the processors.\n
+ * Updates the progress label, bar, button controls and the status of the archived simulation.
+ * \param position - the position of the job in the queue.
+ */
+void SimulationOutputWidget::setJobQueued(int position)
+{
+  if (mpSimulationProcessThread->isCompilationProcessRunning() || mpSimulationProcessThread->isSimulationProcessRunning()) {
+    return;
+  }
+  mpProgressLabel->setText(tr("<b>%1</b> is waiting for free processors. Position %2 in the queue.")
+                           .arg(mSimulationOptions.getClassName()).arg(position));
+  mpProgressBar->setRange(0, 0);
+  mpProgressBar->setTextVisible(false);
+  mpCancelButton->setText(Helper::cancel);
+  mpCancelButton->setEnabled(true);
+  mpArchivedSimulationItem->setStatus(QString("%1 (%2)").arg(Helper::queued).arg(position));
+}
+
 /*!
   Slot activated when SimulationProcessThread sendCompilationStarted signal is raised.\n
   Updates the progress label, bar and button controls.
@@ -386,6 +511,7 @@ void SimulationOutputWidget::compilationProcessStarted()
   mpProgressBar->setTextVisible(false);
   mpCancelButton->setText(tr("Cancel Compilation"));
   mpCancelButton->setEnabled(true);
+  mpArchivedSimulationItem->setStatus(Helper::running);
 }
 
 /*!
@@ -441,16 +567,63 @@ void SimulationOutputWidget::simulationProcessStarted()
   mpProgressLabel->setText(tr("Running simulation of <b>%1</b>. Please wait for a while.").arg(mSimulationOptions.getClassName()));
   mpProgressBar->setRange(0, 100);
   mpProgressBar->setTextVisible(true);
+  mpSimulationStatisticsLabel->clear();
+  mpSimulationStatisticsLabel->show();
+  if (mSimulationOptions.getPlotWhileSimulating()) {
+    mpPlotWhileSimulatingTimer->start();
+  }
   mpCancelButton->setText(Helper::cancelSimulation);
   mpCancelButton->setEnabled(true);
   // save the last modified datetime of result file.
   QFileInfo resultFileInfo(QString(mSimulationOptions.getWorkingDirectory()).append("/").append(mSimulationOptions.getResultFileName()));
   if (resultFileInfo.exists()) {
     mResultFileLastModifiedDateTime = resultFileInfo.lastModified();
+  } else {
+    mResultFileLastModifiedDateTime = QDateTime();
   }
   mpArchivedSimulationItem->setStatus(Helper::running);
 }
 
+/*!
+ * \brief SimulationOutputWidget::updateSimulationStatistics
+ * Slot activated when SimulationProcessThread sendSimulationStatistics signal is raised.\n
+ * Shows the solver statistics. The statistics not sent by the simulation executable are not shown.
+ * \param simulationProgress
+ */
+void SimulationOutputWidget::updateSimulationStatistics(SimulationProgress simulationProgress)
+{
+  QStringList statistics;
+  if (simulationProgress.mTime >= 0) {
+    statistics.append(tr("Time: %1").arg(simulationProgress.mTime));
+  }
+  if (simulationProgress.mStepSize >= 0) {
+    statistics.append(tr("Step size: %1").arg(simulationProgress.mStepSize));
+  }
+  if (simulationProgress.mSteps >= 0) {
+    statistics.append(tr("Steps: %1").arg(simulationProgress.mSteps));
+  }
+  if (simulationProgress.mEvents >= 0) {
+    statistics.append(tr("Events: %1").arg(simulationProgress.mEvents));
+  }
+  statistics.append(tr("Elapsed: %1 s").arg(simulationProgress.mElapsedTime, 0, 'f', 1));
+  if (simulationProgress.mRate >= 0) {
+    statistics.append(tr("Rate: %1 simulated s/s").arg(simulationProgress.mRate, 0, 'g', 3));
+  }
+  mpSimulationStatisticsLabel->setText(statistics.join(" | "));
+}
+
+/*!
+ * \brief SimulationOutputWidget::updateVariablesWhileSimulating
+ * Slot activated when mpPlotWhileSimulatingTimer timeout signal is raised.\n
+ * Shows the result variables and updates the plotted curves of the running simulation.
+ */
+void SimulationOutputWidget::updateVariablesWhileSimulating()
+{
+  if (mpMainWindow->getVariablesWidget()->updateVariablesWhileSimulating(mSimulationOptions, mResultFileLastModifiedDateTime)) {
+    mpMainWindow->getVariablesDockWidget()->show();
+  }
+}
+
 /*!
   Slot activated when SimulationProcessThread sendSimulationOutput signal is raised.\n
   Writes the simulation standard output to the simulation output text box.
@@ -471,10 +644,10 @@ void SimulationOutputWidget::writeSimulationOutput(QString output, StringHandler
           .arg(escaped);
     }
     if (!mpSimulationOutputHandler) {
-      mpSimulationOutputHandler = new SimulationOutputHandler(this, output);
+      mpSimulationOutputHandler = new SimulationOutputHandler(this, output.toUtf8());
       mpSimulationOutputTree->setModel(mpSimulationOutputHandler->getSimulationMessageModel());
     } else {
-      mpSimulationOutputHandler->parseSimulationOutput(output);
+      mpSimulationOutputHandler->parseSimulationOutput(output.toUtf8());
     }
   } else {
     /* move the cursor down before adding to the logger. */
@@ -487,11 +660,18 @@ void SimulationOutputWidget::writeSimulationOutput(QString output, StringHandler
     mpSimulationOutputTextBrowser->setCurrentCharFormat(charFormat);
     /* append the output */
     if (textFormat) {
+      // write the parsed messages first to keep the order of the output.
+      if (mpSimulationOutputHandler) {
+        mpSimulationOutputHandler->flushSimulationMessages();
+        textCursor.movePosition(QTextCursor::End);
+        mpSimulationOutputTextBrowser->setTextCursor(textCursor);
+        mpSimulationOutputTextBrowser->setCurrentCharFormat(charFormat);
+      }
       mpSimulationOutputTextBrowser->insertPlainText(output + "\n");
     } else if (!mpSimulationOutputHandler) {
-      mpSimulationOutputHandler = new SimulationOutputHandler(this, output);
+      mpSimulationOutputHandler = new SimulationOutputHandler(this, output.toUtf8());
     } else {
-      mpSimulationOutputHandler->parseSimulationOutput(output);
+      mpSimulationOutputHandler->parseSimulationOutput(output.toUtf8());
     }
     /* move the cursor */
     textCursor.movePosition(QTextCursor::End);
@@ -509,6 +689,10 @@ void SimulationOutputWidget::simulationProcessFinished(int exitCode, QProcess::E
 {
   Q_UNUSED(exitCode);
   Q_UNUSED(exitStatus);
+  if (mpSimulationOutputHandler) {
+    mpSimulationOutputHandler->finishSimulationOutput();
+  }
+  mpPlotWhileSimulatingTimer->stop();
   mpProgressLabel->setText(tr("Simulation of <b>%1</b> is finished.").arg(mSimulationOptions.getClassName()));
   mpProgressBar->setValue(mpProgressBar->maximum());
   mpCancelButton->setEnabled(false);
@@ -522,7 +706,13 @@ void SimulationOutputWidget::simulationProcessFinished(int exitCode, QProcess::E
   */
 void SimulationOutputWidget::cancelCompilationOrSimulation()
 {
-  if (mpSimulationProcessThread->isCompilationProcessRunning()) {
+  if (mpMainWindow->getSimulationDialog()->getSimulationJobScheduler()->removeQueuedJob(mpSimulationProcessThread)) {
+    mpProgressLabel->setText(tr("<b>%1</b> is cancelled.").arg(mSimulationOptions.getClassName()));
+    mpProgressBar->setRange(0, 1);
+    mpProgressBar->setValue(1);
+    mpCancelButton->setEnabled(false);
+    mpArchivedSimulationItem->setStatus(Helper::finished);
+  } else if (mpSimulationProcessThread->isCompilationProcessRunning()) {
     mpSimulationProcessThread->getCompilationProcess()->kill();
     mpProgressLabel->setText(tr("Compilation of <b>%1</b> is cancelled.").arg(mSimulationOptions.getClassName()));
     mpProgressBar->setRange(0, 1);
@@ -576,3 +766,35 @@ void SimulationOutputWidget::openTransformationBrowser(QUrl url)
     /* TODO: Display error-message */
   }
 }
+
+/*!
+ * \brief SimulationOutputWidget::filterSimulationOutput
+ * Filters the simulation output messages by type, stream and text.\n
+ * Slot activated when the filters are changed or when returnPressed signal of mpFindSimulationOutputTextBox is raised.
+ */
+void SimulationOutputWidget::filterSimulationOutput()
+{
+  if (!mpSimulationOutputHandler || !mpSimulationOutputHandler->getSimulationMessageModel()) {
+    return;
+  }
+  quint32 typesMask = mpSimulationOutputTypesComboBox->itemData(mpSimulationOutputTypesComboBox->currentIndex()).toUInt();
+  int stream = mpSimulationOutputStreamsComboBox->itemData(mpSimulationOutputStreamsComboBox->currentIndex()).toInt();
+  Qt::CaseSensitivity caseSensitivity = mpFindCaseSensitiveCheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+  /* finding the text reads the whole messages log so show the wait cursor. */
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  mpSimulationOutputHandler->getSimulationMessageModel()->setFilter(typesMask, stream, mpFindSimulationOutputTextBox->text(), caseSensitivity);
+  QApplication::restoreOverrideCursor();
+}
+
+/*!
+ * \brief SimulationOutputWidget::findSimulationOutputTextEdited
+ * Slot activated when mpFindSimulationOutputTextBox textEdited signal is raised.\n
+ * The text is only searched when return is pressed. Clearing the text removes the text filter.
+ * \param text
+ */
+void SimulationOutputWidget::findSimulationOutputTextEdited(QString text)
+{
+  if (text.isEmpty()) {
+    filterSimulationOutput();
+  }
+}
@@ -84,31 +84,44 @@ public:
   QPlainTextEdit* getCompilationOutputTextBox() {return mpCompilationOutputTextBox;}
   SimulationProcessThread* getSimulationProcessThread() {return mpSimulationProcessThread;}
   void addGeneratedFileTab(QString fileName);
-  void writeSimulationMessage(SimulationMessage *pSimulationMessage);
+  void writeSimulationMessages(QList<SimulationMessage*> simulationMessages);
+  void updateSimulationOutputStreams(QStringList streams);
+  void setJobQueued(int position);
 private:
   SimulationOptions mSimulationOptions;
   MainWindow *mpMainWindow;
   Label *mpProgressLabel;
   QProgressBar *mpProgressBar;
+  Label *mpSimulationStatisticsLabel;
   QPushButton *mpCancelButton;
   QTabWidget *mpGeneratedFilesTabWidget;
   SimulationOutputHandler *mpSimulationOutputHandler;
   bool mIsOutputStructured;
   QTextBrowser *mpSimulationOutputTextBrowser;
+  QComboBox *mpSimulationOutputTypesComboBox;
+  QComboBox *mpSimulationOutputStreamsComboBox;
+  QLineEdit *mpFindSimulationOutputTextBox;
+  QCheckBox *mpFindCaseSensitiveCheckBox;
   SimulationOutputTree *mpSimulationOutputTree;
   QPlainTextEdit *mpCompilationOutputTextBox;
   ArchivedSimulationItem *mpArchivedSimulationItem;
   SimulationProcessThread *mpSimulationProcessThread;
   QDateTime mResultFileLastModifiedDateTime;
+  QTimer *mpPlotWhileSimulatingTimer;
+  void writeSimulationMessage(SimulationMessage *pSimulationMessage, QTextCursor *pTextCursor);
 public slots:
   void compilationProcessStarted();
   void writeCompilationOutput(QString output, QColor color);
   void compilationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
   void simulationProcessStarted();
+  void updateSimulationStatistics(SimulationProgress simulationProgress);
+  void updateVariablesWhileSimulating();
   void writeSimulationOutput(QString output, StringHandler::SimulationMessageType type, bool textFormat);
   void simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
   void cancelCompilationOrSimulation();
   void openTransformationBrowser(QUrl url);
+  void filterSimulationOutput();
+  void findSimulationOutputTextEdited(QString text);
 };
 
 #endif // SIMULATIONOUTPUTWIDGET_H
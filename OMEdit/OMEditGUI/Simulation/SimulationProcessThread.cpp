@@ -38,6 +38,14 @@
 #include <QTcpSocket>
 #include <QTcpServer>
 #include "SimulationProcessThread.h"
+#include "SimulationJobScheduler.h"
+#include "VariablesWidget.h"
+
+/*!
+ * \brief simulationProgressInterval
+ * The interval in milliseconds in which the simulation progress is shown.
+ */
+static const int simulationProgressInterval = 100;
 
 SimulationProcessThread::SimulationProcessThread(SimulationOutputWidget *pSimulationOutputWidget)
   : QThread(pSimulationOutputWidget), mpSimulationOutputWidget(pSimulationOutputWidget)
@@ -46,6 +54,39 @@ SimulationProcessThread::SimulationProcessThread(SimulationOutputWidget *pSimula
   mIsCompilationProcessRunning = false;
   mpSimulationProcess = 0;
   mIsSimulationProcessRunning = false;
+  mCompilationProcessors = 1;
+  resetSimulationProgress();
+  mSimulationProgressTimer.setInterval(simulationProgressInterval);
+  connect(&mSimulationProgressTimer, SIGNAL(timeout()), SLOT(sendSimulationProgressUpdate()));
+}
+
+/*!
+ * \brief SimulationProcessThread::startCompilation
+ * Starts the thread which compiles the model. Called by the SimulationJobScheduler.
+ * \param processors - the number of processors granted to the compilation.
+ */
+void SimulationProcessThread::startCompilation(int processors)
+{
+  mCompilationProcessors = processors;
+  start();
+}
+
+/*!
+ * \brief SimulationProcessThread::startSimulation
+ * Runs the simulation executable. Called by the SimulationJobScheduler.
+ * Starts the thread for re-simulation otherwise the thread is already running after the compilation.
+ */
+void SimulationProcessThread::startSimulation()
+{
+  // close the mapped result file before the executable writes it again.
+  SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+  mpSimulationOutputWidget->getMainWindow()->getVariablesWidget()->getMatResultFilesCache()->removeMatResultFile(
+        QString(simulationOptions.getWorkingDirectory()).append("/").append(simulationOptions.getResultFileName()));
+  if (!isRunning()) {
+    start();
+  } else {
+    runSimulationExecutable();
+  }
 }
 
 void SimulationProcessThread::run()
@@ -63,21 +104,16 @@ void SimulationProcessThread::compileModel()
   mpCompilationProcess = new QProcess;
   mpCompilationProcess->setWorkingDirectory(mpSimulationOutputWidget->getSimulationOptions().getWorkingDirectory());
   qRegisterMetaType<QProcess::ExitStatus>("QProcess::ExitStatus");
+  qRegisterMetaType<QProcess::ProcessError>("QProcess::ProcessError");
   connect(mpCompilationProcess, SIGNAL(started()), SLOT(compilationProcessStarted()));
+  connect(mpCompilationProcess, SIGNAL(error(QProcess::ProcessError)), SLOT(processError(QProcess::ProcessError)));
   connect(mpCompilationProcess, SIGNAL(readyReadStandardOutput()), SLOT(readCompilationStandardOutput()));
   connect(mpCompilationProcess, SIGNAL(readyReadStandardError()), SLOT(readCompilationStandardError()));
   connect(mpCompilationProcess, SIGNAL(finished(int,QProcess::ExitStatus)), SLOT(compilationProcessFinished(int,QProcess::ExitStatus)));
-  QString numProcs;
   SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
-  if (simulationOptions.getNumberOfProcessors() == 0) {
-    numProcs = QString::number(simulationOptions.getNumberOfProcessors());
-  } else {
-    numProcs = QString::number(simulationOptions.getNumberOfProcessors());
-  }
   QStringList args;
-  int numProcsInt = numProcs.toInt();
-  if (numProcsInt > 1) {
-    args << "-j" + numProcs;
+  if (mCompilationProcessors > 1) {
+    args << "-j" + QString::number(mCompilationProcessors);
   }
   args << "-f" << simulationOptions.getOutputFileName() + ".makefile";
 #ifdef WIN32
@@ -91,12 +127,32 @@ void SimulationProcessThread::compileModel()
 #endif
 }
 
+/*!
+ * \brief SimulationProcessThread::resetSimulationProgress
+ * Clears the simulation progress. The statistics not sent by the simulation executable are -1.
+ */
+void SimulationProcessThread::resetSimulationProgress()
+{
+  mSimulationProgressBuffer.clear();
+  mSimulationProgress.mProgress = 0;
+  mSimulationProgress.mTime = -1;
+  mSimulationProgress.mStepSize = -1;
+  mSimulationProgress.mSteps = -1;
+  mSimulationProgress.mEvents = -1;
+  mSimulationProgress.mElapsedTime = 0;
+  mSimulationProgress.mRate = -1;
+  mSimulationProgressChanged = false;
+  mLastSimulationProgressTime = 0;
+}
+
 void SimulationProcessThread::runSimulationExecutable()
 {
   mpSimulationProcess = new QProcess;
   mpSimulationProcess->setWorkingDirectory(mpSimulationOutputWidget->getSimulationOptions().getWorkingDirectory());
   qRegisterMetaType<StringHandler::SimulationMessageType>("StringHandler::SimulationMessageType");
+  qRegisterMetaType<QProcess::ProcessError>("QProcess::ProcessError");
   connect(mpSimulationProcess, SIGNAL(started()), SLOT(simulationProcessStarted()));
+  connect(mpSimulationProcess, SIGNAL(error(QProcess::ProcessError)), SLOT(processError(QProcess::ProcessError)));
   connect(mpSimulationProcess, SIGNAL(readyReadStandardOutput()), SLOT(readSimulationStandardOutput()));
   connect(mpSimulationProcess, SIGNAL(readyReadStandardError()), SLOT(readSimulationStandardError()));
   connect(mpSimulationProcess, SIGNAL(finished(int,QProcess::ExitStatus)), SLOT(simulationProcessFinished(int,QProcess::ExitStatus)));
@@ -121,6 +177,19 @@ void SimulationProcessThread::runSimulationExecutable()
   emit sendSimulationOutput(QString("%1 %2").arg(fileName).arg(args.join(" ")), StringHandler::OMEditInfo, true);
 }
 
+/*!
+ * \brief SimulationProcessThread::processError
+ * Slot activated when mpCompilationProcess or mpSimulationProcess error signal is raised.\n
+ * The finished signal is not raised if the process fails to start so release its processors here.
+ * \param error
+ */
+void SimulationProcessThread::processError(QProcess::ProcessError error)
+{
+  if (error == QProcess::FailedToStart) {
+    mpSimulationOutputWidget->getMainWindow()->getSimulationDialog()->getSimulationJobScheduler()->jobStageFinished(this);
+  }
+}
+
 /*!
   Slot activated when mpCompilationProcess started signal is raised.\n
   Notifies SimulationOutputWidget about the start of the compilation by emitting the sendCompilationStarted SIGNAL.
@@ -157,14 +226,16 @@ void SimulationProcessThread::readCompilationStandardError()
 void SimulationProcessThread::compilationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
   mIsCompilationProcessRunning = false;
+  SimulationJobScheduler *pSimulationJobScheduler = mpSimulationOutputWidget->getMainWindow()->getSimulationDialog()->getSimulationJobScheduler();
+  pSimulationJobScheduler->jobStageFinished(this);
   QString exitCodeStr = tr("Compilation process failed. Exited with code %1.").arg(exitCode);
   if (exitStatus == QProcess::NormalExit && exitCode == 0) {
     emit sendCompilationOutput(tr("Compilation process finished successfully."), Qt::blue);
     emit sendCompilationFinished(exitCode, exitStatus);
-    // if not build only and launch the algorithmic debugger is false then run the simulation process.
+    // if not build only and launch the algorithmic debugger is false then queue the simulation process.
     SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
     if (!simulationOptions.getBuildOnly() && !simulationOptions.getLaunchAlgorithmicDebugger()) {
-      runSimulationExecutable();
+      pSimulationJobScheduler->addSimulationJob(this);
     }
   } else if (mpCompilationProcess->error() == QProcess::UnknownError) {
     emit sendCompilationOutput(exitCodeStr, Qt::red);
@@ -182,6 +253,9 @@ void SimulationProcessThread::compilationProcessFinished(int exitCode, QProcess:
 void SimulationProcessThread::simulationProcessStarted()
 {
   mIsSimulationProcessRunning = true;
+  resetSimulationProgress();
+  mSimulationElapsedTimer.start();
+  mSimulationProgressTimer.start();
   emit sendSimulationStarted();
 }
 
@@ -210,6 +284,10 @@ void SimulationProcessThread::readSimulationStandardError()
 void SimulationProcessThread::simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
   mIsSimulationProcessRunning = false;
+  mSimulationProgressTimer.stop();
+  mSimulationProgressChanged = true;
+  sendSimulationProgressUpdate();
+  mpSimulationOutputWidget->getMainWindow()->getSimulationDialog()->getSimulationJobScheduler()->jobStageFinished(this);
   QString exitCodeStr = tr("Simulation process failed. Exited with code %1.").arg(QString::number(exitCode));
   if (exitStatus == QProcess::NormalExit && exitCode == 0) {
     emit sendSimulationOutput(tr("Simulation process finished successfully."), StringHandler::OMEditInfo, true);
@@ -233,24 +311,94 @@ void SimulationProcessThread::createSimulationProgressSocket()
   }
 }
 
+/*!
+ * \brief SimulationProcessThread::readSimulationProgress
+ * Slot activated when the progress socket readyRead signal is raised.\n
+ * Reads all the available progress lines. Only the latest progress is kept and sent by sendSimulationProgressUpdate().
+ */
 void SimulationProcessThread::readSimulationProgress()
 {
   if (sender()) {
     QTcpSocket *pTcpSocket = qobject_cast<QTcpSocket*>(const_cast<QObject*>(sender()));
     if (pTcpSocket) {
-      const int SOCKMAXLEN = 4096;
-      char buf[SOCKMAXLEN];
-      if (pTcpSocket->readLine(buf,SOCKMAXLEN) > 0) {
-        char *msg = 0;
-        double d = strtod(buf, &msg);
-        if (msg == buf || *msg != ' ') {
-          // do we really need to take care of this communication error?????
-          //fprintf(stderr, "TODO: OMEdit GUI: COMM ERROR '%s'", buf);
-        } else {
-          emit sendSimulationProgress(d/100.0);
-          //fprintf(stderr, "TODO: OMEdit GUI: Display progress (%g%%) and message: %s", d/100.0, msg+1);
-        }
+      mSimulationProgressBuffer.append(pTcpSocket->readAll());
+      int position = 0;
+      int lineEnd;
+      while ((lineEnd = mSimulationProgressBuffer.indexOf('\n', position)) >= 0) {
+        parseSimulationProgress(mSimulationProgressBuffer.mid(position, lineEnd - position));
+        position = lineEnd + 1;
+      }
+      mSimulationProgressBuffer.remove(0, position);
+      // a line without the end is a communication error, don't keep it forever.
+      if (mSimulationProgressBuffer.size() > 4096) {
+        mSimulationProgressBuffer.clear();
       }
     }
   }
 }
+
+/*!
+ * \brief SimulationProcessThread::parseSimulationProgress
+ * Parses a progress line. The line starts with the progress in 1/100 percent followed by a message.
+ * The message can have the solver statistics as key=value pairs, time, stepSize, steps and events,
+ * e.g., "5000 time=0.5 stepSize=0.002 steps=250 events=3".
+ * \param line
+ */
+void SimulationProcessThread::parseSimulationProgress(const QByteArray &line)
+{
+  QList<QByteArray> tokens = line.trimmed().split(' ');
+  bool ok;
+  double progress = tokens.first().toDouble(&ok);
+  if (!ok) {
+    // do we really need to take care of this communication error?????
+    return;
+  }
+  mSimulationProgress.mProgress = progress / 100.0;
+  for (int i = 1 ; i < tokens.size() ; i++) {
+    int equal = tokens.at(i).indexOf('=');
+    if (equal <= 0) {
+      continue;
+    }
+    QByteArray key = tokens.at(i).left(equal);
+    QByteArray value = tokens.at(i).mid(equal + 1);
+    if (key == "time") {
+      mSimulationProgress.mTime = value.toDouble(&ok);
+    } else if (key == "stepSize") {
+      mSimulationProgress.mStepSize = value.toDouble(&ok);
+    } else if (key == "steps") {
+      mSimulationProgress.mSteps = value.toLongLong(&ok);
+    } else if (key == "events") {
+      mSimulationProgress.mEvents = value.toLongLong(&ok);
+    }
+  }
+  mSimulationProgressChanged = true;
+}
+
+/*!
+ * \brief SimulationProcessThread::sendSimulationProgressUpdate
+ * Slot activated when mSimulationProgressTimer timeout signal is raised.\n
+ * Sends the latest simulation progress. When the progress is not changing the statistics are still sent every second
+ * so the elapsed time and the rate show a stalled simulation.
+ */
+void SimulationProcessThread::sendSimulationProgressUpdate()
+{
+  qint64 elapsedTime = mSimulationElapsedTimer.isValid() ? mSimulationElapsedTimer.elapsed() : 0;
+  if (!mSimulationProgressChanged && elapsedTime - mLastSimulationProgressTime < 1000) {
+    return;
+  }
+  mSimulationProgressChanged = false;
+  mLastSimulationProgressTime = elapsedTime;
+  mSimulationProgress.mElapsedTime = elapsedTime / 1000.0;
+  // if the executable doesn't send the time then compute it from the progress.
+  SimulationOptions simulationOptions = mpSimulationOutputWidget->getSimulationOptions();
+  double startTime = simulationOptions.getStartTime().toDouble();
+  double time = mSimulationProgress.mTime;
+  if (time < startTime) {
+    time = startTime + (simulationOptions.getStopTime().toDouble() - startTime) * mSimulationProgress.mProgress / 100.0;
+  }
+  if (mSimulationProgress.mElapsedTime > 0) {
+    mSimulationProgress.mRate = (time - startTime) / mSimulationProgress.mElapsedTime;
+  }
+  emit sendSimulationProgress(mSimulationProgress.mProgress);
+  emit sendSimulationStatistics(mSimulationProgress);
+}
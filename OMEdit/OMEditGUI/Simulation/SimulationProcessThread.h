@@ -42,11 +42,25 @@
 
 class SimulationOutputWidget;
 
+struct SimulationProgress
+{
+  double mProgress;
+  double mTime;
+  double mStepSize;
+  qint64 mSteps;
+  qint64 mEvents;
+  double mElapsedTime;
+  double mRate;
+};
+
 class SimulationProcessThread : public QThread
 {
   Q_OBJECT
 public:
   SimulationProcessThread(SimulationOutputWidget *pSimulationOutputWidget);
+  SimulationOutputWidget* getSimulationOutputWidget() {return mpSimulationOutputWidget;}
+  void startCompilation(int processors);
+  void startSimulation();
   QProcess* getCompilationProcess() {return mpCompilationProcess;}
   bool isCompilationProcessRunning() {return mIsCompilationProcessRunning;}
   QProcess* getSimulationProcess() {return mpSimulationProcess;}
@@ -59,10 +73,20 @@ private:
   bool mIsCompilationProcessRunning;
   QProcess *mpSimulationProcess;
   bool mIsSimulationProcessRunning;
+  int mCompilationProcessors;
+  QByteArray mSimulationProgressBuffer;
+  SimulationProgress mSimulationProgress;
+  bool mSimulationProgressChanged;
+  QTimer mSimulationProgressTimer;
+  QElapsedTimer mSimulationElapsedTimer;
+  qint64 mLastSimulationProgressTime;
 
   void compileModel();
   void runSimulationExecutable();
+  void resetSimulationProgress();
+  void parseSimulationProgress(const QByteArray &line);
 private slots:
+  void processError(QProcess::ProcessError error);
   void compilationProcessStarted();
   void readCompilationStandardOutput();
   void readCompilationStandardError();
@@ -73,6 +97,7 @@ private slots:
   void simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
   void createSimulationProgressSocket();
   void readSimulationProgress();
+  void sendSimulationProgressUpdate();
 signals:
   void sendCompilationStarted();
   void sendCompilationOutput(QString, QColor);
@@ -81,6 +106,7 @@ signals:
   void sendSimulationOutput(QString, StringHandler::SimulationMessageType type, bool);
   void sendSimulationFinished(int, QProcess::ExitStatus);
   void sendSimulationProgress(int);
+  void sendSimulationStatistics(SimulationProgress simulationProgress);
 };
 
 #endif // SIMULATIONPROCESSTHREAD_H
@@ -0,0 +1,382 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#include <QVarLengthArray>
+
+#include "AnnotationTree.h"
+
+/*!
+ * \class AnnotationNode
+ * \brief A value of an AnnotationTree.
+ * The node is a light handle to the tree and is only valid as long as the tree exists. Accessing a missing child returns an
+ * invalid node whose values are empty, so the callers can check the size of a list once.
+ */
+/*!
+ * \brief AnnotationNode::getType
+ * \return
+ */
+AnnotationNode::Type AnnotationNode::getType() const
+{
+  return isValid() ? mpAnnotationTree->mNodes.at(mIndex).mType : Invalid;
+}
+
+/*!
+ * \brief AnnotationNode::size
+ * \return the number of the elements of an array or the arguments of a record.
+ */
+int AnnotationNode::size() const
+{
+  if (!isValid()) {
+    return 0;
+  }
+  return mpAnnotationTree->mNodes.at(mIndex).mChildrenCount;
+}
+
+/*!
+ * \brief AnnotationNode::at
+ * \param index
+ * \return the element of the array or the argument of the record at index.
+ */
+AnnotationNode AnnotationNode::at(int index) const
+{
+  if (index < 0 || index >= size()) {
+    return AnnotationNode();
+  }
+  return AnnotationNode(mpAnnotationTree, mpAnnotationTree->mChildren.at(mpAnnotationTree->mNodes.at(mIndex).mChildrenOffset + index));
+}
+
+/*!
+ * \brief AnnotationNode::getName
+ * \return the name of the record, e.g Line for Line(...).
+ */
+QString AnnotationNode::getName() const
+{
+  if (getType() != Record) {
+    return QString();
+  }
+  const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+  return mpAnnotationTree->getString(node.mValueStart, node.mValueLength);
+}
+
+/*!
+ * \brief AnnotationNode::getText
+ * \return the text of the value as it is in the annotation.
+ */
+QString AnnotationNode::getText() const
+{
+  if (!isValid()) {
+    return QString();
+  }
+  const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+  return mpAnnotationTree->getString(node.mStart, node.mEnd - node.mStart);
+}
+
+/*!
+ * \brief AnnotationNode::toString
+ * \return the string without the quotes, the token of a scalar or the text of an array or a record.
+ */
+QString AnnotationNode::toString() const
+{
+  switch (getType()) {
+    case Invalid:
+      return QString();
+    case Array:
+    case Record:
+      return getText();
+    default: {
+      const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+      return mpAnnotationTree->getString(node.mValueStart, node.mValueLength);
+    }
+  }
+}
+
+/*!
+ * \brief AnnotationNode::toRawString
+ * Same as toString() but the string refers to the annotation instead of copying it. Use it only to compare or convert the value
+ * while the tree exists and never keep it.
+ * \return
+ */
+QString AnnotationNode::toRawString() const
+{
+  if (!isValid()) {
+    return QString();
+  }
+  const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+  if (node.mType == Array || node.mType == Record) {
+    return mpAnnotationTree->getRawString(node.mStart, node.mEnd - node.mStart);
+  }
+  return mpAnnotationTree->getRawString(node.mValueStart, node.mValueLength);
+}
+
+/*!
+ * \brief AnnotationNode::toDouble
+ * The token is converted in place without copying it.
+ * \param ok - set to false if the value is not a number.
+ * \return
+ */
+double AnnotationNode::toDouble(bool *ok) const
+{
+  Type type = getType();
+  if (type == Invalid || type == Array || type == Record) {
+    if (ok) {
+      *ok = false;
+    }
+    return 0;
+  }
+  const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+  return mpAnnotationTree->getRawString(node.mValueStart, node.mValueLength).toDouble(ok);
+}
+
+/*!
+ * \brief AnnotationNode::toInt
+ * \return
+ */
+int AnnotationNode::toInt() const
+{
+  Type type = getType();
+  if (type == Invalid || type == Array || type == Record) {
+    return 0;
+  }
+  const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+  return mpAnnotationTree->getRawString(node.mValueStart, node.mValueLength).toInt();
+}
+
+/*!
+ * \brief AnnotationNode::toBool
+ * \return true if the value is the boolean true.
+ */
+bool AnnotationNode::toBool() const
+{
+  if (getType() != Boolean) {
+    return false;
+  }
+  const AnnotationTreeNode &node = mpAnnotationTree->mNodes.at(mIndex);
+  return mpAnnotationTree->getRawString(node.mValueStart, node.mValueLength) == QLatin1String("true");
+}
+
+/*!
+ * \brief AnnotationNode::toPointF
+ * \return the point of an array {x, y}.
+ */
+QPointF AnnotationNode::toPointF() const
+{
+  return QPointF(at(0).toDouble(), at(1).toDouble());
+}
+
+/*!
+ * \brief AnnotationNode::toColor
+ * \return the color of an array {red, green, blue}.
+ */
+QColor AnnotationNode::toColor() const
+{
+  return QColor(at(0).toInt(), at(1).toInt(), at(2).toInt());
+}
+
+/*!
+ * \class AnnotationTree
+ * \brief Parses an annotation returned by OMC into a tree of typed values.
+ * The annotation is read once. The nodes only keep the positions of the values in the annotation, so no substrings are created
+ * while parsing. The root is the list of the comma separated values of the annotation, e.g the arguments of a shape.
+ */
+/*!
+ * \brief AnnotationTree::AnnotationTree
+ * \param annotation
+ */
+AnnotationTree::AnnotationTree(const QString &annotation)
+  : mAnnotation(annotation)
+{
+  mNodes.reserve(64);
+  mChildren.reserve(64);
+  AnnotationTreeNode root;
+  root.mType = AnnotationNode::Array;
+  root.mStart = 0;
+  root.mEnd = mAnnotation.length();
+  root.mValueStart = 0;
+  root.mValueLength = 0;
+  root.mChildrenOffset = 0;
+  root.mChildrenCount = 0;
+  mNodes.append(root);
+  int position = 0;
+  parseValues(&position, QChar(), 0);
+}
+
+void AnnotationTree::skipSpaces(int *pPosition) const
+{
+  const QChar *pData = mAnnotation.constData();
+  while (*pPosition < mAnnotation.length() && pData[*pPosition].isSpace()) {
+    (*pPosition)++;
+  }
+}
+
+/*!
+ * \brief AnnotationTree::parseValue
+ * Parses the value at the position and moves the position after it.
+ * \param pPosition
+ * \return the index of the node of the value.
+ */
+int AnnotationTree::parseValue(int *pPosition)
+{
+  const QChar *pData = mAnnotation.constData();
+  int length = mAnnotation.length();
+  skipSpaces(pPosition);
+  int index = mNodes.size();
+  AnnotationTreeNode node;
+  node.mStart = *pPosition;
+  node.mEnd = *pPosition;
+  node.mValueStart = *pPosition;
+  node.mValueLength = 0;
+  node.mChildrenOffset = 0;
+  node.mChildrenCount = 0;
+  // array
+  if (*pPosition < length && pData[*pPosition] == '{') {
+    node.mType = AnnotationNode::Array;
+    mNodes.append(node);
+    (*pPosition)++;
+    parseValues(pPosition, '}', index);
+    if (*pPosition < length && pData[*pPosition] == '}') {
+      (*pPosition)++;
+    }
+    mNodes[index].mEnd = *pPosition;
+    return index;
+  }
+  // string
+  if (*pPosition < length && (pData[*pPosition] == '"' || pData[*pPosition] == '\'')) {
+    QChar quote = pData[*pPosition];
+    int i = *pPosition + 1;
+    while (i < length && pData[i] != quote) {
+      if (pData[i] == '\\') {
+        i++;
+      }
+      i++;
+    }
+    i = qMin(i, length);
+    node.mType = AnnotationNode::String;
+    node.mValueStart = *pPosition + 1;
+    node.mValueLength = i - node.mValueStart;
+    *pPosition = qMin(i + 1, length);
+    node.mEnd = *pPosition;
+    mNodes.append(node);
+    return index;
+  }
+  // a number, a boolean, an enumeration literal or the name of a record.
+  int i = *pPosition;
+  while (i < length) {
+    QChar c = pData[i];
+    if (c == ',' || c == '{' || c == '}' || c == '(' || c == ')' || c == '"' || c == '\'') {
+      break;
+    }
+    i++;
+  }
+  int end = i;
+  while (end > *pPosition && pData[end - 1].isSpace()) {
+    end--;
+  }
+  node.mValueLength = end - *pPosition;
+  *pPosition = i;
+  if (i < length && pData[i] == '(') {
+    node.mType = AnnotationNode::Record;
+    mNodes.append(node);
+    (*pPosition)++;
+    parseValues(pPosition, ')', index);
+    if (*pPosition < length && pData[*pPosition] == ')') {
+      (*pPosition)++;
+    }
+    mNodes[index].mEnd = *pPosition;
+    return index;
+  }
+  QString token = QString::fromRawData(pData + node.mValueStart, node.mValueLength);
+  if (token == QLatin1String("true") || token == QLatin1String("false")) {
+    node.mType = AnnotationNode::Boolean;
+  } else if (!token.isEmpty() && (token.at(0).isDigit() || ((token.at(0) == '-' || token.at(0) == '+' || token.at(0) == '.')
+                                                             && token.length() > 1 && (token.at(1).isDigit() || token.at(1) == '.')))) {
+    node.mType = AnnotationNode::Number;
+  } else {
+    node.mType = AnnotationNode::Identifier;
+  }
+  node.mEnd = end;
+  mNodes.append(node);
+  return index;
+}
+
+/*!
+ * \brief AnnotationTree::parseValues
+ * Parses the comma separated values until the end character and adds them as the children of the node.
+ * \param pPosition
+ * \param end - the closing bracket of the array or the record. The values of the root are parsed until the end of the annotation.
+ * \param node
+ */
+void AnnotationTree::parseValues(int *pPosition, QChar end, int node)
+{
+  const QChar *pData = mAnnotation.constData();
+  int length = mAnnotation.length();
+  QVarLengthArray<int, 16> children;
+  skipSpaces(pPosition);
+  // an empty array or record has no values.
+  bool empty = (*pPosition >= length) || (!end.isNull() && pData[*pPosition] == end);
+  while (!empty && *pPosition < length) {
+    children.append(parseValue(pPosition));
+    skipSpaces(pPosition);
+    if (*pPosition >= length) {
+      break;
+    }
+    QChar c = pData[*pPosition];
+    if (c == ',') {
+      (*pPosition)++;
+    } else if (!end.isNull() && c == end) {
+      break;
+    } else {
+      // skip the unexpected character, e.g a closing bracket of the wrong kind.
+      (*pPosition)++;
+    }
+  }
+  mNodes[node].mChildrenOffset = mChildren.size();
+  mNodes[node].mChildrenCount = children.size();
+  for (int i = 0 ; i < children.size() ; i++) {
+    mChildren.append(children[i]);
+  }
+}
+
+QString AnnotationTree::getString(int start, int length) const
+{
+  return mAnnotation.mid(start, length);
+}
+
+QString AnnotationTree::getRawString(int start, int length) const
+{
+  return QString::fromRawData(mAnnotation.constData() + start, length);
+}
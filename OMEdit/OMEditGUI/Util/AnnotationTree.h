@@ -0,0 +1,104 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+/*
+ *
+ * @author Adeel Asghar <adeel.asghar@liu.se>
+ *
+ * RCS: $Id$
+ *
+ */
+
+#ifndef ANNOTATIONTREE_H
+#define ANNOTATIONTREE_H
+
+#include <QString>
+#include <QVector>
+#include <QPointF>
+#include <QColor>
+
+class AnnotationTree;
+class AnnotationNode
+{
+public:
+  enum Type {Invalid, Array, Record, Number, Boolean, String, Identifier};
+  AnnotationNode() : mpAnnotationTree(0), mIndex(-1) {}
+  AnnotationNode(const AnnotationTree *pAnnotationTree, int index) : mpAnnotationTree(pAnnotationTree), mIndex(index) {}
+  Type getType() const;
+  bool isValid() const {return mpAnnotationTree && mIndex >= 0;}
+  int size() const;
+  AnnotationNode at(int index) const;
+  QString getName() const;
+  QString getText() const;
+  QString toString() const;
+  QString toRawString() const;
+  double toDouble(bool *ok = 0) const;
+  int toInt() const;
+  bool toBool() const;
+  QPointF toPointF() const;
+  QColor toColor() const;
+private:
+  const AnnotationTree *mpAnnotationTree;
+  int mIndex;
+};
+
+struct AnnotationTreeNode
+{
+  AnnotationNode::Type mType;
+  // the whole value in the annotation.
+  int mStart;
+  int mEnd;
+  // the token of a scalar, the text of a string without quotes or the name of a record.
+  int mValueStart;
+  int mValueLength;
+  // the children of an array or a record in AnnotationTree::mChildren.
+  int mChildrenOffset;
+  int mChildrenCount;
+};
+
+class AnnotationTree
+{
+  friend class AnnotationNode;
+public:
+  AnnotationTree(const QString &annotation);
+  AnnotationNode getRoot() const {return AnnotationNode(this, 0);}
+private:
+  QString mAnnotation;
+  QVector<AnnotationTreeNode> mNodes;
+  QVector<int> mChildren;
+
+  void skipSpaces(int *pPosition) const;
+  int parseValue(int *pPosition);
+  void parseValues(int *pPosition, QChar end, int node);
+  QString getString(int start, int length) const;
+  QString getRawString(int start, int length) const;
+};
+
+#endif // ANNOTATIONTREE_H
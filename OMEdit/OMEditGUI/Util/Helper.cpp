@@ -38,6 +38,7 @@
 
 #include "Helper.h"
 #include <QDir>
+#include <QFileInfo>
 
 /* Global non-translated variables */
 QString Helper::applicationName = "OMEdit";
@@ -192,6 +193,8 @@ QString Helper::reSimulate;
 QString Helper::reSimulateTip;
 QString Helper::reSimulateSetup;
 QString Helper::reSimulateSetupTip;
+QString Helper::parameterSweep;
+QString Helper::parameterSweepTip;
 QString Helper::simulateWithTransformationalDebugger;
 QString Helper::simulateWithTransformationalDebuggerTip;
 QString Helper::simulateWithAlgorithmicDebugger;
@@ -255,6 +258,7 @@ QString Helper::center;
 QString Helper::right;
 QString Helper::connectArray;
 QString Helper::findVariables;
+QString Helper::findMessages;
 QString Helper::viewClass;
 QString Helper::viewClassTip;
 QString Helper::viewDocumentation;
@@ -292,6 +296,7 @@ QString Helper::version;
 QString Helper::unlimited;
 QString Helper::simulationOutput;
 QString Helper::cancelSimulation;
+QString Helper::cancelTranslation;
 QString Helper::fetchInterfaceData;
 QString Helper::fetchInterfaceDataTip;
 QString Helper::tlmCoSimulationSetup;
@@ -299,6 +304,7 @@ QString Helper::tlmCoSimulationSetupTip;
 QString Helper::tlmCoSimulation;
 QString Helper::running;
 QString Helper::finished;
+QString Helper::queued;
 
 void Helper::initHelperVariables()
 {
@@ -378,6 +384,8 @@ void Helper::initHelperVariables()
   Helper::reSimulateTip = tr("Re-simulates the Modelica class");
   Helper::reSimulateSetup = tr("Re-simulate Setup");
   Helper::reSimulateSetupTip = tr("Setup re-simulation settings");
+  Helper::parameterSweep = tr("Parameter Sweep");
+  Helper::parameterSweepTip = tr("Re-simulates the model for a set of parameter values");
   Helper::simulateWithTransformationalDebugger = tr("Simulate with Transformational Debugger");
   Helper::simulateWithTransformationalDebuggerTip = tr("Simulates the Modelica class with Transformational Debugger");
   Helper::simulateWithAlgorithmicDebugger = tr("Simulate with Algorithmic Debugger");
@@ -441,6 +449,7 @@ void Helper::initHelperVariables()
   Helper::right = tr("Right");
   Helper::connectArray = tr("Connect Array");
   Helper::findVariables = tr("Find Variables");
+  Helper::findMessages = tr("Find Messages");
   Helper::viewClass = tr("View Class");
   Helper::viewClassTip = tr("Opens the class details");
   Helper::viewDocumentation = tr("View Documentation");
@@ -478,6 +487,7 @@ void Helper::initHelperVariables()
   Helper::unlimited = tr("unlimited");
   Helper::simulationOutput = tr("Simulation Output");
   Helper::cancelSimulation = tr("Cancel Simulation");
+  Helper::cancelTranslation = tr("Cancel Translation");
   Helper::fetchInterfaceData = tr("Fetch Interface Data");
   Helper::fetchInterfaceDataTip = tr("Fetches the interface data for TLM co-simulation");
   Helper::tlmCoSimulationSetup = tr("TLM Co-Simulation Setup");
@@ -485,6 +495,7 @@ void Helper::initHelperVariables()
   Helper::tlmCoSimulation = tr("TLM Co-Simulation");
   Helper::running = tr("Running");
   Helper::finished = tr("Finished");
+  Helper::queued = tr("Queued");
 }
 
 QString GUIMessages::getMessage(int type)
@@ -629,6 +640,25 @@ QString& OpenModelica::tempDirectory()
   return tmpPath;
 }
 
+/*!
+ * \brief OpenModelica::cacheDirectory
+ * Returns the directory where OMEdit keeps the data that should survive between the sessions e.g., library cache.
+ * The directory is created next to the settings file.
+ * \return
+ */
+QString& OpenModelica::cacheDirectory()
+{
+  static int init = 0;
+  static QString cachePath;
+  if (!init) {
+    init = 1;
+    cachePath = QFileInfo(getApplicationSettings()->fileName()).absolutePath() + "/" + Helper::application + "-cache/";
+    if (!QDir().exists(cachePath))
+      QDir().mkpath(cachePath);
+  }
+  return cachePath;
+}
+
 QSettings* OpenModelica::getApplicationSettings()
 {
   static int init = 0;
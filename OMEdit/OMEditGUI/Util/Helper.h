@@ -194,6 +194,8 @@ public:
   static QString reSimulateTip;
   static QString reSimulateSetup;
   static QString reSimulateSetupTip;
+  static QString parameterSweep;
+  static QString parameterSweepTip;
   static QString simulateWithTransformationalDebugger;
   static QString simulateWithTransformationalDebuggerTip;
   static QString simulateWithAlgorithmicDebugger;
@@ -257,6 +259,7 @@ public:
   static QString right;
   static QString connectArray;
   static QString findVariables;
+  static QString findMessages;
   static QString viewClass;
   static QString viewClassTip;
   static QString viewDocumentation;
@@ -294,6 +297,7 @@ public:
   static QString unlimited;
   static QString simulationOutput;
   static QString cancelSimulation;
+  static QString cancelTranslation;
   static QString fetchInterfaceData;
   static QString fetchInterfaceDataTip;
   static QString tlmCoSimulationSetup;
@@ -301,6 +305,7 @@ public:
   static QString tlmCoSimulation;
   static QString running;
   static QString finished;
+  static QString queued;
 };
 
 class GUIMessages : public QObject
@@ -374,6 +379,7 @@ public:
 
 namespace OpenModelica {
   QString& tempDirectory();
+  QString& cacheDirectory();
   QSettings* getApplicationSettings();
 }
 